@@ -256,6 +256,26 @@ void Compiler::EndCompile() {
   engine_->AddSelfModule();
 }
 
+std::string Compiler::GetObject() {
+  return target_.arch.Match(
+      [&](common::X86Arch) -> std::string {
+        return engine_->GetSelfModuleObject();
+      },
+      [&](std::variant<common::UnknownArch,
+                       common::ARMArch,
+                       common::NVGPUArch,
+                       common::HygonDCUArchHIP>) -> std::string { return ""; });
+}
+
+void Compiler::LoadObject(const std::string& object) {
+  target_.arch.Match(
+      [&](common::X86Arch) { engine_->AddObject(object); },
+      [&](std::variant<common::UnknownArch,
+                       common::ARMArch,
+                       common::NVGPUArch,
+                       common::HygonDCUArchHIP>) { CINN_NOT_IMPLEMENTED; });
+}
+
 std::string Compiler::GetSourceCode(const ir::Module& module) {
   return target_.arch.Match(
       [&](common::UnknownArch) -> std::string { CINN_NOT_IMPLEMENTED; },
@@ -116,6 +116,19 @@ class Compiler final {
 
   void ExportObject(const std::string& path);
 
+  /**
+   * Get the object code of the compiled module, which is available after the
+   * first Lookup. Only x86 targets are supported, and an empty string is
+   * returned for the others.
+   */
+  std::string GetObject();
+
+  /**
+   * Load the object code returned by GetObject() instead of compiling the
+   * modules. Only x86 targets are supported.
+   */
+  void LoadObject(const std::string& object);
+
   std::string GetSourceCode(const ir::Module& module);
 
   void BuildDefault(const ir::Module& module);
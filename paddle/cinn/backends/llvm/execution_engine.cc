@@ -107,6 +107,15 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(
   return llvm::MemoryBuffer::getMemBuffer(it->second->getMemBufferRef());
 }
 
+llvm::StringRef NaiveObjectCache::GetCompiledObject(
+    const std::string &module_id) const {
+  auto it = cached_objects_.find(module_id);
+  if (it == cached_objects_.end()) {
+    return llvm::StringRef();
+  }
+  return it->second->getBuffer();
+}
+
 /*static*/ std::unique_ptr<ExecutionEngine> ExecutionEngine::Create(
     const ExecutionOptions &config) {
   VLOG(1) << "===================== Create CINN ExecutionEngine begin "
@@ -244,9 +253,25 @@ void ExecutionEngine::RegisterModuleRuntimeSymbols(
 }
 
 bool ExecutionEngine::AddSelfModule() {
+  self_module_id_ = m->getModuleIdentifier();
   return AddModule(std::move(m), std::move(ctx));
 }
 
+std::string ExecutionEngine::GetSelfModuleObject() {
+  std::lock_guard<std::mutex> lock(mu_);
+  if (self_module_id_.empty()) {
+    return "";
+  }
+  return cache_->GetCompiledObject(self_module_id_).str();
+}
+
+void ExecutionEngine::AddObject(const std::string &object) {
+  utils::RecordEvent("ExecutionEngine AddObject", utils::EventType::kOrdinary);
+  std::lock_guard<std::mutex> lock(mu_);
+  llvm::cantFail(jit_->addObjectFile(
+      llvm::MemoryBuffer::getMemBufferCopy(object, "cinn_cached_object")));
+}
+
 void ExecutionEngine::ExportObject(const std::string &path) {
   FILE *of = fopen(path.c_str(), "w");
   fwrite(buffer_.data(), 1, buffer_.size(), of);
@@ -56,6 +56,10 @@ class NaiveObjectCache : public llvm::ObjectCache {
                             llvm::MemoryBufferRef) override;
   std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *) override;
 
+  // Return the object compiled from the module, or an empty reference if the
+  // module has not been compiled yet.
+  llvm::StringRef GetCompiledObject(const std::string &module_id) const;
+
  private:
   llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> cached_objects_;
 };
@@ -87,6 +91,14 @@ class ExecutionEngine {
 
   bool AddSelfModule();
 
+  // Return the object code of the module added by AddSelfModule, or an empty
+  // string if it has not been compiled, which happens on the first Lookup.
+  std::string GetSelfModuleObject();
+
+  // Add an object code returned by GetSelfModuleObject, possibly from another
+  // process, instead of linking and adding the modules.
+  void AddObject(const std::string &object);
+
  protected:
   explicit ExecutionEngine(bool enable_object_cache)
       : cache_(std::make_unique<NaiveObjectCache>()),
@@ -107,6 +119,7 @@ class ExecutionEngine {
   std::unique_ptr<llvm::orc::LLJIT> jit_;
   std::unique_ptr<NaiveObjectCache> cache_;
   RuntimeSymbols module_symbols_;
+  std::string self_module_id_;
 
   std::unique_ptr<llvm::LLVMContext> ctx;
   std::unique_ptr<llvm::Module> m;
@@ -57,6 +57,7 @@ class BackendResource final {
   }
   pir::CINNKernelInfo GenerateKernelInfo() const;
   const std::string& GetHostFuncName() const { return host_fn_name_; }
+  const std::string& GetInferFuncName() const { return infer_fn_name_; }
 
  private:
   std::string host_fn_name_;
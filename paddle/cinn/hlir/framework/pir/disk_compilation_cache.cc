@@ -0,0 +1,364 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/hlir/framework/pir/disk_compilation_cache.h"
+
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+#include "paddle/cinn/utils/profiler.h"
+#include "paddle/common/enforce.h"
+#include "paddle/common/flags.h"
+
+PD_DECLARE_string(cinn_compilation_cache_dir);
+
+namespace cinn::hlir::framework::pir {
+
+namespace {
+
+// Bump it when the layout of the entry changes.
+constexpr int kFormatVersion = 1;
+constexpr char kEntrySuffix[] = ".cinn";
+// Guards against allocating for a corrupted size.
+constexpr uint64_t kMaxFieldSize = 1ULL << 32;
+
+// std::hash is not guaranteed to be the same across builds, so the entry
+// names are hashed by FNV-1a.
+uint64_t Fnv1a(const std::string& str) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : str) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+std::string TargetString(const Target& target) {
+  std::ostringstream os;
+  os << target;
+  return os.str();
+}
+
+std::string EntryName(const std::string& fingerprint,
+                      const std::string& target) {
+  char name[32];
+  snprintf(name,
+           sizeof(name),
+           "%016llx",
+           static_cast<unsigned long long>(  // NOLINT
+               Fnv1a(fingerprint + "\n" + target)));
+  return std::string(name) + kEntrySuffix;
+}
+
+class EntryWriter {
+ public:
+  explicit EntryWriter(std::ostream* os) : os_(os) {}
+
+  template <typename T>
+  void Write(T value) {
+    os_->write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void Write(const std::string& str) {
+    Write<uint64_t>(str.size());
+    os_->write(str.data(), str.size());
+  }
+
+ private:
+  std::ostream* os_;
+};
+
+class EntryReader {
+ public:
+  explicit EntryReader(std::istream* is) : is_(is) {}
+
+  template <typename T>
+  bool Read(T* value) {
+    is_->read(reinterpret_cast<char*>(value), sizeof(T));
+    return is_->good();
+  }
+
+  bool Read(std::string* str) {
+    uint64_t size = 0;
+    if (!Read(&size) || size > kMaxFieldSize) return false;
+    str->resize(size);
+    is_->read(str->data(), size);
+    return is_->good();
+  }
+
+  // The bytes left in the stream, to bound the counts read from it before
+  // allocating for them.
+  uint64_t Remaining() {
+    const auto pos = is_->tellg();
+    is_->seekg(0, std::ios::end);
+    const auto end = is_->tellg();
+    is_->seekg(pos);
+    if (pos < 0 || end < pos) return 0;
+    return static_cast<uint64_t>(end - pos);
+  }
+
+ private:
+  std::istream* is_;
+};
+
+struct Entry {
+  std::string version;
+  std::string fingerprint;
+  std::string target;
+  std::string host_fn_name;
+  std::string infer_fn_name;
+  std::map<int, CINNKernelInfo::SymbolArgBindInfo> symbol_args_map;
+  std::vector<int64_t> temp_space_sizes;
+  std::string object;
+};
+
+void WriteEntry(const Entry& entry, std::ostream* os) {
+  EntryWriter writer(os);
+  writer.Write(entry.version);
+  writer.Write(entry.fingerprint);
+  writer.Write(entry.target);
+  writer.Write(entry.host_fn_name);
+  writer.Write(entry.infer_fn_name);
+  writer.Write<uint64_t>(entry.symbol_args_map.size());
+  for (const auto& [arg_idx, bind_info] : entry.symbol_args_map) {
+    writer.Write<int32_t>(arg_idx);
+    writer.Write<int32_t>(bind_info.index());
+    std::visit(
+        [&](const auto& idx) {
+          using T = std::decay_t<decltype(idx)>;
+          if constexpr (std::is_same_v<T, CINNKernelInfo::ArgDimIdx>) {
+            writer.Write<int32_t>(idx.arg_idx);
+            writer.Write<int32_t>(idx.dim_idx);
+          } else {
+            writer.Write<int32_t>(idx.arg_idx);
+            writer.Write<int32_t>(idx.value_idx);
+          }
+        },
+        bind_info);
+  }
+  writer.Write<uint64_t>(entry.temp_space_sizes.size());
+  for (int64_t size : entry.temp_space_sizes) {
+    writer.Write<int64_t>(size);
+  }
+  writer.Write(entry.object);
+}
+
+// Stop right after the version if it mismatches, to avoid reading the object
+// of an entry that is going to be dropped anyway.
+bool ReadEntry(std::istream* is, Entry* entry) {
+  EntryReader reader(is);
+  if (!reader.Read(&entry->version) ||
+      entry->version != DiskCompilationCache::Version()) {
+    return false;
+  }
+  if (!reader.Read(&entry->fingerprint) || !reader.Read(&entry->target) ||
+      !reader.Read(&entry->host_fn_name) ||
+      !reader.Read(&entry->infer_fn_name)) {
+    return false;
+  }
+  uint64_t num_symbol_args = 0;
+  if (!reader.Read(&num_symbol_args)) return false;
+  for (uint64_t i = 0; i < num_symbol_args; ++i) {
+    int32_t arg_idx = 0, kind = 0, first = 0, second = 0;
+    if (!reader.Read(&arg_idx) || !reader.Read(&kind) ||
+        !reader.Read(&first) || !reader.Read(&second)) {
+      return false;
+    }
+    if (kind == 0) {
+      entry->symbol_args_map[arg_idx] =
+          CINNKernelInfo::ArgDimIdx{first, second};
+    } else {
+      entry->symbol_args_map[arg_idx] =
+          CINNKernelInfo::ArgValueIdx{first, second};
+    }
+  }
+  uint64_t num_temp_spaces = 0;
+  if (!reader.Read(&num_temp_spaces) ||
+      num_temp_spaces > reader.Remaining() / sizeof(int64_t)) {
+    return false;
+  }
+  entry->temp_space_sizes.resize(num_temp_spaces);
+  for (uint64_t i = 0; i < num_temp_spaces; ++i) {
+    if (!reader.Read(&entry->temp_space_sizes[i])) return false;
+  }
+  return reader.Read(&entry->object) && !entry->object.empty();
+}
+
+}  // namespace
+
+DiskCompilationCache& DiskCompilationCache::Instance() {
+  static DiskCompilationCache instance;
+  return instance;
+}
+
+bool DiskCompilationCache::IsEnabled(const Target& target) {
+  return !FLAGS_cinn_compilation_cache_dir.empty() &&
+         std::holds_alternative<common::X86Arch>(target.arch);
+}
+
+const std::string& DiskCompilationCache::Version() {
+  static const std::string version = [] {
+    std::ostringstream os;
+    os << "cinn-compilation-cache-v" << kFormatVersion;
+#ifdef PADDLE_VERSION_INTEGER
+    os << " paddle-" << PADDLE_VERSION_INTEGER;
+#endif
+    os << " llvm-" << LLVM_VERSION_STRING;
+    // The objects are compiled for the host CPU, see ExecutionEngine::Link.
+    auto jtmb = llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (jtmb) {
+      os << " " << jtmb->getTargetTriple().str() << " " << jtmb->getCPU()
+         << " " << jtmb->getFeatures().getString();
+    } else {
+      llvm::consumeError(jtmb.takeError());
+    }
+    return os.str();
+  }();
+  return version;
+}
+
+void DiskCompilationCache::ListDirectory() {
+  if (listed_ && dir_ == FLAGS_cinn_compilation_cache_dir) return;
+  listed_ = true;
+  dir_ = FLAGS_cinn_compilation_cache_dir;
+  entries_.clear();
+  std::error_code ec;
+  std::filesystem::create_directories(dir_, ec);
+  for (std::filesystem::directory_iterator it(dir_, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    const auto& path = it->path();
+    if (path.extension() == kEntrySuffix) {
+      entries_.insert(path.filename().string());
+    }
+  }
+  if (ec) {
+    LOG(WARNING) << "Failed to list the cinn compilation cache directory "
+                 << dir_ << ": " << ec.message();
+  }
+  VLOG(3) << "Found " << entries_.size()
+          << " entries in the cinn compilation cache directory " << dir_;
+}
+
+std::shared_ptr<CompilationResult> DiskCompilationCache::Load(
+    const FusionInfo& key, const Target& target) {
+  if (!IsEnabled(target)) return nullptr;
+  utils::RecordEvent record_load("DiskCompilationCache Load",
+                                 utils::EventType::kOrdinary);
+  const std::string fingerprint = key.Fingerprint();
+  const std::string target_str = TargetString(target);
+  const std::string name = EntryName(fingerprint, target_str);
+  std::string path;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    ListDirectory();
+    if (entries_.count(name) == 0) return nullptr;
+    path = (std::filesystem::path(dir_) / name).string();
+  }
+
+  Entry entry;
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs.is_open() || !ReadEntry(&ifs, &entry) ||
+      entry.fingerprint != fingerprint || entry.target != target_str) {
+    VLOG(3) << "Ignore the stale or mismatched cinn compilation cache entry "
+            << path;
+    return nullptr;
+  }
+
+  auto backend_resource =
+      std::make_shared<BackendResource>(target,
+                                        entry.host_fn_name,
+                                        entry.infer_fn_name,
+                                        entry.symbol_args_map,
+                                        entry.temp_space_sizes);
+  backend_resource->GetBackendCompiler()->LoadObject(entry.object);
+  auto result = std::make_shared<CompilationResult>(target);
+  result->SetBackendResource(backend_resource);
+  VLOG(4) << "Load " << entry.host_fn_name
+          << " from the cinn compilation cache entry " << path;
+  return result;
+}
+
+void DiskCompilationCache::Save(const FusionInfo& key,
+                                const Target& target,
+                                const CompilationResult& result) {
+  if (!IsEnabled(target)) return;
+  const auto& backend_resource = result.GetBackendResource();
+  if (backend_resource == nullptr) return;
+  utils::RecordEvent record_save("DiskCompilationCache Save",
+                                 utils::EventType::kOrdinary);
+
+  // The JIT emits the object code of the module on the first lookup, which
+  // has not happened yet when PirCompiler saves a new kernel.
+  backend_resource->GetBackendCompiler()->Lookup(
+      backend_resource->GetHostFuncName());
+  Entry entry;
+  entry.object = backend_resource->GetBackendCompiler()->GetObject();
+  if (entry.object.empty()) {
+    VLOG(3) << "Skip saving " << backend_resource->GetHostFuncName()
+            << " into the cinn compilation cache since it is not compiled.";
+    return;
+  }
+  entry.version = Version();
+  entry.fingerprint = key.Fingerprint();
+  entry.target = TargetString(target);
+  entry.host_fn_name = backend_resource->GetHostFuncName();
+  entry.infer_fn_name = backend_resource->GetInferFuncName();
+  entry.symbol_args_map = backend_resource->GetSymbolArgsMap();
+  entry.temp_space_sizes = backend_resource->GetTempSpaceSizes();
+
+  const std::string name = EntryName(entry.fingerprint, entry.target);
+  std::string path;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    ListDirectory();
+    path = (std::filesystem::path(dir_) / name).string();
+  }
+
+  // Write a temporary file unique to this process and thread, then rename it,
+  // which atomically replaces the entry on POSIX file systems.
+  std::ostringstream tmp_path;
+  tmp_path << path << ".tmp." << getpid() << "."
+           << std::hash<std::thread::id>()(std::this_thread::get_id());
+  {
+    std::ofstream ofs(tmp_path.str(), std::ios::binary | std::ios::trunc);
+    if (ofs.is_open()) WriteEntry(entry, &ofs);
+    ofs.close();
+    if (!ofs.good()) {
+      LOG(WARNING) << "Failed to write the cinn compilation cache entry "
+                   << tmp_path.str();
+      std::remove(tmp_path.str().c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Failed to rename " << tmp_path.str() << " to " << path;
+    std::remove(tmp_path.str().c_str());
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  entries_.insert(name);
+  VLOG(4) << "Save " << entry.host_fn_name
+          << " into the cinn compilation cache entry " << path;
+}
+
+}  // namespace cinn::hlir::framework::pir
@@ -0,0 +1,75 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include "paddle/cinn/common/macros.h"
+#include "paddle/cinn/common/target.h"
+#include "paddle/cinn/hlir/framework/pir/compilation_cache.h"
+#include "paddle/cinn/hlir/framework/pir/fusion_info.h"
+
+namespace cinn::hlir::framework::pir {
+
+/**
+ * DiskCompilationCache saves the compiled kernels into
+ * FLAGS_cinn_compilation_cache_dir, so that the later processes load them
+ * instead of lowering and compiling the same fusion groups again.
+ *
+ * Each entry is a file named by the hash of the fingerprint of the fusion
+ * group and the target. It starts with a version string made of the cache
+ * format, Paddle and LLVM versions and the host CPU, followed by the
+ * fingerprint, the kernel info and the object code. An entry with another
+ * version or fingerprint is treated as a miss and overwritten after compiling.
+ * Entries are written to a temporary file and renamed, so that a concurrent
+ * process never reads a partial one.
+ *
+ * The directory is listed on the first access, and an entry is read only when
+ * its fusion group is compiled. Only x86 targets are supported, since the
+ * device code of GPU targets is not a part of the object code.
+ */
+class DiskCompilationCache {
+ public:
+  static DiskCompilationCache& Instance();
+
+  static bool IsEnabled(const Target& target);
+
+  // Return nullptr if the entry does not exist or is invalid.
+  std::shared_ptr<CompilationResult> Load(const FusionInfo& key,
+                                          const Target& target);
+
+  void Save(const FusionInfo& key,
+            const Target& target,
+            const CompilationResult& result);
+
+  // The version string written into each entry.
+  static const std::string& Version();
+
+ private:
+  DiskCompilationCache() = default;
+  CINN_DISALLOW_COPY_AND_ASSIGN(DiskCompilationCache);
+
+  void ListDirectory();
+
+  std::mutex mutex_;
+  bool listed_{false};
+  std::string dir_;
+  std::unordered_set<std::string> entries_;
+};
+
+}  // namespace cinn::hlir::framework::pir
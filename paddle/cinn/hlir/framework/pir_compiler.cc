@@ -17,6 +17,7 @@
 
 #include "paddle/cinn/hlir/dialect/operator/transforms/lowering_pass/utils.h"
 #include "paddle/cinn/hlir/framework/pir/broadcast_with_cf.h"
+#include "paddle/cinn/hlir/framework/pir/disk_compilation_cache.h"
 #include "paddle/cinn/hlir/framework/pir/utils.h"
 #include "paddle/cinn/runtime/arch_device.h"
 #include "paddle/cinn/utils/multi_threading.h"
@@ -30,7 +31,8 @@ namespace cinn::hlir::framework {
 class CompilationContextMapper {
  public:
   CompilationContextMapper(const Target& target,
-                           const std::vector<pir::OpLoweringGroupPtr>& groups) {
+                           const std::vector<pir::OpLoweringGroupPtr>& groups)
+      : target_(target) {
     Construct(target, groups);
   }
   std::vector<GroupCompilationContext>& UniqueCompilationContexts() {
@@ -48,6 +50,7 @@ class CompilationContextMapper {
  private:
   void Construct(const Target& target,
                  const std::vector<pir::OpLoweringGroupPtr>& groups);
+  Target target_;
   std::vector<size_t> mapper_index_;
   std::vector<pir::FusionInfo> fusion_infos_;
   std::vector<GroupCompilationContext> group_compilation_contexts_;
@@ -148,6 +151,18 @@ void CompilationContextMapper::Construct(
     const bool is_new = !CompilationCache::Instance().Has(info);
     return is_new && is_unique;
   };
+  // Kernels compiled by previous processes are loaded into the in-memory cache
+  // directly.
+  const auto LoadFromDisk = [&target](const pir::FusionInfo& info) -> bool {
+    if (!FLAGS_enable_cinn_compile_cache ||
+        !pir::DiskCompilationCache::IsEnabled(target)) {
+      return false;
+    }
+    auto result = pir::DiskCompilationCache::Instance().Load(info, target);
+    if (result == nullptr) return false;
+    CompilationCache::Instance().Insert(info, result);
+    return true;
+  };
 
   for (size_t i = 0; i < groups.size(); ++i) {
     cinn::dialect::ir::details::UpdateGroupShapeOrDataExprs(groups[i]);
@@ -156,7 +171,8 @@ void CompilationContextMapper::Construct(
             << " for group: " << *groups[i];
     // If FLAGS_enable_cinn_compile_cache=False, Cache strategy will not take
     // effects.
-    if (IsNewAndUnique(fusion_infos_[i]) || !FLAGS_enable_cinn_compile_cache) {
+    if ((IsNewAndUnique(fusion_infos_[i]) && !LoadFromDisk(fusion_infos_[i])) ||
+        !FLAGS_enable_cinn_compile_cache) {
       mapper_index_.push_back(i);
       group_compilation_contexts_.emplace_back(target, groups[i]);
       compilation_results_.push_back(
@@ -207,6 +223,10 @@ void CompilationContextMapper::UpdateGlobalCache() {
             << fusion_info << ", host func name: "
             << compilation_results_[i]->GetHostFuncName();
     CompilationCache::Instance().Insert(fusion_info, compilation_results_[i]);
+    if (FLAGS_enable_cinn_compile_cache) {
+      pir::DiskCompilationCache::Instance().Save(
+          fusion_info, target_, *compilation_results_[i]);
+    }
   }
 }
 }  // namespace cinn::hlir::framework
@@ -374,6 +374,21 @@ PHI_DEFINE_EXPORTED_bool(
 PHI_DEFINE_EXPORTED_int32(communicator_send_queue_size,
                           20,
                           "queue size to recv gradient before send");
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_communicator_merge_sparse_grad_on_send
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If true, the async communicator sums the sparse gradients of the
+ *       same id as the trainer sends them, instead of queueing the
+ *       gradients of each batch, and pushes the merged gradients once every
+ *       communicator_max_merge_var_num batches.
+ */
+PHI_DEFINE_EXPORTED_bool(communicator_merge_sparse_grad_on_send,
+                         false,
+                         "merge the sparse gradients of the same id when "
+                         "they are sent to the communicator");
 #endif
 
 /**
@@ -1059,6 +1074,19 @@ PHI_DEFINE_EXPORTED_int64(
     cinn_compile_thread_num,
     -1,
     "It controls how many thread numbers applying compilation cache.");
+/*
+ * CINN related FLAG
+ * Name: FLAGS_cinn_compilation_cache_dir
+ * Since Version: 3.0 Beta
+ * Value Range: string, default=""
+ * Example: FLAGS_cinn_compilation_cache_dir="/path/to/cache" would save the
+ * compiled x86 kernels into the directory and reuse them in later processes
+ */
+PHI_DEFINE_EXPORTED_string(
+    cinn_compilation_cache_dir,
+    "",
+    "The directory of the on-disk cinn compilation cache, which is shared "
+    "between processes. Empty means disabled.");
 /*
  * CINN related FLAG
  * Name: FLAGS_enable_interpretercore_launch_cinn
@@ -1217,6 +1245,17 @@ PD_DEFINE_bool(enable_slotrecord_reset_shrink,  // NOLINT
 PD_DEFINE_bool(enable_ins_parser_file,  // NOLINT
                false,
                "enable parser ins file, default false");
+PD_DEFINE_string(dataset_record_cache_dir,  // NOLINT
+                 "",
+                 "the local dir to cache the records parsed from the local "
+                 "files of InMemoryDataset, which are loaded from the cache "
+                 "instead of parsed again in the later passes, "
+                 "default empty to disable the cache");
+PD_DEFINE_bool(enable_dataset_column_store,  // NOLINT
+               false,
+               "keep the records of MultiSlotDataset in columns after the "
+               "local shuffle, which take less memory than the records, "
+               "default false");
 PHI_DEFINE_EXPORTED_bool(
     gpugraph_enable_hbm_table_collision_stat,
     false,
@@ -1515,6 +1554,36 @@ PHI_DEFINE_EXPORTED_bool(use_shm_cache,
                          false,
                          "Use shm cache in mmap_allocator.");
 
+/**
+ * Parameter loading related FLAG
+ * Name: enable_mmap_load_params
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If True, load_combine maps the parameter file into memory when loading
+ * to CPU, and the parameters whose data is aligned in the file point into the
+ * mapping instead of being copied, so processes loading the same file share
+ * its page cache. Writes to them are copy-on-write and never reach the file.
+ */
+PHI_DEFINE_EXPORTED_bool(enable_mmap_load_params,
+                         false,
+                         "Load combined parameters to CPU by mmap.");
+
+/**
+ * Parameter saving related FLAG
+ * Name: enable_aligned_save_params
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If True, save_combine pads the description of each tensor, so that the
+ * data of the tensors not smaller than a page starts at a page boundary and
+ * the others at a 64 bytes boundary, which FLAGS_enable_mmap_load_params
+ * requires to share the data. The file can still be loaded as before.
+ */
+PHI_DEFINE_EXPORTED_bool(enable_aligned_save_params,
+                         false,
+                         "Align the tensor data in the saved parameter file.");
+
 /**
  * mmap_allocator related FLAG
  * Name: dataloader_use_file_descriptor
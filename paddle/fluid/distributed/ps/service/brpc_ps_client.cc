@@ -19,6 +19,7 @@
 #include <string>
 
 #include "paddle/fluid/distributed/ps/service/coordinator_client.h"
+#include "paddle/fluid/distributed/ps/service/sparse_rpc_codec.h"
 #include "paddle/fluid/framework/archive.h"
 #include "paddle/utils/string/split.h"
 
@@ -347,6 +348,15 @@ int32_t BrpcPsClient::Initialize() {
       _push_sparse_merge_count_map[table_id] = 0;
     }
   }
+  const auto &server_param = _config.server_param().downpour_server_param();
+  for (int i = 0; i < server_param.downpour_table_param_size(); ++i) {
+    const auto &table_param = server_param.downpour_table_param(i);
+    if (table_param.sparse_rpc_compress()) {
+      _sparse_rpc_compress_map[table_param.table_id()] = {
+          table_param.sparse_pull_fp32_dim(),
+          table_param.sparse_push_fp32_dim()};
+    }
+  }
 
   auto &profiler = CostProfiler::instance();
   profiler.register_profiler("pserver_client_pull_dense");
@@ -1004,13 +1014,51 @@ std::future<int32_t> BrpcPsClient::PushDenseParam(const Region *regions,
   return fut;
 }
 
+void BrpcPsClient::SerializeSparsePushData(size_t table_id,
+                                           const uint64_t *keys,
+                                           const float *const *values,
+                                           uint32_t num,
+                                           PsRequestMessage *request) {
+  auto *accessor = GetTableAccessor(table_id);
+  size_t value_size = accessor->GetAccessorInfo().update_size;
+  auto *push_data = request->mutable_data();
+  auto itr = _sparse_rpc_compress_map.find(table_id);
+  if (itr != _sparse_rpc_compress_map.end()) {
+    /*
+    Compressed Push Content:
+    |---keysData(varint)---|---valuesData(fp32_dim fp32, others fp16)---|
+    */
+    uint32_t fp32_dim = itr->second.push_fp32_dim;
+    size_t dim = accessor->GetAccessorInfo().update_dim;
+    size_t value_bytes = SparseValueBytes(dim, fp32_dim);
+    request->add_params(reinterpret_cast<char *>(&fp32_dim), sizeof(uint32_t));
+    push_data->clear();
+    EncodeSparseKeys(keys, num, push_data);
+    size_t keys_bytes = push_data->size();
+    push_data->resize(keys_bytes + num * value_bytes);
+    char *push_data_ptr = const_cast<char *>(push_data->data()) + keys_bytes;
+    for (uint32_t i = 0; i < num; ++i) {
+      EncodeSparseValue(values[i], dim, fp32_dim, push_data_ptr);
+      push_data_ptr += value_bytes;
+    }
+    return;
+  }
+  push_data->resize(num * (sizeof(uint64_t) + value_size));
+  char *push_data_ptr = const_cast<char *>(push_data->data());
+  memcpy(push_data_ptr, keys, num * sizeof(uint64_t));
+  push_data_ptr += num * sizeof(uint64_t);
+  for (uint32_t i = 0; i < num; ++i) {
+    memcpy(push_data_ptr, values[i], value_size);
+    push_data_ptr += value_size;
+  }
+}
+
 std::future<int32_t> BrpcPsClient::PushSparseRawGradient(
     size_t table_id,
     const uint64_t *keys,
     const float **update_values,
     size_t num,
     void *done) {
-  auto *accessor = GetTableAccessor(table_id);
   // 发送RPC请求
   DownpourBrpcClosure *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
   auto promise = std::make_shared<std::promise<int32_t>>();
@@ -1044,7 +1092,6 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradient(
     auto value_ptr = value_ptrs[shard_idx];
 
     size_t kv_size = kvs.size();
-    uint32_t value_size = accessor->GetAccessorInfo().update_size;
 
     // 发送RPC请求
     auto *push_request = closure->request(shard_idx);
@@ -1052,16 +1099,8 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradient(
     push_request->set_table_id(table_id);
     push_request->set_client_id(_client_id);
     push_request->add_params((char *)&kv_size, sizeof(uint32_t));  // NOLINT
-    auto *push_data = push_request->mutable_data();
-    push_data->resize(kv_size * (sizeof(uint64_t) + value_size));
-    char *push_data_ptr = const_cast<char *>(push_data->data());
-    memcpy(push_data_ptr, kvs.data(), kv_size * sizeof(uint64_t));
-    push_data_ptr += kv_size * sizeof(uint64_t);
-
-    for (size_t i = 0; i < kv_size; ++i) {
-      memcpy(push_data_ptr, value_ptr[i], value_size);
-      push_data_ptr += value_size;
-    }
+    SerializeSparsePushData(
+        table_id, kvs.data(), value_ptr.data(), kv_size, push_request);
     PsService_Stub rpc_stub(GetSparseChannel(shard_idx));
     closure->cntl(shard_idx)->set_request_compress_type(
         (brpc::CompressType)FLAGS_pserver_communicate_compress_type);
@@ -1168,11 +1207,18 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
   auto *accessor = GetTableAccessor(table_id);
 
   size_t value_size = accessor->GetAccessorInfo().select_size;
+  size_t value_dim = accessor->GetAccessorInfo().select_dim;
+  auto compress_itr = _sparse_rpc_compress_map.find(table_id);
+  bool compress = compress_itr != _sparse_rpc_compress_map.end();
+  uint32_t fp32_dim = compress ? compress_itr->second.pull_fp32_dim : 0;
 
   DownpourBrpcClosure *closure = new DownpourBrpcClosure(
-      request_call_num, [shard_sorted_kvs, value_size](void *done) {
+      request_call_num,
+      [shard_sorted_kvs, value_size, value_dim, compress, fp32_dim](
+          void *done) {
         int ret = 0;
         auto *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
+        size_t value_bytes = SparseValueBytes(value_dim, fp32_dim);
         for (size_t i = 0; i < shard_sorted_kvs->size(); ++i) {
           if (closure->check_response(i, PS_PULL_SPARSE_TABLE) != 0) {
             ret = -1;
@@ -1184,12 +1230,30 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
           butil::IOBufBytesIterator io_buffer_itr(res_io_buffer);
           uint64_t last_key = UINT64_MAX;
           float *last_value_data = NULL;
+          std::string res_data;
+          if (compress) {
+            res_io_buffer.copy_to(&res_data);
+          }
+          size_t res_offset = 0;
 
           for (auto &kv_pair : request_kvs) {
             if (kv_pair.first == last_key) {
               memcpy(reinterpret_cast<void *>(kv_pair.second),
                      reinterpret_cast<void *>(last_value_data),
                      value_size);
+            } else if (compress) {
+              last_key = kv_pair.first;
+              last_value_data = kv_pair.second;
+              if (res_offset + value_bytes > res_data.size()) {
+                LOG(WARNING) << "res data is lack or not in format";
+                ret = -1;
+                break;
+              }
+              DecodeSparseValue(res_data.data() + res_offset,
+                                value_dim,
+                                fp32_dim,
+                                last_value_data);
+              res_offset += value_bytes;
             } else {
               last_key = kv_pair.first;
               last_value_data = kv_pair.second;
@@ -1227,13 +1291,18 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
     request_buffer.append(reinterpret_cast<void *>(&is_training), sizeof(bool));
     std::vector<uint32_t> keys_counter;
     keys_counter.reserve(sorted_kv_size);
+    std::vector<uint64_t> unique_keys;
 
     for (size_t kv_idx = 0; kv_idx < sorted_kv_size; ++kv_idx) {
       ++kv_request_count;
       uint32_t keys = 1;
       last_key = sorted_kvs[kv_idx].first;
-      request_buffer.append(reinterpret_cast<void *>(&last_key),
-                            sizeof(uint64_t));
+      if (compress) {
+        unique_keys.push_back(last_key);
+      } else {
+        request_buffer.append(reinterpret_cast<void *>(&last_key),
+                              sizeof(uint64_t));
+      }
       while (kv_idx < sorted_kv_size - 1 &&
              last_key == sorted_kvs[kv_idx + 1].first) {
         ++kv_idx;
@@ -1242,8 +1311,21 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
       keys_counter.push_back(keys);
     }
 
-    request_buffer.append(reinterpret_cast<void *>(keys_counter.data()),
-                          sizeof(uint32_t) * keys_counter.size());
+    if (compress) {
+      /*
+      Compressed Pull Content:
+      |---isTraining---|---keysData(varint)---|---Frequencies(varint)---|
+      */
+      std::string compressed_data;
+      EncodeSparseKeys(
+          unique_keys.data(), unique_keys.size(), &compressed_data);
+      EncodeSparseCounts(
+          keys_counter.data(), keys_counter.size(), &compressed_data);
+      request_buffer.append(compressed_data);
+    } else {
+      request_buffer.append(reinterpret_cast<void *>(keys_counter.data()),
+                            sizeof(uint32_t) * keys_counter.size());
+    }
 
     if (kv_request_count == 0) {
       closure->Run();
@@ -1253,6 +1335,10 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
       closure->request(i)->set_client_id(_client_id);
       closure->request(i)->add_params((char *)&kv_request_count,  // NOLINT
                                       sizeof(uint32_t));
+      if (compress) {
+        closure->request(i)->add_params(
+            reinterpret_cast<const char *>(&fp32_dim), sizeof(uint32_t));
+      }
       PsService_Stub rpc_stub(GetCmdChannel(i));
       closure->cntl(i)->set_log_id(butil::gettimeofday_ms());
       rpc_stub.service(
@@ -1410,8 +1496,6 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradientPartial(
     uint32_t num,
     void *done,
     int pserver_idx) {
-  auto *accessor = GetTableAccessor(table_id);
-  size_t value_size = accessor->GetAccessorInfo().update_size;
   DownpourBrpcClosure *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
   auto promise = std::make_shared<std::promise<int32_t>>();
   closure->add_promise(promise);
@@ -1423,15 +1507,7 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradientPartial(
   push_request->set_table_id(table_id);
   push_request->set_client_id(_client_id);
   push_request->add_params((char *)&num, sizeof(uint32_t));  // NOLINT
-  auto *push_data = push_request->mutable_data();
-  push_data->resize(num * (sizeof(uint64_t) + value_size));
-  char *push_data_ptr = const_cast<char *>(push_data->data());
-  memcpy(push_data_ptr, keys, num * sizeof(uint64_t));
-  push_data_ptr += num * sizeof(uint64_t);
-  for (uint32_t i = 0; i < num; ++i) {
-    memcpy(push_data_ptr, update_values[i], value_size);
-    push_data_ptr += value_size;
-  }
+  SerializeSparsePushData(table_id, keys, update_values, num, push_request);
   PsService_Stub rpc_stub(GetSparseChannel(pserver_idx));
   closure->cntl(0)->set_request_compress_type(
       (brpc::CompressType)FLAGS_pserver_communicate_compress_type);
@@ -1857,22 +1933,16 @@ int BrpcPsClient::PushSparseAsyncShardPush(
   push_request->set_client_id(_client_id);
   push_request->add_params(reinterpret_cast<char *>(&merged_kv_count),
                            sizeof(uint32_t));  // NOLINT
-  auto *push_data = push_request->mutable_data();
-  int update_size = accessor->GetAccessorInfo().update_size;
-  push_data->resize(merged_kv_count * (sizeof(uint64_t) + update_size));
-  char *push_data_ptr = const_cast<char *>(push_data->data());
-  memcpy(push_data_ptr,
-         merged_key_list.data(),
-         merged_kv_count * sizeof(uint64_t));
-  push_data_ptr += merged_kv_count * sizeof(uint64_t);
+  std::vector<const float *> merged_value_ptrs(merged_kv_count);
   for (size_t i = 0; i < merged_kv_count; ++i) {
-    const char *task_data_ptr = merged_value_list[i].data();
-
-    memcpy(push_data_ptr,
-           (float *)(task_data_ptr),  // NOLINT
-           update_size);
-    push_data_ptr += update_size;
+    merged_value_ptrs[i] =
+        reinterpret_cast<const float *>(merged_value_list[i].data());
   }
+  SerializeSparsePushData(table_id,
+                          merged_key_list.data(),
+                          merged_value_ptrs.data(),
+                          merged_kv_count,
+                          push_request);
   PsService_Stub rpc_stub(GetSparseChannel(shard_idx));
   closure->cntl(shard_idx)->set_request_compress_type(
       (brpc::CompressType)FLAGS_pserver_communicate_compress_type);
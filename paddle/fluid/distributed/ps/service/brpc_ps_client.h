@@ -367,6 +367,22 @@ class BrpcPsClient : public PSClient {
       _push_sparse_task_queue_map;
   std::unordered_map<uint32_t, uint32_t> _push_sparse_merge_count_map;
 
+  // the fp32_dim of the pull and push values of the tables with
+  // sparse_rpc_compress, see sparse_rpc_codec.h
+  struct SparseRpcCompressParam {
+    uint32_t pull_fp32_dim;
+    uint32_t push_fp32_dim;
+  };
+  std::unordered_map<uint32_t, SparseRpcCompressParam> _sparse_rpc_compress_map;
+
+  // Fill the keys and values of a sparse push request, whose params(0) is set
+  // by the caller.
+  void SerializeSparsePushData(size_t table_id,
+                               const uint64_t *keys,
+                               const float *const *values,
+                               uint32_t num,
+                               PsRequestMessage *request);
+
   std::thread _print_thread;
 
   int PushSparseAsyncShardMerge(
@@ -18,6 +18,7 @@
 
 #include "butil/object_pool.h"
 #include "paddle/fluid/distributed/common/cost_timer.h"
+#include "paddle/fluid/distributed/ps/service/sparse_rpc_codec.h"
 #include "paddle/fluid/distributed/ps/table/depends/sparse_utils.h"
 #include "paddle/fluid/distributed/ps/table/table.h"
 #include "paddle/fluid/framework/archive.h"
@@ -535,7 +536,38 @@ int32_t BrpcPsService::PullSparse(Table *table,
 
   auto value = PullSparseValue(num, dim);
 
-  value.DeserializeFromBytes(const_cast<void *>(data));
+  // params(1) is the fp32_dim of a compressed request, see sparse_rpc_codec.h
+  bool compress = request.params_size() > 1;
+  if (compress && request.params(1).size() != sizeof(uint32_t)) {
+    set_response_code(response,
+                      -1,
+                      "PsRequestMessage.params(1) should be the uint32 "
+                      "fp32_dim of a compressed request");
+    return 0;
+  }
+  uint32_t fp32_dim = 0;
+  if (compress) {
+    fp32_dim = *(reinterpret_cast<const uint32_t *>(request.params(1).c_str()));
+    thread_local std::vector<uint64_t> keys;
+    thread_local std::vector<uint32_t> frequencies;
+    keys.resize(num);
+    frequencies.resize(num);
+    const char *begin = reinterpret_cast<const char *>(data);
+    const char *end = begin + req_buffer_size;
+    value.is_training_ = *(reinterpret_cast<const bool *>(begin));
+    begin = DecodeSparseKeys(begin + sizeof(bool), end, num, keys.data());
+    if (begin != nullptr) {
+      begin = DecodeSparseCounts(begin, end, num, frequencies.data());
+    }
+    if (begin == nullptr) {
+      set_response_code(response, -1, "compressed pull sparse data is broken");
+      return 0;
+    }
+    value.feasigns_ = keys.data();
+    value.frequencies_ = frequencies.data();
+  } else {
+    value.DeserializeFromBytes(const_cast<void *>(data));
+  }
 
   auto res_data = butil::get_object<std::vector<float>>();
   res_data->resize(num * dim);
@@ -546,8 +578,21 @@ int32_t BrpcPsService::PullSparse(Table *table,
   table->Pull(table_context);
   // table->PullSparse(res_data->data(), value);
 
-  cntl->response_attachment().append(reinterpret_cast<char *>(res_data->data()),
-                                     res_data->size() * sizeof(float));
+  if (compress) {
+    size_t value_bytes = SparseValueBytes(dim, fp32_dim);
+    thread_local std::string res_buffer;
+    res_buffer.resize(num * value_bytes);
+    char *res_ptr = const_cast<char *>(res_buffer.data());
+    for (uint32_t i = 0; i < num; ++i) {
+      EncodeSparseValue(res_data->data() + i * dim, dim, fp32_dim, res_ptr);
+      res_ptr += value_bytes;
+    }
+    cntl->response_attachment().append(res_buffer);
+  } else {
+    cntl->response_attachment().append(
+        reinterpret_cast<char *>(res_data->data()),
+        res_data->size() * sizeof(float));
+  }
   butil::return_object(res_data);
   return 0;
 }
@@ -585,6 +630,38 @@ int32_t BrpcPsService::PushSparse(Table *table,
   table_context.push_context.values =
       (const float *)(push_data.data() + sizeof(uint64_t) * num);
   table_context.num = num;
+  // params(1) is the fp32_dim of a compressed request, see sparse_rpc_codec.h
+  if (request.params_size() > 1) {
+    if (request.params(1).size() != sizeof(uint32_t)) {
+      set_response_code(response,
+                        -1,
+                        "PsRequestMessage.params(1) should be the uint32 "
+                        "fp32_dim of a compressed request");
+      return 0;
+    }
+    const uint32_t fp32_dim =
+        *(reinterpret_cast<const uint32_t *>(request.params(1).c_str()));
+    size_t dim = table->GetValueAccessor()->GetAccessorInfo().update_dim;
+    size_t value_bytes = SparseValueBytes(dim, fp32_dim);
+    thread_local std::vector<uint64_t> keys;
+    thread_local std::vector<float> values;
+    keys.resize(num);
+    values.resize(num * dim);
+    const char *begin = push_data.data();
+    const char *end = begin + push_data.size();
+    begin = DecodeSparseKeys(begin, end, num, keys.data());
+    if (begin == nullptr ||
+        static_cast<size_t>(end - begin) != num * value_bytes) {
+      set_response_code(response, -1, "compressed push sparse data is broken");
+      return 0;
+    }
+    for (uint32_t i = 0; i < num; ++i) {
+      DecodeSparseValue(begin, dim, fp32_dim, values.data() + i * dim);
+      begin += value_bytes;
+    }
+    table_context.push_context.keys = keys.data();
+    table_context.push_context.values = values.data();
+  }
   // const uint64_t *keys = (const uint64_t *)push_data.data();
   // const float *values = (const float *)(push_data.data() + sizeof(uint64_t) *
   // num);
@@ -506,6 +506,10 @@ void AsyncCommunicator::SendByCommunicator() {
 
     auto send_recv_task = [this, &ctx] {
       auto &varnames = ctx.origin_varnames;
+      if (send_varname_to_buffer_.count(varnames[0]) > 0) {
+        SendSparseGradBuffer(ctx);
+        return;
+      }
       auto &table_id = ctx.table_id;
       size_t var_nums = varnames.size();
       auto &check_queue = send_varname_to_queue_[varnames[0]];
@@ -572,6 +576,30 @@ void AsyncCommunicator::SendByCommunicator() {
   return;
 }
 
+void AsyncCommunicator::SendSparseGradBuffer(const CommContext &ctx) {
+  auto &var_name = ctx.origin_varnames[0];
+  auto &buffer = send_varname_to_buffer_.at(var_name);
+  // wait for a window of batches like SendByCommunicator
+  int batch_num = buffer->BatchNum();
+  int wait_times = 0;
+  while (batch_num < max_merge_var_num_ && wait_times < send_wait_times_) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    int num = buffer->BatchNum();
+    wait_times = num > batch_num ? 0 : wait_times + 1;
+    batch_num = num;
+  }
+  auto *slr = send_scope_->Var(var_name)->GetMutable<phi::SelectedRows>();
+  if (buffer->Take(slr) == 0) {
+    return;
+  }
+  VLOG(3) << "send " << var_name << " merged " << slr->rows().size()
+          << " ids of " << batch_num << " batches";
+  RpcSendSparse(var_name, ctx.table_id, *send_scope_);
+  if (independent_recv_) {
+    grad_num_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
 void AsyncCommunicator::PushDensePostProcessing() {
   if (independent_recv_) {
     grad_num_.fetch_add(1, std::memory_order_relaxed);
@@ -851,6 +879,12 @@ void AsyncCommunicator::InitImpl(const RpcCtxMap &send_varname_to_ctx,
   for (auto &iter : send_varname_to_ctx_) {
     auto &ctx = iter.second;
     auto &varnames = ctx.origin_varnames;
+    if (MergeSparseGradOnSend() && ctx.is_sparse && !ctx.is_tensor_table) {
+      // a window of max_merge_var_num_ batches can be merged while the
+      // last one is sent
+      send_varname_to_buffer_[varnames[0]] = std::make_shared<SparseGradBuffer>(
+          std::max(send_queue_size_, max_merge_var_num_));
+    }
     for (auto &var_name : varnames) {
       send_varname_to_queue_[var_name] =
           std::make_shared<BlockingQueue<std::shared_ptr<Variable>>>(
@@ -943,6 +977,11 @@ void AsyncCommunicator::Send(const std::vector<std::string> &var_names,
   waiting_ = false;
   for (const auto &var_name : var_names) {
     auto *var = scope.FindVar(var_name);
+    auto buffer = send_varname_to_buffer_.find(var_name);
+    if (buffer != send_varname_to_buffer_.end()) {
+      buffer->second->Add(var->Get<phi::SelectedRows>());
+      continue;
+    }
     auto tmp_grad_var = std::make_shared<Variable>();
     framework::CopyVariable(*var, tmp_grad_var.get());
     send_varname_to_queue_[var_name]->Push(tmp_grad_var);
@@ -17,10 +17,14 @@ limitations under the License. */
 #include <ThreadPool.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstring>
 #include <deque>
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <numeric>
 #include <set>
 #include <string>
@@ -33,6 +37,7 @@ limitations under the License. */
 #include "paddle/fluid/distributed/ps/service/communicator/communicator_common.h"
 #include "paddle/fluid/distributed/ps/service/coordinator_client.h"
 #include "paddle/fluid/distributed/ps/service/ps_client.h"
+#include "paddle/fluid/distributed/ps/thirdparty/round_robin.h"
 #include "paddle/fluid/framework/channel.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/framework/variable.h"
@@ -53,6 +58,7 @@ struct CommContext;
 }  // namespace paddle
 
 COMMON_DECLARE_bool(communicator_is_sgd_optimizer);
+COMMON_DECLARE_bool(communicator_merge_sparse_grad_on_send);
 
 namespace paddle {
 namespace distributed {
@@ -226,6 +232,99 @@ inline void MergeVars(const std::string &var_name,
   }
 }
 
+// SparseGradBuffer sums the sparse gradients of the batches in a send window
+// as they are sent, so that an id is pushed once a window however many
+// batches it appears in, and the batches are not copied into a queue.
+class SparseGradBuffer {
+ public:
+  // At most `capacity` batches are buffered, Add blocks until the buffer is
+  // taken when it is full.
+  explicit SparseGradBuffer(int capacity) : capacity_(capacity) {
+    PADDLE_ENFORCE_GT(capacity_,
+                      0,
+                      common::errors::InvalidArgument(
+                          "The capacity must be greater than 0."));
+  }
+
+  // Add the gradients of a batch, and return the number of batches buffered.
+  int Add(const phi::SelectedRows &slr) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    full_cond_.wait(lock, [this] { return batch_num_ < capacity_; });
+    height_ = slr.height();
+    auto &rows = slr.rows();
+    if (!rows.empty()) {
+      int64_t dim = slr.value().dims()[1];
+      if (dim_ == 0) {
+        dim_ = dim;
+      }
+      PADDLE_ENFORCE_EQ(dim,
+                        dim_,
+                        common::errors::InvalidArgument(
+                            "The width of the sparse gradient changes from %d "
+                            "to %d.",
+                            dim_,
+                            dim));
+      const float *data = slr.value().data<float>();
+      phi::CPUContext cpu_ctx;
+      auto blas = phi::funcs::GetBlas<phi::CPUContext, float>(cpu_ctx);
+      for (size_t i = 0; i < rows.size(); ++i) {
+        const float *grad = data + i * dim_;
+        auto res = index_.emplace(rows[i], rows_.size());
+        if (res.second) {
+          rows_.push_back(rows[i]);
+          values_.insert(values_.end(), grad, grad + dim_);
+        } else {
+          float *merged = values_.data() + res.first->second * dim_;
+          blas.VADD(dim_, merged, grad, merged);
+        }
+      }
+    }
+    return ++batch_num_;
+  }
+
+  // Move the merged gradients into `slr` and clear the buffer, return the
+  // number of batches merged.
+  int Take(phi::SelectedRows *slr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int batch_num = batch_num_;
+    if (batch_num == 0) {
+      return 0;
+    }
+    auto *tensor = slr->mutable_value();
+    tensor->Resize(common::make_ddim(
+        {static_cast<int64_t>(rows_.size()), std::max<int64_t>(dim_, 1)}));
+    float *data = tensor->mutable_data<float>(phi::CPUPlace());
+    if (!values_.empty()) {
+      memcpy(data, values_.data(), values_.size() * sizeof(float));
+    }
+    slr->set_height(height_);
+    slr->mutable_rows()->swap(rows_);
+    rows_.clear();
+    values_.clear();
+    index_.clear();
+    batch_num_ = 0;
+    full_cond_.notify_all();
+    return batch_num;
+  }
+
+  int BatchNum() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batch_num_;
+  }
+
+ private:
+  const int capacity_;
+  int batch_num_ = 0;
+  int64_t dim_ = 0;
+  int64_t height_ = 0;
+  // id -> the row of the id in rows_ and values_
+  robin_hood::unordered_flat_map<int64_t, size_t> index_;
+  std::vector<int64_t> rows_;
+  std::vector<float> values_;
+  std::mutex mutex_;
+  std::condition_variable full_cond_;
+};
+
 using RpcCtxMap = std::unordered_map<std::string, CommContext>;
 using RecvCtxMap = std::unordered_map<uint64_t, std::vector<std::string>>;
 using SparseValue = std::unordered_map<int64_t, std::vector<float>>;
@@ -465,6 +564,14 @@ class AsyncCommunicator : public Communicator {
 
   virtual void RecvByCommunicator();
 
+  // Whether the sparse gradients are merged by SparseGradBuffer in Send,
+  // instead of being queued and merged by SendByCommunicator.
+  virtual bool MergeSparseGradOnSend() {
+    return FLAGS_communicator_merge_sparse_grad_on_send;
+  }
+
+  void SendSparseGradBuffer(const CommContext &ctx);
+
   virtual void RecvNoBarrier();
 
   virtual int BatchesCounter() { return 1; }
@@ -499,6 +606,8 @@ class AsyncCommunicator : public Communicator {
   std::unordered_map<std::string,
                      std::shared_ptr<BlockingQueue<std::shared_ptr<Variable>>>>
       send_varname_to_queue_;
+  std::unordered_map<std::string, std::shared_ptr<SparseGradBuffer>>
+      send_varname_to_buffer_;
   std::unique_ptr<::ThreadPool> send_threadpool_{nullptr};
 
   int min_send_grad_num_before_recv_;
@@ -543,6 +652,9 @@ class HalfAsyncCommunicator : public AsyncCommunicator {
 
   void SendByCommunicator() override;
 
+  // the batches are counted by the barriers from the queues
+  bool MergeSparseGradOnSend() override { return false; }
+
   void Clean() override;
 
   void Barrier() override;
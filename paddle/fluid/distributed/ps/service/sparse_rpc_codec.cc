@@ -0,0 +1,178 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/service/sparse_rpc_codec.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace paddle::distributed {
+
+namespace {
+
+inline void AppendVarint(uint64_t v, std::string* out) {
+  char buf[10];
+  size_t len = 0;
+  while (v >= 0x80) {
+    buf[len++] = static_cast<char>(v | 0x80);
+    v >>= 7;
+  }
+  buf[len++] = static_cast<char>(v);
+  out->append(buf, len);
+}
+
+inline const char* ReadVarint(const char* p, const char* end, uint64_t* v) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64 && p < end; shift += 7) {
+    uint64_t byte = static_cast<uint8_t>(*p++);
+    result |= (byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      *v = result;
+      return p;
+    }
+  }
+  return nullptr;
+}
+
+// Round to the nearest fp16, ties to even.
+inline uint16_t FloatToHalf(float value) {
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(float));
+  uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+  bits &= 0x7fffffff;
+  if (bits >= 0x7f800000) {
+    // inf or nan
+    return sign | 0x7c00 | (bits > 0x7f800000 ? 0x200 : 0);
+  }
+  if (bits >= 0x477ff000) {
+    // rounds to 65536 or more
+    return sign | 0x7c00;
+  }
+  if (bits < 0x38800000) {
+    // subnormal fp16 in the unit of 2^-24, which is exact in float
+    float abs_value = 0;
+    memcpy(&abs_value, &bits, sizeof(float));
+    return sign |
+           static_cast<uint16_t>(std::nearbyint(abs_value * 16777216.0f));
+  }
+  // rebias the exponent from 127 to 15, a carry of the mantissa goes into the
+  // exponent
+  bits += 0xfff + ((bits >> 13) & 1);
+  return sign | static_cast<uint16_t>((bits - (112u << 23)) >> 13);
+}
+
+inline float HalfToFloat(uint16_t half) {
+  uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+  uint32_t exponent = (half >> 10) & 0x1f;
+  uint32_t mantissa = half & 0x3ff;
+  uint32_t bits = 0;
+  if (exponent == 0) {
+    float abs_value = mantissa / 16777216.0f;
+    memcpy(&bits, &abs_value, sizeof(float));
+    bits |= sign;
+  } else if (exponent == 0x1f) {
+    bits = sign | 0x7f800000 | (mantissa << 13);
+  } else {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  }
+  float value = 0;
+  memcpy(&value, &bits, sizeof(float));
+  return value;
+}
+
+}  // namespace
+
+void EncodeSparseKeys(const uint64_t* keys, size_t num, std::string* out) {
+  uint64_t last_key = 0;
+  for (size_t i = 0; i < num; ++i) {
+    int64_t delta = static_cast<int64_t>(keys[i] - last_key);
+    AppendVarint((static_cast<uint64_t>(delta) << 1) ^
+                     static_cast<uint64_t>(delta >> 63),
+                 out);
+    last_key = keys[i];
+  }
+}
+
+const char* DecodeSparseKeys(const char* begin,
+                             const char* end,
+                             size_t num,
+                             uint64_t* keys) {
+  uint64_t last_key = 0;
+  for (size_t i = 0; i < num; ++i) {
+    uint64_t zigzag = 0;
+    begin = ReadVarint(begin, end, &zigzag);
+    if (begin == nullptr) {
+      return nullptr;
+    }
+    last_key += (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+    keys[i] = last_key;
+  }
+  return begin;
+}
+
+void EncodeSparseCounts(const uint32_t* counts, size_t num, std::string* out) {
+  for (size_t i = 0; i < num; ++i) {
+    AppendVarint(counts[i], out);
+  }
+}
+
+const char* DecodeSparseCounts(const char* begin,
+                               const char* end,
+                               size_t num,
+                               uint32_t* counts) {
+  for (size_t i = 0; i < num; ++i) {
+    uint64_t count = 0;
+    begin = ReadVarint(begin, end, &count);
+    if (begin == nullptr || count > UINT32_MAX) {
+      return nullptr;
+    }
+    counts[i] = static_cast<uint32_t>(count);
+  }
+  return begin;
+}
+
+void EncodeSparseValue(const float* value,
+                       size_t dim,
+                       size_t fp32_dim,
+                       char* out) {
+  if (fp32_dim > dim) {
+    fp32_dim = dim;
+  }
+  memcpy(out, value, fp32_dim * sizeof(float));
+  out += fp32_dim * sizeof(float);
+  for (size_t i = fp32_dim; i < dim; ++i) {
+    uint16_t half = FloatToHalf(value[i]);
+    memcpy(out, &half, sizeof(uint16_t));
+    out += sizeof(uint16_t);
+  }
+}
+
+void DecodeSparseValue(const char* data,
+                       size_t dim,
+                       size_t fp32_dim,
+                       float* value) {
+  if (fp32_dim > dim) {
+    fp32_dim = dim;
+  }
+  memcpy(value, data, fp32_dim * sizeof(float));
+  data += fp32_dim * sizeof(float);
+  for (size_t i = fp32_dim; i < dim; ++i) {
+    uint16_t half = 0;
+    memcpy(&half, data, sizeof(uint16_t));
+    value[i] = HalfToFloat(half);
+    data += sizeof(uint16_t);
+  }
+}
+
+}  // namespace paddle::distributed
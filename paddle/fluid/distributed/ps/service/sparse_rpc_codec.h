@@ -0,0 +1,79 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+namespace paddle {
+namespace distributed {
+
+// The compressed encoding of the sparse pull and push rpc of the tables with
+// TableParameter.sparse_rpc_compress:
+//
+// Pull request:  |---isTraining---|---keys---|---counts---|
+// Pull response: |---values---|
+// Push request:  |---keys---|---values---|
+//
+// The keys are the zigzag varints of the difference to the previous key,
+// which take 1~3 bytes for the sorted keys of a shard instead of 8, and the
+// counts are varints. The first `fp32_dim` floats of each value are kept in
+// fp32, such as show and click which may be out of the range or precision of
+// fp16, and the others are rounded to the nearest fp16.
+//
+// A compressed request carries the fp32_dim of its values in params(1), so
+// the server does not rely on its own config to decode it, and replies with
+// the same fp32_dim.
+
+// Append the encoded `num` keys to `out`.
+void EncodeSparseKeys(const uint64_t* keys, size_t num, std::string* out);
+
+// Decode `num` keys from [begin, end), return the end of the decoded bytes, or
+// nullptr if the data is truncated or malformed.
+const char* DecodeSparseKeys(const char* begin,
+                             const char* end,
+                             size_t num,
+                             uint64_t* keys);
+
+void EncodeSparseCounts(const uint32_t* counts, size_t num, std::string* out);
+
+const char* DecodeSparseCounts(const char* begin,
+                               const char* end,
+                               size_t num,
+                               uint32_t* counts);
+
+// The bytes of an encoded value of `dim` floats.
+inline size_t SparseValueBytes(size_t dim, size_t fp32_dim) {
+  if (fp32_dim > dim) {
+    fp32_dim = dim;
+  }
+  return fp32_dim * sizeof(float) + (dim - fp32_dim) * sizeof(uint16_t);
+}
+
+// Encode a value of `dim` floats into the SparseValueBytes(dim, fp32_dim)
+// bytes of `out`, and decode it back.
+void EncodeSparseValue(const float* value,
+                       size_t dim,
+                       size_t fp32_dim,
+                       char* out);
+void DecodeSparseValue(const char* data,
+                       size_t dim,
+                       size_t fp32_dim,
+                       float* value);
+
+}  // namespace distributed
+}  // namespace paddle
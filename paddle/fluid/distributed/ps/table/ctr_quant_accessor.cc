@@ -0,0 +1,316 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/ctr_quant_accessor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include "glog/logging.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/utils/string/string_helper.h"
+
+namespace paddle::distributed {
+
+namespace {
+
+uint16_t FloatToBF16(float value, uint32_t round_bits) {
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  return static_cast<uint16_t>((bits + round_bits) >> 16);
+}
+
+// Round `value` to the nearest fp16, or stochastically to one of the two
+// nearest with the probability of its distance to the other one. The float16
+// conversion may truncate without F16C, so the neighbour is checked here.
+uint16_t FloatToFP16(float value, bool stochastic) {
+  phi::dtype::float16 result(value);
+  float result_value = static_cast<float>(result);
+  if (result_value == value || !std::isfinite(result_value)) {
+    return result.x;
+  }
+  // fp16 is sign-magnitude, so the next bits are larger in magnitude
+  phi::dtype::float16 other;
+  other.x = std::fabs(result_value) > std::fabs(value) ? result.x - 1
+                                                       : result.x + 1;
+  float other_value = static_cast<float>(other);
+  float prob = (value - result_value) / (other_value - result_value);
+  if (stochastic) {
+    prob -= local_uniform_real_distribution<float>()(local_random_engine());
+  } else {
+    prob -= 0.5f;
+  }
+  return prob > 0 ? other.x : result.x;
+}
+
+float BF16ToFloat(uint16_t value) {
+  uint32_t bits = static_cast<uint32_t>(value) << 16;
+  float result = 0;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+}  // namespace
+
+int CtrQuantAccessor::Initialize() {
+  CtrCommonAccessor::Initialize();
+  auto quant_type = _config.ctr_accessor_param().embedx_quant_type();
+  if (quant_type == "fp16") {
+    quant_feature_value.quant_type = QuantType::kFP16;
+  } else if (quant_type == "bf16") {
+    quant_feature_value.quant_type = QuantType::kBF16;
+  } else if (quant_type == "int8") {
+    quant_feature_value.quant_type = QuantType::kINT8;
+  } else {
+    PADDLE_THROW(common::errors::InvalidArgument(
+        "Unknown embedx_quant_type %s of CtrQuantAccessor, which should be "
+        "fp16, bf16 or int8.",
+        quant_type));
+  }
+  quant_feature_value.embed_sgd_dim = _embed_sgd_rule->Dim();
+  quant_feature_value.embedx_dim = _config.embedx_dim();
+  quant_feature_value.embedx_sgd_dim = _embedx_sgd_rule->Dim();
+  InitAccessorInfo();
+  return 0;
+}
+
+void CtrQuantAccessor::InitAccessorInfo() {
+  CtrCommonAccessor::InitAccessorInfo();
+  _accessor_info.dim = quant_feature_value.Dim();
+  _accessor_info.size = quant_feature_value.Size();
+  _accessor_info.mf_size =
+      (quant_feature_value.embedx_sgd_dim + quant_feature_value.EmbedxWDim()) *
+      sizeof(float);
+}
+
+bool CtrQuantAccessor::HasMF(int size) {
+  return size > quant_feature_value.EmbedxG2SumIndex();
+}
+
+void CtrQuantAccessor::QuantizeEmbedxW(const float* embedx_w,
+                                       float* value,
+                                       bool stochastic) {
+  int embedx_dim = quant_feature_value.embedx_dim;
+  float* data = value + quant_feature_value.EmbedxWIndex();
+  if (embedx_dim == 0) {
+    return;
+  }
+  // zero the padding, so that the saved bytes are deterministic
+  data[quant_feature_value.EmbedxWDim() - 1] = 0;
+  switch (quant_feature_value.quant_type) {
+    case QuantType::kFP16: {
+      auto* half = reinterpret_cast<uint16_t*>(data);
+      for (int i = 0; i < embedx_dim; ++i) {
+        half[i] = FloatToFP16(embedx_w[i], stochastic);
+      }
+      return;
+    }
+    case QuantType::kBF16: {
+      auto* half = reinterpret_cast<uint16_t*>(data);
+      for (int i = 0; i < embedx_dim; ++i) {
+        uint32_t round_bits =
+            stochastic ? local_random_engine()() & 0xFFFF : 0x8000;
+        half[i] = FloatToBF16(embedx_w[i], round_bits);
+      }
+      return;
+    }
+    case QuantType::kINT8: {
+      float max_abs = 0;
+      for (int i = 0; i < embedx_dim; ++i) {
+        max_abs = std::max(max_abs, std::fabs(embedx_w[i]));
+      }
+      float scale = max_abs / 127;
+      data[0] = scale;
+      auto* quant = reinterpret_cast<int8_t*>(data + 1);
+      for (int i = 0; i < embedx_dim; ++i) {
+        if (scale == 0) {
+          quant[i] = 0;
+          continue;
+        }
+        float offset = stochastic ? local_uniform_real_distribution<float>()(
+                                        local_random_engine())
+                                  : 0.5f;
+        float q = std::floor(embedx_w[i] / scale + offset);
+        quant[i] = static_cast<int8_t>(std::min(127.0f, std::max(-127.0f, q)));
+      }
+      return;
+    }
+  }
+}
+
+void CtrQuantAccessor::DequantizeEmbedxW(const float* value, float* embedx_w) {
+  int embedx_dim = quant_feature_value.embedx_dim;
+  const float* data = value + quant_feature_value.EmbedxWIndex();
+  switch (quant_feature_value.quant_type) {
+    case QuantType::kFP16: {
+      auto* half = reinterpret_cast<const uint16_t*>(data);
+      phi::dtype::float16 fp16;
+      for (int i = 0; i < embedx_dim; ++i) {
+        fp16.x = half[i];
+        embedx_w[i] = static_cast<float>(fp16);
+      }
+      return;
+    }
+    case QuantType::kBF16: {
+      auto* half = reinterpret_cast<const uint16_t*>(data);
+      for (int i = 0; i < embedx_dim; ++i) {
+        embedx_w[i] = BF16ToFloat(half[i]);
+      }
+      return;
+    }
+    case QuantType::kINT8: {
+      float scale = data[0];
+      auto* quant = reinterpret_cast<const int8_t*>(data + 1);
+      for (int i = 0; i < embedx_dim; ++i) {
+        embedx_w[i] = quant[i] * scale;
+      }
+      return;
+    }
+  }
+}
+
+int32_t CtrQuantAccessor::Create(float** values, size_t num) {
+  float embedx_w[quant_feature_value.embedx_dim];  // NOLINT
+  for (size_t value_item = 0; value_item < num; ++value_item) {
+    float* value = values[value_item];
+    value[common_feature_value.UnseenDaysIndex()] = 0;
+    value[common_feature_value.DeltaScoreIndex()] = 0;
+    value[common_feature_value.ShowIndex()] = 0;
+    value[common_feature_value.ClickIndex()] = 0;
+    value[common_feature_value.SlotIndex()] = -1;
+    bool zero_init = _config.ctr_accessor_param().zero_init();
+    _embed_sgd_rule->InitValue(value + quant_feature_value.EmbedWIndex(),
+                               value + quant_feature_value.EmbedG2SumIndex(),
+                               zero_init);
+    _embedx_sgd_rule->InitValue(embedx_w,
+                                value + quant_feature_value.EmbedxG2SumIndex(),
+                                false);
+    QuantizeEmbedxW(embedx_w, value, false);
+  }
+  return 0;
+}
+
+// from CtrQuantFeatureValue to CtrCommonPullValue
+int32_t CtrQuantAccessor::Select(float** select_values,
+                                 const float** values,
+                                 size_t num) {
+  for (size_t value_item = 0; value_item < num; ++value_item) {
+    float* select_value = select_values[value_item];
+    const float* value = values[value_item];
+    select_value[CtrCommonPullValue::ShowIndex()] =
+        value[common_feature_value.ShowIndex()];
+    select_value[CtrCommonPullValue::ClickIndex()] =
+        value[common_feature_value.ClickIndex()];
+    select_value[CtrCommonPullValue::EmbedWIndex()] =
+        value[quant_feature_value.EmbedWIndex()];
+    DequantizeEmbedxW(value, select_value + CtrCommonPullValue::EmbedxWIndex());
+  }
+  return 0;
+}
+
+// from CtrCommonPushValue to CtrQuantFeatureValue
+int32_t CtrQuantAccessor::Update(float** update_values,
+                                 const float** push_values,
+                                 size_t num) {
+  float embedx_w[quant_feature_value.embedx_dim];  // NOLINT
+  for (size_t value_item = 0; value_item < num; ++value_item) {
+    float* update_value = update_values[value_item];
+    const float* push_value = push_values[value_item];
+    float push_show = push_value[CtrCommonPushValue::ShowIndex()];
+    float push_click = push_value[CtrCommonPushValue::ClickIndex()];
+    float slot = push_value[CtrCommonPushValue::SlotIndex()];
+    update_value[common_feature_value.ShowIndex()] += push_show;
+    update_value[common_feature_value.ClickIndex()] += push_click;
+    update_value[common_feature_value.SlotIndex()] = slot;
+    update_value[common_feature_value.DeltaScoreIndex()] +=
+        (push_show - push_click) * _config.ctr_accessor_param().nonclk_coeff() +
+        push_click * _config.ctr_accessor_param().click_coeff();
+    update_value[common_feature_value.UnseenDaysIndex()] = 0;
+    if (!_show_scale) {
+      push_show = 1;
+    }
+    _embed_sgd_rule->UpdateValue(
+        update_value + quant_feature_value.EmbedWIndex(),
+        update_value + quant_feature_value.EmbedG2SumIndex(),
+        push_value + CtrCommonPushValue::EmbedGIndex(),
+        push_show);
+    DequantizeEmbedxW(update_value, embedx_w);
+    _embedx_sgd_rule->UpdateValue(
+        embedx_w,
+        update_value + quant_feature_value.EmbedxG2SumIndex(),
+        push_value + CtrCommonPushValue::EmbedxGIndex(),
+        push_show);
+    QuantizeEmbedxW(embedx_w, update_value, true);
+  }
+  return 0;
+}
+
+// The same text as CtrCommonAccessor, with the dequantized embedx_w.
+std::string CtrQuantAccessor::ParseToString(const float* v, int param) {
+  thread_local std::ostringstream os;
+  os.clear();
+  os.str("");
+  os << v[0] << " " << v[1] << " " << v[2] << " " << v[3] << " " << v[4] << " "
+     << v[5];
+  for (int i = quant_feature_value.EmbedG2SumIndex();
+       i < quant_feature_value.EmbedxG2SumIndex();
+       i++) {
+    os << " " << v[i];
+  }
+  auto show = common_feature_value.Show(const_cast<float*>(v));
+  auto click = common_feature_value.Click(const_cast<float*>(v));
+  auto score = ShowClickScore(show, click);
+  if (score >= _config.embedx_threshold() &&
+      param > quant_feature_value.EmbedxG2SumIndex()) {
+    float embedx_w[quant_feature_value.embedx_dim];  // NOLINT
+    DequantizeEmbedxW(v, embedx_w);
+    for (int i = 0; i < quant_feature_value.embedx_dim; ++i) {
+      os << " " << embedx_w[i];
+    }
+    for (int i = quant_feature_value.EmbedxG2SumIndex();
+         i < quant_feature_value.EmbedxWIndex();
+         ++i) {
+      os << " " << v[i];
+    }
+  }
+  return os.str();
+}
+
+int CtrQuantAccessor::ParseFromString(const std::string& str, float* value) {
+  // parse into the layout of CtrCommonAccessor first
+  float data[common_feature_value.Dim()];  // NOLINT
+  _embedx_sgd_rule->InitValue(data + common_feature_value.EmbedxWIndex(),
+                              data + common_feature_value.EmbedxG2SumIndex());
+  int ret = paddle::string::str_to_float(str.data(), data);
+  PADDLE_ENFORCE_GE(
+      ret,
+      6,
+      common::errors::InvalidArgument(
+          "Invalid return value. Expect more than 6. But recieved %d.", ret));
+  int head_dim = quant_feature_value.EmbedxG2SumIndex();
+  memcpy(value, data, head_dim * sizeof(float));
+  if (ret <= head_dim) {
+    return ret;
+  }
+  memcpy(value + quant_feature_value.EmbedxG2SumIndex(),
+         data + common_feature_value.EmbedxG2SumIndex(),
+         quant_feature_value.embedx_sgd_dim * sizeof(float));
+  QuantizeEmbedxW(data + common_feature_value.EmbedxWIndex(), value, false);
+  return quant_feature_value.Dim();
+}
+
+}  // namespace paddle::distributed
@@ -0,0 +1,99 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/distributed/ps/table/ctr_accessor.h"
+
+namespace paddle {
+namespace distributed {
+
+// CtrQuantAccessor is a CtrCommonAccessor which stores embedx_w in fp16, bf16
+// or int8 with a scale of each value, selected by
+// ctr_accessor_param.embedx_quant_type. The values are dequantized on Select
+// and Update, so the pull and push values are the same as CtrCommonAccessor,
+// and so is the text of ParseToString, which means the checkpoints of the two
+// accessors can be loaded by each other.
+//
+// The weights updated by Update are rounded stochastically, otherwise the
+// updates smaller than half of a quantization step would be lost.
+class CtrQuantAccessor : public CtrCommonAccessor {
+ public:
+  enum class QuantType { kFP16, kBF16, kINT8 };
+
+  struct CtrQuantFeatureValue {
+    /*
+       float slot;
+       float unseen_days;
+       float delta_score;
+       float show;
+       float click;
+       float embed_w;
+       std::vector<float> embed_g2sum;
+       std::vector<float> embedx_g2sum;
+       // fp16 or bf16: embedx_dim uint16, padded to floats
+       // int8: float scale and embedx_dim int8, padded to floats
+       quantized embedx_w;
+       */
+
+    int Dim() { return EmbedxWIndex() + EmbedxWDim(); }
+    int Size() { return Dim() * sizeof(float); }
+    int EmbedWIndex() { return 5; }
+    int EmbedG2SumIndex() { return EmbedWIndex() + 1; }
+    int EmbedxG2SumIndex() { return EmbedG2SumIndex() + embed_sgd_dim; }
+    int EmbedxWIndex() { return EmbedxG2SumIndex() + embedx_sgd_dim; }
+    // the floats of the quantized embedx_w
+    int EmbedxWDim() {
+      if (quant_type == QuantType::kINT8) {
+        return 1 + (embedx_dim + 3) / 4;
+      }
+      return (embedx_dim + 1) / 2;
+    }
+
+    int embed_sgd_dim = 0;
+    int embedx_dim = 0;
+    int embedx_sgd_dim = 0;
+    QuantType quant_type = QuantType::kFP16;
+  };
+
+  CtrQuantAccessor() {}
+  virtual ~CtrQuantAccessor() {}
+  int Initialize() override;
+  void InitAccessorInfo() override;
+  bool HasMF(int size) override;
+  int32_t Create(float** value, size_t num) override;
+  int32_t Select(float** select_values,
+                 const float** values,
+                 size_t num) override;
+  int32_t Update(float** values,
+                 const float** update_values,
+                 size_t num) override;
+  std::string ParseToString(const float* value, int param) override;
+  int32_t ParseFromString(const std::string& str, float* v) override;
+
+  // Quantize the embedx_dim floats of `embedx_w` into `value`, and dequantize
+  // them back.
+  void QuantizeEmbedxW(const float* embedx_w, float* value, bool stochastic);
+  void DequantizeEmbedxW(const float* value, float* embedx_w);
+
+  CtrQuantFeatureValue quant_feature_value;
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -14,6 +14,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <utility>
 #include <vector>
 
 #include <mct/hash-map.hpp>
@@ -28,17 +33,257 @@ static const int CTR_SPARSE_SHARD_BUCKET_NUM_BITS = 6;
 static const size_t CTR_SPARSE_SHARD_BUCKET_NUM =
     static_cast<size_t>(1) << CTR_SPARSE_SHARD_BUCKET_NUM_BITS;
 
+// FixedFeatureValue holds the floats of a sparse feature. When it is acquired
+// from a FixedFeatureValueSlab, the floats are stored right after it in the
+// same slot, up to the dim of the slab, and only a larger value is allocated
+// on the heap.
 class FixedFeatureValue {
  public:
   FixedFeatureValue() {}
-  ~FixedFeatureValue() {}
-  float* data() { return _data.data(); }
-  size_t size() { return _data.size(); }
-  void resize(size_t size) { _data.resize(size); }
-  void shrink_to_fit() { _data.shrink_to_fit(); }
+  explicit FixedFeatureValue(uint32_t inline_capacity)
+      : _inline_capacity(inline_capacity) {}
+  FixedFeatureValue(const FixedFeatureValue& other) { *this = other; }
+  FixedFeatureValue& operator=(const FixedFeatureValue& other) {
+    if (this != &other) {
+      resize(other._size);
+      if (_size > 0) {
+        memcpy(_data, other._data, _size * sizeof(float));
+      }
+    }
+    return *this;
+  }
+  ~FixedFeatureValue() {
+    if (on_heap()) {
+      delete[] _data;
+    }
+  }
+  float* data() { return _data; }
+  size_t size() { return _size; }
+  // Like std::vector, the new floats are zero.
+  void resize(size_t size) {
+    if (size == _size) {
+      return;
+    }
+    float* dst = size <= _inline_capacity ? inline_data() : new float[size];
+    if (dst != _data && _size > 0) {
+      memcpy(dst, _data, std::min<size_t>(size, _size) * sizeof(float));
+    }
+    if (size > _size) {
+      memset(dst + _size, 0, (size - _size) * sizeof(float));
+    }
+    if (on_heap() && dst != _data) {
+      delete[] _data;
+    }
+    _data = dst;
+    _size = static_cast<uint32_t>(size);
+  }
+  // The heap storage is always of the exact size.
+  void shrink_to_fit() {}
+
+ private:
+  friend class FixedFeatureValueSlab;
+
+  float* inline_data() { return reinterpret_cast<float*>(this + 1); }
+  bool on_heap() const { return _size > _inline_capacity; }
+
+  float* _data = nullptr;
+  uint32_t _size = 0;
+  uint32_t _inline_capacity = 0;
+};
+
+// FixedFeatureValueSlab allocates the FixedFeatureValues of a shard in large
+// chunks of fixed-stride slots, each holding a value and its `dim` floats,
+// which saves the heap allocation and the pointer chase of every value.
+//
+// Released slots are reused, but the chunks are only freed by Compact, which
+// moves the values out of the sparsest chunks, e.g. after shrinking a table.
+class FixedFeatureValueSlab {
+ public:
+  static constexpr size_t kChunkBytes = 256 * 1024;
+
+  FixedFeatureValueSlab() { set_dim(0); }
+  FixedFeatureValueSlab(const FixedFeatureValueSlab&) = delete;
+  ~FixedFeatureValueSlab() { free_chunks(); }
+
+  // Set the number of floats stored inline, before acquiring any value.
+  void set_dim(size_t dim) {
+    PADDLE_ENFORCE_EQ(
+        _counter,
+        0UL,
+        common::errors::PreconditionNotMet(
+            "The dim of a FixedFeatureValueSlab can only be set when it is "
+            "empty, but %d values are acquired.",
+            _counter));
+    free_chunks();
+    _dim = dim;
+    size_t align = alignof(FixedFeatureValue);
+    _stride = (sizeof(FixedFeatureValue) + dim * sizeof(float) + align - 1) /
+              align * align;
+    _chunk_size = std::max<size_t>(1, kChunkBytes / _stride);
+  }
+  size_t dim() const { return _dim; }
+
+  template <class... ARGS>
+  FixedFeatureValue* acquire(ARGS&&... args) {
+    if (_free_nodes == NULL) {
+      create_new_chunk();
+    }
+    FixedFeatureValue* x = (FixedFeatureValue*)(void*)_free_nodes;  // NOLINT
+    _free_nodes = _free_nodes->next;
+    new (x) FixedFeatureValue(static_cast<uint32_t>(_dim));
+    (x->operator=(std::forward<ARGS>(args)), ...);
+    _counter++;
+    return x;
+  }
+  void release(FixedFeatureValue* x) {
+    x->~FixedFeatureValue();
+    Node* node = (Node*)(void*)x;  // NOLINT
+    node->next = _free_nodes;
+    _free_nodes = node;
+    _counter--;
+  }
+  size_t size() const { return _counter; }
+  size_t capacity() const { return _chunks.size() * _chunk_size; }
+
+  // Move the values into the fullest chunks and free the others, return the
+  // number of chunks freed. `visit_values(relocate)` should replace each
+  // acquired value `v` by `relocate(v)`.
+  template <class VISITOR>
+  size_t Compact(VISITOR&& visit_values) {
+    size_t num_chunks = _chunks.size();
+    size_t num_kept = (_counter + _chunk_size - 1) / _chunk_size;
+    if (num_kept >= num_chunks) {
+      return 0;
+    }
+    std::vector<size_t> sorted(num_chunks);
+    std::iota(sorted.begin(), sorted.end(), 0);
+    std::sort(sorted.begin(), sorted.end(), [this](size_t a, size_t b) {
+      return _chunks[a] < _chunks[b];
+    });
+    auto locate = [&](FixedFeatureValue* x) {
+      char* p = reinterpret_cast<char*>(x);
+      auto it = std::upper_bound(
+          sorted.begin(), sorted.end(), p, [this](char* addr, size_t chunk) {
+            return addr < _chunks[chunk];
+          });
+      size_t chunk = *(it - 1);
+      return std::make_pair(chunk,
+                            static_cast<size_t>(p - _chunks[chunk]) / _stride);
+    };
+
+    std::vector<size_t> live_count(num_chunks, 0);
+    std::vector<bool> live(num_chunks * _chunk_size, false);
+    visit_values([&](FixedFeatureValue* x) {
+      auto [chunk, slot] = locate(x);
+      ++live_count[chunk];
+      live[chunk * _chunk_size + slot] = true;
+      return x;
+    });
+
+    // Keep the fullest chunks, whose free slots are enough for the values in
+    // the others.
+    std::vector<size_t> by_count(num_chunks);
+    std::iota(by_count.begin(), by_count.end(), 0);
+    std::nth_element(by_count.begin(),
+                     by_count.begin() + num_kept,
+                     by_count.end(),
+                     [&](size_t a, size_t b) {
+                       return live_count[a] > live_count[b];
+                     });
+    std::vector<bool> kept(num_chunks, false);
+    _free_nodes = NULL;
+    for (size_t i = 0; i < num_kept; ++i) {
+      size_t chunk = by_count[i];
+      kept[chunk] = true;
+      for (size_t slot = _chunk_size; slot-- > 0;) {
+        if (!live[chunk * _chunk_size + slot]) {
+          char* addr = _chunks[chunk] + slot * _stride;
+          Node* node = (Node*)(void*)addr;  // NOLINT
+          node->next = _free_nodes;
+          _free_nodes = node;
+        }
+      }
+    }
+
+    visit_values([&](FixedFeatureValue* x) {
+      if (kept[locate(x).first]) {
+        return x;
+      }
+      FixedFeatureValue* y = (FixedFeatureValue*)(void*)_free_nodes;  // NOLINT
+      _free_nodes = _free_nodes->next;
+      // The value is relocated bitwise, only the pointer to its inline floats
+      // changes.
+      memcpy(static_cast<void*>(y), static_cast<void*>(x), _stride);
+      if (!y->on_heap()) {
+        y->_data = y->inline_data();
+      }
+      return y;
+    });
+
+    std::vector<char*> chunks;
+    chunks.reserve(num_kept);
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+      if (kept[chunk]) {
+        chunks.push_back(_chunks[chunk]);
+      } else {
+        free(_chunks[chunk]);
+      }
+    }
+    _chunks.swap(chunks);
+    return num_chunks - num_kept;
+  }
 
  private:
-  std::vector<float> _data;
+  struct Node {
+    Node* next;
+  };
+
+  void create_new_chunk() {
+    char* chunk = nullptr;
+    size_t alloc_size = _stride * _chunk_size;
+    int error = posix_memalign(reinterpret_cast<void**>(&chunk),
+                               alignof(FixedFeatureValue),
+                               alloc_size);
+    PADDLE_ENFORCE_EQ(error,
+                      0,
+                      common::errors::ResourceExhausted(
+                          "Fail to alloc memory of %ld size, error code is %d.",
+                          alloc_size,
+                          error));
+    _chunks.push_back(chunk);
+    for (size_t i = _chunk_size; i-- > 0;) {
+      Node* node = (Node*)(void*)(chunk + i * _stride);  // NOLINT
+      node->next = _free_nodes;
+      _free_nodes = node;
+    }
+  }
+
+  void free_chunks() {
+    for (char* chunk : _chunks) {
+      free(chunk);
+    }
+    _chunks.clear();
+    _free_nodes = NULL;
+  }
+
+  size_t _dim = 0;
+  size_t _stride = 0;
+  size_t _chunk_size = 0;  // how many values in one chunk
+  std::vector<char*> _chunks;
+  Node* _free_nodes = NULL;  // a list
+  size_t _counter = 0;       // how many values are acquired
+};
+
+// The values of a SparseTableShard are allocated by ChunkAllocator, except
+// that FixedFeatureValues are packed into a FixedFeatureValueSlab.
+template <class VALUE>
+struct SparseTableShardAllocator {
+  typedef ChunkAllocator<VALUE> type;
+};
+
+template <>
+struct SparseTableShardAllocator<FixedFeatureValue> {
+  typedef FixedFeatureValueSlab type;
 };
 
 template <class KEY, class VALUE>
@@ -136,6 +381,43 @@ struct alignas(64) SparseTableShard {
     }
     return {it, bucket, _buckets};
   }
+  // Find at most kFindBatchSize keys, set values[i] to the value of keys[i],
+  // or nullptr if missed. The lookups of the block are independent of each
+  // other and grouped by bucket, and the values found are prefetched, so the
+  // cache misses of the keys overlap instead of one after another.
+  static constexpr size_t kFindBatchSize = 256;
+  void find_batch(const KEY* keys, size_t num, VALUE** values) {
+    PADDLE_ENFORCE_LE(num,
+                      kFindBatchSize,
+                      common::errors::InvalidArgument(
+                          "find_batch takes at most %d keys, but got %d.",
+                          kFindBatchSize,
+                          num));
+    size_t hashes[kFindBatchSize];
+    uint16_t order[kFindBatchSize];
+    uint16_t offsets[CTR_SPARSE_SHARD_BUCKET_NUM + 1] = {0};
+    for (size_t i = 0; i < num; ++i) {
+      hashes[i] = _hasher(keys[i]);
+      ++offsets[compute_bucket(hashes[i]) + 1];
+    }
+    for (size_t bucket = 0; bucket < CTR_SPARSE_SHARD_BUCKET_NUM; ++bucket) {
+      offsets[bucket + 1] += offsets[bucket];
+    }
+    for (size_t i = 0; i < num; ++i) {
+      order[offsets[compute_bucket(hashes[i])]++] = i;
+    }
+    for (size_t j = 0; j < num; ++j) {
+      size_t i = order[j];
+      map_type& data = _buckets[compute_bucket(hashes[i])];
+      auto it = data.find_with_hash(keys[i], hashes[i]);
+      if (it == data.end()) {
+        values[i] = nullptr;
+      } else {
+        values[i] = (VALUE*)(void*)it->second;  // NOLINT
+        __builtin_prefetch(values[i]);
+      }
+    }
+  }
   VALUE& operator[](const KEY& key) { return emplace(key).first.value(); }
   std::pair<iterator, bool> insert(const KEY& key, const VALUE& val) {
     return emplace(key, val);
@@ -185,6 +467,25 @@ struct alignas(64) SparseTableShard {
     quick_erase(it);
     return 1;
   }
+  // Only for FixedFeatureValue, set the number of floats stored inline, see
+  // FixedFeatureValueSlab. It should be called before inserting any key.
+  void set_value_dim(size_t dim) { _alloc.set_dim(dim); }
+  // Only for FixedFeatureValue, free the unused memory of the erased values.
+  // It moves the values, so the pointers to them are invalidated.
+  size_t compact() {
+    return _alloc.Compact([this](const auto& relocate) {
+      for (size_t bucket = 0; bucket < CTR_SPARSE_SHARD_BUCKET_NUM; bucket++) {
+        map_type& data = _buckets[bucket];
+        for (auto it = data.begin(); it != data.end(); ++it) {
+          VALUE* value = (VALUE*)(void*)it->second;  // NOLINT
+          VALUE* moved = relocate(value);
+          if (moved != value) {
+            it->second = moved;
+          }
+        }
+      }
+    });
+  }
   size_t compute_bucket(size_t hash) {
     if (CTR_SPARSE_SHARD_BUCKET_NUM == 1) {
       return 0;
@@ -195,7 +496,7 @@ struct alignas(64) SparseTableShard {
 
  private:
   map_type _buckets[CTR_SPARSE_SHARD_BUCKET_NUM];
-  ChunkAllocator<VALUE> _alloc;
+  typename SparseTableShardAllocator<VALUE>::type _alloc;
   std::hash<KEY> _hasher;
 };
 
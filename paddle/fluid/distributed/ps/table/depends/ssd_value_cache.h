@@ -0,0 +1,275 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "paddle/utils/string/string_helper.h"
+
+namespace paddle {
+namespace distributed {
+
+// A count-min sketch of 4-bit counters, which estimates how often a key is
+// accessed recently. All counters are halved after `10 * width` increments.
+class FrequencySketch {
+ public:
+  void Resize(size_t width) {
+    _width = 64;
+    while (_width < width) {
+      _width <<= 1;
+    }
+    _counters.assign(kDepth * _width, 0);
+    _increments = 0;
+  }
+
+  void Increment(uint64_t key) {
+    for (size_t row = 0; row < kDepth; ++row) {
+      uint8_t& counter = _counters[Index(key, row)];
+      if (counter < 15) {
+        ++counter;
+      }
+    }
+    if (++_increments >= 10 * _width) {
+      for (auto& counter : _counters) {
+        counter >>= 1;
+      }
+      _increments = 0;
+    }
+  }
+
+  uint8_t Frequency(uint64_t key) const {
+    uint8_t frequency = 15;
+    for (size_t row = 0; row < kDepth; ++row) {
+      frequency = std::min(frequency, _counters[Index(key, row)]);
+    }
+    return frequency;
+  }
+
+ private:
+  static constexpr size_t kDepth = 4;
+
+  size_t Index(uint64_t key, size_t row) const {
+    // splitmix64 with a seed of each row
+    uint64_t x = key + (row + 1) * 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return row * _width + (x & (_width - 1));
+  }
+
+  size_t _width = 0;
+  size_t _increments = 0;
+  std::vector<uint8_t> _counters;
+};
+
+// SSDValueCache keeps the decoded values of the keys evicted from the memory
+// shards of SSDSparseTable into rocksdb, so that the keys pulled back soon
+// after are not read from rocksdb. A cached value is always the same as the
+// one in rocksdb, and is taken out of the cache when the key moves back to
+// the memory shard.
+//
+// Each local shard has a cache of `capacity / shard_num` bytes. The entries
+// are evicted by CLOCK, and a new key is admitted into a full cache only if
+// it is accessed more often than the victim (TinyLFU), so that a scan of
+// cold keys does not flush the hot ones.
+class SSDValueCache {
+ public:
+  void Initialize(int shard_num, size_t capacity, size_t value_bytes) {
+    _shards.reset(new Shard[shard_num]);
+    _shard_num = shard_num;
+    _shard_capacity = capacity / shard_num;
+    for (int i = 0; i < shard_num; ++i) {
+      _shards[i].sketch.Resize(_shard_capacity / (value_bytes + kEntryBytes));
+    }
+  }
+
+  bool Enabled() const { return _shard_num > 0; }
+
+  // Move the value of `key` into `data` and set its number of floats to
+  // `size`, return false if it is not cached.
+  bool Take(int shard_id, uint64_t key, float* data, size_t* size) {
+    if (!Enabled()) {
+      return false;
+    }
+    auto& shard = _shards[shard_id];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.sketch.Increment(key);
+    auto itr = shard.index.find(key);
+    if (itr == shard.index.end()) {
+      ++_miss_count;
+      return false;
+    }
+    ++_hit_count;
+    auto& entry = shard.entries[itr->second];
+    *size = entry.value.size();
+    memcpy(data, entry.value.data(), entry.value.size() * sizeof(float));
+    RemoveEntry(&shard, itr->second);
+    shard.index.erase(itr);
+    return true;
+  }
+
+  // Cache the value of `key` written into rocksdb.
+  void Put(int shard_id, uint64_t key, const float* data, size_t size) {
+    if (!Enabled()) {
+      return;
+    }
+    auto& shard = _shards[shard_id];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto itr = shard.index.find(key);
+    if (itr != shard.index.end()) {
+      RemoveEntry(&shard, itr->second);
+      shard.index.erase(itr);
+    }
+    size_t bytes = size * sizeof(float) + kEntryBytes;
+    if (bytes > _shard_capacity) {
+      return;
+    }
+    while (shard.bytes + bytes > _shard_capacity) {
+      size_t victim = NextVictim(&shard);
+      uint64_t victim_key = shard.entries[victim].key;
+      if (shard.sketch.Frequency(key) <= shard.sketch.Frequency(victim_key)) {
+        ++_reject_count;
+        return;
+      }
+      RemoveEntry(&shard, victim);
+      shard.index.erase(victim_key);
+      ++_evict_count;
+    }
+    size_t slot = 0;
+    if (!shard.free_slots.empty()) {
+      slot = shard.free_slots.back();
+      shard.free_slots.pop_back();
+    } else {
+      slot = shard.entries.size();
+      shard.entries.emplace_back();
+    }
+    auto& entry = shard.entries[slot];
+    entry.key = key;
+    entry.used = true;
+    entry.referenced = true;
+    entry.value.assign(data, data + size);
+    shard.bytes += bytes;
+    shard.index[key] = slot;
+  }
+
+  // Drop the values of a shard, when the values in rocksdb are changed in
+  // bulk.
+  void Clear(int shard_id) {
+    if (!Enabled()) {
+      return;
+    }
+    auto& shard = _shards[shard_id];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.index.clear();
+    shard.entries.clear();
+    shard.free_slots.clear();
+    shard.hand = 0;
+    shard.bytes = 0;
+  }
+
+  void Clear() {
+    for (int i = 0; i < _shard_num; ++i) {
+      Clear(i);
+    }
+  }
+
+  std::string StatString() {
+    size_t bytes = 0;
+    size_t size = 0;
+    for (int i = 0; i < _shard_num; ++i) {
+      std::lock_guard<std::mutex> lock(_shards[i].mutex);
+      bytes += _shards[i].bytes;
+      size += _shards[i].index.size();
+    }
+    uint64_t hit = _hit_count;
+    uint64_t miss = _miss_count;
+    return ::paddle::string::format_string(
+        "size:%lu bytes:%lu hit:%lu miss:%lu hit_rate:%.4f reject:%lu "
+        "evict:%lu",
+        size,
+        bytes,
+        hit,
+        miss,
+        hit + miss == 0 ? 0.0 : static_cast<double>(hit) / (hit + miss),
+        _reject_count.load(),
+        _evict_count.load());
+  }
+
+ private:
+  // the memory used by an entry besides the floats
+  static constexpr size_t kEntryBytes = 64;
+
+  struct Entry {
+    uint64_t key = 0;
+    bool used = false;
+    bool referenced = false;
+    std::vector<float> value;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, size_t> index;
+    std::vector<Entry> entries;
+    std::vector<size_t> free_slots;
+    size_t hand = 0;
+    size_t bytes = 0;
+    FrequencySketch sketch;
+  };
+
+  void RemoveEntry(Shard* shard, size_t slot) {
+    auto& entry = shard->entries[slot];
+    shard->bytes -= entry.value.size() * sizeof(float) + kEntryBytes;
+    entry.used = false;
+    std::vector<float>().swap(entry.value);
+    shard->free_slots.push_back(slot);
+  }
+
+  // Sweep the entries from the hand, give the referenced ones a second chance.
+  size_t NextVictim(Shard* shard) {
+    while (true) {
+      if (shard->hand >= shard->entries.size()) {
+        shard->hand = 0;
+      }
+      auto& entry = shard->entries[shard->hand++];
+      if (!entry.used) {
+        continue;
+      }
+      if (entry.referenced) {
+        entry.referenced = false;
+        continue;
+      }
+      return shard->hand - 1;
+    }
+  }
+
+  std::unique_ptr<Shard[]> _shards;
+  int _shard_num = 0;
+  size_t _shard_capacity = 0;
+  std::atomic<uint64_t> _hit_count{0};
+  std::atomic<uint64_t> _miss_count{0};
+  std::atomic<uint64_t> _reject_count{0};
+  std::atomic<uint64_t> _evict_count{0};
+};
+
+}  // namespace distributed
+}  // namespace paddle
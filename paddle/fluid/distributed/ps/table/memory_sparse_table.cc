@@ -13,13 +13,16 @@
 // limitations under the License.
 
 #include <omp.h>
+#include <chrono>  // NOLINT
 #include <sstream>
+#include <thread>  // NOLINT
 
 #include "glog/logging.h"
 #include "paddle/fluid/distributed/common/cost_timer.h"
 #include "paddle/fluid/distributed/common/local_random.h"
 #include "paddle/fluid/distributed/common/topk_calculator.h"
 #include "paddle/fluid/distributed/ps/table/memory_sparse_table.h"
+#include "paddle/fluid/distributed/ps/table/sparse_binary_format.h"
 #include "paddle/fluid/framework/archive.h"
 #include "paddle/fluid/framework/io/fs.h"
 
@@ -38,6 +41,22 @@ PD_DEFINE_bool(pserver_enable_create_feasign_randomly,
 PD_DEFINE_int32(pserver_table_save_max_retry,
                 3,
                 "pserver_table_save_max_retry");
+PD_DEFINE_bool(pserver_sparse_table_binary_save,
+               false,
+               "save the checkpoints of sparse tables in the binary format, "
+               "the xbox models are always saved in text");
+PD_DEFINE_bool(pserver_sparse_table_delta_save,
+               false,
+               "track the keys changed since the last checkpoint of sparse "
+               "tables, to save delta checkpoints with save param 6");
+PD_DEFINE_int32(pserver_sparse_table_shrink_buckets_per_tick,
+                0,
+                "shrink the sparse tables in the background, this many "
+                "buckets of each shard per tick, 0 to shrink all at once");
+PD_DEFINE_int32(pserver_sparse_table_shrink_tick_ms,
+                10,
+                "the interval in ms between the ticks of the background "
+                "shrink");
 
 namespace paddle::distributed {
 
@@ -76,7 +95,15 @@ int32_t MemorySparseTable::InitializeValue() {
           << " _task_pool_size:" << _task_pool_size
           << " _use_gpu_graph:" << _use_gpu_graph;
 
-  _local_shards.reset(new shard_type[_real_local_shard_num]);
+  _local_shards.reset(NewShards(_real_local_shard_num));
+  if (FLAGS_pserver_sparse_table_delta_save) {
+    if (_use_gpu_graph) {
+      LOG(WARNING) << "MemorySparseTable delta save is not supported in gpu "
+                      "graph mode";
+    } else {
+      _delta_keys.resize(_real_local_shard_num);
+    }
+  }
 
   if (_config.enable_revert()) {
     // calculate merged shard number based on config param;
@@ -115,13 +142,23 @@ int32_t MemorySparseTable::InitializeValue() {
     LOG(INFO) << "merged shard info: [" << _m_sparse_table_shard_num << "|"
               << _m_avg_local_shard_num << "|" << _m_real_local_shard_num
               << "]";
-    _local_shards_new.reset(new shard_type[_real_local_shard_num]);  // NOLINT
+    _local_shards_new.reset(NewShards(_real_local_shard_num));
   }
   return 0;
 }
 
+MemorySparseTable::shard_type *MemorySparseTable::NewShards(int shard_num) {
+  auto *shards = new shard_type[shard_num];  // NOLINT
+  size_t dim = _value_accessor->GetAccessorInfo().dim;
+  for (int i = 0; i < shard_num; ++i) {
+    shards[i].set_value_dim(dim);
+  }
+  return shards;
+}
+
 int32_t MemorySparseTable::Load(const std::string &path,
                                 const std::string &param) {
+  WaitShrink();
   std::string table_path = TableDir(path);
   auto file_list = _afs_client.list(table_path);
 
@@ -176,6 +213,13 @@ int32_t MemorySparseTable::Load(const std::string &path,
     channel_config.converter = _value_accessor->Converter(load_param).converter;
     channel_config.deconverter =
         _value_accessor->Converter(load_param).deconverter;
+    if (IsSparseBinaryFile(channel_config.path)) {
+      LoadBinaryShard(
+          channel_config, &_local_shards[i], &mem_count, &mem_mf_count);
+      VLOG(0) << "Table>> load done. ALL[" << mem_count << "] MEM["
+              << mem_count << "] MEM_MF[" << mem_mf_count << "]";
+      continue;
+    }
 
     bool is_read_failed = false;
     int retry_num = 0;
@@ -224,14 +268,117 @@ int32_t MemorySparseTable::Load(const std::string &path,
     VLOG(0) << "Table>> load done. ALL[" << mem_count << "] MEM[" << mem_count
             << "] MEM_MF[" << mem_mf_count << "]";
   }
+  // delta checkpoint, erase the keys deleted after the previous checkpoint
+  if (load_param == 6) {
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < _real_local_shard_num; ++i) {
+      LoadDeletedKeys(file_list[file_start_idx + i], &_local_shards[i]);
+    }
+  }
+  if (load_param == 0 || load_param == 6) {
+    ResetDelta();
+  }
   LOG(INFO) << "MemorySparseTable load success, path from "
             << file_list[file_start_idx] << " to "
             << file_list[file_start_idx + _real_local_shard_num - 1];
   return 0;
 }
 
+void MemorySparseTable::LoadDeletedKeys(const std::string &path,
+                                        shard_type *shard) {
+  // part-xxx-xxxxx[.bin][.gz] -> deleted/part-xxx-xxxxx
+  size_t pos = path.find_last_of('/');
+  std::string dir = pos == std::string::npos ? "." : path.substr(0, pos);
+  std::string name = pos == std::string::npos ? path : path.substr(pos + 1);
+  FsChannelConfig channel_config = {};
+  channel_config.path = dir + "/deleted/" + name.substr(0, name.find('.'));
+  int retry_num = 0;
+  while (true) {
+    int err_no = 0;
+    size_t erase_count = 0;
+    std::string line_data;
+    auto read_channel = _afs_client.open_r(channel_config, 0, &err_no);
+    while (read_channel->read_line(line_data) == 0 && !line_data.empty()) {
+      uint64_t key = std::strtoul(line_data.data(), nullptr, 10);
+      erase_count += shard->erase(key);
+    }
+    read_channel->close();
+    if (err_no != -1) {
+      VLOG(0) << "Table>> load deleted keys done. path:" << channel_config.path
+              << " erase:" << erase_count;
+      return;
+    }
+    ++retry_num;
+    LOG(ERROR) << "MemorySparseTable load deleted keys failed, retry it! path:"
+               << channel_config.path << " , retry_num=" << retry_num;
+    if (retry_num > FLAGS_pserver_table_save_max_retry) {
+      LOG(ERROR) << "MemorySparseTable load failed reach max limit!";
+      exit(-1);
+    }
+  }
+}
+
+void MemorySparseTable::LoadBinaryShard(const FsChannelConfig &channel_config,
+                                        shard_type *shard,
+                                        uint64_t *mem_count,
+                                        uint64_t *mem_mf_count) {
+  size_t feature_value_size =
+      _value_accessor->GetAccessorInfo().size / sizeof(float);
+  size_t mf_value_size =
+      _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
+  auto insert_block = [&](const uint64_t *keys,
+                          const uint32_t *sizes,
+                          const float *values,
+                          size_t key_num) {
+    for (size_t j = 0; j < key_num; ++j) {
+      auto &value = (*shard)[keys[j]];
+      value.resize(sizes[j]);
+      memcpy(value.data(), values, sizes[j] * sizeof(float));
+      values += sizes[j];
+      if (sizes[j] > feature_value_size - mf_value_size) {
+        ++*mem_mf_count;
+      }
+    }
+    *mem_count += key_num;
+  };
+
+  // The binary data is not processed by the text converters.
+  FsChannelConfig binary_config = {};
+  binary_config.path = channel_config.path;
+  int retry_num = 0;
+  while (true) {
+    *mem_count = 0;
+    *mem_mf_count = 0;
+    int ret = 0;
+    if (CanMapSparseBinaryFile(binary_config.path)) {
+      ret = ReadSparseBinaryMapped(
+          binary_config.path, feature_value_size, insert_block);
+    } else {
+      int err_no = 0;
+      auto read_channel = _afs_client.open_r(binary_config, 0, &err_no);
+      ret = ReadSparseBinary(
+          read_channel.get(), feature_value_size, insert_block);
+      read_channel->close();
+      if (err_no == -1) {
+        ret = -1;
+      }
+    }
+    if (ret == 0) {
+      return;
+    }
+    ++retry_num;
+    LOG(ERROR) << "MemorySparseTable load binary failed, retry it! path:"
+               << binary_config.path << " , retry_num=" << retry_num;
+    if (retry_num > FLAGS_pserver_table_save_max_retry) {
+      LOG(ERROR) << "MemorySparseTable load failed reach max limit!";
+      exit(-1);
+    }
+  }
+}
+
 int32_t MemorySparseTable::LoadPatch(const std::vector<std::string> &file_list,
                                      int load_param) {
+  WaitShrink();
   if (!_config.enable_revert()) {
     LOG(INFO) << "MemorySparseTable should be enabled revert.";
     return 0;
@@ -342,6 +489,7 @@ void MemorySparseTable::CheckSavePrePatchDone() {
 
 int32_t MemorySparseTable::Save(const std::string &dirname,
                                 const std::string &param) {
+  WaitShrink();
 #if defined(PADDLE_WITH_HETERPS) && defined(PADDLE_WITH_PSCORE)
   // gpu graph mode
   if (_use_gpu_graph) {
@@ -360,10 +508,15 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
   int save_param =
       atoi(param.c_str());  // checkpoint:0  xbox delta:1  xbox base:2
 
+  // delta checkpoint
+  if (save_param == 6) {
+    return SaveDelta(dirname);
+  }
+
   // patch model
   if (save_param == 5) {
     _local_shards_patch_model.reset(_local_shards_new.release());
-    _local_shards_new.reset(new shard_type[_real_local_shard_num]);  // NOLINT
+    _local_shards_new.reset(NewShards(_real_local_shard_num));
     _save_patch_model_thread = std::thread(std::bind(
         &MemorySparseTable::SavePatch, this, std::string(dirname), save_param));
     return 0;
@@ -379,6 +532,12 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
   std::atomic<uint32_t> feasign_size_all{0};
 
   size_t file_start_idx = _avg_local_shard_num * _shard_idx;
+  // Only the checkpoints are saved in binary, the xbox models are read by
+  // other tools.
+  bool save_binary = FLAGS_pserver_sparse_table_binary_save &&
+                     (save_param == 0 || save_param == 3);
+  size_t feature_value_size =
+      _value_accessor->GetAccessorInfo().size / sizeof(float);
 
 #ifdef PADDLE_WITH_HETERPS
   int thread_num = _real_local_shard_num;
@@ -389,21 +548,22 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
 #pragma omp parallel for schedule(dynamic)
   for (int i = 0; i < _real_local_shard_num; ++i) {
     FsChannelConfig channel_config = {};
+    std::string suffix = save_binary ? kSparseBinarySuffix : "";
     if (_config.compress_in_save() && (save_param == 0 || save_param == 3)) {
-      channel_config.path =
-          ::paddle::string::format_string("%s/part-%03d-%05d.gz",
-                                          table_path.c_str(),
-                                          _shard_idx,
-                                          file_start_idx + i);
-    } else {
-      channel_config.path = ::paddle::string::format_string("%s/part-%03d-%05d",
-                                                            table_path.c_str(),
-                                                            _shard_idx,
-                                                            file_start_idx + i);
+      suffix += ".gz";
+    }
+    channel_config.path =
+        ::paddle::string::format_string("%s/part-%03d-%05d%s",
+                                        table_path.c_str(),
+                                        _shard_idx,
+                                        file_start_idx + i,
+                                        suffix.c_str());
+    if (!save_binary) {
+      channel_config.converter =
+          _value_accessor->Converter(save_param).converter;
+      channel_config.deconverter =
+          _value_accessor->Converter(save_param).deconverter;
     }
-    channel_config.converter = _value_accessor->Converter(save_param).converter;
-    channel_config.deconverter =
-        _value_accessor->Converter(save_param).deconverter;
     bool is_write_failed = false;
     int feasign_size = 0;
     int retry_num = 0;
@@ -423,6 +583,11 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
       is_write_failed = false;
       auto write_channel =
           _afs_client.open_w(channel_config, 1024 * 1024 * 40, &err_no);
+      std::unique_ptr<SparseBinaryWriter> binary_writer;
+      if (save_binary) {
+        binary_writer = std::make_unique<SparseBinaryWriter>(
+            write_channel.get(), feature_value_size);
+      }
       for (auto it = shard.begin(); it != shard.end(); ++it) {
         if (_config.enable_sparse_table_cache() &&
             (save_param == 1 || save_param == 2) &&
@@ -432,10 +597,17 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
         }
 
         if (_value_accessor->Save(it.value().data(), save_param)) {
-          std::string format_value = _value_accessor->ParseToString(
-              it.value().data(), it.value().size());
-          if (0 != write_channel->write_line(::paddle::string::format_string(
-                       "%lu %s", it.key(), format_value.c_str()))) {
+          int ret = 0;
+          if (binary_writer) {
+            ret = binary_writer->Append(
+                it.key(), it.value().data(), it.value().size());
+          } else {
+            std::string format_value = _value_accessor->ParseToString(
+                it.value().data(), it.value().size());
+            ret = write_channel->write_line(::paddle::string::format_string(
+                "%lu %s", it.key(), format_value.c_str()));
+          }
+          if (0 != ret) {
             ++retry_num;
             is_write_failed = true;
             LOG(ERROR)
@@ -444,8 +616,18 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
             break;
           }
           ++feasign_size;
+          // the xbox saves update the stat of the saved values
+          if (save_param == 1 || save_param == 2) {
+            MarkDirty(i, it.key());
+          }
         }
       }
+      if (binary_writer && !is_write_failed && binary_writer->Finish() != 0) {
+        ++retry_num;
+        is_write_failed = true;
+        LOG(ERROR) << "MemorySparseTable save prefix failed, retry it! path:"
+                   << channel_config.path << " , retry_num=" << retry_num;
+      }
       write_channel->close();
       if (err_no == -1) {
         ++retry_num;
@@ -467,6 +649,9 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
       for (auto it = shard.begin(); it != shard.end(); ++it) {
         _value_accessor->UpdateStatAfterSave(it.value().data(), save_param);
       }
+      if (save_param == 3) {
+        MarkAllDirty(i);
+      }
     } else if (save_param != 3) {
       for (auto it = shard.begin(); it != shard.end(); ++it) {
         _value_accessor->UpdateStatAfterSave(it.value().data(), save_param);
@@ -476,6 +661,9 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
               << channel_config.path << " feasign_size: " << feasign_size;
   }
   _local_show_threshold = tk.top();
+  if (save_param == 0) {
+    ResetDelta();
+  }
   // int32 may overflow need to change return value
   return 0;
 }
@@ -483,6 +671,7 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
 #if defined(PADDLE_WITH_HETERPS) && defined(PADDLE_WITH_PSCORE)
 int32_t MemorySparseTable::Save_v2(const std::string &dirname,
                                    const std::string &param) {
+  WaitShrink();
   if (_real_local_shard_num == 0) {
     _local_show_threshold = -1;
     return 0;
@@ -495,7 +684,7 @@ int32_t MemorySparseTable::Save_v2(const std::string &dirname,
   // patch model
   if (save_param == 5) {
     _local_shards_patch_model.reset(_local_shards_new.release());
-    _local_shards_new.reset(new shard_type[_real_local_shard_num]);
+    _local_shards_new.reset(NewShards(_real_local_shard_num));
     _save_patch_model_thread = std::thread(std::bind(
         &MemorySparseTable::SavePatch, this, std::string(dirname), save_param));
     return 0;
@@ -683,6 +872,7 @@ int32_t MemorySparseTable::Save_v2(const std::string &dirname,
 #endif
 
 int32_t MemorySparseTable::SavePatch(const std::string &path, int save_param) {
+  WaitShrink();
   if (!_config.enable_revert()) {
     LOG(INFO) << "MemorySparseTable should be enabled revert.";
     return 0;
@@ -771,6 +961,144 @@ int32_t MemorySparseTable::SavePatch(const std::string &path, int save_param) {
   return 0;
 }
 
+int32_t MemorySparseTable::SaveDelta(const std::string &path) {
+  WaitShrink();
+  if (_delta_keys.empty()) {
+    LOG(WARNING) << "MemorySparseTable save delta needs "
+                    "FLAGS_pserver_sparse_table_delta_save";
+    return -1;
+  }
+  if (_real_local_shard_num == 0) {
+    return 0;
+  }
+  std::string table_path = TableDir(path);
+  std::string deleted_path = table_path + "/deleted";
+  _afs_client.remove(::paddle::string::format_string(
+      "%s/part-%03d-*", table_path.c_str(), _shard_idx));
+  _afs_client.remove(::paddle::string::format_string(
+      "%s/part-%03d-*", deleted_path.c_str(), _shard_idx));
+  std::atomic<uint32_t> feasign_size_all{0};
+  std::atomic<uint32_t> deleted_size_all{0};
+
+  size_t file_start_idx = _avg_local_shard_num * _shard_idx;
+  bool save_binary = FLAGS_pserver_sparse_table_binary_save;
+  size_t feature_value_size =
+      _value_accessor->GetAccessorInfo().size / sizeof(float);
+
+  int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
+  omp_set_num_threads(thread_num);
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    std::string suffix = save_binary ? kSparseBinarySuffix : "";
+    if (_config.compress_in_save()) {
+      suffix += ".gz";
+    }
+    FsChannelConfig channel_config = {};
+    channel_config.path =
+        ::paddle::string::format_string("%s/part-%03d-%05d%s",
+                                        table_path.c_str(),
+                                        _shard_idx,
+                                        file_start_idx + i,
+                                        suffix.c_str());
+    if (!save_binary) {
+      channel_config.converter = _value_accessor->Converter(6).converter;
+      channel_config.deconverter = _value_accessor->Converter(6).deconverter;
+    }
+    FsChannelConfig deleted_config = {};
+    deleted_config.path =
+        ::paddle::string::format_string("%s/part-%03d-%05d",
+                                        deleted_path.c_str(),
+                                        _shard_idx,
+                                        file_start_idx + i);
+
+    auto &shard = _local_shards[i];
+    auto &delta = _delta_keys[i];
+    bool is_write_failed = false;
+    int feasign_size = 0;
+    int retry_num = 0;
+    int err_no = 0;
+    do {
+      err_no = 0;
+      feasign_size = 0;
+      is_write_failed = false;
+      auto write_channel =
+          _afs_client.open_w(channel_config, 1024 * 1024 * 40, &err_no);
+      std::unique_ptr<SparseBinaryWriter> binary_writer;
+      if (save_binary) {
+        binary_writer = std::make_unique<SparseBinaryWriter>(
+            write_channel.get(), feature_value_size);
+      }
+      auto write_value = [&](uint64_t key, FixedFeatureValue &value) -> int {
+        if (!_value_accessor->Save(value.data(), 0)) {
+          return 0;
+        }
+        ++feasign_size;
+        if (binary_writer) {
+          return binary_writer->Append(key, value.data(), value.size());
+        }
+        std::string format_value =
+            _value_accessor->ParseToString(value.data(), value.size());
+        return write_channel->write_line(::paddle::string::format_string(
+            "%lu %s", key, format_value.c_str()));
+      };
+      if (delta.all_dirty) {
+        for (auto it = shard.begin(); it != shard.end(); ++it) {
+          if (write_value(it.key(), it.value()) != 0) {
+            is_write_failed = true;
+            break;
+          }
+        }
+      } else {
+        for (uint64_t key : delta.dirty) {
+          auto it = shard.find(key);
+          if (it != shard.end() && write_value(key, it.value()) != 0) {
+            is_write_failed = true;
+            break;
+          }
+        }
+      }
+      if (binary_writer && !is_write_failed && binary_writer->Finish() != 0) {
+        is_write_failed = true;
+      }
+      write_channel->close();
+
+      if (!is_write_failed && err_no != -1) {
+        auto deleted_channel =
+            _afs_client.open_w(deleted_config, 1024 * 1024, &err_no);
+        for (uint64_t key : delta.deleted) {
+          if (deleted_channel->write_line(
+                  ::paddle::string::format_string("%lu", key)) != 0) {
+            is_write_failed = true;
+            break;
+          }
+        }
+        deleted_channel->close();
+      }
+      if (is_write_failed || err_no == -1) {
+        ++retry_num;
+        is_write_failed = true;
+        LOG(ERROR) << "MemorySparseTable save delta failed, retry it! path:"
+                   << channel_config.path << " , retry_num=" << retry_num;
+        _afs_client.remove(channel_config.path);
+        _afs_client.remove(deleted_config.path);
+      }
+      if (retry_num > FLAGS_pserver_table_save_max_retry) {
+        LOG(ERROR) << "MemorySparseTable save delta failed reach max limit!";
+        exit(-1);
+      }
+    } while (is_write_failed);
+    feasign_size_all += feasign_size;
+    deleted_size_all += delta.deleted.size();
+  }
+  ResetDelta();
+  LOG(INFO) << "MemorySparseTable save delta success, path:" << table_path
+            << " from " << file_start_idx << " to "
+            << file_start_idx + _real_local_shard_num - 1
+            << ", feasign size: " << feasign_size_all
+            << ", deleted size: " << deleted_size_all;
+  return 0;
+}
+
 int64_t MemorySparseTable::CacheShuffle(
     const std::string &path,
     const std::string &param,
@@ -780,6 +1108,14 @@ int64_t MemorySparseTable::CacheShuffle(
     ::paddle::framework::Channel<std::pair<uint64_t, std::string>>
         &shuffled_channel,
     const std::vector<Table *> &table_ptrs) {
+  // the shards of the tables are walked outside their task pools
+  WaitShrink();
+  for (auto table_ptr : table_ptrs) {
+    auto *memory_table = dynamic_cast<MemorySparseTable *>(table_ptr);
+    if (memory_table != nullptr) {
+      memory_table->WaitShrink();
+    }
+  }
   LOG(INFO) << "cache shuffle with cache threshold: " << cache_threshold;
   int save_param = atoi(param.c_str());  // batch_model:0  xbox:1
   if (!_config.enable_sparse_table_cache() || cache_threshold < 0) {
@@ -889,6 +1225,7 @@ int32_t MemorySparseTable::SaveCache(
     const std::string &param,
     ::paddle::framework::Channel<std::pair<uint64_t, std::string>>
         &shuffled_channel) {
+  WaitShrink();
   if (_shard_idx >= _config.sparse_table_cache_file_num()) {
     return 0;
   }
@@ -934,9 +1271,18 @@ int32_t MemorySparseTable::SaveCache(
 }
 
 int64_t MemorySparseTable::LocalSize() {
+  // in the task pools, which run the background shrink of the shards
+  std::vector<std::future<size_t>> tasks(_real_local_shard_num);
+  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
+    tasks[shard_id] =
+        _shards_task_pool[shard_id % _shards_task_pool.size()]->enqueue(
+            [this, shard_id]() -> size_t {
+              return _local_shards[shard_id].size();
+            });
+  }
   int64_t local_size = 0;
-  for (int i = 0; i < _real_local_shard_num; ++i) {
-    local_size += _local_shards[i].size();
+  for (auto &task : tasks) {
+    local_size += task.get();
   }
   return local_size;
 }
@@ -1044,37 +1390,56 @@ int32_t MemorySparseTable::PullSparse(float *pull_values,
               auto &local_shard = _local_shards[shard_id];
               float data_buffer[value_size];  // NOLINT
               float *data_buffer_ptr = data_buffer;
+              constexpr size_t kBatchSize = shard_type::kFindBatchSize;
+              uint64_t batch_keys[kBatchSize];
+              FixedFeatureValue *batch_values[kBatchSize];
 
               auto &keys = task_keys[shard_id];
-              for (auto &item : keys) {
-                uint64_t key = item.first;
-                auto itr = local_shard.find(key);
-                size_t data_size = value_size - mf_value_size;
-                if (itr == local_shard.end()) {
-                  // ++missed_keys;
-                  if (FLAGS_pserver_create_value_when_push) {
-                    memset(data_buffer, 0, sizeof(float) * data_size);
-                  } else {
-                    auto &feature_value = local_shard[key];
-                    feature_value.resize(data_size);
-                    float *data_ptr = feature_value.data();
-                    _value_accessor->Create(&data_buffer_ptr, 1);
-                    memcpy(
-                        data_ptr, data_buffer_ptr, data_size * sizeof(float));
-                  }
-                } else {
-                  data_size = itr.value().size();
-                  memcpy(data_buffer_ptr,
-                         itr.value().data(),
-                         data_size * sizeof(float));
+              for (size_t begin = 0; begin < keys.size(); begin += kBatchSize) {
+                // look up the whole batch first to overlap the cache misses
+                size_t batch_size = std::min(kBatchSize, keys.size() - begin);
+                for (size_t j = 0; j < batch_size; ++j) {
+                  batch_keys[j] = keys[begin + j].first;
                 }
-                for (size_t mf_idx = data_size; mf_idx < value_size; ++mf_idx) {
-                  data_buffer[mf_idx] = 0.0;
+                local_shard.find_batch(batch_keys, batch_size, batch_values);
+
+                for (size_t j = 0; j < batch_size; ++j) {
+                  uint64_t key = batch_keys[j];
+                  FixedFeatureValue *value = batch_values[j];
+                  size_t data_size = value_size - mf_value_size;
+                  if (value == nullptr) {
+                    // ++missed_keys;
+                    if (FLAGS_pserver_create_value_when_push) {
+                      memset(data_buffer, 0, sizeof(float) * data_size);
+                    } else {
+                      // the key may be created by an earlier one of the batch
+                      auto res = local_shard.emplace(key);
+                      value = res.first.value_ptr();
+                      if (res.second) {
+                        value->resize(data_size);
+                        _value_accessor->Create(&data_buffer_ptr, 1);
+                        memcpy(value->data(),
+                               data_buffer_ptr,
+                               data_size * sizeof(float));
+                        MarkDirty(shard_id, key);
+                      }
+                    }
+                  }
+                  if (value != nullptr) {
+                    data_size = value->size();
+                    memcpy(data_buffer_ptr,
+                           value->data(),
+                           data_size * sizeof(float));
+                  }
+                  for (size_t mf_idx = data_size; mf_idx < value_size;
+                       ++mf_idx) {
+                    data_buffer[mf_idx] = 0.0;
+                  }
+                  auto offset = keys[begin + j].second;
+                  float *select_data = pull_values + select_value_size * offset;
+                  _value_accessor->Select(
+                      &select_data, (const float **)&data_buffer_ptr, 1);
                 }
-                auto offset = item.second;
-                float *select_data = pull_values + select_value_size * offset;
-                _value_accessor->Select(
-                    &select_data, (const float **)&data_buffer_ptr, 1);
               }
 
               return 0;
@@ -1134,6 +1499,8 @@ int32_t MemorySparseTable::PullSparsePtr(int shard_id,  // fake num
                 } else {
                   ret = itr.value_ptr();
                 }
+                // the values are updated through the pointers
+                MarkDirty(shard_id, key);
                 int pull_data_idx = item.second;
                 pull_values[pull_data_idx] = reinterpret_cast<char *>(ret);
               }
@@ -1226,6 +1593,7 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                      value_data,
                      new_size * sizeof(float));
             }
+            MarkDirty(shard_id, key);
           }
           return 0;
         });
@@ -1294,6 +1662,7 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
               }
               memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
             }
+            MarkDirty(shard_id, key);
           }
           return 0;
         });
@@ -1309,6 +1678,25 @@ int32_t MemorySparseTable::Flush() { return 0; }
 
 int32_t MemorySparseTable::Shrink(const std::string &param) {
   VLOG(0) << "MemorySparseTable::Shrink";
+  // every value is shrunk once a pass, so wait for the last pass
+  WaitShrink();
+#ifdef PADDLE_WITH_HETERPS
+  // the values pulled by PullSparsePtr are held until the end of the pass,
+  // so they can not be freed in the background
+  if (FLAGS_pserver_sparse_table_shrink_buckets_per_tick > 0) {
+    LOG(WARNING) << "MemorySparseTable background shrink is not supported "
+                    "with heterps";
+  }
+#else
+  if (FLAGS_pserver_sparse_table_shrink_buckets_per_tick > 0) {
+    _shrink_running = true;
+    _shrink_bucket_done = 0;
+    _shrink_bucket_num = _real_local_shard_num * CTR_SPARSE_SHARD_BUCKET_NUM;
+    _shrink_erased = 0;
+    _shrink_thread = std::thread([this]() { ShrinkInBackground(); });
+    return 0;
+  }
+#endif
   std::atomic<uint32_t> shrink_size_all{0};
   int thread_num = _real_local_shard_num;
   omp_set_num_threads(thread_num);
@@ -1317,14 +1705,18 @@ int32_t MemorySparseTable::Shrink(const std::string &param) {
     // Shrink
     int feasign_size = 0;
     auto &shard = _local_shards[shard_id];
+    // the kept values are decayed by the accessor
+    MarkAllDirty(shard_id);
     for (auto it = shard.begin(); it != shard.end();) {
       if (_value_accessor->Shrink(it.value().data())) {
+        MarkDeleted(shard_id, it.key());
         it = shard.erase(it);
         ++feasign_size;
       } else {
         ++it;
       }
     }
+    shard.compact();
     shrink_size_all += feasign_size;
   }
   VLOG(0) << "MemorySparseTable::Shrink success, shrink size:"
@@ -1332,6 +1724,62 @@ int32_t MemorySparseTable::Shrink(const std::string &param) {
   return 0;
 }
 
+void MemorySparseTable::ShrinkInBackground() {
+  size_t bucket_num = CTR_SPARSE_SHARD_BUCKET_NUM;
+  size_t step = FLAGS_pserver_sparse_table_shrink_buckets_per_tick;
+  for (size_t begin = 0; begin < bucket_num; begin += step) {
+    size_t end = std::min(begin + step, bucket_num);
+    std::vector<std::future<size_t>> tasks(_real_local_shard_num);
+    for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
+      tasks[shard_id] =
+          _shards_task_pool[shard_id % _shards_task_pool.size()]->enqueue(
+              [this, shard_id, begin, end]() -> size_t {
+                size_t erased = ShrinkBuckets(shard_id, begin, end);
+                if (end == CTR_SPARSE_SHARD_BUCKET_NUM) {
+                  _local_shards[shard_id].compact();
+                }
+                return erased;
+              });
+    }
+    for (auto &task : tasks) {
+      _shrink_erased += task.get();
+    }
+    _shrink_bucket_done += (end - begin) * _real_local_shard_num;
+    VLOG(1) << "MemorySparseTable::Shrink buckets:" << _shrink_bucket_done
+            << "/" << _shrink_bucket_num << " shrink size:" << _shrink_erased;
+    if (end < bucket_num) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(
+          FLAGS_pserver_sparse_table_shrink_tick_ms));
+    }
+  }
+  _shrink_running = false;
+  VLOG(0) << "MemorySparseTable::Shrink success, shrink size:"
+          << _shrink_erased;
+}
+
+size_t MemorySparseTable::ShrinkBuckets(int shard_id,
+                                        size_t begin,
+                                        size_t end) {
+  auto &shard = _local_shards[shard_id];
+  if (begin == 0) {
+    // the kept values are decayed by the accessor
+    MarkAllDirty(shard_id);
+  }
+  size_t erased = 0;
+  for (size_t bucket = begin; bucket < end; ++bucket) {
+    for (auto it = shard.begin(bucket); it != shard.end(bucket);) {
+      if (_value_accessor->Shrink(it.value().data())) {
+        MarkDeleted(shard_id, it.key());
+        it = shard.erase(bucket, it);
+        ++erased;
+      } else {
+        ++it;
+      }
+    }
+  }
+  return erased;
+}
+
 void MemorySparseTable::Clear() { VLOG(0) << "clear coming soon"; }
 
 }  // namespace paddle::distributed
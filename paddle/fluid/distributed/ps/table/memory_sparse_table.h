@@ -18,10 +18,12 @@
 #include <assert.h>
 #include <pthread.h>
 
+#include <atomic>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -40,7 +42,7 @@ class MemorySparseTable : public Table {
  public:
   typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
   MemorySparseTable() {}
-  virtual ~MemorySparseTable() {}
+  virtual ~MemorySparseTable() { WaitShrink(); }
 
   // unused method end
   static int32_t sparse_local_shard_num(uint32_t shard_num,
@@ -107,6 +109,28 @@ class MemorySparseTable : public Table {
   int32_t Shrink(const std::string& param) override;
   void Clear() override;
 
+  // With FLAGS_pserver_sparse_table_shrink_buckets_per_tick, Shrink returns
+  // at once and the shards are shrunk in the background, a few buckets per
+  // tick in the shard task pools, between the pulls and pushes.
+  struct ShrinkStat {
+    bool running;
+    uint64_t bucket_done;  // the buckets of all shards shrunk in the pass
+    uint64_t bucket_num;
+    uint64_t erased;
+  };
+  ShrinkStat GetShrinkStat() const {
+    return {_shrink_running.load(),
+            _shrink_bucket_done.load(),
+            _shrink_bucket_num.load(),
+            _shrink_erased.load()};
+  }
+  // Wait for the background shrink to finish.
+  void WaitShrink() {
+    if (_shrink_thread.joinable()) {
+      _shrink_thread.join();
+    }
+  }
+
   void* GetShard(size_t shard_idx) override {
     return &_local_shards[shard_idx];
   }
@@ -115,10 +139,63 @@ class MemorySparseTable : public Table {
   virtual void CheckSavePrePatchDone();
 
  protected:
+  // Create the shards, whose values are packed by the dim of the accessor.
+  shard_type* NewShards(int shard_num);
+
+  // Load a shard file in the binary format, see sparse_binary_format.h.
+  void LoadBinaryShard(const FsChannelConfig& channel_config,
+                       shard_type* shard,
+                       uint64_t* mem_count,
+                       uint64_t* mem_mf_count);
+
   virtual int32_t SavePatch(const std::string& path, int save_param);
   virtual int32_t LoadPatch(const std::vector<std::string>& file_list,
                             int save_param);
 
+  // Save the values changed and the keys deleted since the last checkpoint,
+  // which are loaded on top of the checkpoint by Load with param 6.
+  int32_t SaveDelta(const std::string& path);
+  void LoadDeletedKeys(const std::string& path, shard_type* shard);
+
+  void ShrinkInBackground();
+  // Shrink the buckets in [begin, end) of a shard, return the keys erased.
+  size_t ShrinkBuckets(int shard_id, size_t begin, size_t end);
+
+  void MarkDirty(int shard_id, uint64_t key) {
+    if (_delta_keys.empty()) {
+      return;
+    }
+    auto& delta = _delta_keys[shard_id];
+    if (!delta.deleted.empty()) {
+      delta.deleted.erase(key);
+    }
+    if (!delta.all_dirty) {
+      delta.dirty.insert(key);
+    }
+  }
+  void MarkDeleted(int shard_id, uint64_t key) {
+    if (_delta_keys.empty()) {
+      return;
+    }
+    auto& delta = _delta_keys[shard_id];
+    delta.dirty.erase(key);
+    delta.deleted.insert(key);
+  }
+  void MarkAllDirty(int shard_id) {
+    if (_delta_keys.empty()) {
+      return;
+    }
+    _delta_keys[shard_id].all_dirty = true;
+    _delta_keys[shard_id].dirty.clear();
+  }
+  void ResetDelta() {
+    for (auto& delta : _delta_keys) {
+      delta.all_dirty = false;
+      delta.dirty.clear();
+      delta.deleted.clear();
+    }
+  }
+
   int _task_pool_size = 24;
   int _avg_local_shard_num;
   int _real_local_shard_num;
@@ -137,6 +214,22 @@ class MemorySparseTable : public Table {
   std::unique_ptr<shard_type[]> _local_shards_patch_model;
   std::thread _save_patch_model_thread;
   bool _use_gpu_graph = false;
+
+  std::thread _shrink_thread;
+  std::atomic<bool> _shrink_running{false};
+  std::atomic<uint64_t> _shrink_bucket_done{0};
+  std::atomic<uint64_t> _shrink_bucket_num{0};
+  std::atomic<uint64_t> _shrink_erased{0};
+
+  // The keys changed since the last checkpoint of each local shard, empty if
+  // FLAGS_pserver_sparse_table_delta_save is off. A shard is all dirty after
+  // the values are updated in bulk, e.g. decayed by Shrink.
+  struct DeltaKeys {
+    bool all_dirty = false;
+    std::unordered_set<uint64_t> dirty;
+    std::unordered_set<uint64_t> deleted;
+  };
+  std::vector<DeltaKeys> _delta_keys;
 };
 
 }  // namespace distributed
@@ -0,0 +1,295 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/sparse_binary_format.h"
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <xxhash.h>
+
+#include <cstring>
+
+#include "paddle/fluid/framework/io/fs.h"
+
+namespace paddle {
+namespace distributed {
+
+namespace {
+
+// The columns of a block are padded to 8 bytes to keep the keys of the next
+// block aligned in the mapping.
+size_t PaddingBytes(uint64_t key_num, uint64_t value_num) {
+  size_t bytes = key_num * (sizeof(uint64_t) + sizeof(uint32_t)) +
+                 value_num * sizeof(float);
+  return (8 - bytes % 8) % 8;
+}
+
+uint64_t BlockChecksum(const uint64_t* keys,
+                       const uint32_t* sizes,
+                       const float* values,
+                       size_t key_num,
+                       uint64_t value_num) {
+  uint64_t checksum = XXH64(keys, key_num * sizeof(uint64_t), 0);
+  checksum = XXH64(sizes, key_num * sizeof(uint32_t), checksum);
+  return XXH64(values, value_num * sizeof(float), checksum);
+}
+
+// Parse a binary file from `next(size)`, which returns the next `size` bytes
+// of the file, or nullptr if there are not enough bytes. The bytes returned
+// are valid until the next call.
+int ParseSparseBinary(const std::function<const char*(size_t)>& next,
+                      uint32_t max_value_dim,
+                      const SparseBinaryBlockFunc& func) {
+  const char* data = next(sizeof(SparseBinaryFileHeader));
+  if (data == nullptr) {
+    LOG(ERROR) << "SparseBinary: failed to read the file header";
+    return -1;
+  }
+  SparseBinaryFileHeader header;
+  memcpy(&header, data, sizeof(header));
+  if (memcmp(header.magic, kSparseBinaryMagic, sizeof(header.magic)) != 0 ||
+      header.version != kSparseBinaryVersion) {
+    LOG(ERROR) << "SparseBinary: unknown magic or version " << header.version;
+    return -1;
+  }
+
+  uint64_t key_num = 0;
+  while (true) {
+    data = next(sizeof(SparseBinaryBlockHeader));
+    if (data == nullptr) {
+      LOG(ERROR) << "SparseBinary: the file is truncated after " << key_num
+                 << " keys";
+      return -1;
+    }
+    SparseBinaryBlockHeader block;
+    memcpy(&block, data, sizeof(block));
+    if (block.key_num == 0) {
+      if (block.value_num != key_num) {
+        LOG(ERROR) << "SparseBinary: expect " << block.value_num
+                   << " keys, but read " << key_num;
+        return -1;
+      }
+      return 0;
+    }
+    if (block.key_num > header.block_key_num ||
+        block.value_num >
+            static_cast<uint64_t>(block.key_num) * max_value_dim) {
+      LOG(ERROR) << "SparseBinary: invalid block of " << block.key_num
+                 << " keys and " << block.value_num << " values";
+      return -1;
+    }
+    size_t keys_bytes = block.key_num * sizeof(uint64_t);
+    size_t sizes_bytes = block.key_num * sizeof(uint32_t);
+    data = next(keys_bytes + sizes_bytes + block.value_num * sizeof(float) +
+                PaddingBytes(block.key_num, block.value_num));
+    if (data == nullptr) {
+      LOG(ERROR) << "SparseBinary: the file is truncated after " << key_num
+                 << " keys";
+      return -1;
+    }
+    auto* keys = reinterpret_cast<const uint64_t*>(data);
+    auto* sizes = reinterpret_cast<const uint32_t*>(data + keys_bytes);
+    auto* values =
+        reinterpret_cast<const float*>(data + keys_bytes + sizes_bytes);
+    if (BlockChecksum(keys, sizes, values, block.key_num, block.value_num) !=
+        block.checksum) {
+      LOG(ERROR) << "SparseBinary: checksum mismatch in the block after "
+                 << key_num << " keys";
+      return -1;
+    }
+    uint64_t value_num = 0;
+    for (uint32_t i = 0; i < block.key_num; ++i) {
+      if (sizes[i] > max_value_dim) {
+        LOG(ERROR) << "SparseBinary: the value of key " << keys[i] << " has "
+                   << sizes[i] << " floats, more than " << max_value_dim;
+        return -1;
+      }
+      value_num += sizes[i];
+    }
+    if (value_num != block.value_num) {
+      LOG(ERROR) << "SparseBinary: the sizes of the values do not match";
+      return -1;
+    }
+    func(keys, sizes, values, block.key_num);
+    key_num += block.key_num;
+  }
+}
+
+}  // namespace
+
+bool IsSparseBinaryFile(const std::string& path) {
+  return ::paddle::string::ends_with(path, kSparseBinarySuffix) ||
+         ::paddle::string::ends_with(path,
+                                     std::string(kSparseBinarySuffix) + ".gz");
+}
+
+bool CanMapSparseBinaryFile(const std::string& path) {
+  return ::paddle::string::ends_with(path, kSparseBinarySuffix) &&
+         paddle::framework::fs_select_internal(path) == 0;
+}
+
+SparseBinaryWriter::SparseBinaryWriter(FsWriteChannel* channel,
+                                       uint32_t value_dim,
+                                       uint32_t block_key_num)
+    : _channel(channel) {
+  memset(&_header, 0, sizeof(_header));
+  memcpy(_header.magic, kSparseBinaryMagic, sizeof(_header.magic));
+  _header.version = kSparseBinaryVersion;
+  _header.value_dim = value_dim;
+  _header.block_key_num = block_key_num;
+  _keys.reserve(block_key_num);
+  _sizes.reserve(block_key_num);
+}
+
+int SparseBinaryWriter::WriteHeader() {
+  _header_written = true;
+  return _channel->write(reinterpret_cast<const char*>(&_header),
+                         sizeof(_header)) == 0
+             ? 0
+             : -1;
+}
+
+int SparseBinaryWriter::Append(uint64_t key,
+                               const float* value,
+                               uint32_t size) {
+  if (!_header_written && WriteHeader() != 0) {
+    return -1;
+  }
+  _keys.push_back(key);
+  _sizes.push_back(size);
+  _values.insert(_values.end(), value, value + size);
+  ++_key_num;
+  if (_keys.size() >= _header.block_key_num) {
+    return FlushBlock();
+  }
+  return 0;
+}
+
+int SparseBinaryWriter::FlushBlock() {
+  SparseBinaryBlockHeader block;
+  memset(&block, 0, sizeof(block));
+  block.key_num = static_cast<uint32_t>(_keys.size());
+  block.value_num = _values.size();
+  block.checksum = BlockChecksum(_keys.data(),
+                                 _sizes.data(),
+                                 _values.data(),
+                                 _keys.size(),
+                                 _values.size());
+  const char padding[8] = {0};
+  int ret = 0;
+  if (_channel->write(reinterpret_cast<const char*>(&block), sizeof(block)) !=
+          0 ||
+      _channel->write(reinterpret_cast<const char*>(_keys.data()),
+                      _keys.size() * sizeof(uint64_t)) != 0 ||
+      _channel->write(reinterpret_cast<const char*>(_sizes.data()),
+                      _sizes.size() * sizeof(uint32_t)) != 0 ||
+      _channel->write(reinterpret_cast<const char*>(_values.data()),
+                      _values.size() * sizeof(float)) != 0 ||
+      _channel->write(padding, PaddingBytes(_keys.size(), _values.size())) !=
+          0) {
+    ret = -1;
+  }
+  _keys.clear();
+  _sizes.clear();
+  _values.clear();
+  return ret;
+}
+
+int SparseBinaryWriter::Finish() {
+  if (!_header_written && WriteHeader() != 0) {
+    return -1;
+  }
+  if (!_keys.empty() && FlushBlock() != 0) {
+    return -1;
+  }
+  SparseBinaryBlockHeader end;
+  memset(&end, 0, sizeof(end));
+  end.value_num = _key_num;
+  return _channel->write(reinterpret_cast<const char*>(&end), sizeof(end)) == 0
+             ? 0
+             : -1;
+}
+
+int ReadSparseBinary(FsReadChannel* channel,
+                     uint32_t max_value_dim,
+                     const SparseBinaryBlockFunc& func) {
+  // Read into uint64_t to keep the keys aligned.
+  std::vector<uint64_t> buffer;
+  return ParseSparseBinary(
+      [&](size_t size) -> const char* {
+        buffer.resize((size + 7) / 8);
+        char* data = reinterpret_cast<char*>(buffer.data());
+        size_t read = 0;
+        while (read < size) {
+          int ret = channel->read(data + read, size - read);
+          if (ret <= 0) {
+            return nullptr;
+          }
+          read += ret;
+        }
+        return data;
+      },
+      max_value_dim,
+      func);
+}
+
+int ReadSparseBinaryMapped(const std::string& path,
+                           uint32_t max_value_dim,
+                           const SparseBinaryBlockFunc& func) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    LOG(ERROR) << "SparseBinary: failed to open " << path;
+    return -1;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1 || file_stat.st_size == 0) {
+    LOG(ERROR) << "SparseBinary: failed to get the size of " << path;
+    close(fd);
+    return -1;
+  }
+  size_t file_size = static_cast<size_t>(file_stat.st_size);
+  void* ptr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    LOG(ERROR) << "SparseBinary: failed to map " << path;
+    return -1;
+  }
+  // The file is read once from the beginning to the end.
+  madvise(ptr, file_size, MADV_SEQUENTIAL);
+  const char* begin = static_cast<const char*>(ptr);
+  size_t offset = 0;
+  int ret = ParseSparseBinary(
+      [&](size_t size) -> const char* {
+        if (size > file_size - offset) {
+          return nullptr;
+        }
+        const char* data = begin + offset;
+        offset += size;
+        return data;
+      },
+      max_value_dim,
+      func);
+  if (ret == 0 && offset != file_size) {
+    LOG(ERROR) << "SparseBinary: unexpected data at the end of " << path;
+    ret = -1;
+  }
+  munmap(ptr, file_size);
+  return ret;
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,110 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/distributed/common/afs_warpper.h"
+
+namespace paddle {
+namespace distributed {
+
+// The binary format of the shard files of sparse tables, which is much
+// smaller and faster to save and load than the text of
+// ValueAccessor::ParseToString.
+//
+// A file starts with a SparseBinaryFileHeader, followed by blocks of at most
+// `block_key_num` keys. Each block is a SparseBinaryBlockHeader followed by
+// the columns of the block: the keys (uint64), the sizes of the values
+// (uint32) and the floats of all the values, padded to 8 bytes. The checksum
+// of a block covers its columns. The file ends with an empty block whose
+// `value_num` is the number of keys in the file, so that a truncated file is
+// detected.
+//
+// The files are named with kSparseBinarySuffix, optionally followed by ".gz"
+// to be compressed by the file system layer.
+constexpr char kSparseBinaryMagic[8] = {'P', 'S', 'S', 'P', 'B', 'I', 'N', 0};
+constexpr uint32_t kSparseBinaryVersion = 1;
+constexpr char kSparseBinarySuffix[] = ".bin";
+
+struct SparseBinaryFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t value_dim;  // the max floats of a value
+  uint32_t block_key_num;
+  uint32_t reserved;
+};
+
+struct SparseBinaryBlockHeader {
+  uint32_t key_num;
+  uint32_t reserved;
+  uint64_t value_num;
+  uint64_t checksum;
+};
+
+// Whether `path` is a shard file in the binary format.
+bool IsSparseBinaryFile(const std::string& path);
+
+// Whether `path` is a local uncompressed binary file, which can be mapped.
+bool CanMapSparseBinaryFile(const std::string& path);
+
+class SparseBinaryWriter {
+ public:
+  SparseBinaryWriter(FsWriteChannel* channel,
+                     uint32_t value_dim,
+                     uint32_t block_key_num = 64 * 1024);
+
+  // Return 0 on success, and -1 if failed to write.
+  int Append(uint64_t key, const float* value, uint32_t size);
+  int Finish();
+
+  uint64_t KeyNum() const { return _key_num; }
+
+ private:
+  int WriteHeader();
+  int FlushBlock();
+
+  FsWriteChannel* _channel;
+  SparseBinaryFileHeader _header;
+  bool _header_written = false;
+  uint64_t _key_num = 0;
+  std::vector<uint64_t> _keys;
+  std::vector<uint32_t> _sizes;
+  std::vector<float> _values;
+};
+
+// Called on each block of keys, sizes and values of a binary file.
+using SparseBinaryBlockFunc = std::function<void(const uint64_t* keys,
+                                                 const uint32_t* sizes,
+                                                 const float* values,
+                                                 size_t key_num)>;
+
+// Read a binary file from `channel`, return 0 on success and -1 if the file is
+// broken, or has a value of more than `max_value_dim` floats.
+int ReadSparseBinary(FsReadChannel* channel,
+                     uint32_t max_value_dim,
+                     const SparseBinaryBlockFunc& func);
+
+// Like ReadSparseBinary, but maps the local file and passes the columns in the
+// mapping to `func` without copying.
+int ReadSparseBinaryMapped(const std::string& path,
+                           uint32_t max_value_dim,
+                           const SparseBinaryBlockFunc& func);
+
+}  // namespace distributed
+}  // namespace paddle
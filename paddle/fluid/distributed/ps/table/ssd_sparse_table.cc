@@ -25,6 +25,10 @@ PD_DECLARE_bool(pserver_create_value_when_push);
 PD_DECLARE_bool(pserver_enable_create_feasign_randomly);
 PD_DEFINE_bool(pserver_open_strict_check, false, "pserver_open_strict_check");
 PD_DEFINE_int32(pserver_load_batch_size, 5000, "load batch size for ssd");
+PD_DEFINE_int32(pserver_ssd_value_cache_mb,
+                0,
+                "memory budget in MB of the cache of the values evicted into "
+                "rocksdb, 0 to disable it");
 PHI_DEFINE_EXPORTED_string(rocksdb_path,
                            "database",
                            "path of sparse table rocksdb file");
@@ -34,8 +38,21 @@ namespace distributed {
 
 int32_t SSDSparseTable::Initialize() {
   MemorySparseTable::Initialize();
+  if (!_delta_keys.empty()) {
+    // the values in rocksdb are not tracked
+    LOG(WARNING) << "SSDSparseTable does not support delta save";
+    _delta_keys.clear();
+  }
   _db = ::paddle::distributed::RocksDBHandler::GetInstance();
   _db->initialize(FLAGS_rocksdb_path, _real_local_shard_num);
+  // at most one read of each shard task is in flight
+  _read_task_pool.reset(new ::ThreadPool(_shards_task_pool.size()));
+  if (FLAGS_pserver_ssd_value_cache_mb > 0 && _real_local_shard_num > 0) {
+    _value_cache.Initialize(
+        _real_local_shard_num,
+        static_cast<size_t>(FLAGS_pserver_ssd_value_cache_mb) << 20,
+        _value_accessor->GetAccessorInfo().size);
+  }
   VLOG(0) << "initialize SSDSparseTable succ";
   VLOG(0) << "SSD FLAGS_pserver_print_missed_key_num_every_push:"
           << FLAGS_pserver_print_missed_key_num_every_push;
@@ -94,12 +111,6 @@ int32_t SSDSparseTable::PullSparse(float* pull_values,
                                    const uint64_t* keys,
                                    size_t num) {
   CostTimer timer("pserver_downpour_sparse_select_all");
-  size_t value_size = _value_accessor->GetAccessorInfo().size / sizeof(float);
-  size_t mf_value_size =
-      _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
-  size_t select_value_size =
-      _value_accessor->GetAccessorInfo().select_size / sizeof(float);
-
   {  // 从table取值 or create
     std::vector<std::future<int>> tasks(_real_local_shard_num);
     std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(
@@ -113,74 +124,9 @@ int32_t SSDSparseTable::PullSparse(float* pull_values,
     for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
       tasks[shard_id] =
           _shards_task_pool[shard_id % _shards_task_pool.size()]->enqueue(
-              [this,
-               shard_id,
-               &task_keys,
-               value_size,
-               mf_value_size,
-               select_value_size,
-               pull_values,
-               &missed_keys]() -> int {
-                auto& keys = task_keys[shard_id];
-                auto& local_shard = _local_shards[shard_id];
-                float data_buffer[value_size];  // NOLINT
-                float* data_buffer_ptr = data_buffer;
-                for (size_t i = 0; i < keys.size(); ++i) {
-                  uint64_t key = keys[i].first;
-                  auto itr = local_shard.find(key);
-                  size_t data_size = value_size - mf_value_size;
-                  if (itr == local_shard.end()) {
-                    // pull rocksdb
-                    std::string tmp_string("");
-                    if (_db->get(shard_id,
-                                 reinterpret_cast<char*>(&key),
-                                 sizeof(uint64_t),
-                                 tmp_string) > 0) {
-                      ++missed_keys;
-                      if (FLAGS_pserver_create_value_when_push) {
-                        memset(data_buffer, 0, sizeof(float) * data_size);
-                      } else {
-                        auto& feature_value = local_shard[key];
-                        feature_value.resize(data_size);
-                        float* data_ptr =
-                            const_cast<float*>(feature_value.data());
-                        _value_accessor->Create(&data_buffer_ptr, 1);
-                        memcpy(data_ptr,
-                               data_buffer_ptr,
-                               data_size * sizeof(float));
-                      }
-                    } else {
-                      data_size = tmp_string.size() / sizeof(float);
-                      memcpy(data_buffer_ptr,
-                             ::paddle::string::str_to_float(tmp_string),
-                             data_size * sizeof(float));
-                      // from rocksdb to mem
-                      auto& feature_value = local_shard[key];
-                      feature_value.resize(data_size);
-                      memcpy(const_cast<float*>(feature_value.data()),
-                             data_buffer_ptr,
-                             data_size * sizeof(float));
-                      _db->del_data(shard_id,
-                                    reinterpret_cast<char*>(&key),
-                                    sizeof(uint64_t));
-                    }
-                  } else {
-                    data_size = itr.value().size();
-                    memcpy(data_buffer_ptr,
-                           itr.value().data(),
-                           data_size * sizeof(float));
-                  }
-                  for (size_t mf_idx = data_size; mf_idx < value_size;
-                       ++mf_idx) {
-                    data_buffer[mf_idx] = 0.0;
-                  }
-                  int pull_data_idx = keys[i].second;
-                  float* select_data =
-                      pull_values + pull_data_idx * select_value_size;
-                  _value_accessor->Select(
-                      &select_data, (const float**)&data_buffer_ptr, 1);
-                }
-                return 0;
+              [this, shard_id, &task_keys, pull_values, &missed_keys]() -> int {
+                return PullSparseShard(
+                    shard_id, task_keys[shard_id], pull_values, &missed_keys);
               });
     }
     for (int i = 0; i < _real_local_shard_num; ++i) {
@@ -189,11 +135,139 @@ int32_t SSDSparseTable::PullSparse(float* pull_values,
     if (FLAGS_pserver_print_missed_key_num_every_push) {
       LOG(WARNING) << "total pull keys:" << num
                    << " missed_keys:" << missed_keys.load();
+      if (_value_cache.Enabled()) {
+        LOG(WARNING) << "ssd value cache " << _value_cache.StatString();
+      }
     }
   }
   return 0;
 }
 
+int32_t SSDSparseTable::PullSparseShard(
+    int shard_id,
+    const std::vector<std::pair<uint64_t, int>>& keys,
+    float* pull_values,
+    std::atomic<uint32_t>* missed_keys) {
+  size_t value_size = _value_accessor->GetAccessorInfo().size / sizeof(float);
+  size_t mf_value_size =
+      _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
+  size_t select_value_size =
+      _value_accessor->GetAccessorInfo().select_size / sizeof(float);
+  auto& local_shard = _local_shards[shard_id];
+  std::vector<float> data_buffer(value_size);
+  float* data_buffer_ptr = data_buffer.data();
+
+  // select the value of keys[i] in data_buffer
+  auto select = [&](size_t i, size_t data_size) {
+    for (size_t mf_idx = data_size; mf_idx < value_size; ++mf_idx) {
+      data_buffer[mf_idx] = 0.0;
+    }
+    float* select_data = pull_values + keys[i].second * select_value_size;
+    _value_accessor->Select(&select_data, (const float**)&data_buffer_ptr, 1);
+  };
+  // from rocksdb to mem
+  auto move_to_mem = [&](uint64_t key, size_t data_size) {
+    auto& feature_value = local_shard[key];
+    feature_value.resize(data_size);
+    memcpy(feature_value.data(), data_buffer_ptr, data_size * sizeof(float));
+    _db->del_data(shard_id, reinterpret_cast<char*>(&key), sizeof(uint64_t));
+  };
+  auto merge = [&](RocksDBItem* item) {
+    for (size_t j = 0; j < item->status.size(); ++j) {
+      size_t i = item->batch_index[j];
+      uint64_t key = keys[i].first;
+      size_t data_size = value_size - mf_value_size;
+      auto itr = local_shard.find(key);
+      if (itr != local_shard.end()) {
+        // moved to mem by the same key earlier in the batch
+        data_size = itr.value().size();
+        memcpy(data_buffer_ptr, itr.value().data(), data_size * sizeof(float));
+      } else if (item->status[j].IsNotFound()) {
+        ++*missed_keys;
+        if (FLAGS_pserver_create_value_when_push) {
+          memset(data_buffer_ptr, 0, sizeof(float) * data_size);
+        } else {
+          auto& feature_value = local_shard[key];
+          feature_value.resize(data_size);
+          _value_accessor->Create(&data_buffer_ptr, 1);
+          memcpy(feature_value.data(),
+                 data_buffer_ptr,
+                 data_size * sizeof(float));
+        }
+      } else {
+        data_size = item->batch_values[j].size() / sizeof(float);
+        memcpy(data_buffer_ptr,
+               item->batch_values[j].data(),
+               data_size * sizeof(float));
+        move_to_mem(key, data_size);
+      }
+      select(i, data_size);
+    }
+    item->reset();
+  };
+
+  // The keys missed in mem are read from rocksdb in batches by the read pool,
+  // while the rest keys are looked up in mem. A batch is merged when the next
+  // one is full, or at the end.
+  RocksDBCtx context;
+  RocksDBItem* cur_ctx = context.switch_item();
+  RocksDBItem* reading_ctx = nullptr;
+  std::future<void> reading;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    uint64_t key = keys[i].first;
+    size_t data_size = 0;
+    auto itr = local_shard.find(key);
+    if (itr != local_shard.end()) {
+      data_size = itr.value().size();
+      memcpy(data_buffer_ptr, itr.value().data(), data_size * sizeof(float));
+      select(i, data_size);
+      continue;
+    }
+    if (_value_cache.Take(shard_id, key, data_buffer_ptr, &data_size)) {
+      move_to_mem(key, data_size);
+      select(i, data_size);
+      continue;
+    }
+    cur_ctx->batch_index.push_back(i);
+    cur_ctx->batch_keys.emplace_back(
+        reinterpret_cast<const char*>(&keys[i].first), sizeof(uint64_t));
+    if (cur_ctx->batch_keys.size() == 1024) {
+      if (reading_ctx != nullptr) {
+        reading.wait();
+        merge(reading_ctx);
+      }
+      cur_ctx->batch_values.resize(cur_ctx->batch_keys.size());
+      cur_ctx->status.resize(cur_ctx->batch_keys.size());
+      reading = _read_task_pool->enqueue([this, shard_id, cur_ctx]() {
+        _db->multi_get(shard_id,
+                       cur_ctx->batch_keys.size(),
+                       cur_ctx->batch_keys.data(),
+                       cur_ctx->batch_values.data(),
+                       cur_ctx->status.data(),
+                       false);
+      });
+      reading_ctx = cur_ctx;
+      cur_ctx = context.switch_item();
+    }
+  }
+  if (reading_ctx != nullptr) {
+    reading.wait();
+    merge(reading_ctx);
+  }
+  if (!cur_ctx->batch_keys.empty()) {
+    cur_ctx->batch_values.resize(cur_ctx->batch_keys.size());
+    cur_ctx->status.resize(cur_ctx->batch_keys.size());
+    _db->multi_get(shard_id,
+                   cur_ctx->batch_keys.size(),
+                   cur_ctx->batch_keys.data(),
+                   cur_ctx->batch_values.data(),
+                   cur_ctx->status.data(),
+                   false);
+    merge(cur_ctx);
+  }
+  return 0;
+}
+
 int32_t SSDSparseTable::PullSparsePtr(int shard_id,
                                       char** pull_values,
                                       const uint64_t* pull_keys,
@@ -217,6 +291,18 @@ int32_t SSDSparseTable::PullSparsePtr(int shard_id,
     for (size_t i = 0; i < num; ++i) {
       uint64_t key = pull_keys[i];
       auto itr = local_shard.find(key);
+      size_t data_size = 0;
+      if (itr == local_shard.end() &&
+          _value_cache.Take(shard_id, key, data_buffer_ptr, &data_size)) {
+        // from the value cache to mem
+        auto& feature_value = local_shard[key];
+        feature_value.resize(data_size);
+        memcpy(
+            feature_value.data(), data_buffer_ptr, data_size * sizeof(float));
+        _db->del_data(
+            shard_id, reinterpret_cast<char*>(&key), sizeof(uint64_t));
+        itr = local_shard.find(key);
+      }
       if (itr == local_shard.end()) {
         cur_ctx->batch_index.push_back(i);
         cur_ctx->batch_keys.emplace_back(
@@ -548,6 +634,9 @@ int32_t SSDSparseTable::Shrink(const std::string& param) {
         ++it;
       }
     }
+    shard.compact();
+    // the values in rocksdb are decayed or deleted
+    _value_cache.Clear(i);
     auto* it = _db->get_iterator(i);
     for (it->SeekToFirst(); it->Valid(); it->Next()) {
       if (_value_accessor->Shrink(
@@ -582,15 +671,20 @@ int32_t SSDSparseTable::UpdateTable() {
                  sizeof(uint64_t),
                  reinterpret_cast<const char*>(it.value().data()),
                  it.value().size() * sizeof(float));
+        _value_cache.Put(i, it.key(), it.value().data(), it.value().size());
         count++;
         it = shard.erase(it);
       } else {
         ++it;
       }
     }
+    shard.compact();
     _db->flush(i);
   }
   LOG(INFO) << "Table>> update count: " << count;
+  if (_value_cache.Enabled()) {
+    LOG(INFO) << "Table>> ssd value cache " << _value_cache.StatString();
+  }
   return 0;
 }
 
@@ -613,6 +707,10 @@ int32_t SSDSparseTable::Save(const std::string& path,
     }
   }
 #endif
+  if (atoi(param.c_str()) == 6) {
+    LOG(WARNING) << "SSDSparseTable does not support delta save";
+    return -1;
+  }
   std::lock_guard<std::mutex> guard(_table_mutex);
 #ifdef PADDLE_WITH_HETERPS
   int save_param = atoi(param.c_str());
@@ -2592,12 +2690,17 @@ int32_t SSDSparseTable::Load(const std::string& path,
   }
 
   int load_param = atoi(param.c_str());
+  if (load_param == 6) {
+    LOG(WARNING) << "SSDSparseTable does not support delta load";
+    return -1;
+  }
   if (file_list.empty()) {
     LOG(WARNING) << "SSDSparseTable load file is empty, path:" << path;
     return -1;
   }
   _value_accessor->SetDayId(_day_id);
   VLOG(1) << " Load Set Dayid:" << _day_id;
+  _value_cache.Clear();
   if (load_param > 3) {
     size_t expect_shard_num = _sparse_table_shard_num;
     if (file_list.size() != expect_shard_num) {
@@ -3164,6 +3267,10 @@ int32_t SSDSparseTable::CacheTable(uint16_t pass_id) {
                           << status.getState();
                   abort();
                 }
+                _value_cache.Put(shard_id,
+                                 tmp_key,
+                                 tmp_value.data(),
+                                 tmp_value.size());
               }
               status = sst_writer.Finish();
               if (!status.ok()) {
@@ -3189,6 +3296,7 @@ int32_t SSDSparseTable::CacheTable(uint16_t pass_id) {
                 ++it;
               }
             }
+            shard.compact();
           }
           return 0;
         });
@@ -14,8 +14,11 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/ps/table/depends/rocksdb_warpper.h"
+#include "paddle/fluid/distributed/ps/table/depends/ssd_value_cache.h"
 #include "paddle/fluid/distributed/ps/table/memory_sparse_table.h"
 
 #if defined(PADDLE_WITH_HETERPS) && defined(PADDLE_WITH_PSCORE)
@@ -135,7 +138,16 @@ class SSDSparseTable : public MemorySparseTable {
   void SetDayId(int day_id) override;
 
  private:
+  // Pull the keys of a shard, the keys missed in mem are read from rocksdb by
+  // multi_get in batches.
+  int32_t PullSparseShard(int shard_id,
+                          const std::vector<std::pair<uint64_t, int>>& keys,
+                          float* pull_values,
+                          std::atomic<uint32_t>* missed_keys);
+
   RocksDBHandler* _db;
+  std::unique_ptr<::ThreadPool> _read_task_pool;
+  SSDValueCache _value_cache;
   int64_t _cache_tk_size;
   double _local_show_threshold{0.0};
   std::vector<paddle::framework::Channel<std::string>> _fs_channel;
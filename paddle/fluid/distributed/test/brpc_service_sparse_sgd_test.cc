@@ -14,8 +14,12 @@ limitations under the License. */
 
 #include <unistd.h>
 
+#include <algorithm>
+#include <cmath>
+#include <map>
 #include <string>
 #include <thread>  // NOLINT
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "paddle/fluid/distributed/ps/service/brpc_ps_client.h"
@@ -309,3 +313,135 @@ void RunBrpcPushSparse() {
 }
 
 TEST(RunBrpcPushSparse, Run) { RunBrpcPushSparse(); }
+
+// Add a sparse table like the table 0, but with the values initialized to 0,
+// so that the tables of the same updates have the same values.
+void AddZeroInitSparseTableProto(::paddle::distributed::PSParameter* fleet_desc,
+                                 uint32_t table_id,
+                                 bool compress) {
+  std::vector<::paddle::distributed::TableParameter*> table_protos = {
+      fleet_desc->mutable_server_param()
+          ->mutable_downpour_server_param()
+          ->add_downpour_table_param()};
+  if (fleet_desc->has_worker_param()) {
+    table_protos.push_back(fleet_desc->mutable_worker_param()
+                               ->mutable_downpour_worker_param()
+                               ->add_downpour_table_param());
+  }
+  for (auto* table_proto : table_protos) {
+    GetDownpourSparseTableProto(table_proto);
+    table_proto->set_table_id(table_id);
+    table_proto->set_sparse_rpc_compress(compress);
+    auto* accessor_config = table_proto->mutable_accessor();
+    accessor_config->mutable_embed_sgd_param()
+        ->mutable_naive()
+        ->set_initial_range(0);
+    accessor_config->mutable_embedx_sgd_param()
+        ->mutable_naive()
+        ->set_initial_range(0);
+  }
+}
+
+// Push the same gradients to the sparse table 1 and the table 2, which only
+// differ in sparse_rpc_compress, and compare the values pulled from them.
+void RunBrpcPushSparseCompress() {
+  setenv("http_proxy", "", 1);
+  setenv("https_proxy", "", 1);
+  port_ = 4210;
+  host_sign_list_.clear();
+  auto ph_host = paddle::distributed::PSHost(ip_, port_, 0);
+  host_sign_list_.push_back(ph_host.SerializeToString());
+
+  std::thread server_thread([] {
+    ::paddle::distributed::PSParameter server_proto = GetServerProto();
+    AddZeroInitSparseTableProto(&server_proto, 1, false);
+    AddZeroInitSparseTableProto(&server_proto, 2, true);
+    auto _ps_env = paddle::distributed::PaddlePSEnvironment();
+    _ps_env.SetPsServers(&host_sign_list_, 1);
+    pserver_ptr_ = std::shared_ptr<paddle::distributed::PSServer>(
+        paddle::distributed::PSServerFactory::Create(server_proto));
+    std::vector<framework::ProgramDesc> empty_vec;
+    empty_vec.emplace_back();
+    pserver_ptr_->Configure(server_proto, _ps_env, 0, empty_vec);
+    pserver_ptr_->Start(ip_, port_);
+  });
+  sleep(1);
+
+  ::paddle::distributed::PSParameter worker_proto = GetWorkerProto();
+  AddZeroInitSparseTableProto(&worker_proto, 1, false);
+  AddZeroInitSparseTableProto(&worker_proto, 2, true);
+  std::map<uint64_t, std::vector<paddle::distributed::Region>> dense_regions;
+  dense_regions[0] = {};
+  paddle::distributed::PaddlePSEnvironment _ps_env;
+  _ps_env.SetPsServers(&host_sign_list_, host_sign_list_.size());
+  worker_ptr_ = std::shared_ptr<paddle::distributed::PSClient>(
+      paddle::distributed::PSClientFactory::Create(worker_proto));
+  worker_ptr_->Configure(worker_proto, dense_regions, _ps_env, 0);
+
+  const size_t key_num = 10;
+  const size_t pull_dim = 10;
+  const size_t push_dim = 13;
+  std::vector<uint64_t> fea_keys(key_num);
+  // slot, show and click are sent in fp32, the gradients are not exact in
+  // fp16
+  std::vector<float> fea_grads(key_num * push_dim);
+  std::vector<const float*> fea_grad_ptr(key_num);
+  for (size_t idx = 0; idx < key_num; ++idx) {
+    fea_keys[idx] = idx * 1000 + 7;
+    float* grad = fea_grads.data() + idx * push_dim;
+    grad[0] = 1.0;
+    grad[1] = 1.0;
+    grad[2] = 1.0;
+    for (size_t j = 3; j < push_dim; ++j) {
+      grad[j] = 0.1f * (idx + 1) + 0.013f * j;
+    }
+    fea_grad_ptr[idx] = grad;
+  }
+
+  std::map<uint32_t, std::vector<float>> fea_values;
+  for (uint32_t table_id : {1, 2}) {
+    std::vector<float>& values = fea_values[table_id];
+    values.resize(key_num * pull_dim);
+    std::vector<float*> fea_value_ptr(key_num);
+    for (size_t idx = 0; idx < key_num; ++idx) {
+      fea_value_ptr[idx] = values.data() + idx * pull_dim;
+    }
+    auto pull_status = worker_ptr_->PullSparse(
+        fea_value_ptr.data(), table_id, fea_keys.data(), key_num, true);
+    ASSERT_EQ(pull_status.get(), 0);
+    // the first push expands the embedx, and the second one updates it
+    for (int step = 0; step < 2; ++step) {
+      auto* closure = new paddle::distributed::DownpourBrpcClosure(
+          1, [](void* done) {
+            auto* push_closure =
+                (paddle::distributed::DownpourBrpcClosure*)done;
+            push_closure->set_promise_value(push_closure->check_response(
+                0, paddle::distributed::PS_PUSH_SPARSE_TABLE));
+          });
+      auto push_status = worker_ptr_->PushSparseRawGradient(
+          table_id, fea_keys.data(), fea_grad_ptr.data(), key_num, closure);
+      ASSERT_EQ(push_status.get(), 0);
+    }
+    pull_status = worker_ptr_->PullSparse(
+        fea_value_ptr.data(), table_id, fea_keys.data(), key_num, true);
+    ASSERT_EQ(pull_status.get(), 0);
+  }
+
+  bool updated = false;
+  for (size_t i = 0; i < key_num * pull_dim; ++i) {
+    float expected = fea_values[1][i];
+    updated = updated || expected != 0;
+    // two fp16 roundings of the pushed gradients and one of the pulled value
+    EXPECT_NEAR(fea_values[2][i],
+                expected,
+                3e-3 * std::max(1.0f, std::fabs(expected)))
+        << "the " << i << "-th value";
+  }
+  EXPECT_TRUE(updated);
+
+  worker_ptr_->StopServer();
+  worker_ptr_->FinalizeWorker();
+  server_thread.join();
+}
+
+TEST(RunBrpcPushSparse, Compress) { RunBrpcPushSparseCompress(); }
@@ -0,0 +1,247 @@
+/* Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/table/ctr_quant_accessor.h"
+
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/common/registerer.h"
+#include "paddle/fluid/distributed/ps/table/sparse_sgd_rule.h"
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+
+namespace paddle::distributed {
+REGISTER_PSCORE_CLASS(SparseValueSGDRule, SparseAdaGradSGDRule);
+REGISTER_PSCORE_CLASS(SparseValueSGDRule, StdAdaGradSGDRule);
+
+TableAccessorParameter gen_quant_param(const std::string& quant_type) {
+  TableAccessorParameter param;
+  param.set_accessor_class("CtrQuantAccessor");
+  param.set_fea_dim(11);
+  param.set_embedx_dim(8);
+  param.set_embedx_threshold(0);
+  param.mutable_ctr_accessor_param()->set_nonclk_coeff(0.2);
+  param.mutable_ctr_accessor_param()->set_click_coeff(1);
+  param.mutable_ctr_accessor_param()->set_embedx_quant_type(quant_type);
+
+  param.mutable_embed_sgd_param()->set_name("StdAdaGradSGDRule");
+  auto* adagrad_param = param.mutable_embed_sgd_param()->mutable_adagrad();
+  adagrad_param->set_learning_rate(0.05);
+  adagrad_param->set_initial_range(0.3);
+  adagrad_param->set_initial_g2sum(3.0);
+  adagrad_param->add_weight_bounds(-10.0);
+  adagrad_param->add_weight_bounds(10.0);
+
+  param.mutable_embedx_sgd_param()->set_name("SparseAdaGradSGDRule");
+  adagrad_param = param.mutable_embedx_sgd_param()->mutable_adagrad();
+  adagrad_param->set_learning_rate(0.05);
+  adagrad_param->set_initial_range(0.3);
+  adagrad_param->set_initial_g2sum(3.0);
+  adagrad_param->add_weight_bounds(-10.0);
+  adagrad_param->add_weight_bounds(10.0);
+  return param;
+}
+
+std::vector<float> SelectValue(ValueAccessor* acc, const float* value) {
+  std::vector<float> select_value(acc->GetAccessorInfo().select_dim);
+  float* select_ptr = select_value.data();
+  acc->Select(&select_ptr, &value, 1);
+  return select_value;
+}
+
+// Train the same values with CtrCommonAccessor and CtrQuantAccessor, and
+// compare the pulled embedx_w.
+void CheckQuantAccuracy(const std::string& quant_type, float max_error) {
+  TableAccessorParameter param = gen_quant_param(quant_type);
+  CtrCommonAccessor common_acc;
+  ASSERT_EQ(common_acc.Configure(param), 0);
+  ASSERT_EQ(common_acc.Initialize(), 0);
+  CtrQuantAccessor quant_acc;
+  ASSERT_EQ(quant_acc.Configure(param), 0);
+  ASSERT_EQ(quant_acc.Initialize(), 0);
+  ASSERT_LT(quant_acc.GetAccessorInfo().size,
+            common_acc.GetAccessorInfo().size);
+  ASSERT_EQ(quant_acc.GetAccessorInfo().select_dim,
+            common_acc.GetAccessorInfo().select_dim);
+  ASSERT_EQ(quant_acc.GetAccessorInfo().update_dim,
+            common_acc.GetAccessorInfo().update_dim);
+
+  std::vector<float> common_value(common_acc.GetAccessorInfo().dim);
+  float* common_ptr = common_value.data();
+  ASSERT_EQ(common_acc.Create(&common_ptr, 1), 0);
+  // the checkpoints of CtrCommonAccessor can be loaded
+  std::vector<float> quant_value(quant_acc.GetAccessorInfo().dim);
+  std::string text =
+      common_acc.ParseToString(common_ptr, common_value.size());
+  ASSERT_EQ(quant_acc.ParseFromString(text, quant_value.data()),
+            static_cast<int>(quant_value.size()));
+  float* quant_ptr = quant_value.data();
+
+  size_t update_dim = common_acc.GetAccessorInfo().update_dim;
+  std::vector<float> push_value(update_dim);
+  const float* push_ptr = push_value.data();
+  for (int step = 0; step < 200; ++step) {
+    push_value[CtrCommonAccessor::CtrCommonPushValue::SlotIndex()] = 1;
+    push_value[CtrCommonAccessor::CtrCommonPushValue::ShowIndex()] = 1;
+    push_value[CtrCommonAccessor::CtrCommonPushValue::ClickIndex()] = step % 2;
+    for (size_t i = CtrCommonAccessor::CtrCommonPushValue::EmbedGIndex();
+         i < update_dim;
+         ++i) {
+      push_value[i] = 0.01 * std::sin(step * 0.1 + i);
+    }
+    ASSERT_EQ(common_acc.Update(&common_ptr, &push_ptr, 1), 0);
+    ASSERT_EQ(quant_acc.Update(&quant_ptr, &push_ptr, 1), 0);
+  }
+
+  auto common_select = SelectValue(&common_acc, common_ptr);
+  auto quant_select = SelectValue(&quant_acc, quant_ptr);
+  // show, click and embed_w are not quantized
+  for (int i = 0; i < CtrCommonAccessor::CtrCommonPullValue::EmbedxWIndex();
+       ++i) {
+    ASSERT_FLOAT_EQ(quant_select[i], common_select[i]);
+  }
+  float error = 0;
+  for (size_t i = CtrCommonAccessor::CtrCommonPullValue::EmbedxWIndex();
+       i < common_select.size();
+       ++i) {
+    error = std::max(error, std::fabs(quant_select[i] - common_select[i]));
+  }
+  VLOG(0) << quant_type << " max error of embedx_w: " << error;
+  ASSERT_LT(error, max_error);
+
+  // save and load again
+  text = quant_acc.ParseToString(quant_ptr, quant_value.size());
+  std::vector<float> loaded_value(quant_acc.GetAccessorInfo().dim);
+  ASSERT_EQ(quant_acc.ParseFromString(text, loaded_value.data()),
+            static_cast<int>(loaded_value.size()));
+  auto loaded_select = SelectValue(&quant_acc, loaded_value.data());
+  for (size_t i = 0; i < quant_select.size(); ++i) {
+    ASSERT_NEAR(loaded_select[i], quant_select[i], 1e-5);
+  }
+}
+
+TEST(CtrQuantAccessor, FP16) { CheckQuantAccuracy("fp16", 0.01); }
+
+TEST(CtrQuantAccessor, BF16) { CheckQuantAccuracy("bf16", 0.06); }
+
+TEST(CtrQuantAccessor, INT8) { CheckQuantAccuracy("int8", 0.1); }
+
+TEST(CtrQuantAccessor, WithoutMF) {
+  TableAccessorParameter param = gen_quant_param("int8");
+  CtrQuantAccessor acc;
+  ASSERT_EQ(acc.Configure(param), 0);
+  ASSERT_EQ(acc.Initialize(), 0);
+  size_t mf_dim = acc.GetAccessorInfo().mf_size / sizeof(float);
+  // the values without mf are zero padded by the tables
+  std::vector<float> value(acc.GetAccessorInfo().dim, 0);
+  float* value_ptr = value.data();
+  ASSERT_EQ(acc.Create(&value_ptr, 1), 0);
+  std::fill(value.end() - mf_dim, value.end(), 0);
+  ASSERT_FALSE(acc.HasMF(value.size() - mf_dim));
+  auto select_value = SelectValue(&acc, value_ptr);
+  for (size_t i = CtrCommonAccessor::CtrCommonPullValue::EmbedxWIndex();
+       i < select_value.size();
+       ++i) {
+    ASSERT_FLOAT_EQ(select_value[i], 0);
+  }
+}
+
+// The number of values per second of Select, Update and ParseToString of
+// the accessor on value_num values.
+void BenchmarkAccessor(ValueAccessor* acc, size_t value_num) {
+  const auto& info = acc->GetAccessorInfo();
+  std::vector<float> values(value_num * info.dim);
+  std::vector<float*> value_ptrs(value_num);
+  for (size_t i = 0; i < value_num; ++i) {
+    value_ptrs[i] = values.data() + i * info.dim;
+  }
+  ASSERT_EQ(acc->Create(value_ptrs.data(), value_num), 0);
+  std::vector<const float*> const_value_ptrs(value_ptrs.begin(),
+                                             value_ptrs.end());
+
+  std::vector<float> select_values(value_num * info.select_dim);
+  std::vector<float*> select_ptrs(value_num);
+  std::vector<float> push_values(value_num * info.update_dim);
+  std::vector<const float*> push_ptrs(value_num);
+  for (size_t i = 0; i < value_num; ++i) {
+    select_ptrs[i] = select_values.data() + i * info.select_dim;
+    float* push_ptr = push_values.data() + i * info.update_dim;
+    push_ptr[CtrCommonAccessor::CtrCommonPushValue::ShowIndex()] = 1;
+    for (size_t j = CtrCommonAccessor::CtrCommonPushValue::EmbedGIndex();
+         j < info.update_dim;
+         ++j) {
+      push_ptr[j] = 0.01 * std::sin(i + j);
+    }
+    push_ptrs[i] = push_ptr;
+  }
+
+  auto seconds = [](auto&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+  };
+  const int rounds = 10;
+  double select_sec = seconds([&] {
+    for (int r = 0; r < rounds; ++r) {
+      acc->Select(select_ptrs.data(), const_value_ptrs.data(), value_num);
+    }
+  });
+  double update_sec = seconds([&] {
+    for (int r = 0; r < rounds; ++r) {
+      acc->Update(value_ptrs.data(), push_ptrs.data(), value_num);
+    }
+  });
+  size_t text_size = 0;
+  double parse_sec = seconds([&] {
+    for (size_t i = 0; i < value_num; ++i) {
+      text_size += acc->ParseToString(value_ptrs[i], info.dim).size();
+    }
+  });
+  ASSERT_GT(text_size, 0UL);
+
+  std::cout << "bytes per value: " << info.size
+            << ", Select: " << rounds * value_num / select_sec / 1e6
+            << " M/s, Update: " << rounds * value_num / update_sec / 1e6
+            << " M/s, ParseToString: " << value_num / parse_sec / 1e6
+            << " M/s" << std::endl;
+}
+
+// Compare the throughput of CtrCommonAccessor and CtrQuantAccessor. The
+// benchmark is disabled by default, run it with
+// --gtest_also_run_disabled_tests.
+TEST(CtrQuantAccessor, DISABLED_Benchmark) {
+  const size_t value_num = 1 << 20;
+  for (const std::string& quant_type : {"fp16", "bf16", "int8"}) {
+    TableAccessorParameter param = gen_quant_param(quant_type);
+    if (quant_type == "fp16") {
+      CtrCommonAccessor common_acc;
+      ASSERT_EQ(common_acc.Configure(param), 0);
+      ASSERT_EQ(common_acc.Initialize(), 0);
+      std::cout << "CtrCommonAccessor, ";
+      BenchmarkAccessor(&common_acc, value_num);
+    }
+    CtrQuantAccessor quant_acc;
+    ASSERT_EQ(quant_acc.Configure(param), 0);
+    ASSERT_EQ(quant_acc.Initialize(), 0);
+    std::cout << "CtrQuantAccessor " << quant_type << ", ";
+    BenchmarkAccessor(&quant_acc, value_num);
+  }
+}
+
+}  // namespace paddle::distributed
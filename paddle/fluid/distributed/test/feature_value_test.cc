@@ -14,6 +14,11 @@ limitations under the License. */
 
 #include "paddle/fluid/distributed/ps/table/depends/feature_value.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <iostream>
+#include <random>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -45,4 +50,130 @@ TEST(BENCHMARK, LargeScaleKV) {
   ASSERT_FLOAT_EQ(value_data[3], 0.3);
 }
 
+TEST(FixedFeatureValueSlab, Compact) {
+  typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
+  const size_t dim = 8;
+  const uint64_t key_num = 100000;
+  shard_type shard;
+  shard.set_value_dim(dim);
+  for (uint64_t key = 0; key < key_num; ++key) {
+    // Every 7th value is larger than the dim and stored on the heap.
+    size_t size = key % 7 == 0 ? dim + 2 : dim;
+    auto& feature_value = shard[key];
+    feature_value.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+      feature_value.data()[i] = static_cast<float>(key + i);
+    }
+  }
+  for (auto it = shard.begin(); it != shard.end();) {
+    if (it.key() % 10 != 0) {
+      it = shard.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ASSERT_GT(shard.compact(), 0UL);
+  ASSERT_EQ(shard.size(), key_num / 10);
+  for (uint64_t key = 0; key < key_num; key += 10) {
+    auto it = shard.find(key);
+    ASSERT_TRUE(it != shard.end());
+    size_t size = key % 7 == 0 ? dim + 2 : dim;
+    ASSERT_EQ(it.value().size(), size);
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_FLOAT_EQ(it.value().data()[i], static_cast<float>(key + i));
+    }
+  }
+}
+
+TEST(SparseTableShard, FindBatch) {
+  typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
+  shard_type shard;
+  shard.set_value_dim(4);
+  std::mt19937_64 rng(0);
+  std::vector<uint64_t> keys;
+  for (int i = 0; i < 10000; ++i) {
+    keys.push_back(rng());
+    shard[keys.back()].resize(4);
+  }
+
+  // A batch of keys in random buckets, with duplicated and missed keys.
+  std::vector<uint64_t> batch_keys;
+  for (size_t i = 0; i < shard_type::kFindBatchSize; ++i) {
+    batch_keys.push_back(i % 3 == 0 ? rng() : keys[rng() % keys.size()]);
+  }
+  batch_keys[1] = batch_keys[2];
+  std::vector<FixedFeatureValue*> values(batch_keys.size());
+  shard.find_batch(batch_keys.data(), batch_keys.size(), values.data());
+  for (size_t i = 0; i < batch_keys.size(); ++i) {
+    auto it = shard.find(batch_keys[i]);
+    if (it == shard.end()) {
+      ASSERT_EQ(values[i], nullptr);
+    } else {
+      ASSERT_EQ(values[i], it.value_ptr());
+    }
+  }
+}
+
+// Look up random keys of a shard much larger than the cache, one by one with
+// find and in blocks with find_batch. Like PullSparse, the values are copied
+// to an output buffer. The benchmark is disabled by default, run it with
+// --gtest_also_run_disabled_tests.
+TEST(SparseTableShard, DISABLED_FindBatchBenchmark) {
+  typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
+  const size_t dim = 8;
+  const size_t key_num = 1 << 23;
+  const size_t lookup_num = 1 << 23;
+  shard_type shard;
+  shard.set_value_dim(dim);
+  std::mt19937_64 rng(0);
+  std::vector<uint64_t> keys(key_num);
+  for (auto& key : keys) {
+    key = rng();
+    auto& feature_value = shard[key];
+    feature_value.resize(dim);
+    feature_value.data()[0] = static_cast<float>(key % 100);
+  }
+  std::vector<uint64_t> lookup_keys(lookup_num);
+  for (auto& key : lookup_keys) {
+    key = keys[rng() % key_num];
+  }
+
+  for (int round = 0; round < 3; ++round) {
+    std::vector<float> output(shard_type::kFindBatchSize * dim);
+    auto start = std::chrono::steady_clock::now();
+    double find_sum = 0;
+    for (size_t i = 0; i < lookup_num; ++i) {
+      float* out = output.data() + i % shard_type::kFindBatchSize * dim;
+      memcpy(out,
+             shard.find(lookup_keys[i]).value().data(),
+             dim * sizeof(float));
+      find_sum += out[0];
+    }
+    auto end = std::chrono::steady_clock::now();
+    double find_sec = std::chrono::duration<double>(end - start).count();
+
+    start = std::chrono::steady_clock::now();
+    double batch_sum = 0;
+    std::vector<FixedFeatureValue*> values(shard_type::kFindBatchSize);
+    for (size_t begin = 0; begin < lookup_num;
+         begin += shard_type::kFindBatchSize) {
+      size_t num = std::min(shard_type::kFindBatchSize, lookup_num - begin);
+      shard.find_batch(lookup_keys.data() + begin, num, values.data());
+      for (size_t i = 0; i < num; ++i) {
+        float* out = output.data() + i * dim;
+        memcpy(out, values[i]->data(), dim * sizeof(float));
+        batch_sum += out[0];
+      }
+    }
+    end = std::chrono::steady_clock::now();
+    double batch_sec = std::chrono::duration<double>(end - start).count();
+    ASSERT_DOUBLE_EQ(find_sum, batch_sum);
+
+    std::cout << "keys: " << key_num << ", lookups: " << lookup_num
+              << ", find: " << lookup_num / find_sec / 1e6
+              << " M/s, find_batch: " << lookup_num / batch_sec / 1e6
+              << " M/s" << std::endl;
+  }
+}
+
 }  // namespace paddle::distributed
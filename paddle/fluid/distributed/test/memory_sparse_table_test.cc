@@ -22,9 +22,15 @@ limitations under the License. */
 
 #include "google/protobuf/text_format.h"
 #include "gtest/gtest.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/ps/table/table.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
 
+PD_DECLARE_bool(pserver_sparse_table_binary_save);
+PD_DECLARE_bool(pserver_sparse_table_delta_save);
+PD_DECLARE_int32(pserver_sparse_table_shrink_buckets_per_tick);
+PD_DECLARE_int32(pserver_sparse_table_shrink_tick_ms);
+
 namespace paddle {
 namespace distributed {
 
@@ -152,5 +158,184 @@ TEST(MemorySparseTable, SGD) {
   }
 }
 
+TableParameter CtrTableConfig() {
+  TableParameter table_config;
+  table_config.set_table_class("MemorySparseTable");
+  table_config.set_shard_num(10);
+
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(11);
+  accessor_config->set_embedx_dim(8);
+  accessor_config->set_embedx_threshold(5);
+  accessor_config->mutable_ctr_accessor_param()->set_nonclk_coeff(0.2);
+  accessor_config->mutable_ctr_accessor_param()->set_click_coeff(1);
+  accessor_config->mutable_ctr_accessor_param()->set_base_threshold(0.5);
+  accessor_config->mutable_ctr_accessor_param()->set_delta_threshold(0.2);
+  accessor_config->mutable_ctr_accessor_param()->set_delta_keep_days(16);
+  accessor_config->mutable_ctr_accessor_param()->set_show_click_decay_rate(
+      0.99);
+
+  accessor_config->mutable_embed_sgd_param()->set_name("SparseNaiveSGDRule");
+  auto *naive_param =
+      accessor_config->mutable_embed_sgd_param()->mutable_naive();
+  naive_param->set_learning_rate(0.1);
+  naive_param->set_initial_range(0.3);
+  naive_param->add_weight_bounds(-10.0);
+  naive_param->add_weight_bounds(10.0);
+
+  accessor_config->mutable_embedx_sgd_param()->set_name("SparseNaiveSGDRule");
+  naive_param = accessor_config->mutable_embedx_sgd_param()->mutable_naive();
+  naive_param->set_learning_rate(0.1);
+  naive_param->set_initial_range(0.3);
+  naive_param->add_weight_bounds(-10.0);
+  naive_param->add_weight_bounds(10.0);
+  return table_config;
+}
+
+void ExpectSameTable(MemorySparseTable *expected, MemorySparseTable *actual) {
+  ASSERT_EQ(actual->LocalSize(), expected->LocalSize());
+  for (int i = 0; i < 10; ++i) {
+    auto *shard =
+        static_cast<MemorySparseTable::shard_type *>(expected->GetShard(i));
+    auto *actual_shard =
+        static_cast<MemorySparseTable::shard_type *>(actual->GetShard(i));
+    for (auto it = shard->begin(); it != shard->end(); ++it) {
+      auto actual_it = actual_shard->find(it.key());
+      ASSERT_TRUE(actual_it != actual_shard->end());
+      ASSERT_EQ(actual_it.value().size(), it.value().size());
+      for (size_t j = 0; j < it.value().size(); ++j) {
+        ASSERT_FLOAT_EQ(actual_it.value().data()[j], it.value().data()[j]);
+      }
+    }
+  }
+}
+
+TEST(MemorySparseTable, BinarySaveLoad) {
+  int emb_dim = 8;
+  TableParameter table_config = CtrTableConfig();
+  FsClientParameter fs_config;
+  MemorySparseTable table;
+  table.SetShard(0, 1);
+  ASSERT_EQ(table.Initialize(table_config, fs_config), 0);
+
+  std::vector<uint64_t> keys;
+  for (uint64_t key = 0; key < 1000; ++key) {
+    keys.push_back(key);
+  }
+  std::vector<uint32_t> fres(keys.size(), 1);
+  std::vector<float> values(keys.size() * (emb_dim + 3));
+  TableContext pull_context;
+  pull_context.value_type = Sparse;
+  pull_context.pull_context.pull_value = PullSparseValue(keys, fres, emb_dim);
+  pull_context.pull_context.values = values.data();
+  table.Pull(pull_context);
+
+  std::string dirname = "memory_sparse_table_binary_test";
+  FLAGS_pserver_sparse_table_binary_save = true;
+  ASSERT_EQ(table.Save(dirname, "0"), 0);
+  FLAGS_pserver_sparse_table_binary_save = false;
+
+  MemorySparseTable loaded;
+  loaded.SetShard(0, 1);
+  ASSERT_EQ(loaded.Initialize(table_config, fs_config), 0);
+  ASSERT_EQ(loaded.Load(dirname, "0"), 0);
+  ExpectSameTable(&table, &loaded);
+  std::string cmd = "rm -rf " + dirname;
+  ASSERT_EQ(system(cmd.c_str()), 0);
+}
+
+// Push the keys in [begin, end) of the CtrTableConfig table, the keys without
+// show are shrunk.
+void PushShow(MemorySparseTable *table,
+              uint64_t begin,
+              uint64_t end,
+              float show) {
+  int emb_dim = 8;
+  std::vector<uint64_t> keys;
+  std::vector<float> values;
+  for (uint64_t key = begin; key < end; ++key) {
+    keys.push_back(key);
+    values.push_back(0);     // slot
+    values.push_back(show);  // show
+    values.push_back(show);  // click
+    for (int k = 0; k < emb_dim + 1; ++k) {
+      values.push_back(0.1);
+    }
+  }
+  ASSERT_EQ(table->PushSparse(keys.data(), values.data(), keys.size()), 0);
+}
+
+TEST(MemorySparseTable, DeltaSaveLoad) {
+  TableParameter table_config = CtrTableConfig();
+  FsClientParameter fs_config;
+  FLAGS_pserver_sparse_table_delta_save = true;
+  MemorySparseTable table;
+  table.SetShard(0, 1);
+  ASSERT_EQ(table.Initialize(table_config, fs_config), 0);
+  auto push = [&](uint64_t begin, uint64_t end, float show) {
+    PushShow(&table, begin, end, show);
+  };
+
+  std::string base = "memory_sparse_table_delta_test/base";
+  std::string delta1 = "memory_sparse_table_delta_test/delta1";
+  std::string delta2 = "memory_sparse_table_delta_test/delta2";
+  push(0, 50, 0);
+  push(50, 100, 1);
+  ASSERT_EQ(table.Save(base, "0"), 0);
+
+  push(50, 150, 1);
+  table.Shrink("");
+  ASSERT_EQ(table.LocalSize(), 100);
+  ASSERT_EQ(table.Save(delta1, "6"), 0);
+
+  push(120, 130, 1);
+  ASSERT_EQ(table.Save(delta2, "6"), 0);
+
+  MemorySparseTable loaded;
+  loaded.SetShard(0, 1);
+  ASSERT_EQ(loaded.Initialize(table_config, fs_config), 0);
+  ASSERT_EQ(loaded.Load(base, "0"), 0);
+  ASSERT_EQ(loaded.LocalSize(), 100);
+  ASSERT_EQ(loaded.Load(delta1, "6"), 0);
+  ASSERT_EQ(loaded.Load(delta2, "6"), 0);
+  ExpectSameTable(&table, &loaded);
+
+  // only the pushed keys are in the last delta
+  MemorySparseTable delta_only;
+  delta_only.SetShard(0, 1);
+  ASSERT_EQ(delta_only.Initialize(table_config, fs_config), 0);
+  ASSERT_EQ(delta_only.Load(delta2, "6"), 0);
+  ASSERT_EQ(delta_only.LocalSize(), 10);
+  FLAGS_pserver_sparse_table_delta_save = false;
+
+  std::string cmd = "rm -rf memory_sparse_table_delta_test";
+  ASSERT_EQ(system(cmd.c_str()), 0);
+}
+
+TEST(MemorySparseTable, BackgroundShrink) {
+  TableParameter table_config = CtrTableConfig();
+  FsClientParameter fs_config;
+  MemorySparseTable table;
+  table.SetShard(0, 1);
+  ASSERT_EQ(table.Initialize(table_config, fs_config), 0);
+  PushShow(&table, 0, 1000, 0);
+  PushShow(&table, 1000, 2000, 1);
+
+  FLAGS_pserver_sparse_table_shrink_buckets_per_tick = 8;
+  FLAGS_pserver_sparse_table_shrink_tick_ms = 1;
+  ASSERT_EQ(table.Shrink(""), 0);
+  // the pushes are served during the shrink
+  PushShow(&table, 1000, 2000, 1);
+  table.WaitShrink();
+  FLAGS_pserver_sparse_table_shrink_buckets_per_tick = 0;
+
+  auto stat = table.GetShrinkStat();
+  ASSERT_FALSE(stat.running);
+  ASSERT_EQ(stat.bucket_done, stat.bucket_num);
+  ASSERT_EQ(stat.erased, 1000UL);
+  ASSERT_EQ(table.LocalSize(), 1000);
+}
+
 }  // namespace distributed
 }  // namespace paddle
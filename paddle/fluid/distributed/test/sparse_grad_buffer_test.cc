@@ -0,0 +1,131 @@
+/* Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/service/communicator/communicator.h"
+
+namespace paddle::distributed {
+
+// Make a SelectedRows of the rows, the j-th value of the i-th row is
+// values[i] + j.
+static void MakeSparseGrad(int64_t height,
+                           const std::vector<int64_t>& rows,
+                           const std::vector<float>& values,
+                           int64_t dim,
+                           phi::SelectedRows* slr) {
+  slr->set_height(height);
+  *slr->mutable_rows() = rows;
+  auto* tensor = slr->mutable_value();
+  tensor->Resize(
+      common::make_ddim({static_cast<int64_t>(rows.size()), dim}));
+  float* data = tensor->mutable_data<float>(phi::CPUPlace());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    for (int64_t j = 0; j < dim; ++j) {
+      data[i * dim + j] = values[i] + j;
+    }
+  }
+}
+
+static std::vector<float> GetValues(const phi::SelectedRows& slr) {
+  const auto& tensor = slr.value();
+  const float* data = tensor.data<float>();
+  return std::vector<float>(data, data + tensor.numel());
+}
+
+TEST(SparseGradBuffer, MergeDuplicateIds) {
+  SparseGradBuffer buffer(4);
+  phi::SelectedRows grad;
+  // the id 1 appears twice in the first batch
+  MakeSparseGrad(100, {1, 2, 1}, {1, 2, 3}, 2, &grad);
+  EXPECT_EQ(buffer.Add(grad), 1);
+  // the id 2 appears in both batches
+  MakeSparseGrad(100, {2, 5}, {10, 20}, 2, &grad);
+  EXPECT_EQ(buffer.Add(grad), 2);
+  EXPECT_EQ(buffer.BatchNum(), 2);
+
+  phi::SelectedRows merged;
+  EXPECT_EQ(buffer.Take(&merged), 2);
+  EXPECT_EQ(merged.height(), 100);
+  EXPECT_EQ(merged.rows(), std::vector<int64_t>({1, 2, 5}));
+  EXPECT_EQ(merged.value().dims(), common::make_ddim({3, 2}));
+  EXPECT_EQ(GetValues(merged), std::vector<float>({4, 6, 12, 14, 20, 21}));
+
+  // the buffer is empty after it is taken
+  EXPECT_EQ(buffer.BatchNum(), 0);
+  phi::SelectedRows empty;
+  EXPECT_EQ(buffer.Take(&empty), 0);
+
+  // the next window does not see the ids of the last one, and the height
+  // of the last batch is kept
+  MakeSparseGrad(200, {5}, {1}, 2, &grad);
+  EXPECT_EQ(buffer.Add(grad), 1);
+  EXPECT_EQ(buffer.Take(&merged), 1);
+  EXPECT_EQ(merged.height(), 200);
+  EXPECT_EQ(merged.rows(), std::vector<int64_t>({5}));
+  EXPECT_EQ(merged.value().dims(), common::make_ddim({1, 2}));
+  EXPECT_EQ(GetValues(merged), std::vector<float>({1, 2}));
+}
+
+TEST(SparseGradBuffer, Dim) {
+  SparseGradBuffer buffer(4);
+  phi::SelectedRows grad;
+  // a batch without any id still counts, and does not set the dim
+  MakeSparseGrad(100, {}, {}, 3, &grad);
+  EXPECT_EQ(buffer.Add(grad), 1);
+  MakeSparseGrad(100, {7}, {1}, 3, &grad);
+  EXPECT_EQ(buffer.Add(grad), 2);
+  MakeSparseGrad(100, {7}, {1}, 4, &grad);
+  EXPECT_ANY_THROW(buffer.Add(grad));
+
+  phi::SelectedRows merged;
+  EXPECT_EQ(buffer.Take(&merged), 2);
+  EXPECT_EQ(merged.value().dims(), common::make_ddim({1, 3}));
+  EXPECT_EQ(GetValues(merged), std::vector<float>({1, 2, 3}));
+}
+
+TEST(SparseGradBuffer, AddBlocksWhenFull) {
+  SparseGradBuffer buffer(2);
+  phi::SelectedRows grad;
+  MakeSparseGrad(100, {1}, {1}, 1, &grad);
+  EXPECT_EQ(buffer.Add(grad), 1);
+  EXPECT_EQ(buffer.Add(grad), 2);
+
+  std::atomic<bool> added(false);
+  std::thread adder([&] {
+    phi::SelectedRows next;
+    MakeSparseGrad(100, {2}, {5}, 1, &next);
+    EXPECT_EQ(buffer.Add(next), 1);
+    added = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_FALSE(added);
+
+  phi::SelectedRows merged;
+  EXPECT_EQ(buffer.Take(&merged), 2);
+  adder.join();
+  EXPECT_TRUE(added);
+  EXPECT_EQ(merged.rows(), std::vector<int64_t>({1}));
+  EXPECT_EQ(GetValues(merged), std::vector<float>({2}));
+
+  EXPECT_EQ(buffer.Take(&merged), 1);
+  EXPECT_EQ(merged.rows(), std::vector<int64_t>({2}));
+  EXPECT_EQ(GetValues(merged), std::vector<float>({5}));
+}
+
+}  // namespace paddle::distributed
@@ -0,0 +1,143 @@
+/* Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/service/sparse_rpc_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle::distributed {
+
+TEST(SparseRpcCodec, Keys) {
+  std::mt19937_64 rng(0);
+  std::vector<uint64_t> keys(10000);
+  for (auto& key : keys) {
+    key = rng() % 100000000;
+  }
+  keys.push_back(0);
+  keys.push_back(UINT64_MAX);
+  keys.push_back(1);
+  std::vector<uint64_t> sorted_keys(keys.begin(), keys.end() - 3);
+  std::sort(sorted_keys.begin(), sorted_keys.end());
+
+  for (auto* input : {&keys, &sorted_keys}) {
+    std::string data;
+    EncodeSparseKeys(input->data(), input->size(), &data);
+    std::vector<uint64_t> decoded(input->size());
+    const char* end = data.data() + data.size();
+    ASSERT_EQ(DecodeSparseKeys(
+                  data.data(), end, decoded.size(), decoded.data()),
+              end);
+    ASSERT_EQ(decoded, *input);
+  }
+
+  // the sorted keys take much less than 8 bytes
+  std::string data;
+  EncodeSparseKeys(sorted_keys.data(), sorted_keys.size(), &data);
+  ASSERT_LT(data.size(), sorted_keys.size() * 3);
+}
+
+TEST(SparseRpcCodec, Counts) {
+  std::vector<uint32_t> counts = {1, 0, 127, 128, 300, UINT32_MAX};
+  std::string data;
+  EncodeSparseCounts(counts.data(), counts.size(), &data);
+  std::vector<uint32_t> decoded(counts.size());
+  const char* end = data.data() + data.size();
+  ASSERT_EQ(
+      DecodeSparseCounts(data.data(), end, decoded.size(), decoded.data()),
+      end);
+  ASSERT_EQ(decoded, counts);
+}
+
+TEST(SparseRpcCodec, Values) {
+  const size_t dim = 11;
+  const size_t fp32_dim = 2;
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> dist(-1.0, 1.0);
+  std::vector<float> value(dim);
+  std::vector<char> data(SparseValueBytes(dim, fp32_dim));
+  ASSERT_EQ(data.size(), 2 * sizeof(float) + 9 * sizeof(uint16_t));
+  std::vector<float> decoded(dim);
+  for (int step = 0; step < 1000; ++step) {
+    value[0] = 123456789.0 + step;
+    value[1] = step;
+    for (size_t i = fp32_dim; i < dim; ++i) {
+      value[i] = dist(rng) * std::pow(10.0f, step % 6 - 3);
+    }
+    EncodeSparseValue(value.data(), dim, fp32_dim, data.data());
+    DecodeSparseValue(data.data(), dim, fp32_dim, decoded.data());
+    ASSERT_EQ(decoded[0], value[0]);
+    ASSERT_EQ(decoded[1], value[1]);
+    for (size_t i = fp32_dim; i < dim; ++i) {
+      // fp16 has 11 bits of precision, and subnormals below 2^-14
+      ASSERT_LE(std::fabs(decoded[i] - value[i]),
+                std::max(std::fabs(value[i]) / 2048, 1.0f / (1 << 25)));
+    }
+  }
+
+  // the values representable in fp16 are exact
+  std::vector<float> exact = {0, -0.0, 1, -2.5, 65504, 1.0f / (1 << 24)};
+  std::vector<float> exact_decoded(exact.size());
+  std::vector<char> exact_data(SparseValueBytes(exact.size(), 0));
+  EncodeSparseValue(exact.data(), exact.size(), 0, exact_data.data());
+  DecodeSparseValue(exact_data.data(), exact.size(), 0, exact_decoded.data());
+  ASSERT_EQ(exact_decoded, exact);
+
+  // out of the range of fp16
+  float large = 1e6;
+  float large_decoded = 0;
+  char large_data[2];
+  EncodeSparseValue(&large, 1, 0, large_data);
+  DecodeSparseValue(large_data, 1, 0, &large_decoded);
+  ASSERT_TRUE(std::isinf(large_decoded));
+}
+
+TEST(SparseRpcCodec, Malformed) {
+  std::vector<uint64_t> keys = {1, 1000000, 1000000000000};
+  std::string data;
+  EncodeSparseKeys(keys.data(), keys.size(), &data);
+  std::vector<uint64_t> decoded(keys.size() + 1);
+  // truncated
+  ASSERT_EQ(DecodeSparseKeys(data.data(),
+                             data.data() + data.size() - 1,
+                             keys.size(),
+                             decoded.data()),
+            nullptr);
+  // fewer keys than expected
+  ASSERT_EQ(DecodeSparseKeys(data.data(),
+                             data.data() + data.size(),
+                             keys.size() + 1,
+                             decoded.data()),
+            nullptr);
+  // a varint longer than 10 bytes
+  std::string bad(11, static_cast<char>(0xff));
+  ASSERT_EQ(
+      DecodeSparseKeys(bad.data(), bad.data() + bad.size(), 1, decoded.data()),
+      nullptr);
+  // a count of 2^32
+  std::string too_large = {'\x80', '\x80', '\x80', '\x80', '\x10'};
+  uint32_t count = 0;
+  ASSERT_EQ(DecodeSparseCounts(too_large.data(),
+                               too_large.data() + too_large.size(),
+                               1,
+                               &count),
+            nullptr);
+}
+
+}  // namespace paddle::distributed
@@ -0,0 +1,62 @@
+/* Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/table/depends/ssd_value_cache.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle::distributed {
+
+TEST(SSDValueCache, TakeAndAdmit) {
+  const size_t dim = 8;
+  const size_t entry_num = 20;
+  const size_t value_bytes = dim * sizeof(float);
+  SSDValueCache cache;
+  // The entries take the floats and 64 bytes of bookkeeping.
+  cache.Initialize(1, entry_num * (value_bytes + 64), value_bytes);
+
+  std::vector<float> value(dim);
+  for (uint64_t key = 0; key < entry_num; ++key) {
+    value[0] = static_cast<float>(key);
+    cache.Put(0, key, value.data(), dim);
+  }
+  float data[dim];
+  size_t size = 0;
+  ASSERT_TRUE(cache.Take(0, 3, data, &size));
+  ASSERT_EQ(size, dim);
+  ASSERT_FLOAT_EQ(data[0], 3);
+  // The value is moved out of the cache.
+  ASSERT_FALSE(cache.Take(0, 3, data, &size));
+
+  // Fill the room of key 3, then a cold key is not admitted.
+  cache.Put(0, 100, value.data(), dim);
+  cache.Put(0, 101, value.data(), dim);
+  ASSERT_FALSE(cache.Take(0, 101, data, &size));
+
+  // A key missed often replaces a cold one.
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_FALSE(cache.Take(0, 200, data, &size));
+  }
+  value[0] = 200;
+  cache.Put(0, 200, value.data(), dim);
+  ASSERT_TRUE(cache.Take(0, 200, data, &size));
+  ASSERT_FLOAT_EQ(data[0], 200);
+
+  cache.Clear();
+  ASSERT_FALSE(cache.Take(0, 100, data, &size));
+}
+
+}  // namespace paddle::distributed
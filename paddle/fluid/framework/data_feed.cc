@@ -19,19 +19,27 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/data_feed.h"
 
+#include <atomic>
+#include <type_traits>
+
 #include "paddle/fluid/framework/fleet/ps_gpu_wrapper.h"
 #ifdef _LINUX
+#include <fcntl.h>
 #include <stdio_ext.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #endif
 #include "io/fs.h"
 #include "paddle/common/enforce.h"
+#include "paddle/fluid/framework/data_feed_text_parser.h"
+#include "paddle/fluid/framework/record_column_store.h"
 #include "paddle/phi/core/platform/monitor.h"
 #include "paddle/phi/core/platform/timer.h"
 
 USE_INT_STAT(STAT_total_feasign_num_in_mem);
 COMMON_DECLARE_bool(enable_ins_parser_file);
+COMMON_DECLARE_string(dataset_record_cache_dir);
 namespace paddle::framework {
 
 DLManager& global_dlmanager_pool() {
@@ -39,6 +47,287 @@ DLManager& global_dlmanager_pool() {
   return manager;
 }
 
+#ifdef _LINUX
+// The records are written to the record cache with the trivially copyable
+// vectors in bulk, instead of element by element, since the cache is only
+// read on the same machine.
+template <typename T>
+static void WriteCachedVector(BinaryArchive* ar, const std::vector<T>& vec) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "the cached vector should be trivially copyable");
+  ar->PutRaw(static_cast<uint64_t>(vec.size()));
+  ar->Write(vec.data(), vec.size() * sizeof(T));
+}
+
+template <typename T>
+static void ReadCachedVector(BinaryArchive* ar, std::vector<T>* vec) {
+  uint64_t size = ar->GetRaw<uint64_t>();
+  PADDLE_ENFORCE_LE(
+      size,
+      (ar->Finish() - ar->Cursor()) / sizeof(T),
+      common::errors::InvalidArgument(
+          "The record cache is broken, the size of a vector %d is larger "
+          "than the rest of the cache.",
+          size));
+  vec->resize(size);
+  ar->Read(vec->data(), size * sizeof(T));
+}
+
+static void WriteCachedRecord(BinaryArchive* ar, const Record& record) {
+  WriteCachedVector(ar, record.uint64_feasigns_);
+  WriteCachedVector(ar, record.float_feasigns_);
+  *ar << record.ins_id_ << record.content_ << record.uid_;
+  *ar << record.search_id << record.rank << record.cmatch;
+}
+
+static void ReadCachedRecord(BinaryArchive* ar, Record* record) {
+  ReadCachedVector(ar, &record->uint64_feasigns_);
+  ReadCachedVector(ar, &record->float_feasigns_);
+  *ar >> record->ins_id_ >> record->content_ >> record->uid_;
+  *ar >> record->search_id >> record->rank >> record->cmatch;
+}
+
+static void WriteCachedRecord(BinaryArchive* ar, const SlotRecord& record) {
+  *ar << record->ins_id_;
+  *ar << record->search_id << record->rank << record->cmatch;
+  WriteCachedVector(ar, record->slot_uint64_feasigns_.slot_values);
+  WriteCachedVector(ar, record->slot_uint64_feasigns_.slot_offsets);
+  WriteCachedVector(ar, record->slot_float_feasigns_.slot_values);
+  WriteCachedVector(ar, record->slot_float_feasigns_.slot_offsets);
+}
+
+static void ReadCachedRecord(BinaryArchive* ar, SlotRecord* record) {
+  SlotRecord rec = *record;
+  *ar >> rec->ins_id_;
+  *ar >> rec->search_id >> rec->rank >> rec->cmatch;
+  ReadCachedVector(ar, &rec->slot_uint64_feasigns_.slot_values);
+  ReadCachedVector(ar, &rec->slot_uint64_feasigns_.slot_offsets);
+  ReadCachedVector(ar, &rec->slot_float_feasigns_.slot_values);
+  ReadCachedVector(ar, &rec->slot_float_feasigns_.slot_offsets);
+}
+
+// The cache of the records parsed from a local data file in
+// FLAGS_dataset_record_cache_dir:
+//
+//   |---header---|---filename---|---signature---|---records---|
+//
+// The header keeps the size and the mtime of the data file when it was
+// parsed, and the signature is how it was parsed, i.e. the data feed desc,
+// the pipe command and the parse options, so the cache is ignored, and
+// rewritten by the next parse, once the file or the config is changed.
+//
+// The cache is written to a temporary file along with the parse, and renamed
+// after the whole file is parsed, so a partial cache is never read. A valid
+// cache is mmapped and read by BinaryArchive, which skips the pipe command
+// and the text parsing of the later passes.
+class RecordFileCache {
+ public:
+  RecordFileCache(const std::string& filename, const std::string& signature)
+      : filename_(filename), signature_(signature) {
+    const std::string& dir = FLAGS_dataset_record_cache_dir;
+    if (dir.empty() || signature.empty() || fs_select_internal(filename) != 0) {
+      return;
+    }
+    struct stat st;
+    if (stat(filename.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+      return;
+    }
+    header_.magic = kMagic;
+    header_.version = kVersion;
+    header_.file_size = st.st_size;
+    header_.mtime_sec = st.st_mtim.tv_sec;
+    header_.mtime_nsec = st.st_mtim.tv_nsec;
+    char name[32];
+    snprintf(name,
+             sizeof(name),
+             "%016zx.rec",
+             std::hash<std::string>()(filename + '\n' + signature));
+    cache_path_ = dir + "/" + name;
+  }
+
+  ~RecordFileCache() { Discard(); }
+
+  bool enabled() const { return !cache_path_.empty(); }
+  bool writing() const { return fp_ != nullptr; }
+  uint64_t record_num() const { return record_num_; }
+  BinaryArchive* reader() { return &reader_; }
+
+  // Map the cache of the file, return false if there is no valid cache.
+  bool Open() {
+    if (!enabled()) {
+      return false;
+    }
+    int fd = open(cache_path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) < sizeof(Header)) {
+      close(fd);
+      return false;
+    }
+    size_t length = st.st_size;
+    void* data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+      return false;
+    }
+    madvise(data, length, MADV_SEQUENTIAL);
+    reader_.SetReadBuffer(static_cast<char*>(data),
+                          length,
+                          [length](char* p) { munmap(p, length); });
+    Header header;
+    reader_.GetRaw(header);
+    bool valid = header.magic == header_.magic &&
+                 header.version == header_.version &&
+                 header.file_size == header_.file_size &&
+                 header.mtime_sec == header_.mtime_sec &&
+                 header.mtime_nsec == header_.mtime_nsec;
+    if (valid) {
+      std::string filename;
+      std::string signature;
+      reader_ >> filename >> signature;
+      valid = filename == filename_ && signature == signature_ &&
+              header.data_size ==
+                  static_cast<uint64_t>(reader_.Finish() - reader_.Cursor());
+    }
+    if (!valid) {
+      VLOG(3) << "the record cache " << cache_path_ << " of " << filename_
+              << " is out of date";
+      reader_.Reset();
+      return false;
+    }
+    record_num_ = header.record_num;
+    return true;
+  }
+
+  // Start to write the cache along with the parse of the file.
+  void BeginWrite() {
+    if (!enabled()) {
+      return;
+    }
+    static std::atomic<uint64_t> tmp_id(0);
+    tmp_path_ = cache_path_ + ".tmp." + std::to_string(getpid()) + "." +
+                std::to_string(tmp_id++);
+    fp_ = fopen(tmp_path_.c_str(), "wb");
+    if (fp_ == nullptr) {
+      localfs_mkdir(FLAGS_dataset_record_cache_dir);
+      fp_ = fopen(tmp_path_.c_str(), "wb");
+    }
+    if (fp_ == nullptr) {
+      LOG(WARNING) << "failed to create the record cache " << tmp_path_;
+      return;
+    }
+    record_num_ = 0;
+    data_size_ = 0;
+    writer_.PutRaw(header_);
+    writer_ << filename_ << signature_;
+    header_size_ = writer_.Length();
+  }
+
+  template <typename T>
+  void Append(const T& record) {
+    if (!writing()) {
+      return;
+    }
+    WriteCachedRecord(&writer_, record);
+    ++record_num_;
+    if (writer_.Length() >= kFlushSize) {
+      Flush();
+    }
+  }
+
+  // Finish the cache of the whole file, unless the file is changed during the
+  // parse.
+  void Commit() {
+    if (!writing()) {
+      return;
+    }
+    Flush();
+    if (!writing()) {
+      return;
+    }
+    struct stat st;
+    if (stat(filename_.c_str(), &st) != 0 || st.st_size != header_.file_size ||
+        st.st_mtim.tv_sec != header_.mtime_sec ||
+        st.st_mtim.tv_nsec != header_.mtime_nsec) {
+      LOG(WARNING) << "the file " << filename_
+                   << " is changed during the parse, skip the record cache";
+      Discard();
+      return;
+    }
+    header_.record_num = record_num_;
+    header_.data_size = data_size_;
+    bool ok = fseek(fp_, 0, SEEK_SET) == 0 &&
+              fwrite(&header_, sizeof(Header), 1, fp_) == 1;
+    ok = fclose(fp_) == 0 && ok;
+    fp_ = nullptr;
+    if (!ok || rename(tmp_path_.c_str(), cache_path_.c_str()) != 0) {
+      LOG(WARNING) << "failed to write the record cache " << cache_path_;
+      unlink(tmp_path_.c_str());
+      return;
+    }
+    VLOG(3) << "write the record cache " << cache_path_ << " of " << filename_
+            << ", records=" << record_num_;
+  }
+
+  // Drop the cache being written, e.g. the parse of the file fails.
+  void Discard() {
+    if (fp_ != nullptr) {
+      fclose(fp_);
+      fp_ = nullptr;
+      unlink(tmp_path_.c_str());
+    }
+    writer_.Reset();
+  }
+
+ private:
+  static constexpr uint64_t kMagic = 0x4548434143524450ULL;  // "PDRCACHE"
+  static constexpr uint64_t kVersion = 1;
+  static constexpr size_t kFlushSize = 64 << 20;
+
+  struct Header {
+    uint64_t magic = 0;
+    uint64_t version = 0;
+    int64_t file_size = 0;
+    int64_t mtime_sec = 0;
+    int64_t mtime_nsec = 0;
+    uint64_t record_num = 0;
+    // the bytes of the records
+    uint64_t data_size = 0;
+  };
+
+  void Flush() {
+    if (fp_ == nullptr || writer_.Length() == 0) {
+      return;
+    }
+    data_size_ += writer_.Length() - header_size_;
+    if (fwrite(writer_.Buffer(), 1, writer_.Length(), fp_) !=
+        writer_.Length()) {
+      LOG(WARNING) << "failed to write the record cache " << tmp_path_;
+      Discard();
+      return;
+    }
+    header_size_ = 0;
+    writer_.Clear();
+  }
+
+  std::string filename_;
+  std::string signature_;
+  std::string cache_path_;
+  std::string tmp_path_;
+  Header header_;
+  FILE* fp_ = nullptr;
+  BinaryArchive reader_;
+  BinaryArchive writer_;
+  uint64_t record_num_ = 0;
+  uint64_t data_size_ = 0;
+  // the bytes of the header and the strings in writer_ not flushed yet
+  size_t header_size_ = 0;
+};
+#endif
+
 class BufferedLineFileReader {
   typedef std::function<bool()> SampleFunc;
   static const int MAX_FILE_BUFF_SIZE = 4 * 1024 * 1024;
@@ -396,7 +685,10 @@ bool InMemoryDataFeed<T>::Start() {
 #ifdef _LINUX
   VLOG(4) << "entering InMemoryDataFeed<T>::Start()";
   this->CheckSetFileList();
-  if (output_channel_->Size() == 0 && input_channel_->Size() != 0) {
+  // the input channel holds the records being sent to the other trainers
+  // in a streaming global shuffle
+  if (!streaming_input_ && output_channel_->Size() == 0 &&
+      input_channel_->Size() != 0) {
     std::vector<T> data;
     input_channel_->Read(data);
     output_channel_->Write(std::move(data));
@@ -433,10 +725,13 @@ int InMemoryDataFeed<T>::Next() {
     std::vector<T> ins_vec;
     ins_vec.reserve(this->default_batch_size_);
     while (index < this->default_batch_size_) {
-      if (output_channel_->Size() == 0) {
+      if (output_channel_->Size() == 0 &&
+          (!streaming_input_ || output_channel_->Closed())) {
+        break;
+      }
+      if (!output_channel_->Get(instance)) {
         break;
       }
-      output_channel_->Get(instance);
       ins_vec.push_back(instance);
       ++index;
       consume_channel_->Put(std::move(instance));
@@ -538,6 +833,11 @@ void InMemoryDataFeed<T>::SetEnablePvMerge(bool enable_pv_merge) {
   enable_pv_merge_ = enable_pv_merge;
 }
 
+template <typename T>
+void InMemoryDataFeed<T>::SetStreamingInput(bool streaming_input) {
+  streaming_input_ = streaming_input;
+}
+
 template <typename T>
 void InMemoryDataFeed<T>::SetCurrentPhase(int current_phase) {
   current_phase_ = current_phase;
@@ -553,6 +853,23 @@ void InMemoryDataFeed<T>::SetParseUid(bool parse_uid) {
   parse_uid_ = parse_uid;
 }
 
+// The data feed desc which the parse depends on, without the batch size.
+static std::string DataFeedDescSignature(const DataFeedDesc& data_feed_desc) {
+  DataFeedDesc desc = data_feed_desc;
+  desc.clear_batch_size();
+  return desc.SerializeAsString();
+}
+
+template <typename T>
+std::string InMemoryDataFeed<T>::RecordCacheSignature() const {
+  if (record_cache_signature_.empty()) {
+    return std::string();
+  }
+  return record_cache_signature_ + '\n' + pipe_command_ + '\n' +
+         std::to_string(parse_ins_id_) + std::to_string(parse_uid_) +
+         std::to_string(parse_content_) + std::to_string(parse_logkey_);
+}
+
 template <typename T>
 void InMemoryDataFeed<T>::LoadIntoMemory() {
 #ifdef _LINUX
@@ -565,29 +882,50 @@ void InMemoryDataFeed<T>::LoadIntoMemory() {
   while (this->PickOneFile(&filename)) {
     VLOG(3) << "PickOneFile, filename=" << filename
             << ", thread_id=" << thread_id_;
-#ifdef PADDLE_WITH_BOX_PS
-    if (BoxWrapper::GetInstance()->UseAfsApi()) {
-      this->fp_ = BoxWrapper::GetInstance()->afs_manager->GetFile(
-          filename, this->pipe_command_);
-    } else {
-#endif
-      int err_no = 0;
-      this->fp_ = fs_open_read(filename, &err_no, this->pipe_command_, true);
-#ifdef PADDLE_WITH_BOX_PS
-    }
-#endif
-    PADDLE_ENFORCE_EQ(this->fp_ != nullptr,
-                      true,
-                      common::errors::InvalidArgument(
-                          "This fp should not be null, please check!"));
-    __fsetlocking(&*(this->fp_), FSETLOCKING_BYCALLER);
     paddle::framework::ChannelWriter<T> writer(input_channel_);
     T instance;
     platform::Timer timeline;
     timeline.Start();
-    while (ParseOneInstanceFromPipe(&instance)) {
-      writer << std::move(instance);
-      instance = T();
+    // only the Record is cached here, the SlotRecord is cached by
+    // SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand
+    RecordFileCache cache(filename,
+                          std::is_same<T, Record>::value
+                              ? RecordCacheSignature()
+                              : std::string());
+    bool cached = false;
+    if constexpr (std::is_same<T, Record>::value) {
+      cached = cache.Open();
+      for (uint64_t i = 0; cached && i < cache.record_num(); ++i) {
+        ReadCachedRecord(cache.reader(), &instance);
+        fea_num_ += instance.uint64_feasigns_.size();
+        writer << std::move(instance);
+        instance = T();
+      }
+    }
+    if (!cached) {
+#ifdef PADDLE_WITH_BOX_PS
+      if (BoxWrapper::GetInstance()->UseAfsApi()) {
+        this->fp_ = BoxWrapper::GetInstance()->afs_manager->GetFile(
+            filename, this->pipe_command_);
+      } else {
+#endif
+        int err_no = 0;
+        this->fp_ = fs_open_read(filename, &err_no, this->pipe_command_, true);
+#ifdef PADDLE_WITH_BOX_PS
+      }
+#endif
+      PADDLE_ENFORCE_EQ(this->fp_ != nullptr,
+                        true,
+                        common::errors::InvalidArgument(
+                            "This fp should not be null, please check!"));
+      __fsetlocking(&*(this->fp_), FSETLOCKING_BYCALLER);
+      cache.BeginWrite();
+      while (ParseOneInstanceFromPipe(&instance)) {
+        cache.Append(instance);
+        writer << std::move(instance);
+        instance = T();
+      }
+      cache.Commit();
     }
     STAT_ADD(STAT_total_feasign_num_in_mem, fea_num_);
     {
@@ -598,6 +936,7 @@ void InMemoryDataFeed<T>::LoadIntoMemory() {
     writer.Flush();
     timeline.Pause();
     VLOG(3) << "LoadIntoMemory() read all lines, file=" << filename
+            << (cached ? " from the record cache" : "")
             << ", cost time=" << timeline.ElapsedSec()
             << " seconds, thread_id=" << thread_id_;
   }
@@ -1142,6 +1481,7 @@ void MultiSlotInMemoryDataFeed::Init(
   visit_.resize(all_slot_num, false);
   pipe_command_ = data_feed_desc.pipe_command();
   so_parser_name_ = data_feed_desc.so_parser_name();
+  record_cache_signature_ = DataFeedDescSignature(data_feed_desc);
   finish_init_ = true;
   input_type_ = data_feed_desc.input_type();
 }
@@ -1177,8 +1517,7 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
     return false;
   } else {
     const char* str = reader.get();
-    std::string line = std::string(str);
-    // VLOG(3) << line;
+    const char* end = str + reader.length();
     char* endptr = const_cast<char*>(str);
     int pos = 0;
     if (parse_ins_id_) {
@@ -1237,7 +1576,8 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
     }
     for (size_t i = 0; i < use_slots_index_.size(); ++i) {
       int idx = use_slots_index_[i];
-      int num = strtol(&str[pos], &endptr, 10);
+      int num = 0;
+      const char* cursor = ParseDataFeedInt(&str[pos], end, &num);
       PADDLE_ENFORCE_NE(
           num,
           0,
@@ -1262,15 +1602,16 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
                            "please check this error line: %s",
                            str));
 
-        char* uidptr = endptr;
-        uint64_t feasign = (uint64_t)strtoull(uidptr, &uidptr, 10);
+        uint64_t feasign = 0;
+        ParseDataFeedUint64(cursor, end, &feasign);
         instance->uid_ = feasign;
       }
 #endif
       if (idx != -1) {
         if (all_slots_type_[i][0] == 'f') {  // float
           for (int j = 0; j < num; ++j) {
-            float feasign = strtof(endptr, &endptr);
+            float feasign = 0;
+            cursor = ParseDataFeedFloat(cursor, end, &feasign);
             // if float feasign is equal to zero, ignore it
             // except when slot is dense
             if (fabs(feasign) < 1e-6 && !use_slots_is_dense_[i]) {
@@ -1282,7 +1623,8 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
           }
         } else if (all_slots_type_[i][0] == 'u') {  // uint64
           for (int j = 0; j < num; ++j) {
-            uint64_t feasign = (uint64_t)strtoull(endptr, &endptr, 10);
+            uint64_t feasign = 0;
+            cursor = ParseDataFeedUint64(cursor, end, &feasign);
             // if uint64 feasign is equal to zero, ignore it
             // except when slot is dense
             if (feasign == 0 && !use_slots_is_dense_[i]) {
@@ -1293,14 +1635,9 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
             instance->uint64_feasigns_.emplace_back(f, idx);
           }
         }
-        pos = endptr - str;
+        pos = static_cast<int>(cursor - str);
       } else {
-        for (int j = 0; j <= num; ++j) {
-          // pos = line.find_first_of(' ', pos + 1);
-          while (line[pos + 1] != ' ') {
-            pos++;
-          }
-        }
+        pos = static_cast<int>(SkipDataFeedTokens(cursor, end, num) - str);
       }
     }
     instance->float_feasigns_.shrink_to_fit();
@@ -1313,6 +1650,26 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
 #endif
 }
 
+int MultiSlotInMemoryDataFeed::Next() {
+#ifdef _LINUX
+  if (column_store_ != nullptr && !column_store_->Empty()) {
+    this->CheckStart();
+    size_t begin = 0;
+    int num = static_cast<int>(
+        column_store_->NextBatch(this->default_batch_size_, &begin));
+    if (num != 0) {
+      this->batch_size_ = num;
+      VLOG(3) << "batch_size_=" << this->batch_size_
+              << " from the column store, thread_id=" << thread_id_;
+      PutToFeedVec(*column_store_, begin, num);
+      return this->batch_size_;
+    }
+    // then the records loaded into the channels after the local shuffle
+  }
+#endif
+  return InMemoryDataFeed<Record>::Next();
+}
+
 bool MultiSlotInMemoryDataFeed::ParseOneInstance(Record* instance) {
 #ifdef _LINUX
   std::string line;
@@ -1524,7 +1881,69 @@ void MultiSlotInMemoryDataFeed::PutToFeedVec(
       }
     }
   }
+  PutBatchToFeedVec();
+#endif
+}
+
+void MultiSlotInMemoryDataFeed::PutToFeedVec(const RecordColumnStore& store,
+                                             size_t begin,
+                                             int num) {
+#ifdef _LINUX
+  for (size_t i = 0; i < batch_float_feasigns_.size(); ++i) {
+    batch_float_feasigns_[i].clear();
+    batch_uint64_feasigns_[i].clear();
+    offset_[i].clear();
+    offset_[i].push_back(0);
+  }
+  ins_content_vec_.clear();
+  ins_content_vec_.reserve(num);
+  ins_id_vec_.clear();
+  ins_id_vec_.reserve(num);
+  for (int i = 0; i < num; ++i) {
+    ins_id_vec_.push_back(store.InsId(begin + i));
+    ins_content_vec_.push_back(store.Content(begin + i));
+  }
+  // copy the feasigns slot by slot from the columns of the slots
+  for (size_t j = 0; j < use_slots_.size(); ++j) {
+    const auto& type = all_slots_type_[j];
+    for (int i = 0; i < num; ++i) {
+      size_t feasign_num = 0;
+      if (type[0] == 'f') {  // float
+        const float* feasigns =
+            j < store.SlotNum()
+                ? store.FloatFeasigns(begin + i, j, &feasign_num)
+                : nullptr;
+        if (feasigns == nullptr || feasign_num == 0) {
+          // fill slot value with default value 0
+          batch_float_feasigns_[j].push_back(0.0);
+        } else {
+          batch_float_feasigns_[j].insert(batch_float_feasigns_[j].end(),
+                                          feasigns,
+                                          feasigns + feasign_num);
+        }
+        offset_[j].push_back(batch_float_feasigns_[j].size());
+      } else if (type[0] == 'u') {  // uint64
+        const uint64_t* feasigns =
+            j < store.SlotNum()
+                ? store.Uint64Feasigns(begin + i, j, &feasign_num)
+                : nullptr;
+        if (feasigns == nullptr || feasign_num == 0) {
+          batch_uint64_feasigns_[j].push_back(0);
+        } else {
+          batch_uint64_feasigns_[j].insert(batch_uint64_feasigns_[j].end(),
+                                           feasigns,
+                                           feasigns + feasign_num);
+        }
+        offset_[j].push_back(batch_uint64_feasigns_[j].size());
+      }
+    }
+  }
+  PutBatchToFeedVec();
+#endif
+}
 
+void MultiSlotInMemoryDataFeed::PutBatchToFeedVec() {
+#ifdef _LINUX
   for (size_t i = 0; i < use_slots_.size(); ++i) {
     if (feed_vec_[i] == nullptr) {
       continue;
@@ -2168,6 +2587,7 @@ void SlotRecordInMemoryDataFeed::Init(const DataFeedDesc& data_feed_desc) {
   }
   visit_.resize(all_slot_num, false);
   pipe_command_ = data_feed_desc.pipe_command();
+  record_cache_signature_ = DataFeedDescSignature(data_feed_desc);
   finish_init_ = true;
   input_type_ = data_feed_desc.input_type();
   size_t pos = pipe_command_.find(".so");
@@ -2428,8 +2848,34 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
     std::vector<SlotRecord> record_vec;
     platform::Timer timeline;
     timeline.Start();
+    // the sampled records are not cached
+    RecordFileCache cache(
+        filename,
+        std::abs(sample_rate_ - 1.0f) < 1e-5f ? RecordCacheSignature()
+                                              : std::string());
+    if (cache.Open()) {
+      uint64_t left = cache.record_num();
+      while (left > 0) {
+        int num = static_cast<int>(
+            std::min(left, static_cast<uint64_t>(OBJPOOL_BLOCK_SIZE)));
+        SlotRecordPool().get(&record_vec, num);
+        for (int i = 0; i < num; ++i) {
+          ReadCachedRecord(cache.reader(), &record_vec[i]);
+        }
+        input_channel_->Write(std::move(record_vec));
+        record_vec.clear();
+        left -= num;
+      }
+      timeline.Pause();
+      VLOG(3) << "LoadIntoMemory() read the record cache, file=" << filename
+              << ", records=" << cache.record_num()
+              << ", cost time=" << timeline.ElapsedSec()
+              << " seconds, thread_id=" << thread_id_;
+      continue;
+    }
     SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
     int offset = 0;
+    cache.BeginWrite();
 
     do {
       int err_no = 0;
@@ -2442,12 +2888,15 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
 
       lines = line_reader.read_file(
           this->fp_.get(),
-          [this, &record_vec, &offset, &filename](const std::string& line) {
+          [this, &record_vec, &offset, &filename, &cache](
+              const std::string& line) {
             if (ParseOneInstance(line, &record_vec[offset])) {
+              cache.Append(record_vec[offset]);
               ++offset;
             } else {
               LOG(WARNING) << "read file:[" << filename
                            << "] item error, line:[" << line << "]";
+              cache.Discard();
               return false;
             }
             if (offset >= OBJPOOL_BLOCK_SIZE) {
@@ -2460,6 +2909,7 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
           },
           lines);
     } while (line_reader.is_error());
+    cache.Commit();
     if (offset > 0) {
       input_channel_->WriteMove(offset, &record_vec[0]);
       if (offset < OBJPOOL_BLOCK_SIZE) {
@@ -2501,14 +2951,10 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
   SlotRecord& rec = (*ins);
   // parse line
   const char* str = line.c_str();
+  const char* end = str + line.size();
   char* endptr = const_cast<char*>(str);
   int pos = 0;
 
-  thread_local std::vector<std::vector<float>> slot_float_feasigns;
-  thread_local std::vector<std::vector<uint64_t>> slot_uint64_feasigns;
-  slot_float_feasigns.resize(float_use_slot_size_);
-  slot_uint64_feasigns.resize(uint64_use_slot_size_);
-
   if (parse_ins_id_) {
     int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
     PADDLE_ENFORCE_EQ(num == 1,
@@ -2548,11 +2994,19 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
     pos += static_cast<int>(len + 1);
   }
 
-  int float_total_slot_num = 0;
-  int uint64_total_slot_num = 0;
+  // the used slots are in the order of slot_value_idx, so the feasigns are
+  // parsed into the SlotValues of the record directly
+  auto& float_values = rec->slot_float_feasigns_.slot_values;
+  auto& float_offsets = rec->slot_float_feasigns_.slot_offsets;
+  auto& uint64_values = rec->slot_uint64_feasigns_.slot_values;
+  auto& uint64_offsets = rec->slot_uint64_feasigns_.slot_offsets;
+  float_offsets.resize(float_use_slot_size_ + 1);
+  uint64_offsets.resize(uint64_use_slot_size_ + 1);
+  size_t uint64_begin = uint64_values.size();
 
   for (auto& info : all_slots_info_) {
-    int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
+    int num = 0;
+    const char* cursor = ParseDataFeedInt(&str[pos], end, &num);
     PADDLE_ENFORCE(num,
                    "The number of ids can not be zero, you need padding "
                    "it in data generator; or if there is something wrong with "
@@ -2561,42 +3015,36 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
                    str);
     if (info.used_idx != -1) {
       if (info.type[0] == 'f') {  // float
-        auto& slot_fea = slot_float_feasigns[info.slot_value_idx];
-        slot_fea.clear();
+        float_offsets[info.slot_value_idx] =
+            static_cast<uint32_t>(float_values.size());
         for (int j = 0; j < num; ++j) {
-          float feasign = strtof(endptr, &endptr);
+          float feasign = 0;
+          cursor = ParseDataFeedFloat(cursor, end, &feasign);
           if (fabs(feasign) < 1e-6 && !used_slots_info_[info.used_idx].dense) {
             continue;
           }
-          slot_fea.push_back(feasign);
-          ++float_total_slot_num;
+          float_values.push_back(feasign);
         }
       } else if (info.type[0] == 'u') {  // uint64
-        auto& slot_fea = slot_uint64_feasigns[info.slot_value_idx];
-        slot_fea.clear();
+        uint64_offsets[info.slot_value_idx] =
+            static_cast<uint32_t>(uint64_values.size());
         for (int j = 0; j < num; ++j) {
-          uint64_t feasign =
-              static_cast<uint64_t>(strtoull(endptr, &endptr, 10));
-          slot_fea.push_back(feasign);
-          ++uint64_total_slot_num;
+          uint64_t feasign = 0;
+          cursor = ParseDataFeedUint64(cursor, end, &feasign);
+          uint64_values.push_back(feasign);
         }
       }
-      pos = static_cast<int>(endptr - str);
+      pos = static_cast<int>(cursor - str);
     } else {
-      for (int j = 0; j <= num; ++j) {
-        // pos = line.find_first_of(' ', pos + 1);
-        while (line[pos + 1] != ' ') {
-          pos++;
-        }
-      }
+      pos = static_cast<int>(SkipDataFeedTokens(cursor, end, num) - str);
     }
   }
-  rec->slot_float_feasigns_.add_slot_feasigns(slot_float_feasigns,
-                                              float_total_slot_num);
-  rec->slot_uint64_feasigns_.add_slot_feasigns(slot_uint64_feasigns,
-                                               uint64_total_slot_num);
+  float_offsets[float_use_slot_size_] =
+      static_cast<uint32_t>(float_values.size());
+  uint64_offsets[uint64_use_slot_size_] =
+      static_cast<uint32_t>(uint64_values.size());
 
-  return (uint64_total_slot_num > 0);
+  return (uint64_values.size() > uint64_begin);
 }
 
 void SlotRecordInMemoryDataFeed::AssignFeedVar(const Scope& scope) {
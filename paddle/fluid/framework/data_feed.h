@@ -58,6 +58,7 @@ COMMON_DECLARE_bool(enable_slotrecord_reset_shrink);
 namespace paddle {
 namespace framework {
 class DataFeedDesc;
+class RecordColumnStore;
 class Scope;
 class Variable;
 class NeighborSampleResult;
@@ -1207,6 +1208,10 @@ class DataFeed {
   virtual void SetParseLogKey(bool parse_logkey UNUSED) {}
   virtual void SetEnablePvMerge(bool enable_pv_merge UNUSED) {}
   virtual void SetCurrentPhase(int current_phase UNUSED) {}
+  // This function will do nothing at default
+  virtual void SetStreamingInput(bool streaming_input UNUSED) {}
+  // This function will do nothing at default
+  virtual void SetRecordColumnStore(RecordColumnStore* store UNUSED) {}
 #if defined(PADDLE_WITH_PSCORE) && defined(PADDLE_WITH_HETERPS)
   virtual void InitGraphResource() {}
   virtual void InitGraphTrainResource() {}
@@ -1552,6 +1557,7 @@ class InMemoryDataFeed : public DataFeed {
   virtual void SetParseLogKey(bool parse_logkey);
   virtual void SetEnablePvMerge(bool enable_pv_merge);
   virtual void SetCurrentPhase(int current_phase);
+  virtual void SetStreamingInput(bool streaming_input);
   virtual void LoadIntoMemory();
   virtual void LoadIntoMemoryFromSo();
   virtual void SetRecord(T* records) { records_ = records; }
@@ -1574,6 +1580,9 @@ class InMemoryDataFeed : public DataFeed {
   }
   virtual void PutToFeedVec(const std::vector<T>& ins_vec) = 0;
   virtual void PutToFeedVec(const T* ins_vec, int num) = 0;
+  // The signature of how the files are parsed into the records, which the
+  // record cache of a file is valid for, empty if the records are not cached.
+  std::string RecordCacheSignature() const;
 
   std::vector<std::vector<float>> batch_float_feasigns_;
   std::vector<std::vector<uint64_t>> batch_uint64_feasigns_;
@@ -1588,6 +1597,9 @@ class InMemoryDataFeed : public DataFeed {
   bool parse_logkey_;
   bool enable_pv_merge_;
   int current_phase_{-1};  // only for untest
+  // the output channel is being filled by a streaming global shuffle, so
+  // Next waits for the records until the channel is closed
+  bool streaming_input_ = false;
   std::ifstream file_;
   std::shared_ptr<FILE> fp_;
   paddle::framework::ChannelObject<T>* input_channel_;
@@ -1602,6 +1614,9 @@ class InMemoryDataFeed : public DataFeed {
   uint64_t offset_index_ = 0;
   bool enable_heterps_ = false;
   T* records_ = nullptr;
+  // the serialized data feed desc, set by Init of the data feeds which
+  // support the record cache
+  std::string record_cache_signature_;
 };
 
 // This class define the data type of instance(ins_vec) in MultiSlotDataFeed
@@ -1946,6 +1961,10 @@ class MultiSlotInMemoryDataFeed : public InMemoryDataFeed<Record> {
   virtual ~MultiSlotInMemoryDataFeed() {}
   virtual void Init(const DataFeedDesc& data_feed_desc);
   // void SetRecord(Record* records) { records_ = records; }
+  virtual int Next();
+  virtual void SetRecordColumnStore(RecordColumnStore* store) {
+    column_store_ = store;
+  }
 
  protected:
   virtual bool ParseOneInstance(Record* instance);
@@ -1963,6 +1982,15 @@ class MultiSlotInMemoryDataFeed : public InMemoryDataFeed<Record> {
                                 uint32_t* cmatch,
                                 uint32_t* rank);
   virtual void PutToFeedVec(const Record* ins_vec, int num);
+  // put the records [begin, begin + num) of the column store to the feed
+  void PutToFeedVec(const RecordColumnStore& store, size_t begin, int num);
+  // copy the feasigns of the batch in batch_*_feasigns_ and offset_ to the
+  // feed tensors
+  void PutBatchToFeedVec();
+
+  // the records are taken from the column store instead of the output
+  // channel when it is not empty
+  RecordColumnStore* column_store_ = nullptr;
 };
 
 class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
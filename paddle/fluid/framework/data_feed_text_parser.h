@@ -0,0 +1,248 @@
+/* Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#include <emmintrin.h>
+#define PADDLE_DATA_FEED_PARSER_SSE2
+#endif
+
+namespace paddle {
+namespace framework {
+
+// Parsers of the space separated numbers in the text lines of the data feeds,
+//
+//   <num> <feasign> ... <num> <feasign> ...
+//
+// which give the same results as strtol, strtoull and strtof, but take the
+// common forms of the numbers without the locale and the generic checks of
+// them:
+// - uint64 of decimal digits, 8 digits at a time
+// - floats of [-]digits[.digits] with no more than 7 significant digits and
+//   10 fraction digits, which are exactly `mantissa / 10^n` in float
+// and fall back to the strto* functions for the others, such as the floats
+// with exponents.
+//
+// Each parser takes the text in [str, end), skips the leading spaces and
+// returns the end of the number, or `str` if there is no number. The text
+// must be terminated by a char which is not part of a number at or after
+// `end`, e.g. '\0', for the fallbacks.
+
+inline bool IsDataFeedSpace(char c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool IsDataFeedDigit(char c) {
+  return static_cast<unsigned char>(c - '0') < 10;
+}
+
+inline const char* SkipDataFeedSpaces(const char* str, const char* end) {
+  while (str < end && IsDataFeedSpace(*str)) {
+    ++str;
+  }
+  return str;
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+inline bool IsEightDigits(const char* str) {
+  uint64_t chunk = 0;
+  memcpy(&chunk, str, sizeof(chunk));
+  return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+          (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+         0x3333333333333333ULL;
+}
+
+inline uint32_t ParseEightDigits(const char* str) {
+  uint64_t chunk = 0;
+  memcpy(&chunk, str, sizeof(chunk));
+  chunk -= 0x3030303030303030ULL;
+  // combine the adjacent digits into 2, 4 and then 8 digits
+  chunk = (chunk * 10) + (chunk >> 8);
+  chunk = (((chunk & 0x000000FF000000FFULL) * 0x000F424000000064ULL) +
+           (((chunk >> 16) & 0x000000FF000000FFULL) *
+            0x0000271000000001ULL)) >>
+          32;
+  return static_cast<uint32_t>(chunk);
+}
+#define PADDLE_DATA_FEED_PARSER_SWAR
+#endif
+
+inline const char* ParseDataFeedUint64(const char* str,
+                                       const char* end,
+                                       uint64_t* value) {
+  const char* p = SkipDataFeedSpaces(str, end);
+  const char* digits = p;
+  uint64_t result = 0;
+#ifdef PADDLE_DATA_FEED_PARSER_SWAR
+  while (end - p >= 8 && p - digits < 16 && IsEightDigits(p)) {
+    result = result * 100000000 + ParseEightDigits(p);
+    p += 8;
+  }
+#endif
+  while (p < end && IsDataFeedDigit(*p) && p - digits < 19) {
+    result = result * 10 + (*p - '0');
+    ++p;
+  }
+  if (p < end && IsDataFeedDigit(*p) &&
+      (result < 1844674407370955161ULL ||
+       (result == 1844674407370955161ULL && *p <= '5'))) {
+    // the 20th digit which does not overflow
+    result = result * 10 + (*p - '0');
+    ++p;
+  }
+  if (p == digits || (p < end && IsDataFeedDigit(*p))) {
+    // signs, overflows or no number
+    char* endptr = nullptr;
+    *value = strtoull(str, &endptr, 10);
+    return endptr;
+  }
+  *value = result;
+  return p;
+}
+
+inline const char* ParseDataFeedInt(const char* str,
+                                    const char* end,
+                                    int* value) {
+  const char* p = SkipDataFeedSpaces(str, end);
+  int result = 0;
+  int digit_num = 0;
+  while (p < end && IsDataFeedDigit(*p) && digit_num < 9) {
+    result = result * 10 + (*p - '0');
+    ++p;
+    ++digit_num;
+  }
+  if (digit_num == 0 || (p < end && IsDataFeedDigit(*p))) {
+    char* endptr = nullptr;
+    *value = static_cast<int>(strtol(str, &endptr, 10));
+    return endptr;
+  }
+  *value = result;
+  return p;
+}
+
+inline const char* ParseDataFeedFloat(const char* str,
+                                      const char* end,
+                                      float* value) {
+  static const float kPow10[] = {
+      1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+  const char* p = SkipDataFeedSpaces(str, end);
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = *p == '-';
+    ++p;
+  }
+  uint32_t mantissa = 0;
+  int digit_num = 0;
+  int fraction_num = 0;
+  // the leading zeros are not significant
+  while (p < end && *p == '0') {
+    ++p;
+    ++digit_num;
+  }
+  int significant_num = 0;
+  while (p < end && IsDataFeedDigit(*p)) {
+    mantissa = mantissa * 10 + (*p - '0');
+    ++p;
+    ++digit_num;
+    ++significant_num;
+    if (significant_num > 7) {
+      break;
+    }
+  }
+  if (significant_num <= 7 && p < end && *p == '.') {
+    ++p;
+    while (p < end && IsDataFeedDigit(*p)) {
+      if (mantissa != 0 || *p != '0') {
+        ++significant_num;
+      }
+      mantissa = mantissa * 10 + (*p - '0');
+      ++p;
+      ++digit_num;
+      ++fraction_num;
+      if (significant_num > 7 || fraction_num > 10) {
+        break;
+      }
+    }
+  }
+  // 7 digits are below 2^24, and 10^10 is exact in float, so the division is
+  // rounded once like strtof
+  if (digit_num == 0 || significant_num > 7 || fraction_num > 10 ||
+      (p < end && (IsDataFeedDigit(*p) || *p == '.' || *p == 'e' ||
+                   *p == 'E' || *p == 'x' || *p == 'X'))) {
+    char* endptr = nullptr;
+    *value = strtof(str, &endptr);
+    return endptr;
+  }
+  float result = static_cast<float>(mantissa) / kPow10[fraction_num];
+  *value = negative ? -result : result;
+  return p;
+}
+
+// Skip `num` space separated tokens, return the end of the last one.
+inline const char* SkipDataFeedTokens(const char* str,
+                                      const char* end,
+                                      int num) {
+  const char* p = str;
+#ifdef PADDLE_DATA_FEED_PARSER_SSE2
+  // find the start of the num-th token 16 chars at a time, a token starts at
+  // a non-space after a space or at `str`
+  const __m128i space = _mm_set1_epi8(' ');
+  uint32_t prev_space = 1;
+  while (num > 0 && end - p >= 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    uint32_t spaces = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, space)));
+    uint32_t starts = ~spaces & ((spaces << 1) | prev_space) & 0xFFFF;
+    int start_num = __builtin_popcount(starts);
+    if (start_num >= num) {
+      for (int i = 1; i < num; ++i) {
+        starts &= starts - 1;
+      }
+      p += __builtin_ctz(starts);
+      while (p < end && *p != ' ') {
+        ++p;
+      }
+      return p;
+    }
+    num -= start_num;
+    prev_space = (spaces >> 15) & 1;
+    p += 16;
+  }
+  if (num > 0 && prev_space == 0) {
+    // the rest of a counted token
+    while (p < end && *p != ' ') {
+      ++p;
+    }
+  }
+#endif
+  while (num > 0 && p < end) {
+    while (p < end && *p == ' ') {
+      ++p;
+    }
+    while (p < end && *p != ' ') {
+      ++p;
+    }
+    --num;
+  }
+  return p;
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/framework/data_set.h"
 
+#include <limits>
+
 #include "google/protobuf/text_format.h"
 #if (defined PADDLE_WITH_DISTRIBUTE) && (defined PADDLE_WITH_PSCORE)
 #include "paddle/fluid/distributed/index_dataset/index_sampler.h"
@@ -42,6 +44,7 @@ COMMON_DECLARE_bool(graph_get_neighbor_id);
 COMMON_DECLARE_int32(gpugraph_storage_mode);
 COMMON_DECLARE_string(graph_edges_split_mode);
 COMMON_DECLARE_bool(query_dest_rank_by_multi_node);
+COMMON_DECLARE_bool(enable_dataset_column_store);
 
 namespace paddle {
 namespace framework {
@@ -797,6 +800,7 @@ void MultiSlotDataset::TDMSample(const std::string tree_name,
       tdm_layer_counts, start_sample_layer, seed_);
 
   VLOG(0) << "DatasetImpl<T>::Sample() begin";
+  RestoreColumnStore();
   platform::Timer timeline;
   timeline.Start();
 
@@ -859,6 +863,7 @@ void MultiSlotDataset::TDMSample(const std::string tree_name,
 
 void MultiSlotDataset::GlobalShuffle(int thread_num) {
   VLOG(3) << "MultiSlotDataset::GlobalShuffle() begin";
+  RestoreColumnStore();
   platform::Timer timeline;
   timeline.Start();
 #ifdef PADDLE_WITH_PSCORE
@@ -887,7 +892,39 @@ void MultiSlotDataset::GlobalShuffle(int thread_num) {
   VLOG(3) << "MultiSlotDataset::GlobalShuffle() input_channel_ size "
           << input_channel_->Size();
 
-  auto get_client_id = [this, fleet_ptr](const Record& data) -> size_t {
+  auto global_shuffle_func = [this]() {
+    std::vector<Record> data;
+    while (this->input_channel_->Read(data)) {
+      this->SendToClients(&data);
+    }
+  };
+
+  std::vector<std::thread> global_shuffle_threads;
+  if (thread_num == -1) {
+    thread_num = thread_num_;
+  }
+  VLOG(3) << "start global shuffle threads, num = " << thread_num;
+  for (int i = 0; i < thread_num; ++i) {
+    global_shuffle_threads.emplace_back(global_shuffle_func);
+  }
+  for (std::thread& t : global_shuffle_threads) {
+    t.join();
+  }
+  global_shuffle_threads.clear();
+  global_shuffle_threads.shrink_to_fit();
+  input_channel_->Clear();
+  timeline.Pause();
+  VLOG(3) << "DatasetImpl<T>::GlobalShuffle() end, cost time="
+          << timeline.ElapsedSec() << " seconds";
+}
+
+void MultiSlotDataset::SendToClients(std::vector<Record>* data) {
+#ifdef PADDLE_WITH_PSCORE
+  auto fleet_ptr = distributed::FleetWrapper::GetInstance();
+#else
+  auto fleet_ptr = framework::FleetWrapper::GetInstance();
+#endif
+  auto get_client_id = [this, &fleet_ptr](const Record& data) -> size_t {
     if (this->merge_by_insid_) {
       return XXH64(data.ins_id_.data(), data.ins_id_.length(), 0) %
              this->trainer_num_;
@@ -899,71 +936,208 @@ void MultiSlotDataset::GlobalShuffle(int thread_num) {
     }
   };
 
-  auto global_shuffle_func = [this, get_client_id]() {
+  std::vector<paddle::framework::BinaryArchive> ars(trainer_num_);
+  for (auto& t : *data) {
+    auto client_id = get_client_id(t);
+    ars[client_id] << t;
+  }
+  std::vector<std::future<int32_t>> total_status;
+  std::vector<int> send_index(trainer_num_);
+  for (int i = 0; i < trainer_num_; ++i) {
+    send_index[i] = i;
+  }
+  std::shuffle(
+      send_index.begin(), send_index.end(), fleet_ptr->LocalRandomEngine());
+  for (int index = 0; index < trainer_num_; ++index) {
+    int i = send_index[index];
+    if (ars[i].Length() == 0) {
+      continue;
+    }
+    std::string msg(ars[i].Buffer(), ars[i].Length());
+    auto ret = fleet_ptr->SendClientToClientMsg(0, i, msg);
+    total_status.push_back(std::move(ret));
+  }
+  for (auto& t : total_status) {
+    t.wait();
+  }
+  ars.clear();
+  ars.shrink_to_fit();
+  data->clear();
+  data->shrink_to_fit();
+  // currently we find bottleneck is server not able to handle large data
+  // in time, so we can remove this sleep and set fleet_send_batch_size to
+  // 1024, and set server thread to 24.
+  if (fleet_send_sleep_seconds_ != 0) {
+    sleep(fleet_send_sleep_seconds_);
+  }
+}
+
+// the message a trainer sends to all trainers after it has sent all its data
+// of the streaming global shuffle
+static const int kStreamingShuffleFinishMsgType = 1;
+
+void MultiSlotDataset::RegisterClientToClientMsgHandler() {
+  DatasetImpl<Record>::RegisterClientToClientMsgHandler();
+#ifdef PADDLE_WITH_PSCORE
+  auto fleet_ptr = distributed::FleetWrapper::GetInstance();
+#else
+  auto fleet_ptr = framework::FleetWrapper::GetInstance();
+#endif
+  fleet_ptr->RegisterClientToClientMsgHandler(
+      kStreamingShuffleFinishMsgType,
+      [this](int msg_type, int client_id, const std::string& msg) -> int {
+        return this->ReceiveFromClient(msg_type, client_id, msg);
+      });
+}
+
+// The files are loaded by the preload readers into input_channel_, which is
+// bounded, and the sender threads send each block of it to the trainers as
+// soon as it is read. The receivers put the records to the output channels,
+// which are closed after all trainers have sent all their data, so that the
+// readers can train the shuffled data while the rest is in flight.
+void MultiSlotDataset::StreamingGlobalShuffle(int thread_num) {
+  VLOG(3) << "MultiSlotDataset::StreamingGlobalShuffle() begin";
+  PADDLE_ENFORCE_EQ(streaming_shuffle_thread_.joinable(),
+                    false,
+                    common::errors::PreconditionNotMet(
+                        "The last streaming global shuffle is not done, "
+                        "please call WaitStreamingGlobalShuffleDone first."));
+  PADDLE_ENFORCE_EQ(preload_readers_.empty(),
+                    true,
+                    common::errors::PreconditionNotMet(
+                        "The preload readers are in use, streaming global "
+                        "shuffle can not be used with PreLoadIntoMemory."));
+  PADDLE_ENFORCE_GT(fleet_send_batch_size_,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The fleet send batch size should be greater than 0. "
+                        "Received: %d",
+                        fleet_send_batch_size_));
+  if (thread_num == -1) {
+    thread_num = thread_num_;
+  }
+  RestoreColumnStore();
+  CreatePreLoadReaders();
+  streaming_shuffle_ = true;
+  for (auto& reader : readers_) {
+    reader->SetStreamingInput(true);
+  }
+  for (auto& channel : multi_output_channel_) {
+    channel->Open();
+  }
+  input_channel_->Open();
+  input_channel_->SetBlockSize(fleet_send_batch_size_);
+  // the parsed records wait in input_channel_ to be sent for at most two
+  // blocks of each sender thread
+  input_channel_->SetCapacity(2 * thread_num * fleet_send_batch_size_);
+  streaming_shuffle_thread_ = std::thread(
+      &MultiSlotDataset::StreamingGlobalShuffleFunc, this, thread_num);
+  VLOG(3) << "MultiSlotDataset::StreamingGlobalShuffle() end";
+}
+
+void MultiSlotDataset::StreamingGlobalShuffleFunc(int thread_num) {
+  platform::Timer timeline;
+  timeline.Start();
+  std::vector<std::thread> load_threads;
+  for (auto& reader : preload_readers_) {
+    load_threads.emplace_back(&paddle::framework::DataFeed::LoadIntoMemory,
+                              reader.get());
+  }
+
+  auto send_func = [this]() {
 #ifdef PADDLE_WITH_PSCORE
     auto fleet_ptr = distributed::FleetWrapper::GetInstance();
 #else
     auto fleet_ptr = framework::FleetWrapper::GetInstance();
 #endif
-    // auto fleet_ptr = framework::FleetWrapper::GetInstance();
     std::vector<Record> data;
     while (this->input_channel_->Read(data)) {
-      std::vector<paddle::framework::BinaryArchive> ars(this->trainer_num_);
-      for (auto& t : data) {
-        auto client_id = get_client_id(t);
-        ars[client_id] << t;
-      }
-      std::vector<std::future<int32_t>> total_status;
-      std::vector<int> send_index(this->trainer_num_);
-      for (int i = 0; i < this->trainer_num_; ++i) {
-        send_index[i] = i;
-      }
-      std::shuffle(
-          send_index.begin(), send_index.end(), fleet_ptr->LocalRandomEngine());
-      for (int index = 0; index < this->trainer_num_; ++index) {
-        int i = send_index[index];
-        if (ars[i].Length() == 0) {
-          continue;
-        }
-        std::string msg(ars[i].Buffer(), ars[i].Length());
-        auto ret = fleet_ptr->SendClientToClientMsg(0, i, msg);
-        total_status.push_back(std::move(ret));
-      }
-      for (auto& t : total_status) {
-        t.wait();
-      }
-      ars.clear();
-      ars.shrink_to_fit();
-      data.clear();
-      data.shrink_to_fit();
-      // currently we find bottleneck is server not able to handle large data
-      // in time, so we can remove this sleep and set fleet_send_batch_size to
-      // 1024, and set server thread to 24.
-      if (fleet_send_sleep_seconds_ != 0) {
-        sleep(this->fleet_send_sleep_seconds_);
+      // the blocks are shuffled instead of all the loaded data
+      std::shuffle(data.begin(), data.end(), fleet_ptr->LocalRandomEngine());
+      if (this->trainer_num_ == 1) {
+        this->WriteToOutputChannel(&data);
+      } else {
+        this->SendToClients(&data);
       }
     }
   };
-
-  std::vector<std::thread> global_shuffle_threads;
-  if (thread_num == -1) {
-    thread_num = thread_num_;
-  }
-  VLOG(3) << "start global shuffle threads, num = " << thread_num;
+  std::vector<std::thread> send_threads;
+  VLOG(3) << "start streaming global shuffle threads, num = " << thread_num;
   for (int i = 0; i < thread_num; ++i) {
-    global_shuffle_threads.emplace_back(global_shuffle_func);
+    send_threads.emplace_back(send_func);
   }
-  for (std::thread& t : global_shuffle_threads) {
+
+  for (std::thread& t : load_threads) {
     t.join();
   }
-  global_shuffle_threads.clear();
-  global_shuffle_threads.shrink_to_fit();
+  input_channel_->Close();
+  for (std::thread& t : send_threads) {
+    t.join();
+  }
+  DestroyPreLoadReaders();
+  input_channel_->SetCapacity(std::numeric_limits<size_t>::max());
   input_channel_->Clear();
+
+  if (trainer_num_ == 1) {
+    FinishStreamingShuffleFromClient();
+  } else {
+#ifdef PADDLE_WITH_PSCORE
+    auto fleet_ptr = distributed::FleetWrapper::GetInstance();
+#else
+    auto fleet_ptr = framework::FleetWrapper::GetInstance();
+#endif
+    // the data sent before are all received as their responses are waited
+    std::vector<std::future<int32_t>> total_status;
+    for (int i = 0; i < trainer_num_; ++i) {
+      total_status.push_back(fleet_ptr->SendClientToClientMsg(
+          kStreamingShuffleFinishMsgType, i, std::string()));
+    }
+    for (auto& t : total_status) {
+      t.wait();
+    }
+  }
   timeline.Pause();
-  VLOG(3) << "DatasetImpl<T>::GlobalShuffle() end, cost time="
+  VLOG(3) << "MultiSlotDataset::StreamingGlobalShuffleFunc() end, cost time="
           << timeline.ElapsedSec() << " seconds";
 }
 
+void MultiSlotDataset::FinishStreamingShuffleFromClient() {
+  std::lock_guard<std::mutex> lock(streaming_shuffle_mutex_);
+  ++streaming_shuffle_finished_num_;
+  VLOG(3) << "streaming global shuffle finished trainer num "
+          << streaming_shuffle_finished_num_;
+  if (streaming_shuffle_finished_num_ == trainer_num_) {
+    for (auto& channel : multi_output_channel_) {
+      channel->Close();
+    }
+    streaming_shuffle_cond_.notify_all();
+  }
+}
+
+void MultiSlotDataset::WaitStreamingGlobalShuffleDone() {
+  VLOG(3) << "MultiSlotDataset::WaitStreamingGlobalShuffleDone() begin";
+  if (!streaming_shuffle_thread_.joinable()) {
+    return;
+  }
+  streaming_shuffle_thread_.join();
+  {
+    std::unique_lock<std::mutex> lock(streaming_shuffle_mutex_);
+    streaming_shuffle_cond_.wait(lock, [this] {
+      return streaming_shuffle_finished_num_ == trainer_num_;
+    });
+    streaming_shuffle_finished_num_ = 0;
+  }
+  // the output channels are written again when the data is trained next time
+  for (auto& channel : multi_output_channel_) {
+    channel->Open();
+  }
+  streaming_shuffle_ = false;
+  for (auto& reader : readers_) {
+    reader->SetStreamingInput(false);
+  }
+  VLOG(3) << "MultiSlotDataset::WaitStreamingGlobalShuffleDone() end";
+}
+
 template <typename T>
 void DatasetImpl<T>::DynamicAdjustChannelNum(int channel_num,
                                              bool discard_remaining_ins) {
@@ -972,6 +1146,15 @@ void DatasetImpl<T>::DynamicAdjustChannelNum(int channel_num,
             << channel_num_ << ", channel_num_=channel_num, no need to adjust";
     return;
   }
+  // the channels are being filled by the streaming global shuffle
+  PADDLE_ENFORCE_EQ(streaming_shuffle_,
+                    false,
+                    common::errors::PreconditionNotMet(
+                        "The channel num %d can not be adjusted to %d while "
+                        "the streaming global shuffle is running, please "
+                        "train with the thread num of the dataset.",
+                        channel_num_,
+                        channel_num));
   VLOG(3) << "adjust channel num from " << channel_num_ << " to "
           << channel_num;
   channel_num_ = channel_num;
@@ -1188,6 +1371,7 @@ void DatasetImpl<T>::CreateReaders() {
     // In fact, it does not affect the train process when paddle is
     // complied with Box_Ps.
     readers_[i]->SetCurrentPhase(current_phase_);
+    readers_[i]->SetStreamingInput(streaming_shuffle_);
     if (input_channel_ != nullptr) {
       readers_[i]->SetInputChannel(input_channel_.get());
     }
@@ -1355,6 +1539,10 @@ int MultiSlotDataset::ReceiveFromClient(int msg_type,
 #ifdef _LINUX
   VLOG(3) << "ReceiveFromClient msg_type=" << msg_type
           << ", client_id=" << client_id << ", msg length=" << msg.length();
+  if (msg_type == kStreamingShuffleFinishMsgType) {
+    FinishStreamingShuffleFromClient();
+    return 0;
+  }
   if (msg.length() == 0) {
     return 0;
   }
@@ -1376,11 +1564,15 @@ int MultiSlotDataset::ReceiveFromClient(int msg_type,
                         ar.Cursor(),
                         ar.Finish()));
 
-  auto fleet_ptr = framework::FleetWrapper::GetInstance();
+  WriteToOutputChannel(&data);
+#endif
+  return 0;
+}
+
+void MultiSlotDataset::WriteToOutputChannel(std::vector<Record>* data) {
   // not use random because it doesn't perform well here.
   // to make sure each channel get data equally, we just put data to
   // channel one by one.
-  // int64_t index = fleet_ptr->LocalRandomEngine()() % channel_num_;
   int64_t index = 0;
   {
     std::unique_lock<std::mutex> lk(global_index_mutex_);
@@ -1388,18 +1580,27 @@ int MultiSlotDataset::ReceiveFromClient(int msg_type,
   }
   index = index % channel_num_;
   VLOG(3) << "random index=" << index;
-  multi_output_channel_[index]->Write(std::move(data));
+  multi_output_channel_[index]->Write(std::move(*data));
 
-  data.clear();
-  data.shrink_to_fit();
-#endif
-  return 0;
+  data->clear();
+  data->shrink_to_fit();
 }
 
 // explicit instantiation
 template class DatasetImpl<Record>;
 
 void MultiSlotDataset::DynamicAdjustReadersNum(int thread_num) {
+  // the reader i reads the channel i % channel_num_, the channels without
+  // readers would be skipped in the streamed pass
+  PADDLE_ENFORCE_EQ(
+      !streaming_shuffle_ || thread_num == channel_num_,
+      true,
+      common::errors::PreconditionNotMet(
+          "The readers num %d should be equal to the channel num %d while "
+          "the streaming global shuffle is running, please train with the "
+          "thread num of the dataset.",
+          thread_num,
+          channel_num_));
   if (thread_num_ == thread_num) {
     VLOG(3) << "DatasetImpl<T>::DynamicAdjustReadersNum thread_num_="
             << thread_num_ << ", thread_num_=thread_num, no need to adjust";
@@ -1413,6 +1614,105 @@ void MultiSlotDataset::DynamicAdjustReadersNum(int thread_num) {
   PrepareTrain();
 }
 
+void MultiSlotDataset::LocalShuffle() {
+  if (!FLAGS_enable_dataset_column_store || enable_pv_merge_ ||
+      enable_heterps_ || streaming_shuffle_) {
+    RestoreColumnStore();
+    DatasetImpl<Record>::LocalShuffle();
+    return;
+  }
+  VLOG(3) << "MultiSlotDataset::LocalShuffle() begin with column store";
+  platform::Timer timeline;
+  timeline.Start();
+  if (input_channel_ && input_channel_->Size() != 0) {
+    if (column_store_.Empty()) {
+      std::vector<std::string> slot_types;
+      const auto& multi_slot_desc = data_feed_desc_.multi_slot_desc();
+      for (int i = 0; i < multi_slot_desc.slots_size(); ++i) {
+        if (multi_slot_desc.slots(i).is_used()) {
+          slot_types.push_back(multi_slot_desc.slots(i).type());
+        }
+      }
+      column_store_.Init(slot_types);
+    }
+    // move the records into the columns a chunk at a time, so that only a
+    // few chunks of them are in both forms
+    input_channel_->Close();
+    std::vector<std::thread> append_threads;
+    for (int i = 0; i < thread_num_; ++i) {
+      append_threads.emplace_back([this] {
+        std::vector<Record> data;
+        while (input_channel_->ReadOnce(data, RecordColumnStore::kChunkSize) !=
+               0) {
+          column_store_.Append(&data);
+        }
+      });
+    }
+    for (auto& t : append_threads) {
+      t.join();
+    }
+  }
+  if (column_store_.Empty()) {
+    VLOG(3) << "MultiSlotDataset::LocalShuffle() end, no data to shuffle";
+    return;
+  }
+  auto fleet_ptr = framework::FleetWrapper::GetInstance();
+  column_store_.Shuffle(&fleet_ptr->LocalRandomEngine());
+
+  timeline.Pause();
+  VLOG(3) << "MultiSlotDataset::LocalShuffle() end, records in column store="
+          << column_store_.Size()
+          << ", memory size=" << column_store_.MemorySize()
+          << ", cost time=" << timeline.ElapsedSec() << " seconds";
+}
+
+void MultiSlotDataset::RestoreColumnStore() {
+  if (column_store_.Empty()) {
+    return;
+  }
+  VLOG(3) << "restore " << column_store_.Size()
+          << " records from column store to input channel";
+  input_channel_->Open();
+  std::vector<Record> data;
+  for (size_t begin = 0; begin < column_store_.Size();
+       begin += RecordColumnStore::kChunkSize) {
+    size_t end = std::min(column_store_.Size(),
+                          begin + RecordColumnStore::kChunkSize);
+    data.resize(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+      column_store_.Get(i, &data[i - begin]);
+    }
+    input_channel_->Write(std::move(data));
+    data.clear();
+  }
+  column_store_.Clear();
+  input_channel_->Close();
+  input_channel_->SetBlockSize(input_channel_->Size() / thread_num_ + 1);
+}
+
+void MultiSlotDataset::CreateReaders() {
+  DatasetImpl<Record>::CreateReaders();
+  for (auto& reader : readers_) {
+    reader->SetRecordColumnStore(&column_store_);
+  }
+}
+
+void MultiSlotDataset::DestroyReaders() {
+  // the readers of the next pass take the batches from the first record
+  column_store_.ResetBatch();
+  DatasetImpl<Record>::DestroyReaders();
+}
+
+int64_t MultiSlotDataset::GetMemoryDataSize() {
+  return DatasetImpl<Record>::GetMemoryDataSize() +
+         static_cast<int64_t>(column_store_.Size());
+}
+
+void MultiSlotDataset::ReleaseMemory() {
+  column_store_.Clear();
+  DatasetImpl<Record>::ReleaseMemory();
+}
+
 void MultiSlotDataset::PostprocessInstance() {
   // divide pv instance, and merge to input_channel_
   if (enable_pv_merge_) {
@@ -1449,11 +1749,13 @@ void MultiSlotDataset::SetCurrentPhase(int current_phase) {
 }
 
 void MultiSlotDataset::PreprocessInstance() {
+  RestoreColumnStore();
   if (!input_channel_ || input_channel_->Size() == 0) {
     return;
   }
   if (!enable_pv_merge_) {  // means to use Record
-    this->LocalShuffle();
+    // the records stay in the input channel for PostprocessInstance
+    DatasetImpl<Record>::LocalShuffle();
   } else {  // means to use Pv
     auto fleet_ptr = framework::FleetWrapper::GetInstance();
     input_channel_->Close();
@@ -1594,6 +1896,7 @@ void MultiSlotDataset::GenerateLocalTablesUnlock(int table_id,
 
 void MultiSlotDataset::MergeByInsId() {
   VLOG(3) << "MultiSlotDataset::MergeByInsId begin";
+  RestoreColumnStore();
   if (!merge_by_insid_) {
     VLOG(3) << "merge_by_insid=false, will not MergeByInsId";
     return;
@@ -1837,6 +2140,7 @@ void MultiSlotDataset::GetRandomData(
 void MultiSlotDataset::PreprocessChannel(
     const std::set<std::string>& slots_to_replace,
     std::unordered_set<uint16_t>& index_slots) {  // NOLINT
+  RestoreColumnStore();
   int out_channel_size = 0;
   if (cur_channel_ == 0) {  // NOLINT
     for (auto& item : multi_output_channel_) {
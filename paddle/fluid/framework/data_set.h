@@ -16,6 +16,7 @@
 
 #include <ThreadPool.h>
 
+#include <condition_variable>  // NOLINT
 #include <fstream>
 #include <memory>
 #include <mutex>  // NOLINT
@@ -34,6 +35,7 @@
 #endif
 
 #include "paddle/fluid/framework/data_feed.h"
+#include "paddle/fluid/framework/record_column_store.h"
 
 namespace paddle {
 namespace framework {
@@ -127,6 +129,11 @@ class Dataset {
   virtual void LocalShuffle() = 0;
   // global shuffle data
   virtual void GlobalShuffle(int thread_num = -1) = 0;
+  // load data and global shuffle it in async mode, the shuffled data can be
+  // trained before all of it is received
+  virtual void StreamingGlobalShuffle(int thread_num = -1) = 0;
+  // wait async streaming global shuffle done
+  virtual void WaitStreamingGlobalShuffleDone() = 0;
   virtual void SlotsShuffle(const std::set<std::string>& slots_to_replace) = 0;
   // create readers
   virtual void CreateReaders() = 0;
@@ -248,6 +255,8 @@ class DatasetImpl : public Dataset {
   virtual void ReleaseMemory();
   virtual void LocalShuffle();
   virtual void GlobalShuffle(int thread_num UNUSED = -1) {}
+  virtual void StreamingGlobalShuffle(int thread_num UNUSED = -1) {}
+  virtual void WaitStreamingGlobalShuffleDone() {}
   virtual void SlotsShuffle(
       const std::set<std::string>& slots_to_replace UNUSED) {}
   virtual const std::vector<T>& GetSlotsOriginalData() {
@@ -363,6 +372,9 @@ class DatasetImpl : public Dataset {
   int preload_thread_num_;
   std::mutex global_index_mutex_;
   int64_t global_index_ = 0;
+  // true if the output channels are being filled by a streaming global
+  // shuffle, the readers wait for the data until the channels are closed
+  bool streaming_shuffle_ = false;
   std::vector<std::shared_ptr<ThreadPool>> consume_task_pool_;
   std::vector<T> input_records_;  // only for paddleboxdatafeed
   std::vector<std::string> use_slots_;
@@ -414,15 +426,48 @@ class MultiSlotDataset : public DatasetImpl<Record> {
   virtual void GetRandomData(
       const std::unordered_set<uint16_t>& slots_to_replace,
       std::vector<Record>* result);
-  virtual ~MultiSlotDataset() {}
+  virtual ~MultiSlotDataset() {
+    if (streaming_shuffle_thread_.joinable()) {
+      streaming_shuffle_thread_.join();
+    }
+  }
+  virtual void RegisterClientToClientMsgHandler();
   virtual void GlobalShuffle(int thread_num = -1);
+  virtual void StreamingGlobalShuffle(int thread_num = -1);
+  virtual void WaitStreamingGlobalShuffleDone();
   virtual void DynamicAdjustReadersNum(int thread_num);
   virtual void PrepareTrain();
+  virtual void LocalShuffle();
+  virtual void CreateReaders();
+  virtual void DestroyReaders();
+  virtual int64_t GetMemoryDataSize();
+  virtual void ReleaseMemory();
 
  protected:
   virtual int ReceiveFromClient(int msg_type,
                                 int client_id,
                                 const std::string& msg);
+  // send the records to the trainers they are shuffled to, and wait
+  void SendToClients(std::vector<Record>* data);
+  // put the records to the output channels one by one
+  void WriteToOutputChannel(std::vector<Record>* data);
+  void StreamingGlobalShuffleFunc(int thread_num);
+  // called when a trainer has sent all its data of the streaming global
+  // shuffle, the output channels are closed when all trainers have done
+  void FinishStreamingShuffleFromClient();
+
+  std::thread streaming_shuffle_thread_;
+  std::mutex streaming_shuffle_mutex_;
+  std::condition_variable streaming_shuffle_cond_;
+  int streaming_shuffle_finished_num_ = 0;
+
+  // move the records in the column store back to the input channel, for the
+  // processes of the records in the channel
+  void RestoreColumnStore();
+
+  // the locally shuffled records if FLAGS_enable_dataset_column_store is set,
+  // which are read by the readers instead of the channels
+  RecordColumnStore column_store_;
 };
 class SlotRecordDataset : public DatasetImpl<SlotRecord> {
  public:
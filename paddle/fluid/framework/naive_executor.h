@@ -90,6 +90,10 @@ class NaiveExecutor {
 
   Scope* GetScope() { return scope_; }
 
+  const framework::InterpreterCore* GetInterpreterCore() const {
+    return interpreter_core_.get();
+  }
+
   void MakeReusePlan(
       const std::unordered_map<std::string, std::string>& reuse_table);
 
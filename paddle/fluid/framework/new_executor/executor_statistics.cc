@@ -193,6 +193,8 @@ void StatisticsEngine::InitStdEvents() {
   names_.emplace_back("FreeDeviceMem");
   name2idx_["ThreadpoolAddTask"] = names_.size();
   names_.emplace_back("ThreadpoolAddTask");
+  name2idx_["IntraOpParallel"] = names_.size();
+  names_.emplace_back("IntraOpParallel");
 
   size_t n = names_.size();
   filters_.resize(n);
@@ -213,6 +215,7 @@ void StatisticsEngine::InitInnerthreadPriorityForStdEvents() {
   priorities_[name2idx_["DataTransform"]].innerthread_priority = prio;
 
   priorities_[name2idx_["RunOp"]].innerthread_priority = ++prio;
+  priorities_[name2idx_["IntraOpParallel"]].innerthread_priority = prio;
 
   priorities_[name2idx_["CplusplusEnd"]].innerthread_priority = ++prio;
 
@@ -230,6 +233,7 @@ void StatisticsEngine::InitInterthreadPriorityForStdEvents() {
   priorities_[name2idx_["GarbageCollect"]].interthread_priority = ++prio;
   priorities_[name2idx_["OpInfershape"]].interthread_priority = ++prio;
   priorities_[name2idx_["DataTransform"]].interthread_priority = ++prio;
+  priorities_[name2idx_["IntraOpParallel"]].interthread_priority = ++prio;
 
   priorities_[name2idx_["RunOp"]].interthread_priority = ++prio;
   priorities_[name2idx_["CplusplusEnd"]].interthread_priority = ++prio;
@@ -335,6 +339,10 @@ int StatisticsEngine::InitFiltersForInterpreterCore() {
          RegisterEventFilter("ThreadpoolAddTask",
                              [](const platform::HostTraceEventNode& evt) {
                                return evt.Name() == "WorkQueue::AddTask";
+                             }) ||
+         RegisterEventFilter("IntraOpParallel",
+                             [](const platform::HostTraceEventNode& evt) {
+                               return evt.Name() == "IntraOpParallel";
                              });
 }
 
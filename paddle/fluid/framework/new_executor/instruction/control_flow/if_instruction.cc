@@ -148,6 +148,7 @@ IfInstruction::IfInstruction(size_t id,
   auto skip_gc_vars = execution_config.skip_gc_vars;
   execution_config.skip_gc_vars.clear();
   execution_config.create_local_scope = true;
+  execution_config.instruction_dependencies = nullptr;
   true_branch_inter_ = new PirInterpreter(place,
                                           {},
                                           &true_branch_block,
@@ -121,6 +121,7 @@ PyLayerInstruction::PyLayerInstruction(
   auto skip_gc_vars = execution_config.skip_gc_vars;
   execution_config.skip_gc_vars.clear();
   execution_config.create_local_scope = true;
+  execution_config.instruction_dependencies = nullptr;
   fwd_inter_ = new PirInterpreter(place,
                                   {},
                                   &fwd_block,
@@ -130,6 +130,7 @@ WhileInstruction::WhileInstruction(
   auto skip_gc_vars = execution_config.skip_gc_vars;
   execution_config.skip_gc_vars.clear();
   execution_config.create_local_scope = true;
+  execution_config.instruction_dependencies = nullptr;
   body_inter_ = std::unique_ptr<PirInterpreter>(new PirInterpreter(
       place, {}, body_block_, body_scope, body_exe_info, execution_config));
 
@@ -83,6 +83,11 @@ class InstructionBase {
     next_instrs_in_same_thread_.push_back(id);
   }
 
+  void ClearNextInstrs() {
+    next_instrs_in_different_thread_.clear();
+    next_instrs_in_same_thread_.clear();
+  }
+
   bool IsForceRecordEvent() const { return force_record_event_; }
   void SetForceRecordEvent(bool force_record) {
     force_record_event_ = force_record;
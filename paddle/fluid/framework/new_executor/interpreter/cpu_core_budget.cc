@@ -0,0 +1,126 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/cpu_core_budget.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "paddle/common/enforce.h"
+#include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+#include "paddle/fluid/framework/new_executor/interpreter/critical_path_scheduler.h"
+#include "paddle/phi/core/platform/cpu_helper.h"
+#include "paddle/pir/include/core/operation.h"
+
+namespace paddle::framework::interpreter {
+
+CpuCoreBudget::CpuCoreBudget(int num_cores)
+    : num_cores_(num_cores), free_cores_(num_cores) {
+  PADDLE_ENFORCE_GT(num_cores,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The CPU core budget should be greater than 0, but "
+                        "received %d.",
+                        num_cores));
+}
+
+void CpuCoreBudget::Plan(
+    const std::vector<std::unique_ptr<InstructionBase>>& instructions) {
+  desired_threads_.assign(instructions.size(), 1);
+  for (size_t i = 0; i < instructions.size(); ++i) {
+    // Control flow ops run their sub blocks by their own interpreters.
+    auto* op = instructions[i]->Operation();
+    if (op != nullptr && op->num_regions() > 0) {
+      continue;
+    }
+    double cost = EstimateInstructionCost(*instructions[i]);
+    SetDesiredThreads(i, static_cast<int>(std::min<double>(
+                             std::ceil(cost / kCostPerThread), num_cores_)));
+  }
+}
+
+void CpuCoreBudget::SetDesiredThreads(size_t instr_id, int num_threads) {
+  if (instr_id >= desired_threads_.size()) {
+    desired_threads_.resize(instr_id + 1, 1);
+  }
+  desired_threads_[instr_id] = std::clamp(num_threads, 1, num_cores_);
+}
+
+int CpuCoreBudget::Acquire(size_t instr_id) {
+  // The core of the running thread is taken even if the budget is used up,
+  // since the instruction has to run anyway.
+  int free = free_cores_.fetch_sub(1, std::memory_order_acq_rel) - 1;
+  int desired =
+      instr_id < desired_threads_.size() ? desired_threads_[instr_id] : 1;
+  int extra = 0;
+  while (desired > 1 && free > 0) {
+    extra = std::min(desired - 1, free);
+    if (free_cores_.compare_exchange_weak(
+            free, free - extra, std::memory_order_acq_rel)) {
+      break;
+    }
+    extra = 0;
+  }
+  int num_threads = 1 + extra;
+
+  num_acquired_.fetch_add(1, std::memory_order_relaxed);
+  num_threads_sum_.fetch_add(num_threads, std::memory_order_relaxed);
+  if (num_threads > 1) {
+    num_parallel_.fetch_add(1, std::memory_order_relaxed);
+  }
+  int used = num_cores_ - free + extra;
+  int peak = peak_used_cores_.load(std::memory_order_relaxed);
+  while (used > peak && !peak_used_cores_.compare_exchange_weak(
+                            peak, used, std::memory_order_relaxed)) {
+  }
+  return num_threads;
+}
+
+void CpuCoreBudget::Release(int num_threads) {
+  free_cores_.fetch_add(num_threads, std::memory_order_acq_rel);
+}
+
+std::string CpuCoreBudget::Summary() const {
+  int64_t num_acquired = num_acquired_.load();
+  std::stringstream ss;
+  ss << "CPU core budget " << num_cores_ << ": " << num_acquired
+     << " instructions run, " << num_parallel_.load()
+     << " of them with more than one intra-op thread, "
+     << (num_acquired == 0 ? 0.0
+                           : static_cast<double>(num_threads_sum_.load()) /
+                                 static_cast<double>(num_acquired))
+     << " intra-op threads on average, peak " << peak_used_cores_.load()
+     << " cores in use.";
+  return ss.str();
+}
+
+CpuCoreGuard::CpuCoreGuard(CpuCoreBudget* budget, size_t instr_id)
+    : budget_(budget) {
+  if (budget_ == nullptr) {
+    return;
+  }
+  num_threads_ = budget_->Acquire(instr_id);
+  prev_num_threads_ = platform::SetThreadLocalNumThreads(num_threads_);
+}
+
+CpuCoreGuard::~CpuCoreGuard() {
+  if (budget_ == nullptr) {
+    return;
+  }
+  platform::SetThreadLocalNumThreads(prev_num_threads_);
+  budget_->Release(num_threads_);
+}
+
+}  // namespace paddle::framework::interpreter
@@ -0,0 +1,91 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "paddle/utils/test_macros.h"
+
+namespace paddle {
+namespace framework {
+class InstructionBase;
+namespace interpreter {
+
+// CpuCoreBudget shares a fixed number of CPU cores between the inter-op
+// parallelism of the executor and the intra-op parallelism of the kernels.
+//
+// A running instruction always takes one core for the thread that runs it,
+// and takes more cores for its OpenMP/MKL threads only if they are idle, up
+// to the number of threads its cost deserves. So when many independent
+// instructions run at the same time, each of them runs with a single thread,
+// and when few do, the large ones run with many threads, instead of
+// oversubscribing the cores in both cases.
+class TEST_API CpuCoreBudget {
+ public:
+  // An instruction deserves one intra-op thread per this much cost, see
+  // EstimateInstructionCost.
+  static constexpr double kCostPerThread = 1 << 16;
+
+  explicit CpuCoreBudget(int num_cores);
+
+  // Compute the intra-op threads each instruction deserves.
+  void Plan(const std::vector<std::unique_ptr<InstructionBase>>& instructions);
+
+  // Set the number of intra-op threads an instruction deserves.
+  void SetDesiredThreads(size_t instr_id, int num_threads);
+
+  // Take the cores to run an instruction, return the number of its intra-op
+  // threads, which is at least 1.
+  int Acquire(size_t instr_id);
+
+  // Give back the cores taken by Acquire.
+  void Release(int num_threads);
+
+  int NumCores() const { return num_cores_; }
+
+  std::string Summary() const;
+
+ private:
+  const int num_cores_;
+  std::atomic<int> free_cores_;
+  std::vector<int> desired_threads_;
+
+  std::atomic<int64_t> num_acquired_{0};
+  std::atomic<int64_t> num_parallel_{0};
+  std::atomic<int64_t> num_threads_sum_{0};
+  std::atomic<int> peak_used_cores_{0};
+};
+
+// Run the instruction on the current thread with the intra-op threads granted
+// by `budget`, which can be null.
+class CpuCoreGuard {
+ public:
+  CpuCoreGuard(CpuCoreBudget* budget, size_t instr_id);
+  ~CpuCoreGuard();
+
+  int NumThreads() const { return num_threads_; }
+
+ private:
+  CpuCoreBudget* budget_;
+  int num_threads_{1};
+  int prev_num_threads_{1};
+};
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
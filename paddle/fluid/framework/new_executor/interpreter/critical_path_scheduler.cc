@@ -0,0 +1,215 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/critical_path_scheduler.h"
+
+#include <algorithm>
+#include <queue>
+#include <string>
+
+#include "paddle/common/enforce.h"
+#include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_type.h"
+#include "paddle/pir/include/core/builtin_attribute.h"
+#include "paddle/pir/include/core/operation.h"
+
+namespace paddle::framework::interpreter {
+
+namespace {
+
+// Every instruction costs at least as much as touching this many elements,
+// which stands for the overhead of dispatching and launching it.
+constexpr double kInstructionOverhead = 1024;
+
+std::vector<int64_t> StaticDims(pir::Value value) {
+  if (!value || !value.type()) {
+    return {};
+  }
+  auto type =
+      value.type().dyn_cast<paddle::dialect::AllocatedDenseTensorType>();
+  if (!type) {
+    return {};
+  }
+  auto dims = common::vectorize(type.dims());
+  // Unknown dims are counted as 1.
+  for (auto& dim : dims) {
+    dim = std::max<int64_t>(dim, 1);
+  }
+  return dims;
+}
+
+double Numel(pir::Value value) {
+  auto dims = StaticDims(value);
+  if (dims.empty()) {
+    return 0;
+  }
+  double numel = 1;
+  for (int64_t dim : dims) {
+    numel *= static_cast<double>(dim);
+  }
+  return numel;
+}
+
+double MatmulFlops(pir::Operation* op) {
+  auto x_dims = StaticDims(op->operand_source(0));
+  if (x_dims.empty()) {
+    return 0;
+  }
+  bool transpose_x = op->HasAttribute("transpose_x") &&
+                     op->attribute<pir::BoolAttribute>("transpose_x").data();
+  int64_t k = x_dims.back();
+  if (transpose_x && x_dims.size() >= 2) {
+    k = x_dims[x_dims.size() - 2];
+  }
+  return 2.0 * Numel(op->result(0)) * static_cast<double>(k);
+}
+
+double ConvFlops(pir::Operation* op) {
+  // Each output element is reduced from (filter numel / output channels)
+  // products.
+  auto filter_dims = StaticDims(op->operand_source(1));
+  if (filter_dims.empty()) {
+    return 0;
+  }
+  return 2.0 * Numel(op->result(0)) * Numel(op->operand_source(1)) /
+         static_cast<double>(filter_dims[0]);
+}
+
+}  // namespace
+
+double EstimateInstructionCost(const InstructionBase& instr) {
+  pir::Operation* op = instr.Operation();
+  if (op == nullptr) {
+    return kInstructionOverhead;
+  }
+  const std::string& name = instr.Name();
+  double cost = 0;
+  if (name == "pd_op.matmul" && op->num_operands() >= 2 &&
+      op->num_results() >= 1) {
+    cost = MatmulFlops(op);
+  } else if ((name == "pd_op.conv2d" || name == "pd_op.depthwise_conv2d" ||
+              name == "pd_op.conv3d") &&
+             op->num_operands() >= 2 && op->num_results() >= 1) {
+    cost = ConvFlops(op);
+  } else {
+    for (size_t i = 0; i < op->num_operands(); ++i) {
+      cost += Numel(op->operand_source(i));
+    }
+    for (size_t i = 0; i < op->num_results(); ++i) {
+      cost += Numel(op->result(i));
+    }
+  }
+  return kInstructionOverhead + cost;
+}
+
+std::vector<double> ComputePathLength(
+    const std::vector<double>& costs,
+    const std::map<size_t, std::set<size_t>>& downstream_map) {
+  size_t instr_num = costs.size();
+  std::vector<size_t> in_degree(instr_num, 0);
+  for (const auto& [instr_id, next_ids] : downstream_map) {
+    for (size_t next_id : next_ids) {
+      ++in_degree[next_id];
+    }
+  }
+
+  std::vector<size_t> topo_order;
+  topo_order.reserve(instr_num);
+  std::queue<size_t> ready;
+  for (size_t instr_id = 0; instr_id < instr_num; ++instr_id) {
+    if (in_degree[instr_id] == 0) {
+      ready.push(instr_id);
+    }
+  }
+  while (!ready.empty()) {
+    size_t instr_id = ready.front();
+    ready.pop();
+    topo_order.push_back(instr_id);
+    auto iter = downstream_map.find(instr_id);
+    if (iter == downstream_map.end()) {
+      continue;
+    }
+    for (size_t next_id : iter->second) {
+      if (--in_degree[next_id] == 0) {
+        ready.push(next_id);
+      }
+    }
+  }
+  PADDLE_ENFORCE_EQ(
+      topo_order.size(),
+      instr_num,
+      common::errors::PreconditionNotMet(
+          "The dependencies of instructions contain a cycle, only %d of %d "
+          "instructions are sorted.",
+          topo_order.size(),
+          instr_num));
+
+  std::vector<double> path_length(instr_num, 0);
+  for (auto it = topo_order.rbegin(); it != topo_order.rend(); ++it) {
+    double longest_downstream = 0;
+    auto iter = downstream_map.find(*it);
+    if (iter != downstream_map.end()) {
+      for (size_t next_id : iter->second) {
+        longest_downstream = std::max(longest_downstream, path_length[next_id]);
+      }
+    }
+    path_length[*it] = costs[*it] + longest_downstream;
+  }
+  return path_length;
+}
+
+CriticalPathScheduler::CriticalPathScheduler(
+    const std::vector<std::unique_ptr<InstructionBase>>& instructions,
+    const std::map<size_t, std::set<size_t>>& downstream_map)
+    : downstream_map_(downstream_map),
+      measured_costs_(instructions.size(), 0) {
+  costs_.reserve(instructions.size());
+  for (const auto& instr : instructions) {
+    costs_.push_back(EstimateInstructionCost(*instr));
+  }
+  UpdatePathLength();
+}
+
+void CriticalPathScheduler::BeginRun() {
+  ++run_count_;
+  profiling_ = run_count_ > kWarmupRuns &&
+               run_count_ <= kWarmupRuns + kProfileRuns;
+}
+
+bool CriticalPathScheduler::EndRun() {
+  if (!profiling_) {
+    return false;
+  }
+  profiling_ = false;
+  if (run_count_ < kWarmupRuns + kProfileRuns) {
+    return false;
+  }
+  for (size_t i = 0; i < costs_.size(); ++i) {
+    costs_[i] = measured_costs_[i] / kProfileRuns;
+  }
+  UpdatePathLength();
+  VLOG(4) << "Update the critical path by the profiled costs, critical path "
+          << critical_path_length_ << " us";
+  return true;
+}
+
+void CriticalPathScheduler::UpdatePathLength() {
+  path_length_ = ComputePathLength(costs_, downstream_map_);
+  critical_path_length_ = path_length_.empty()
+                              ? 0
+                              : *std::max_element(path_length_.begin(),
+                                                  path_length_.end());
+}
+
+}  // namespace paddle::framework::interpreter
@@ -0,0 +1,107 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "paddle/utils/test_macros.h"
+
+namespace paddle {
+namespace framework {
+class InstructionBase;
+namespace interpreter {
+
+// Estimate the cost of an instruction from the shapes of its operands, in
+// the number of floating point operations for matmul and conv ops, and in the
+// number of elements read and written for the others.
+double EstimateInstructionCost(const InstructionBase& instr);
+
+// Return the length of the longest path from each instruction to the end of
+// the program, where the length of a path is the sum of the costs of the
+// instructions on it, including the first one.
+TEST_API std::vector<double> ComputePathLength(
+    const std::vector<double>& costs,
+    const std::map<size_t, std::set<size_t>>& downstream_map);
+
+// CriticalPathScheduler orders the ready instructions by the length of the
+// longest path from them to the end of the program, so that the instructions
+// on the critical path of a multi-branch program are dispatched first, and
+// the short branches fill the idle threads.
+//
+// The costs are estimated by EstimateInstructionCost at first. After
+// kWarmupRuns runs, the instructions are timed for kProfileRuns runs, and the
+// average measured time replaces the estimation.
+class CriticalPathScheduler {
+ public:
+  static constexpr size_t kWarmupRuns = 1;
+  static constexpr size_t kProfileRuns = 3;
+
+  CriticalPathScheduler(
+      const std::vector<std::unique_ptr<InstructionBase>>& instructions,
+      const std::map<size_t, std::set<size_t>>& downstream_map);
+
+  // Return true if `lhs` should run after `rhs`.
+  bool Less(size_t lhs, size_t rhs) const {
+    if (path_length_[lhs] == path_length_[rhs]) {
+      return lhs > rhs;
+    }
+    return path_length_[lhs] < path_length_[rhs];
+  }
+
+  double Cost(size_t instr_id) const { return costs_[instr_id]; }
+
+  double PathLength(size_t instr_id) const { return path_length_[instr_id]; }
+
+  // Length of the critical path of the whole program.
+  double CriticalPathLength() const { return critical_path_length_; }
+
+  const std::map<size_t, std::set<size_t>>& DownstreamMap() const {
+    return downstream_map_;
+  }
+
+  bool IsProfiled() const { return run_count_ >= kWarmupRuns + kProfileRuns; }
+
+  // Called before and after each multi-thread run. EndRun returns true if
+  // the costs are replaced by the profiled ones in this run.
+  void BeginRun();
+  bool EndRun();
+
+  bool IsProfiling() const { return profiling_; }
+
+  // Record the time of an instruction in the current run. Each instruction
+  // runs once per run, so it is safe to call from different threads.
+  void RecordCost(size_t instr_id, double elapsed_us) {
+    measured_costs_[instr_id] += elapsed_us;
+  }
+
+ private:
+  void UpdatePathLength();
+
+  std::map<size_t, std::set<size_t>> downstream_map_;
+  std::vector<double> costs_;
+  std::vector<double> measured_costs_;
+  std::vector<double> path_length_;
+  double critical_path_length_{0};
+
+  size_t run_count_{0};
+  bool profiling_{false};
+};
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
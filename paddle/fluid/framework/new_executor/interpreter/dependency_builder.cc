@@ -767,6 +767,58 @@ void PirDependencyBuilder::BuildDownstreamMap() {
   }
 }
 
+bool PirDependencyBuilder::Restore(
+    std::vector<paddle::framework::InstructionBase*> instructions,
+    const std::map<size_t, std::set<size_t>>& downstream_map) {
+  if (is_build_) {
+    return true;
+  }
+
+  size_t op_num = instructions.size();
+  for (auto& item : downstream_map) {
+    for (size_t next_op_idx : item.second) {
+      // All the dependencies added by Build point to a later instruction.
+      if (next_op_idx <= item.first || next_op_idx >= op_num) {
+        VLOG(3) << "Invalid dependency " << item.first << "->" << next_op_idx
+                << " for " << op_num << " instructions.";
+        return false;
+      }
+    }
+  }
+
+  instructions_ = instructions;
+  op_num_ = op_num;
+  op_downstream_map_ =
+      std::make_shared<std::map<size_t, std::set<size_t>>>(downstream_map);
+  op_happens_before_ = std::make_shared<std::vector<std::vector<bool>>>(
+      op_num_, std::vector<bool>(op_num_, false));
+
+  // Since the dependencies only point to later instructions, the transitive
+  // closure of an instruction is complete once all the later ones are done.
+  for (size_t op_idx = op_num_; op_idx-- > 0;) {
+    auto iter = op_downstream_map_->find(op_idx);
+    if (iter == op_downstream_map_->end()) {
+      continue;
+    }
+    auto& happens_before = (*op_happens_before_)[op_idx];
+    for (size_t next_op_idx : iter->second) {
+      happens_before[next_op_idx] = true;
+      const auto& next_happens_before = (*op_happens_before_)[next_op_idx];
+      for (size_t i = next_op_idx + 1; i < op_num_; ++i) {
+        if (next_happens_before[i]) {
+          happens_before[i] = true;
+        }
+      }
+    }
+  }
+
+  VLOG(6) << "Finish restore dependency";
+  VLOG(8) << "downstream count: " << CountDownstreamMap(*op_downstream_map_);
+
+  is_build_ = true;
+  return true;
+}
+
 void PirDependencyBuilder::ShareDependencyFrom(
     const PirDependencyBuilder& src) {
   std::tie(op_downstream_map_, op_happens_before_) = src.GetDependency();
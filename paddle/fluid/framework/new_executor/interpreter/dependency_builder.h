@@ -122,6 +122,12 @@ class PirDependencyBuilder : public DependencyBuilder {
 
   void BuildDownstreamMap();
 
+  // Restore the dependencies built by Build before, e.g. from an execution plan
+  // saved by another process, instead of analysing the instructions again.
+  // Return false if the downstream map does not fit the instructions.
+  bool Restore(std::vector<paddle::framework::InstructionBase*> instructions,
+               const std::map<size_t, std::set<size_t>>& downstream_map);
+
   void ShareDependencyFrom(const PirDependencyBuilder& src);
 
   bool IsSameDeviceContext(size_t op1, size_t op2) const {
@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/framework/new_executor/interpreter/execution_config.h"
 
+#include <algorithm>
 #include <set>
 #include <thread>
 
@@ -37,6 +38,39 @@ PHI_DEFINE_EXPORTED_string(force_sync_ops,
                            "",
                            "Pattern to force sync ops in executor.");
 
+PHI_DEFINE_EXPORTED_int32(
+    new_executor_numa_node,
+    -1,
+    "Pin the host worker threads of the executor to this NUMA node, so that "
+    "the tensors they allocate stay local when FLAGS_use_numa_cpu_allocator "
+    "is set. -1 means no pinning.");
+
+PHI_DEFINE_EXPORTED_bool(
+    new_executor_static_memory_plan,
+    false,
+    "Plan the memory of the static shaped intermediate values of a PIR "
+    "program at build time and back them with one arena, instead of "
+    "allocating and garbage collecting them in each run. Only takes effect "
+    "for CPU programs run in trace mode, dynamic shaped values still use the "
+    "allocator.");
+
+PHI_DEFINE_EXPORTED_string(
+    new_executor_scheduling_policy,
+    "default",
+    "The order in which the executor dispatches ready instructions of PIR "
+    "programs, 'default' orders them by their scheduling priority, "
+    "'critical_path' runs the instructions on the longest path to the end of "
+    "the program first.");
+
+PHI_DEFINE_EXPORTED_int32(
+    new_executor_cpu_core_budget,
+    0,
+    "Number of CPU cores shared by the host worker threads of the executor "
+    "and the OpenMP/MKL threads of the CPU kernels they run. Each instruction "
+    "takes intra-op threads only from the idle cores, so that the two levels "
+    "of parallelism do not oversubscribe the cores. 0 means no "
+    "co-scheduling.");
+
 PD_DECLARE_bool(new_executor_serial_run);
 
 namespace paddle::framework::interpreter {
@@ -131,6 +165,29 @@ void ExecutionConfig::AnalyzeThreadPoolConfig(const phi::Place& place,
     std::tie(host_num_threads, device_num_threads) =
         GetThreadPoolConfig(place, op_num);
   }
+  if (numa_node < 0) {
+    numa_node = FLAGS_new_executor_numa_node;
+  }
+  if (cpu_core_budget == 0) {
+    cpu_core_budget = FLAGS_new_executor_cpu_core_budget;
+  }
+  if (cpu_core_budget > 0 && phi::is_cpu_place(place)) {
+    // Not more worker threads than cores, so the budget is never exceeded by
+    // the inter-op parallelism alone.
+    host_num_threads =
+        std::min(host_num_threads, static_cast<size_t>(cpu_core_budget));
+  }
+  static_memory_plan |= FLAGS_new_executor_static_memory_plan;
+  if (scheduling_policy.empty()) {
+    scheduling_policy = FLAGS_new_executor_scheduling_policy;
+  }
+  PADDLE_ENFORCE_EQ(
+      scheduling_policy == "default" || scheduling_policy == "critical_path",
+      true,
+      phi::errors::InvalidArgument(
+          "The scheduling policy should be 'default' or 'critical_path', but "
+          "received '%s'.",
+          scheduling_policy));
 }
 
 void ExecutionConfig::Log(int log_level) {
@@ -142,7 +199,13 @@ void ExecutionConfig::Log(int log_level) {
           << "used_for_jit = " << used_for_jit << "\n"
           << "used_for_sot = " << used_for_sot << "\n"
           << "device_num_threads = " << device_num_threads << "\n"
-          << "host_num_threads = " << host_num_threads << "\n";
+          << "host_num_threads = " << host_num_threads << "\n"
+          << "numa_node = " << numa_node << "\n"
+          << "static_memory_plan = " << static_memory_plan << "\n"
+          << "scheduling_policy = " << scheduling_policy << "\n"
+          << "cpu_core_budget = " << cpu_core_budget << "\n"
+          << "instruction_dependencies = "
+          << (instruction_dependencies ? "restored" : "none") << "\n";
 
   log_str << "force_root_scope_vars = [";
   for (const std::string& var : force_root_scope_vars) {
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -34,6 +36,26 @@ struct ExecutionConfig {
 
   size_t device_num_threads{0};
   size_t host_num_threads{0};
+  // NUMA node to pin the host worker threads to, -1 means no pinning.
+  int numa_node{-1};
+  // Pre-assign the memory of static shaped values in one arena, see
+  // StaticMemoryPlanner.
+  bool static_memory_plan{false};
+  // The order to dispatch ready instructions, empty means
+  // FLAGS_new_executor_scheduling_policy.
+  //   "default": by the scheduling priority of instructions.
+  //   "critical_path": the instructions on the longest path to the end of the
+  //     program first, see CriticalPathScheduler.
+  std::string scheduling_policy;
+  // Number of CPU cores shared by the host worker threads and the intra-op
+  // threads of CPU kernels, see CpuCoreBudget. 0 means no co-scheduling.
+  int cpu_core_budget{0};
+  // The downstream map of instructions saved in an execution plan, which is
+  // restored instead of built from the program, see
+  // PirDependencyBuilder::Restore. Not passed to the interpreters of sub
+  // blocks.
+  std::shared_ptr<const std::map<size_t, std::set<size_t>>>
+      instruction_dependencies;
 
   std::set<std::pair<int, std::string>>
       force_sync_ops;  // set{pair<op_id, name>}, -1 matches any op_id, ""
@@ -53,6 +53,12 @@ COMMON_DECLARE_bool(check_nan_inf);
 COMMON_DECLARE_string(static_runtime_data_save_path);
 COMMON_DECLARE_bool(save_static_runtime_data);
 
+PHI_DEFINE_EXPORTED_bool(
+    new_executor_lock_free_run_queue,
+    false,
+    "Use the lock-free run queue for the worker threads of the executor, "
+    "which avoids contention on the queue lock with many fine-grained tasks.");
+
 namespace paddle::framework::interpreter {
 
 using VariableIdMap = std::map<std::string, std::vector<int>>;
@@ -90,7 +96,10 @@ class SingleStreamGuard {
 };
 
 const std::vector<WorkQueueOptions> ConstructWorkQueueOptions(
-    size_t host_num_threads, size_t device_num_threads, EventsWaiter* waiter) {
+    size_t host_num_threads,
+    size_t device_num_threads,
+    EventsWaiter* waiter,
+    int numa_node) {
   std::vector<WorkQueueOptions> group_options;
   // for execute host Kernel
   group_options.emplace_back(/*name*/ "HostTasks",
@@ -100,6 +109,8 @@ const std::vector<WorkQueueOptions> ConstructWorkQueueOptions(
                              /*track_task*/ false,
                              /*detached*/ true,
                              /*events_waiter*/ waiter);
+  group_options.back().numa_node = numa_node;
+  group_options.back().lock_free_queue = FLAGS_new_executor_lock_free_run_queue;
   // for launch device Kernel
   group_options.emplace_back(/*name*/ "DeviceKernelLaunch",
                              /*num_threads*/ device_num_threads,
@@ -108,15 +119,17 @@ const std::vector<WorkQueueOptions> ConstructWorkQueueOptions(
                              /*track_task*/ false,
                              /*detached*/ true,
                              /*events_waiter*/ waiter);
+  group_options.back().lock_free_queue = FLAGS_new_executor_lock_free_run_queue;
   return group_options;
 }
 
 AsyncWorkQueue::AsyncWorkQueue(size_t host_num_threads,
                                size_t device_num_threads,
-                               EventsWaiter* waiter)
+                               EventsWaiter* waiter,
+                               int numa_node)
     : host_num_thread_(host_num_threads),
       queue_group_(CreateWorkQueueGroup(ConstructWorkQueueOptions(
-          host_num_threads, device_num_threads, waiter))) {}
+          host_num_threads, device_num_threads, waiter, numa_node))) {}
 
 void AsyncWorkQueue::AddTask(const OpFuncType& op_func_type,
                              std::function<void()> fn) {
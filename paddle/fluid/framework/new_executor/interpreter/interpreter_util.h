@@ -49,7 +49,8 @@ class AsyncWorkQueue {
  public:
   AsyncWorkQueue(size_t host_num_threads,
                  size_t device_num_threads,
-                 EventsWaiter* waiter);
+                 EventsWaiter* waiter,
+                 int numa_node = -1);
 
   // void WaitEmpty() { queue_group_->WaitQueueGroupEmpty(); }
 
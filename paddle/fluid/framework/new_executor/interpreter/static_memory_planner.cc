@@ -0,0 +1,272 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/static_memory_planner.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <unordered_set>
+
+#include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+#include "paddle/fluid/framework/new_executor/pir_adaptor/pir_adaptor_util.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_op.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_type.h"
+#include "paddle/fluid/pir/dialect/operator/utils/utils.h"
+#include "paddle/phi/common/data_type.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/memory/malloc.h"
+
+namespace paddle::framework::interpreter {
+
+namespace {
+
+constexpr size_t kBlockAlignment = 64;
+constexpr size_t kNotUsed = std::numeric_limits<size_t>::max();
+
+// Ops whose outputs are fed or fetched by the caller.
+const std::unordered_set<std::string> kUnplannedProducers = {
+    "pd_op.data",
+    "pd_op.feed",
+    "pd_op.fetch",
+    "pd_op.shadow_feed",
+    "pd_op.shadow_feed_tensors"};
+
+// Ops that make their inputs visible outside the program.
+const std::unordered_set<std::string> kEscapingUsers = {
+    "builtin.shadow_output",
+    "builtin.set_parameter",
+    "builtin.set_persistable_value",
+    "cf.yield"};
+
+// A slice of the arena, which keeps the arena alive as long as any tensor
+// holds it.
+class ArenaViewAllocation : public phi::Allocation {
+ public:
+  ArenaViewAllocation(std::shared_ptr<phi::Allocation> arena,
+                      size_t offset,
+                      size_t size)
+      : phi::Allocation(static_cast<uint8_t*>(arena->ptr()) + offset,
+                        size,
+                        arena->place()),
+        arena_(std::move(arena)) {}
+
+ private:
+  std::shared_ptr<phi::Allocation> arena_;
+};
+
+bool Overlap(const MemoryBlock& a, const MemoryBlock& b) {
+  return a.first_use <= b.last_use && b.first_use <= a.last_use;
+}
+
+// Return the aligned size of the static shaped dense tensor `value` on
+// `place`, or 0 if its memory can not be planned.
+size_t StaticTensorSize(pir::Value value, const phi::Place& place) {
+  auto type = value.type().dyn_cast<paddle::dialect::AllocatedDenseTensorType>();
+  if (!type || type.place() != place) {
+    return 0;
+  }
+  const auto& dims = type.dims();
+  if (common::contain_unknown_dim(dims)) {
+    return 0;
+  }
+  int64_t numel = common::product(dims);
+  size_t bytes = static_cast<size_t>(numel) *
+                 phi::SizeOf(paddle::dialect::TransToPhiDataType(type.dtype()));
+  return (bytes + kBlockAlignment - 1) / kBlockAlignment * kBlockAlignment;
+}
+
+bool IsEscaping(pir::Value value) {
+  for (auto it = value.use_begin(); it != value.use_end(); ++it) {
+    if (kEscapingUsers.count(it->owner()->name())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+size_t AssignMemoryOffsets(std::vector<MemoryBlock>* blocks) {
+  std::vector<size_t> order(blocks->size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    const auto& lhs = blocks->at(a);
+    const auto& rhs = blocks->at(b);
+    return lhs.size != rhs.size ? lhs.size > rhs.size
+                                : lhs.first_use < rhs.first_use;
+  });
+
+  size_t arena_size = 0;
+  std::vector<size_t> placed;
+  std::vector<const MemoryBlock*> conflicts;
+  for (size_t idx : order) {
+    auto& block = blocks->at(idx);
+    conflicts.clear();
+    for (size_t other : placed) {
+      if (Overlap(block, blocks->at(other))) {
+        conflicts.push_back(&blocks->at(other));
+      }
+    }
+    std::sort(conflicts.begin(),
+              conflicts.end(),
+              [](const MemoryBlock* a, const MemoryBlock* b) {
+                return a->offset < b->offset;
+              });
+
+    // Find the smallest gap between the conflicting blocks that fits, or
+    // place the block after all of them.
+    size_t best_offset = kNotUsed;
+    size_t best_gap = kNotUsed;
+    size_t gap_begin = 0;
+    for (const auto* other : conflicts) {
+      if (other->offset > gap_begin) {
+        size_t gap = other->offset - gap_begin;
+        if (gap >= block.size && gap < best_gap) {
+          best_gap = gap;
+          best_offset = gap_begin;
+        }
+      }
+      gap_begin = std::max(gap_begin, other->offset + other->size);
+    }
+    block.offset = best_offset == kNotUsed ? gap_begin : best_offset;
+    arena_size = std::max(arena_size, block.offset + block.size);
+    placed.push_back(idx);
+  }
+  return arena_size;
+}
+
+size_t StaticMemoryPlanner::Plan(
+    const std::vector<std::unique_ptr<InstructionBase>>& instructions,
+    const std::vector<size_t>& execute_order,
+    const ValueExecutionInfo& value_exe_info,
+    const std::set<std::string>& skip_var_names) {
+  const auto& var_list = value_exe_info.GetVarList();
+  size_t var_num = var_list.size();
+
+  // Variables sharing a buffer by inplace or view ops form a group, which is
+  // alive until the last use of any of them.
+  std::vector<size_t> group(var_num);
+  std::iota(group.begin(), group.end(), 0);
+  auto find = [&](size_t id) {
+    while (group[id] != id) {
+      group[id] = group[group[id]];
+      id = group[id];
+    }
+    return id;
+  };
+  for (const auto& instr : instructions) {
+    for (const auto& [in, out] : instr->InplaceInfo()) {
+      int in_id = value_exe_info.GetVarId(in);
+      int out_id = value_exe_info.GetVarId(out);
+      if (in_id >= 0 && out_id >= 0) {
+        group[find(out_id)] = find(in_id);
+      }
+    }
+  }
+
+  // Liveness of each group in the execution order, the group is planned only
+  // if its first use is an output of a kernel, whose variable owns the
+  // buffer.
+  std::vector<size_t> first_use(var_num, kNotUsed);
+  std::vector<size_t> last_use(var_num, 0);
+  std::vector<size_t> size(var_num, 0);
+  std::vector<size_t> owner(var_num, 0);
+  std::vector<bool> plannable(var_num, true);
+  for (size_t pos = 0; pos < execute_order.size(); ++pos) {
+    auto* instr = instructions.at(execute_order[pos]).get();
+    bool is_kernel =
+        instr->Operation()->isa<paddle::dialect::PhiKernelOp>() &&
+        !kUnplannedProducers.count(instr->Name());
+    for (const auto& [value, ids] : instr->Inputs()) {
+      for (int id : ids) {
+        size_t root = find(id);
+        if (first_use[root] == kNotUsed) {
+          first_use[root] = pos;
+          plannable[root] = false;
+        }
+        last_use[root] = pos;
+      }
+    }
+    for (const auto& [value, ids] : instr->Outputs()) {
+      bool escaping = IsEscaping(value);
+      for (int id : ids) {
+        size_t root = find(id);
+        if (first_use[root] == kNotUsed) {
+          first_use[root] = pos;
+          plannable[root] = is_kernel && ids.size() == 1;
+          size[root] = StaticTensorSize(value, place_);
+          owner[root] = id;
+        }
+        if (escaping) {
+          plannable[root] = false;
+        }
+        last_use[root] = pos;
+      }
+    }
+  }
+
+  for (size_t id = 0; id < var_num; ++id) {
+    size_t root = find(id);
+    const auto& name = value_exe_info.GetNameById(static_cast<int>(id));
+    if (skip_var_names.count(name) ||
+        !var_list[id]->IsType<phi::DenseTensor>()) {
+      plannable[root] = false;
+    }
+  }
+
+  planned_.assign(var_num, false);
+  for (size_t id = 0; id < var_num; ++id) {
+    if (find(id) != id || !plannable[id] || size[id] == 0) {
+      continue;
+    }
+    blocks_.push_back({size[id], first_use[id], last_use[id], 0});
+    var_ids_.push_back(owner[id]);
+    total_size_ += size[id];
+  }
+  for (size_t id = 0; id < var_num; ++id) {
+    size_t root = find(id);
+    planned_[id] = plannable[root] && size[root] != 0;
+  }
+
+  planned_peak_ = AssignMemoryOffsets(&blocks_);
+  VLOG(4) << "Static memory plan: " << var_ids_.size()
+          << " values, planned peak " << planned_peak_ << " bytes, "
+          << total_size_ << " bytes without sharing.";
+  return var_ids_.size();
+}
+
+void StaticMemoryPlanner::Bind(const ValueExecutionInfo& value_exe_info) {
+  if (var_ids_.empty()) {
+    return;
+  }
+  if (!arena_) {
+    arena_ = memory::AllocShared(place_, planned_peak_);
+    views_.reserve(blocks_.size());
+    for (const auto& block : blocks_) {
+      views_.emplace_back(std::make_shared<ArenaViewAllocation>(
+          arena_, block.offset, block.size));
+    }
+  }
+  const auto& var_list = value_exe_info.GetVarList();
+  for (size_t i = 0; i < var_ids_.size(); ++i) {
+    auto* tensor = var_list[var_ids_[i]]->GetMutable<phi::DenseTensor>();
+    if (tensor->Holder() != views_[i]) {
+      tensor->clear();
+      tensor->ResetHolder(views_[i]);
+    }
+  }
+}
+
+}  // namespace paddle::framework::interpreter
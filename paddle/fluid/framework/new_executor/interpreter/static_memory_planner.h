@@ -0,0 +1,104 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/allocator.h"
+#include "paddle/utils/test_macros.h"
+
+namespace paddle {
+namespace framework {
+class InstructionBase;
+class ValueExecutionInfo;
+namespace interpreter {
+
+// A buffer that is alive from the first_use-th to the last_use-th instruction
+// (both inclusive) of the execution order.
+struct MemoryBlock {
+  size_t size{0};
+  size_t first_use{0};
+  size_t last_use{0};
+  size_t offset{0};
+};
+
+// Assign an offset to each block, so that blocks alive at the same time never
+// overlap. Blocks are placed from the largest to the smallest, each into the
+// best fitting gap left by the placed blocks it conflicts with. Return the size
+// of the arena needed by all blocks.
+TEST_API size_t AssignMemoryOffsets(std::vector<MemoryBlock>* blocks);
+
+// StaticMemoryPlanner pre-assigns the memory of the intermediate values of a
+// program whose shapes are all known at build time.
+//
+// Based on the liveness of each value in a fixed execution order, values that
+// are never alive at the same time share memory, and all of them are backed by
+// one arena allocated on the first Bind(). Each planned tensor holds its slice
+// of the arena across runs, so kernels find their output already allocated and
+// the garbage collector has nothing to free.
+//
+// Values with dynamic shapes, persistable values and values that are visible
+// outside the program are not planned, they still use the allocator.
+class StaticMemoryPlanner {
+ public:
+  explicit StaticMemoryPlanner(const phi::Place& place) : place_(place) {}
+
+  // Plan the memory of the values produced by `instructions`, which must run
+  // in `execute_order`. Values named in `skip_var_names` are not planned.
+  // Return the number of planned values.
+  size_t Plan(const std::vector<std::unique_ptr<InstructionBase>>& instructions,
+              const std::vector<size_t>& execute_order,
+              const ValueExecutionInfo& value_exe_info,
+              const std::set<std::string>& skip_var_names);
+
+  // Share the arena to the planned tensors, must be called before each run.
+  void Bind(const ValueExecutionInfo& value_exe_info);
+
+  bool IsBound() const { return arena_ != nullptr; }
+
+  bool IsPlanned(size_t var_id) const {
+    return var_id < planned_.size() && planned_[var_id];
+  }
+
+  size_t NumPlannedValues() const { return var_ids_.size(); }
+
+  // Size of the arena, i.e. the peak memory of all planned values.
+  size_t PlannedPeak() const { return planned_peak_; }
+
+  // Memory needed by the planned values if none of them shares memory.
+  size_t TotalSize() const { return total_size_; }
+
+ private:
+  phi::Place place_;
+
+  std::vector<MemoryBlock> blocks_;
+  // var_ids_[i] is the variable that owns blocks_[i].
+  std::vector<size_t> var_ids_;
+  std::vector<bool> planned_;
+
+  size_t planned_peak_{0};
+  size_t total_size_{0};
+
+  std::shared_ptr<phi::Allocation> arena_;
+  std::vector<std::shared_ptr<phi::Allocation>> views_;
+};
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
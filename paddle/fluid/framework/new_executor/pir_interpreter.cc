@@ -14,7 +14,9 @@
 
 #include "paddle/fluid/framework/new_executor/pir_interpreter.h"
 
+#include <algorithm>
 #include <chrono>
+#include <optional>
 #include <unordered_set>
 
 #include "paddle/common/flags.h"
@@ -26,6 +28,7 @@
 #include "paddle/fluid/platform/profiler/supplement_tracing.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/kernel_context.h"
+#include "paddle/phi/core/memory/stats.h"
 #include "paddle/phi/core/os_info.h"
 #include "paddle/phi/core/platform/device/gpu/gpu_info.h"
 #include "paddle/phi/core/platform/profiler/event_tracing.h"
@@ -304,6 +307,9 @@ PirInterpreter::~PirInterpreter() {
   gc_.reset(nullptr);
   async_work_queue_.reset();
   VLOG(4) << "~PirInterpreter(): " << this << " on " << place_;
+  if (cpu_core_budget_) {
+    VLOG(1) << cpu_core_budget_->Summary();
+  }
 
 #ifdef PADDLE_WITH_DNNL
   // Clear mkl-dnn cache,
@@ -423,7 +429,8 @@ std::shared_ptr<interpreter::AsyncWorkQueue> PirInterpreter::GetWorkQueue() {
     async_work_queue_ = std::make_shared<interpreter::AsyncWorkQueue>(
         execution_config_.host_num_threads,
         execution_config_.device_num_threads,
-        nullptr);
+        nullptr,
+        execution_config_.numa_node);
   }
   return async_work_queue_;
 }
@@ -1086,47 +1093,106 @@ void PirInterpreter::BuildInstructionDependences() {
   for (auto& instr : vec_instruction_base_) {
     instructions_ptr.push_back(instr.get());
   }
+  const auto& restored_dependencies = execution_config_.instruction_dependencies;
+  if (restored_dependencies != nullptr &&
+      !ir_dependency_builder_.Restore(instructions_ptr,
+                                      *restored_dependencies)) {
+    LOG(WARNING) << "The restored instruction dependencies do not match the "
+                    "program, build them from the program instead.";
+  }
   auto downstream_map = ir_dependency_builder_.Build(instructions_ptr);
+  BuildCriticalPathScheduler(downstream_map);
 
   for (size_t instr_id = 0; instr_id < instr_num; ++instr_id) {
-    InstructionBase* cur_instr = vec_instruction_base_[instr_id].get();
-    const std::set<size_t>& next_instr_ids = downstream_map[instr_id];
+    LinkNextInstructions(vec_instruction_base_[instr_id].get(),
+                         downstream_map[instr_id]);
 
-    if (FLAGS_new_executor_serial_run) {
+    if (!is_shared_results_build_) {
+      for (size_t next_instr_id : downstream_map[instr_id]) {
+        ++(*dependency_count_)[next_instr_id];
+      }
+    }
+  }
+}
+
+void PirInterpreter::LinkNextInstructions(
+    InstructionBase* instr, const std::set<size_t>& downstreams) {
+  std::vector<size_t> next_instr_ids(downstreams.begin(), downstreams.end());
+  if (critical_path_scheduler_) {
+    // The first downstream is kept in the same thread, so let it be the one
+    // on the longest path.
+    std::sort(next_instr_ids.begin(),
+              next_instr_ids.end(),
+              [this](size_t lhs, size_t rhs) {
+                return critical_path_scheduler_->Less(rhs, lhs);
+              });
+  }
+
+  if (FLAGS_new_executor_serial_run) {
+    for (size_t next_instr_id : next_instr_ids) {
+      instr->AddNextInstrInSameThread(next_instr_id);
+    }
+  } else {
+    if (instr->KernelType() == OpFuncType::kGpuAsync) {
       for (size_t next_instr_id : next_instr_ids) {
-        cur_instr->AddNextInstrInSameThread(next_instr_id);
+        if (vec_instruction_base_[next_instr_id]->KernelType() ==
+            OpFuncType::kGpuAsync) {
+          instr->AddNextInstrInSameThread(next_instr_id);
+        } else {
+          instr->AddNextInstrInDifferentThread(next_instr_id);
+        }
       }
     } else {
-      if (cur_instr->KernelType() == OpFuncType::kGpuAsync) {
-        for (size_t next_instr_id : next_instr_ids) {
-          if (vec_instruction_base_[next_instr_id]->KernelType() ==
-              OpFuncType::kGpuAsync) {
-            cur_instr->AddNextInstrInSameThread(next_instr_id);
-          } else {
-            cur_instr->AddNextInstrInDifferentThread(next_instr_id);
-          }
-        }
-      } else {
-        bool has_instr_in_same_thread = false;
-        for (size_t next_instr_id : next_instr_ids) {
-          if (!has_instr_in_same_thread &&
-              vec_instruction_base_[next_instr_id]->KernelType() !=
-                  OpFuncType::kGpuAsync) {
-            cur_instr->AddNextInstrInSameThread(next_instr_id);
-            has_instr_in_same_thread = true;
-          } else {
-            cur_instr->AddNextInstrInDifferentThread(next_instr_id);
-          }
+      bool has_instr_in_same_thread = false;
+      for (size_t next_instr_id : next_instr_ids) {
+        if (!has_instr_in_same_thread &&
+            vec_instruction_base_[next_instr_id]->KernelType() !=
+                OpFuncType::kGpuAsync) {
+          instr->AddNextInstrInSameThread(next_instr_id);
+          has_instr_in_same_thread = true;
+        } else {
+          instr->AddNextInstrInDifferentThread(next_instr_id);
         }
       }
     }
+  }
+}
 
-    if (!is_shared_results_build_) {
-      for (size_t next_instr_id : next_instr_ids) {
-        ++(*dependency_count_)[next_instr_id];
-      }
-    }
+// The downstream kept in the same thread was picked by the estimated costs,
+// pick it again by the profiled costs.
+void PirInterpreter::RelinkNextInstructions() {
+  const auto& downstream_map = critical_path_scheduler_->DownstreamMap();
+  for (auto& [instr_id, downstreams] : downstream_map) {
+    InstructionBase* instr = vec_instruction_base_[instr_id].get();
+    instr->ClearNextInstrs();
+    LinkNextInstructions(instr, downstreams);
+  }
+}
+
+void PirInterpreter::BuildCriticalPathScheduler(
+    const std::map<size_t, std::set<size_t>>& downstream_map) {
+  critical_path_scheduler_.reset();
+  if (execution_config_.scheduling_policy != "critical_path") {
+    return;
   }
+  critical_path_scheduler_ =
+      std::make_unique<interpreter::CriticalPathScheduler>(
+          vec_instruction_base_, downstream_map);
+  VLOG(4) << "Critical path scheduling, estimated critical path: "
+          << critical_path_scheduler_->CriticalPathLength();
+
+  // The scheduling priority set by the program still comes first, e.g.
+  // communication ops are dispatched after computation ops.
+  ir_instruction_scheduling_priority_less = [this](size_t lhs, size_t rhs) {
+    SchedulingPriority lhs_scheduling_priority =
+        vec_instruction_base_[lhs]->GetSchedulingPriority();
+    SchedulingPriority rhs_scheduling_priority =
+        vec_instruction_base_[rhs]->GetSchedulingPriority();
+    if (lhs_scheduling_priority != rhs_scheduling_priority) {
+      return lhs_scheduling_priority > rhs_scheduling_priority;
+    }
+    return critical_path_scheduler_->Less(lhs, rhs);
+  };
 }
 
 void PirInterpreter::RecordMemcpyD2H(InstructionBase* instr_node) {
@@ -1290,6 +1356,11 @@ void PirInterpreter::CheckGC(InstructionBase* instr) {
 #endif
 
   for (auto var_id : instr->GCCheckVars()) {
+    // the memory of planned vars is held across runs
+    if (static_memory_planner_ && static_memory_planner_->IsBound() &&
+        static_memory_planner_->IsPlanned(var_id)) {
+      continue;
+    }
     VLOG(4) << "GC:" << value_exe_info_->GetNameById(static_cast<int>(var_id))
             << ", id:" << var_id << ", ref:" << refs_[var_id]->DynamicRef();
     bool is_ready = refs_[var_id]->CheckAndDecrease();
@@ -1635,8 +1706,21 @@ void PirInterpreter::TraceRunImpl() {
   interpreter::ResetAtomicGuard guard(&deps_, &refs_);
   VLOG(4) << "Tracing Instruction List";
 
+  if (static_memory_planner_) {
+    if (is_build_) {
+      static_memory_planner_->Bind(*value_exe_info_);
+    } else {
+      host_memory_base_ = memory::HostMemoryStatCurrentValue("Allocated", 0);
+      host_memory_peak_ = host_memory_base_;
+    }
+  }
+
   TraceRunInstructionList(vec_instruction_base_);
   VLOG(4) << "Done TraceRunInstructionList";
+
+  if (host_memory_peak_ >= 0) {
+    LogStaticMemoryPlan();
+  }
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
   if (phi::is_custom_place(place_)) {
     phi::DeviceContextPool::Instance().Get(place_)->Wait();
@@ -1654,8 +1738,14 @@ void PirInterpreter::MultiThreadRunImpl() {
   VLOG(4) << "Multi Thread Run Instruction List";
 
   async_work_queue_ = GetWorkQueue();
+  if (critical_path_scheduler_) {
+    critical_path_scheduler_->BeginRun();
+  }
   MultiThreadRunInstructionList(vec_instruction_base_);
   VLOG(4) << "Done MultiThreadRunInstructionList";
+  if (critical_path_scheduler_ && critical_path_scheduler_->EndRun()) {
+    RelinkNextInstructions();
+  }
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
   if (phi::is_custom_place(place_)) {
     phi::DeviceContextPool::Instance().Get(place_)->Wait();
@@ -1744,16 +1834,28 @@ void PirInterpreter::MultiThreadRunInstructionList(
     }
   }
 
+  std::vector<size_t> root_instr_ids;
   for (size_t i = 0; i < dependency_count_->size(); ++i) {
     if ((*dependency_count_)[i] == 0) {
-      // NOTE(zhiqiu): hot fix for jit input var
-      RecordMemcpyD2H(vec_instr.at(i).get());
-      if (FLAGS_new_executor_serial_run) {
-        RunInstructionBaseAsync(i);
-      } else {
-        async_work_queue_->AddTask(vec_instr.at(i)->KernelType(),
-                                   [this, i] { RunInstructionBaseAsync(i); });
-      }
+      root_instr_ids.push_back(i);
+    }
+  }
+  if (critical_path_scheduler_) {
+    // Dispatch the roots of the longer paths first.
+    std::sort(root_instr_ids.begin(),
+              root_instr_ids.end(),
+              [this](size_t lhs, size_t rhs) {
+                return ir_instruction_scheduling_priority_less(rhs, lhs);
+              });
+  }
+  for (size_t i : root_instr_ids) {
+    // NOTE(zhiqiu): hot fix for jit input var
+    RecordMemcpyD2H(vec_instr.at(i).get());
+    if (FLAGS_new_executor_serial_run) {
+      RunInstructionBaseAsync(i);
+    } else {
+      async_work_queue_->AddTask(vec_instr.at(i)->KernelType(),
+                                 [this, i] { RunInstructionBaseAsync(i); });
     }
   }
 
@@ -1827,7 +1929,18 @@ void PirInterpreter::RunInstructionBaseAsync(size_t instr_id) {
     ready_ops.pop();
     auto* instr_node = vec_instruction_base_.at(instr_id).get();
 
-    RunInstructionBase(instr_node);
+    if (UNLIKELY(critical_path_scheduler_ &&
+                 critical_path_scheduler_->IsProfiling())) {
+      auto start = std::chrono::steady_clock::now();
+      RunInstructionBase(instr_node);
+      critical_path_scheduler_->RecordCost(
+          instr_id,
+          std::chrono::duration<double, std::micro>(
+              std::chrono::steady_clock::now() - start)
+              .count());
+    } else {
+      RunInstructionBase(instr_node);
+    }
 
     if (UNLIKELY(exception_holder_.IsCaught())) {
       VLOG(4) << "Exception caught";
@@ -1879,6 +1992,15 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
   phi::RecordEvent instruction_event(
       instr_node->Name(), phi::TracerEventType::Operator, 1);
 
+  // Run with the intra-op threads granted by the CPU core budget.
+  interpreter::CpuCoreGuard core_guard(cpu_core_budget_.get(),
+                                       instr_node->Id());
+  std::optional<phi::RecordEvent> intra_op_parallel_event;
+  if (core_guard.NumThreads() > 1) {
+    intra_op_parallel_event.emplace(
+        "IntraOpParallel", phi::TracerEventType::UserDefined, 10);
+  }
+
   auto cur_place = instr_node->DeviceContext().GetPlace();
   SetDeviceId(cur_place);
 
@@ -1948,6 +2070,11 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
               << " runs on " << phi::GetCurrentThreadName() << "\n"
               << "After: " << cur_place << " "
               << instr_node->DebugStringEx(scope_, value_exe_info_.get());
+      if (UNLIKELY(host_memory_peak_ >= 0)) {
+        host_memory_peak_ =
+            std::max(host_memory_peak_,
+                     memory::HostMemoryStatCurrentValue("Allocated", 0));
+      }
       CheckGC(instr_node);
       VLOG(4) << "done CheckGC";
       memory::LogDeviceMemoryStats(cur_place, instr_node->Name());
@@ -2041,6 +2168,73 @@ void PirInterpreter::PreAnalysis() {
 
   UpdateOneDNNOpNum();
   VLOG(4) << "Done UpdateOneDNNOpNum";
+
+  PlanStaticMemory();
+  VLOG(4) << "Done PlanStaticMemory";
+
+  BuildCpuCoreBudget();
+  VLOG(4) << "Done BuildCpuCoreBudget";
+}
+
+void PirInterpreter::BuildCpuCoreBudget() {
+  cpu_core_budget_.reset();
+  if (execution_config_.cpu_core_budget <= 0 || !phi::is_cpu_place(place_)) {
+    return;
+  }
+  cpu_core_budget_ = std::make_unique<interpreter::CpuCoreBudget>(
+      execution_config_.cpu_core_budget);
+  cpu_core_budget_->Plan(vec_instruction_base_);
+}
+
+void PirInterpreter::PlanStaticMemory() {
+  static_memory_planner_.reset();
+  if (!execution_config_.static_memory_plan) {
+    return;
+  }
+  // The plan is only valid in a fixed execution order, and values of sub
+  // blocks are not tracked.
+  if (!phi::is_cpu_place(place_) ||
+      !UseTraceRun(execution_config_, onednn_op_num_, sync_op_num_) ||
+      execution_config_.used_for_control_flow_op || !sub_blocks_.empty()) {
+    VLOG(4) << "Skip static memory plan, place: " << place_
+            << ", used_for_control_flow_op: "
+            << execution_config_.used_for_control_flow_op
+            << ", sub blocks: " << sub_blocks_.size();
+    return;
+  }
+
+  std::set<std::string> skip_var_names(execution_config_.skip_gc_vars);
+  skip_var_names.insert(execution_config_.jit_input_vars.begin(),
+                        execution_config_.jit_input_vars.end());
+  skip_var_names.insert(execution_config_.force_root_scope_vars.begin(),
+                        execution_config_.force_root_scope_vars.end());
+  skip_var_names.insert(fetch_var_names_.begin(), fetch_var_names_.end());
+  skip_var_names.insert(parameter_var_names_.begin(),
+                        parameter_var_names_.end());
+
+  auto planner = std::make_unique<interpreter::StaticMemoryPlanner>(place_);
+  if (planner->Plan(vec_instruction_base_,
+                    trace_execute_order_,
+                    *value_exe_info_,
+                    skip_var_names) > 0) {
+    static_memory_planner_ = std::move(planner);
+  }
+}
+
+void PirInterpreter::LogStaticMemoryPlan() {
+  int64_t achieved_peak = host_memory_peak_ - host_memory_base_;
+  LOG_FIRST_N(INFO, 1) << "Static memory plan of "
+                       << static_memory_planner_->NumPlannedValues()
+                       << " values, planned peak: "
+                       << static_memory_planner_->PlannedPeak()
+                       << " bytes (without sharing: "
+                       << static_memory_planner_->TotalSize()
+                       << " bytes), achieved peak without plan: "
+                       << achieved_peak << " bytes.";
+  VLOG(4) << "Static memory plan of PirInterpreter(" << this
+          << "), planned peak: " << static_memory_planner_->PlannedPeak()
+          << ", achieved peak: " << achieved_peak;
+  host_memory_peak_ = -1;
 }
 
 ::pir::Value PirInterpreter::GetValueByName(const std::string& var_name) {
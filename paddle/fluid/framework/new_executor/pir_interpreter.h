@@ -15,6 +15,9 @@
 #pragma once
 #include <memory>
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+#include "paddle/fluid/framework/new_executor/interpreter/cpu_core_budget.h"
+#include "paddle/fluid/framework/new_executor/interpreter/critical_path_scheduler.h"
+#include "paddle/fluid/framework/new_executor/interpreter/static_memory_planner.h"
 #include "paddle/fluid/framework/new_executor/interpreter_base_impl.h"
 #include "paddle/pir/include/core/value.h"
 
@@ -110,6 +113,12 @@ class PirInterpreter : public InterpreterBaseImpl {
 
   std::string GetNameByValue(::pir::Value value) const;
 
+  // The static memory plan built by the first run, nullptr if the memory is
+  // not planned.
+  const interpreter::StaticMemoryPlanner* GetStaticMemoryPlanner() const {
+    return static_memory_planner_.get();
+  }
+
   // Only for debug
   Variable* DebugVar(const std::string& name) const override;
 
@@ -140,6 +149,16 @@ class PirInterpreter : public InterpreterBaseImpl {
   // gc
   void ClearLoDTensorArrayInLocalScope();
 
+  // scheduling
+  void BuildCriticalPathScheduler(
+      const std::map<size_t, std::set<size_t>>& downstream_map);
+  void RelinkNextInstructions();
+  void BuildCpuCoreBudget();
+
+  // static memory plan
+  void PlanStaticMemory();
+  void LogStaticMemoryPlan();
+
   // cuda graph
   void CheckCUDAGraphBeforeRun(const std::vector<std::string>& feed_names);
   void PrepareForCUDAGraphCapture();
@@ -189,6 +208,19 @@ class PirInterpreter : public InterpreterBaseImpl {
 
   std::unique_ptr<InterpreterCoreGarbageCollector> gc_;
 
+  // Not null if the CPU cores are shared by the inter-op and intra-op threads.
+  std::unique_ptr<interpreter::CpuCoreBudget> cpu_core_budget_;
+
+  // Not null if the scheduling policy is "critical_path".
+  std::unique_ptr<interpreter::CriticalPathScheduler> critical_path_scheduler_;
+
+  // Not null if the memory of the values is planned at build time.
+  std::unique_ptr<interpreter::StaticMemoryPlanner> static_memory_planner_;
+  // Peak of the host allocated memory in the build run, which is measured to
+  // be compared with the planned peak. -1 means not measuring.
+  int64_t host_memory_base_{0};
+  int64_t host_memory_peak_{-1};
+
   // last_live_ops_[i] contains the id of operators that last access the i-th
   // var
   std::map<size_t, std::set<size_t>> last_live_ops_;
@@ -226,6 +258,9 @@ class PirInterpreter : public InterpreterBaseImpl {
 
   void BuildInstructionDependences();
 
+  void LinkNextInstructions(InstructionBase* instr,
+                            const std::set<size_t>& downstreams);
+
   void TraceRunImpl();
 
   void TraceRunInstructionList(
@@ -0,0 +1,277 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// LockFreeRunQueue is a drop-in replacement of RunQueue that takes no lock.
+// Operations on front of the queue must be done by a single thread (owner),
+// operations on back of the queue can be done by multiple threads concurrently.
+//
+// Algorithm outline:
+// The queue is made of two fixed-size arrays.
+// 1. A Chase-Lev deque for the work pushed by the owner. The owner pushes and
+//    pops at its bottom, remote threads steal from its top by a CAS on top_.
+// 2. A bounded MPMC queue (by Dmitry Vyukov) as the inbox for the work pushed
+//    by remote threads. Each cell carries a sequence number which tells
+//    whether it is ready to be written or to be read, so that producers and
+//    consumers only race on enqueue_pos_ and dequeue_pos_ respectively.
+// The front of the queue is the bottom of the deque followed by the inbox, the
+// back of the queue is the inbox followed by the top of the deque.
+//
+// Different from the textbook Chase-Lev deque, which reads the element before
+// the CAS and thus requires trivially copyable elements, a thief moves the
+// element out after it claims it. Each deque element carries a ready flag, and
+// the owner never pushes into an element that is still ready, so a claimed
+// element is never overwritten before it is moved out. This allows to store
+// std::function<()> in place like RunQueue does.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace paddle {
+namespace framework {
+
+template <typename Work, unsigned kSize>
+class LockFreeRunQueue {
+ public:
+  LockFreeRunQueue()
+      : top_(0), bottom_(0), enqueue_pos_(0), dequeue_pos_(0) {
+    // require power-of-two for fast masking
+    static_assert((kSize & (kSize - 1)) == 0,
+                  "need to be a power of two for fast masking");
+    static_assert(kSize > 2, "need to be in [4, 65536] range");
+    static_assert(kSize <= (64 << 10), "need to be in [4, 65536] range");
+    for (unsigned i = 0; i < kSize; i++) {
+      deque_[i].ready.store(false, std::memory_order_relaxed);
+      inbox_[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  LockFreeRunQueue(const LockFreeRunQueue&) = delete;
+  void operator=(const LockFreeRunQueue&) = delete;
+
+  ~LockFreeRunQueue() { assert(Size() == 0); }
+
+  // PushFront inserts w at the beginning of the queue.
+  // If queue is full returns w, otherwise returns default-constructed Work.
+  Work PushFront(Work w) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_acquire);
+    if (bottom - top >= static_cast<int64_t>(kSize)) {
+      return w;
+    }
+    DequeElem* e = &deque_[bottom & kMask];
+    // The element is claimed by a thief but not moved out yet.
+    if (e->ready.load(std::memory_order_acquire)) {
+      return w;
+    }
+    e->w = std::move(w);
+    e->ready.store(true, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_release);
+    return Work();
+  }
+
+  // PopFront removes and returns the first element in the queue.
+  // If the queue was empty returns default-constructed Work.
+  Work PopFront() {
+    Work w = Work();
+    if (!TakeBottom(&w)) {
+      Dequeue(&w);
+    }
+    return w;
+  }
+
+  // PushBack adds w at the end of the queue.
+  // If queue is full returns w, otherwise returns default-constructed Work.
+  Work PushBack(Work w) {
+    if (!Enqueue(&w)) {
+      return w;
+    }
+    return Work();
+  }
+
+  // PopBack removes and returns the last elements in the queue.
+  Work PopBack() {
+    Work w = Work();
+    if (Empty()) {
+      return w;
+    }
+    if (!Dequeue(&w)) {
+      TakeTop(&w);
+    }
+    return w;
+  }
+
+  // PopBackHalf removes and returns half last elements in the queue.
+  // Returns number of elements removed.
+  unsigned PopBackHalf(std::vector<Work>* result) {
+    unsigned size = Size();
+    unsigned n = 0;
+    for (unsigned i = 0; i < (size + 1) / 2; ++i) {
+      Work w = Work();
+      if (!Dequeue(&w) && !TakeTop(&w)) {
+        break;
+      }
+      result->push_back(std::move(w));
+      n++;
+    }
+    return n;
+  }
+
+  // Size returns current queue size.
+  // Can be called by any thread at any time.
+  unsigned Size() const {
+    int64_t top = top_.load(std::memory_order_acquire);
+    int64_t bottom = bottom_.load(std::memory_order_acquire);
+    size_t dequeue_pos = dequeue_pos_.load(std::memory_order_acquire);
+    size_t enqueue_pos = enqueue_pos_.load(std::memory_order_acquire);
+    int64_t size = std::max<int64_t>(bottom - top, 0);
+    if (enqueue_pos > dequeue_pos) {
+      size += static_cast<int64_t>(enqueue_pos - dequeue_pos);
+    }
+    return static_cast<unsigned>(
+        std::min<int64_t>(size, static_cast<int64_t>(kSize) * 2));
+  }
+
+  // Empty tests whether container is empty.
+  // Can be called by any thread at any time.
+  bool Empty() const { return Size() == 0; }
+
+  // Delete all the elements from the queue.
+  void Flush() {
+    while (!Empty()) {
+      PopFront();
+    }
+  }
+
+ private:
+  static const unsigned kMask = kSize - 1;
+
+  struct alignas(64) DequeElem {
+    std::atomic<bool> ready;
+    Work w;
+  };
+
+  struct alignas(64) InboxElem {
+    std::atomic<size_t> seq;
+    Work w;
+  };
+
+  // Owner only.
+  bool TakeBottom(Work* w) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return false;
+    }
+    if (top == bottom) {
+      // The last element, race with thieves.
+      bool won = top_.compare_exchange_strong(
+          top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      if (!won) {
+        return false;
+      }
+    }
+    DequeElem* e = &deque_[bottom & kMask];
+    *w = std::move(e->w);
+    e->ready.store(false, std::memory_order_release);
+    return true;
+  }
+
+  // Any thread.
+  bool TakeTop(Work* w) {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return false;
+    }
+    if (!top_.compare_exchange_strong(top,
+                                      top + 1,
+                                      std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return false;
+    }
+    DequeElem* e = &deque_[top & kMask];
+    *w = std::move(e->w);
+    e->ready.store(false, std::memory_order_release);
+    return true;
+  }
+
+  // Any thread.
+  bool Enqueue(Work* w) {
+    InboxElem* e = nullptr;
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      e = &inbox_[pos & kMask];
+      size_t seq = e->seq.load(std::memory_order_acquire);
+      intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (dif == 0) {
+        if (enqueue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (dif < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    e->w = std::move(*w);
+    e->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Any thread.
+  bool Dequeue(Work* w) {
+    InboxElem* e = nullptr;
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      e = &inbox_[pos & kMask];
+      size_t seq = e->seq.load(std::memory_order_acquire);
+      intptr_t dif =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (dif == 0) {
+        if (dequeue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (dif < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    *w = std::move(e->w);
+    e->seq.store(pos + kSize, std::memory_order_release);
+    return true;
+  }
+
+  alignas(64) std::atomic<int64_t> top_;
+  alignas(64) std::atomic<int64_t> bottom_;
+  alignas(64) std::atomic<size_t> enqueue_pos_;
+  alignas(64) std::atomic<size_t> dequeue_pos_;
+  DequeElem deque_[kSize];
+  InboxElem inbox_[kSize];
+};
+
+}  // namespace framework
+}  // namespace paddle
@@ -15,28 +15,50 @@
 
 #include "glog/logging.h"
 #include "paddle/fluid/framework/new_executor/workqueue/event_count.h"
+#include "paddle/fluid/framework/new_executor/workqueue/lock_free_run_queue.h"
 #include "paddle/fluid/framework/new_executor/workqueue/run_queue.h"
 #include "paddle/fluid/framework/new_executor/workqueue/thread_environment.h"
+#include "paddle/phi/backends/cpu/numa_info.h"
 #include "paddle/phi/core/os_info.h"
 #include "paddle/phi/core/platform/profiler/event_tracing.h"
 
 namespace paddle {
 namespace framework {
 
-template <typename Environment>
-class ThreadPoolTempl {
+// The interface of ThreadPoolTempl, so that thread pools with different run
+// queues can be used interchangeably.
+class ThreadPoolInterface {
+ public:
+  virtual ~ThreadPoolInterface() = default;
+
+  virtual void AddTask(std::function<void()> fn) = 0;
+
+  virtual void Cancel() = 0;
+
+  virtual void WaitThreadsExit() = 0;
+
+  virtual size_t NumThreads() const = 0;
+};
+
+// RunQueueTempl is the per-thread queue, RunQueue protects its back by a spin
+// lock, while LockFreeRunQueue takes no lock.
+template <typename Environment,
+          template <typename, unsigned> class RunQueueTempl = RunQueue>
+class ThreadPoolTempl : public ThreadPoolInterface {
  public:
   typedef typename Environment::Task Task;
-  typedef RunQueue<Task, 1024> Queue;
+  typedef RunQueueTempl<Task, 1024> Queue;
 
   ThreadPoolTempl(const std::string& name,
                   int num_threads,
                   bool allow_spinning,
                   bool always_spinning,
+                  int numa_node = -1,
                   Environment env = Environment())
       : env_(env),
         allow_spinning_(allow_spinning),
         always_spinning_(always_spinning),
+        numa_node_(numa_node),
         global_steal_partition_(EncodePartition(0, num_threads)),
         blocked_(0),
         done_(false),
@@ -65,7 +87,7 @@ class ThreadPoolTempl {
     }
   }
 
-  ~ThreadPoolTempl() {
+  ~ThreadPoolTempl() override {
     done_ = true;
 
     // Now if all threads block without work, they will start exiting.
@@ -101,7 +123,7 @@ class ThreadPoolTempl {
     }
   }
 
-  void AddTask(std::function<void()> fn) {
+  void AddTask(std::function<void()> fn) override {
     AddTaskWithHint(std::move(fn), 0, num_threads_);
   }
 
@@ -140,7 +162,7 @@ class ThreadPoolTempl {
     }
   }
 
-  void Cancel() {
+  void Cancel() override {
     cancelled_ = true;
     done_ = true;
 
@@ -148,13 +170,13 @@ class ThreadPoolTempl {
     ec_.Notify(true);
   }
 
-  void WaitThreadsExit() {
+  void WaitThreadsExit() override {
     for (size_t i = 0; i < thread_data_.size(); ++i) {
       thread_data_[i].thread->WaitExit();
     }
   }
 
-  size_t NumThreads() const { return num_threads_; }
+  size_t NumThreads() const override { return num_threads_; }
 
   int CurrentThreadId() const {
     const PerThread* pt = const_cast<ThreadPoolTempl*>(this)->GetPerThread();
@@ -235,6 +257,7 @@ class ThreadPoolTempl {
   Environment env_;
   const bool allow_spinning_;
   const bool always_spinning_;
+  const int numa_node_;
   std::vector<std::vector<unsigned>> all_coprimes_;
   unsigned global_steal_partition_;
   std::atomic<unsigned> blocked_;
@@ -250,6 +273,11 @@ class ThreadPoolTempl {
     std::string thr_name = name_ + "_thread_" + std::to_string(thread_id);
     VLOG(1) << thr_name << " started ";
     phi::SetCurrentThreadName(thr_name);
+    if (numa_node_ >= 0 &&
+        !phi::backends::cpu::BindCurrentThreadToNumaNode(numa_node_)) {
+      LOG(WARNING) << thr_name << " failed to bind to NUMA node "
+                   << numa_node_;
+    }
     PerThread* pt = GetPerThread();
     pt->pool = this;
     pt->rand = GlobalThreadIdHash();
@@ -470,6 +498,8 @@ class ThreadPoolTempl {
 };
 
 using NonblockingThreadPool = ThreadPoolTempl<StlThreadEnvironment>;
+using LockFreeNonblockingThreadPool =
+    ThreadPoolTempl<StlThreadEnvironment, LockFreeRunQueue>;
 
 }  // namespace framework
 }  // namespace paddle
@@ -29,12 +29,34 @@ void WorkQueueOptions::Validate() const {
       false,
       common::errors::InvalidArgument("WorkQueueOptions.allow_spinning must "
                                       "be true when always_spinning is set"));
+  PADDLE_ENFORCE_GE(numa_node,
+                    -1,
+                    common::errors::InvalidArgument(
+                        "WorkQueueOptions.numa_node must be -1 (no pinning) "
+                        "or a valid NUMA node, but got %d",
+                        numa_node));
 }
 
 namespace {
 
 using TaskTracker = TaskTracker<EventsWaiter::EventNotifier>;
 
+ThreadPoolInterface* CreateThreadPool(const WorkQueueOptions& options) {
+  if (options.lock_free_queue) {
+    return new LockFreeNonblockingThreadPool(
+        options.name,
+        static_cast<int>(options.num_threads),
+        options.allow_spinning,
+        options.always_spinning,
+        options.numa_node);
+  }
+  return new NonblockingThreadPool(options.name,
+                                   static_cast<int>(options.num_threads),
+                                   options.allow_spinning,
+                                   options.always_spinning,
+                                   options.numa_node);
+}
+
 class WorkQueueImpl : public WorkQueue {
  public:
   explicit WorkQueueImpl(const WorkQueueOptions& options) : WorkQueue(options) {
@@ -47,10 +69,7 @@ class WorkQueueImpl : public WorkQueue {
       destruct_notifier_ =
           options.events_waiter->RegisterEvent(kQueueDestructEvent);
     }
-    queue_ = new NonblockingThreadPool(options_.name,
-                                       static_cast<int>(options_.num_threads),
-                                       options_.allow_spinning,
-                                       options_.always_spinning);
+    queue_ = CreateThreadPool(options_);
   }
 
   ~WorkQueueImpl() override {
@@ -82,7 +101,7 @@ class WorkQueueImpl : public WorkQueue {
   size_t NumThreads() const override { return queue_->NumThreads(); }
 
  private:
-  NonblockingThreadPool* queue_{nullptr};
+  ThreadPoolInterface* queue_{nullptr};
   TaskTracker* tracker_{nullptr};
   std::shared_ptr<EventsWaiter::EventNotifier> empty_notifier_;
   std::shared_ptr<EventsWaiter::EventNotifier> destruct_notifier_;
@@ -104,8 +123,7 @@ class WorkQueueGroupImpl : public WorkQueueGroup {
   void Cancel() override;
 
  private:
-  std::vector<NonblockingThreadPool*> queues_;
-  NonblockingThreadPool* queues_storage_;
+  std::vector<ThreadPoolInterface*> queues_;
   TaskTracker* tracker_;
   std::shared_ptr<EventsWaiter::EventNotifier> empty_notifier_;
   std::shared_ptr<EventsWaiter::EventNotifier> destruct_notifier_;
@@ -113,13 +131,9 @@ class WorkQueueGroupImpl : public WorkQueueGroup {
 
 WorkQueueGroupImpl::WorkQueueGroupImpl(
     const std::vector<WorkQueueOptions>& queues_options)
-    : WorkQueueGroup(queues_options),
-      queues_storage_(nullptr),
-      tracker_(nullptr) {
+    : WorkQueueGroup(queues_options), tracker_(nullptr) {
   size_t num_queues = queues_options_.size();
   queues_.resize(num_queues);
-  void* buffer = malloc(sizeof(NonblockingThreadPool) * num_queues);  // NOLINT
-  queues_storage_ = reinterpret_cast<NonblockingThreadPool*>(buffer);
 
   for (size_t idx = 0; idx < num_queues; ++idx) {
     const auto& options = queues_options_[idx];
@@ -138,25 +152,18 @@ WorkQueueGroupImpl::WorkQueueGroupImpl(
       destruct_notifier_ =
           options.events_waiter->RegisterEvent(kQueueDestructEvent);
     }
-    queues_[idx] = new (&queues_storage_[idx])
-        NonblockingThreadPool(options.name,
-                              static_cast<int>(options.num_threads),
-                              options.allow_spinning,
-                              options.always_spinning);
+    queues_[idx] = CreateThreadPool(options);
   }
 }
 
 WorkQueueGroupImpl::~WorkQueueGroupImpl() {
   for (auto queue : queues_) {
-    if (queue) {
-      queue->~NonblockingThreadPool();
-    }
+    delete queue;
   }
   if (tracker_ != nullptr) {
     tracker_->~TaskTracker();
     AlignedFree(tracker_);
   }
-  free(queues_storage_);  // NOLINT
   if (destruct_notifier_) {
     destruct_notifier_->NotifyEvent();
   }
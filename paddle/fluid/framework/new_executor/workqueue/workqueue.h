@@ -102,6 +102,12 @@ struct WorkQueueOptions {
   // false and set events_waiter.
   bool detached{true};
   EventsWaiter* events_waiter{nullptr};  // not owned
+  // Pin worker threads to the processors of this NUMA node, so that the
+  // memory they allocate stays local. -1 means no pinning.
+  int numa_node{-1};
+  // Use LockFreeRunQueue instead of RunQueue as the per-thread queue, which
+  // takes no lock when other threads push tasks to or steal tasks from it.
+  bool lock_free_queue{false};
 };
 
 class WorkQueue {
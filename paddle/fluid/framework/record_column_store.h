@@ -0,0 +1,317 @@
+/* Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "paddle/fluid/framework/data_feed.h"
+
+namespace paddle {
+namespace framework {
+
+// RecordColumnStore keeps the records of MultiSlotDataset in columns instead
+// of a Record with its own feasign vectors and strings for each instance:
+// the feasigns of each used slot are in one array of the slot, with the
+// offsets of the instances into it, and the strings of the instances are in
+// one string. The columns are in chunks of at most kChunkSize records, so
+// that a block of records can be moved into the store and freed at a time.
+//
+// The records are shuffled by permuting their indices, and the data feeds
+// take the mini batches from the shuffled indices by NextBatch, then copy
+// the feasigns slot by slot from the arrays.
+class RecordColumnStore {
+ public:
+  static constexpr size_t kChunkSize = 1 << 16;
+
+  RecordColumnStore() {}
+  RecordColumnStore(const RecordColumnStore&) = delete;
+  RecordColumnStore& operator=(const RecordColumnStore&) = delete;
+
+  // The types of the used slots, e.g. "uint64" or "float", which are indexed
+  // by the slots of the feasigns in the records. It clears the store.
+  void Init(const std::vector<std::string>& slot_types) {
+    Clear();
+    is_float_slot_.clear();
+    for (auto& type : slot_types) {
+      is_float_slot_.push_back(!type.empty() && type[0] == 'f');
+    }
+  }
+
+  // Move the records into a new chunk, which can be called by multiple
+  // threads.
+  void Append(std::vector<Record>* records) {
+    for (size_t begin = 0; begin < records->size(); begin += kChunkSize) {
+      size_t end = std::min(records->size(), begin + kChunkSize);
+      Chunk chunk;
+      BuildChunk(records->data() + begin, end - begin, &chunk);
+      std::lock_guard<std::mutex> lock(mutex_);
+      uint64_t chunk_id = chunks_.size();
+      chunks_.push_back(std::move(chunk));
+      for (uint64_t row = 0; row < end - begin; ++row) {
+        order_.push_back((chunk_id << 32) | row);
+      }
+    }
+    records->clear();
+    records->shrink_to_fit();
+  }
+
+  size_t Size() const { return order_.size(); }
+  bool Empty() const { return order_.empty(); }
+  size_t SlotNum() const { return is_float_slot_.size(); }
+  bool IsFloatSlot(size_t slot) const { return is_float_slot_[slot]; }
+
+  void Clear() {
+    std::vector<Chunk>().swap(chunks_);
+    std::vector<uint64_t>().swap(order_);
+    next_batch_ = 0;
+  }
+
+  // the bytes of the columns and the indices
+  size_t MemorySize() const {
+    size_t size = order_.capacity() * sizeof(uint64_t);
+    for (auto& chunk : chunks_) {
+      size += chunk.MemorySize();
+    }
+    return size;
+  }
+
+  // permute the indices of the records, and start the batches from the first
+  void Shuffle(std::default_random_engine* engine) {
+    std::shuffle(order_.begin(), order_.end(), *engine);
+    next_batch_ = 0;
+  }
+
+  // Take the next batch of at most num records, whose indices are
+  // [*begin, *begin + returned num), return 0 if all have been taken. It can
+  // be called by multiple threads.
+  size_t NextBatch(size_t num, size_t* begin) {
+    size_t batch_begin = next_batch_.fetch_add(num);
+    if (batch_begin >= order_.size()) {
+      return 0;
+    }
+    *begin = batch_begin;
+    return std::min(num, order_.size() - batch_begin);
+  }
+
+  void ResetBatch() { next_batch_ = 0; }
+
+  // the feasigns in the slot of the index-th record, nullptr if the slot is
+  // of the other type
+  const uint64_t* Uint64Feasigns(size_t index,
+                                 size_t slot,
+                                 size_t* num) const {
+    const Chunk& chunk = GetChunk(index);
+    size_t row = order_[index] & 0xFFFFFFFFULL;
+    auto& offsets = chunk.offsets[slot];
+    *num = offsets[row + 1] - offsets[row];
+    return is_float_slot_[slot] ? nullptr
+                                : chunk.uint64_feasigns[slot].data() +
+                                      offsets[row];
+  }
+
+  const float* FloatFeasigns(size_t index, size_t slot, size_t* num) const {
+    const Chunk& chunk = GetChunk(index);
+    size_t row = order_[index] & 0xFFFFFFFFULL;
+    auto& offsets = chunk.offsets[slot];
+    *num = offsets[row + 1] - offsets[row];
+    return is_float_slot_[slot]
+               ? chunk.float_feasigns[slot].data() + offsets[row]
+               : nullptr;
+  }
+
+  std::string InsId(size_t index) const { return GetString(index, 0); }
+  std::string Content(size_t index) const { return GetString(index, 1); }
+
+  // build the index-th record back
+  void Get(size_t index, Record* record) const {
+    const Chunk& chunk = GetChunk(index);
+    size_t row = order_[index] & 0xFFFFFFFFULL;
+    record->uint64_feasigns_.clear();
+    record->float_feasigns_.clear();
+    for (size_t slot = 0; slot < SlotNum(); ++slot) {
+      auto& offsets = chunk.offsets[slot];
+      for (uint32_t i = offsets[row]; i < offsets[row + 1]; ++i) {
+        FeatureFeasign sign;
+        if (is_float_slot_[slot]) {
+          sign.float_feasign_ = chunk.float_feasigns[slot][i];
+          record->float_feasigns_.emplace_back(sign, slot);
+        } else {
+          sign.uint64_feasign_ = chunk.uint64_feasigns[slot][i];
+          record->uint64_feasigns_.emplace_back(sign, slot);
+        }
+      }
+    }
+    record->ins_id_ = GetString(index, 0);
+    record->content_ = GetString(index, 1);
+    record->uid_ = GetString(index, 2);
+    // the log keys are dropped from the chunks which have none
+    record->search_id = chunk.search_ids.empty() ? 0 : chunk.search_ids[row];
+    record->rank = chunk.ranks.empty() ? 0 : chunk.ranks[row];
+    record->cmatch = chunk.cmatches.empty() ? 0 : chunk.cmatches[row];
+  }
+
+ private:
+  // the strings of a record in Chunk::strings
+  static constexpr size_t kStringNum = 3;
+
+  struct Chunk {
+    // offsets[slot][row] is the offset of the row-th record in the feasigns
+    // of the slot, which has the size of the records + 1
+    std::vector<std::vector<uint32_t>> offsets;
+    std::vector<std::vector<uint64_t>> uint64_feasigns;
+    std::vector<std::vector<float>> float_feasigns;
+    // the ins_id, content and uid of the records, the offsets are dropped if
+    // all of them are empty
+    std::string strings;
+    std::vector<uint64_t> string_offsets;
+    std::vector<uint64_t> search_ids;
+    std::vector<uint32_t> ranks;
+    std::vector<uint32_t> cmatches;
+
+    size_t MemorySize() const {
+      size_t size = strings.capacity() +
+                    string_offsets.capacity() * sizeof(uint64_t) +
+                    search_ids.capacity() * sizeof(uint64_t) +
+                    (ranks.capacity() + cmatches.capacity()) * sizeof(uint32_t);
+      for (size_t slot = 0; slot < offsets.size(); ++slot) {
+        size += offsets[slot].capacity() * sizeof(uint32_t) +
+                uint64_feasigns[slot].capacity() * sizeof(uint64_t) +
+                float_feasigns[slot].capacity() * sizeof(float);
+      }
+      return size;
+    }
+  };
+
+  const Chunk& GetChunk(size_t index) const {
+    return chunks_[order_[index] >> 32];
+  }
+
+  std::string GetString(size_t index, size_t i) const {
+    const Chunk& chunk = GetChunk(index);
+    size_t row = order_[index] & 0xFFFFFFFFULL;
+    if (chunk.string_offsets.empty()) {
+      return std::string();
+    }
+    uint64_t begin = chunk.string_offsets[row * kStringNum + i];
+    uint64_t end = chunk.string_offsets[row * kStringNum + i + 1];
+    return chunk.strings.substr(begin, end - begin);
+  }
+
+  void BuildChunk(Record* records, size_t num, Chunk* chunk) const {
+    size_t slot_num = SlotNum();
+    chunk->offsets.resize(slot_num);
+    chunk->uint64_feasigns.resize(slot_num);
+    chunk->float_feasigns.resize(slot_num);
+    for (auto& offsets : chunk->offsets) {
+      offsets.reserve(num + 1);
+      offsets.push_back(0);
+    }
+    chunk->string_offsets.reserve(num * kStringNum + 1);
+    chunk->string_offsets.push_back(0);
+    chunk->search_ids.reserve(num);
+    chunk->ranks.reserve(num);
+    chunk->cmatches.reserve(num);
+    bool has_log_key = false;
+    for (size_t row = 0; row < num; ++row) {
+      Record& record = records[row];
+      for (auto& item : record.uint64_feasigns_) {
+        CheckSlot(item.slot(), false);
+        chunk->uint64_feasigns[item.slot()].push_back(
+            item.sign().uint64_feasign_);
+      }
+      for (auto& item : record.float_feasigns_) {
+        CheckSlot(item.slot(), true);
+        chunk->float_feasigns[item.slot()].push_back(
+            item.sign().float_feasign_);
+      }
+      for (size_t slot = 0; slot < slot_num; ++slot) {
+        size_t size = is_float_slot_[slot]
+                          ? chunk->float_feasigns[slot].size()
+                          : chunk->uint64_feasigns[slot].size();
+        PADDLE_ENFORCE_LE(
+            size,
+            std::numeric_limits<uint32_t>::max(),
+            common::errors::OutOfRange(
+                "The feasign number of slot %d in a chunk of the record "
+                "column store should be no more than %d, but received %d.",
+                slot,
+                std::numeric_limits<uint32_t>::max(),
+                size));
+        chunk->offsets[slot].push_back(static_cast<uint32_t>(size));
+      }
+      for (auto* str : {&record.ins_id_, &record.content_, &record.uid_}) {
+        chunk->strings.append(*str);
+        chunk->string_offsets.push_back(chunk->strings.size());
+      }
+      chunk->search_ids.push_back(record.search_id);
+      chunk->ranks.push_back(record.rank);
+      chunk->cmatches.push_back(record.cmatch);
+      has_log_key = has_log_key || record.search_id != 0 || record.rank != 0 ||
+                    record.cmatch != 0;
+      // free the record as soon as it is in the columns
+      std::vector<FeatureItem>().swap(record.uint64_feasigns_);
+      std::vector<FeatureItem>().swap(record.float_feasigns_);
+    }
+    if (chunk->strings.empty()) {
+      std::vector<uint64_t>().swap(chunk->string_offsets);
+    }
+    if (!has_log_key) {
+      std::vector<uint64_t>().swap(chunk->search_ids);
+      std::vector<uint32_t>().swap(chunk->ranks);
+      std::vector<uint32_t>().swap(chunk->cmatches);
+    }
+    // the columns are not appended any more
+    for (size_t slot = 0; slot < slot_num; ++slot) {
+      chunk->uint64_feasigns[slot].shrink_to_fit();
+      chunk->float_feasigns[slot].shrink_to_fit();
+    }
+    chunk->strings.shrink_to_fit();
+  }
+
+  void CheckSlot(size_t slot, bool is_float) const {
+    PADDLE_ENFORCE_LT(
+        slot,
+        SlotNum(),
+        common::errors::InvalidArgument(
+            "The slot of the feasign should be less than the used slot "
+            "number %d of the record column store, but received %d.",
+            SlotNum(),
+            slot));
+    PADDLE_ENFORCE_EQ(
+        is_float_slot_[slot],
+        is_float,
+        common::errors::InvalidArgument(
+            "The %s feasign is in slot %d, which is of the other type.",
+            is_float ? "float" : "uint64",
+            slot));
+  }
+
+  std::vector<bool> is_float_slot_;
+  std::vector<Chunk> chunks_;
+  // the chunk id and the row in the chunk of the records, (chunk << 32) | row
+  std::vector<uint64_t> order_;
+  std::mutex mutex_;
+  std::atomic<size_t> next_batch_{0};
+};
+
+}  // namespace framework
+}  // namespace paddle
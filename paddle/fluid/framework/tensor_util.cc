@@ -27,6 +27,7 @@ limitations under the License. */
 #include "paddle/phi/api/lib/data_transform.h"
 #include "paddle/phi/common/complex.h"
 #include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/framework/dense_tensor_tostream.h"
 #include "paddle/phi/core/platform/profiler/event_tracing.h"
 
 #ifdef PADDLE_WITH_DNNL
@@ -470,9 +471,13 @@ void TensorToStream(std::ostream& os,
     auto* pb_dims = desc.mutable_dims();
     pb_dims->Resize(static_cast<int>(dims.size()), 0);
     std::copy(dims.begin(), dims.end(), pb_dims->begin());
-    int32_t size = desc.ByteSize();
-    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
     auto out = desc.SerializeAsString();
+    phi::PadTensorDesc(
+        os,
+        contiguous_tensor.numel() * phi::SizeOf(contiguous_tensor.dtype()),
+        &out);
+    int32_t size = static_cast<int32_t>(out.size());
+    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
     os.write(out.data(), size);
   }
   {  // the 3rd field, tensor data
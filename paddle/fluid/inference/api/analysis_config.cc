@@ -564,6 +564,7 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(specify_input_name_);
 
   CP_MEMBER(use_optimized_model_);
+  CP_MEMBER(execution_plan_dir_);
 
   CP_MEMBER(cpu_math_library_num_threads_);
 
@@ -1127,6 +1128,7 @@ std::string AnalysisConfig::SerializeInfoCache() {
   ss << ir_debug_;
 
   ss << use_optimized_model_;
+  ss << execution_plan_dir_;
 
   ss << specify_input_name_;
   ss << cpu_math_library_num_threads_;
@@ -1423,6 +1425,9 @@ std::string AnalysisConfig::Summary() {
   os.InsertRow({"ir_debug", ir_debug_ ? "true" : "false"});
   os.InsertRow(
       {"use_optimized_model", use_optimized_model_ ? "true" : "false"});
+  if (!execution_plan_dir_.empty()) {
+    os.InsertRow({"execution_plan_dir", execution_plan_dir_});
+  }
   os.InsertRow({"memory_optim", enable_memory_optim_ ? "true" : "false"});
   os.InsertRow({"enable_profile", with_profile_ ? "true" : "false"});
   os.InsertRow({"enable_log", with_glog_info_ ? "true" : "false"});
@@ -17,9 +17,12 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <cstdio>
 #include <cstdlib>
 #include <fstream>
+#include <functional>
 #include <memory>
+#include <random>
 #include <set>
 #include <string>
 #include <utility>
@@ -33,9 +36,11 @@
 #include "paddle/fluid/framework/ir/pass.h"
 #include "paddle/fluid/framework/naive_executor.h"
 #include "paddle/fluid/framework/new_executor/pir_adaptor/pir_adaptor_util.h"
+#include "paddle/fluid/framework/new_executor/pir_interpreter.h"
 #include "paddle/fluid/framework/op_proto_maker.h"
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/framework/transfer_scope_cache.h"
 #include "paddle/fluid/framework/var_type_traits.h"
 #include "paddle/fluid/framework/version.h"
@@ -112,6 +117,7 @@
 
 #include "paddle/common/flags.h"
 #include "paddle/fluid/ir_adaptor/translator/translate.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_type.h"
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
 #include "paddle/fluid/pir/dialect/operator/utils/utils.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
@@ -136,6 +142,8 @@
 #include "paddle/pir/include/pass/pass_registry.h"
 
 COMMON_DECLARE_bool(pir_apply_inplace_pass);
+COMMON_DECLARE_bool(new_executor_sequential_run);
+COMMON_DECLARE_bool(add_dependency_for_communication_op);
 
 namespace paddle {
 namespace {
@@ -366,6 +374,61 @@ bool PaddleTensorToDenseTensor(const PaddleTensor &pt,
   t->set_lod(lod);
   return true;
 }
+
+constexpr char kExecutionPlanFile[] = "_execution_plan.json";
+constexpr char kExecutionPlanParamsFile[] = "_execution_plan.pdiparams";
+
+// The names of the tensors held by the scope that the lowered program reads,
+// which are saved along with the execution plan.
+std::vector<std::pair<std::string, pir::Value>> ExecutionPlanTensors(
+    const pir::Program &program) {
+  std::vector<std::pair<std::string, pir::Value>> tensors;
+  for (auto &op : *program.block()) {
+    if (op.isa<::pir::ParameterOp>()) {
+      auto persistable =
+          op.result(0).attribute<::pir::BoolAttribute>("persistable");
+      if (persistable && persistable.data()) {
+        tensors.emplace_back(
+            op.attribute<pir::StrAttribute>("parameter_name").AsString(),
+            op.result(0));
+      }
+    } else if (op.isa<::pir::ConstantTensorOp>()) {
+      tensors.emplace_back(
+          op.dyn_cast<::pir::ConstantTensorOp>().tensor_name(), op.result(0));
+    }
+  }
+  std::sort(tensors.begin(),
+            tensors.end(),
+            [](const std::pair<std::string, pir::Value> &a,
+               const std::pair<std::string, pir::Value> &b) {
+              return a.first < b.first;
+            });
+  tensors.erase(std::unique(tensors.begin(),
+                            tensors.end(),
+                            [](const std::pair<std::string, pir::Value> &a,
+                               const std::pair<std::string, pir::Value> &b) {
+                              return a.first == b.first;
+                            }),
+                tensors.end());
+  return tensors;
+}
+
+// Files are identified by their size and modification time, except the
+// program file, which is small enough to be hashed.
+std::string FileStamp(const std::string &path, bool hash_content) {
+  std::stringstream ss;
+  struct stat statbuf;
+  if (stat(path.c_str(), &statbuf) == 0) {
+    ss << statbuf.st_size << ":" << statbuf.st_mtime;
+  }
+  if (hash_content) {
+    std::ifstream fin(path, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(fin)),
+                        std::istreambuf_iterator<char>());
+    ss << ":" << std::hash<std::string>()(content);
+  }
+  return ss.str();
+}
 }  // namespace
 
 AnalysisPredictor::AnalysisPredictor(const AnalysisConfig &config)
@@ -485,7 +548,9 @@ bool AnalysisPredictor::Init(
     return false;
   }
 
-  if (load_pir_model_) {
+  if (ExecutionPlanEnabled() && RestoreExecutionPlan()) {
+    VLOG(3) << "Skip optimizing the program restored from the execution plan.";
+  } else if (load_pir_model_) {
     if (!PreparePirProgram()) {
       return false;
     }
@@ -494,6 +559,8 @@ bool AnalysisPredictor::Init(
       return false;
     }
   }
+  save_execution_plan_ = ExecutionPlanEnabled() && !status_is_cloned_ &&
+                         restored_dependencies_ == nullptr;
 
   // Get the feed_target_names and fetch_target_names
 
@@ -1214,6 +1281,228 @@ bool AnalysisPredictor::PreparePirProgram() {
   return true;
 }
 
+bool AnalysisPredictor::ExecutionPlanEnabled() const {
+  // The kernels compiled by CINN and the engines built by TensorRT are not
+  // saved in the program, so these programs can not be restored.
+  // The plan is keyed by the program file, which is empty for the models
+  // set by their directory.
+  return !config_.execution_plan_dir().empty() && config_.new_ir_enabled() &&
+         config_.new_executor_enabled() && !config_.prog_file().empty() &&
+         !config_.model_from_memory() &&
+         !config_.cinn_enabled() && !config_.tensorrt_engine_enabled() &&
+         !config_.dist_config().use_dist_model();
+}
+
+std::string AnalysisPredictor::ExecutionPlanFingerprint() const {
+  std::stringstream ss;
+  ss << paddle::get_version() << ";" << place_ << ";";
+  ss << FileStamp(config_.prog_file(), true) << ";";
+  ss << FileStamp(config_.params_file(), false) << ";";
+  ss << config_.use_gpu() << config_.use_xpu() << config_.mkldnn_enabled()
+     << config_.mkldnn_bfloat16_enabled() << config_.use_cutlass_ << ";";
+  ss << config_.enable_gpu_mixed_ << static_cast<int>(
+                                         config_.mixed_precision_mode_)
+     << config_.enable_low_precision_io_ << ";";
+  for (const auto &op_type : std::set<std::string>(
+           config_.mixed_black_list_.begin(), config_.mixed_black_list_.end())) {
+    ss << op_type << ",";
+  }
+  ss << ";";
+  for (const auto &op_type : std::set<std::string>(
+           config_.mixed_white_list_.begin(), config_.mixed_white_list_.end())) {
+    ss << op_type << ",";
+  }
+  ss << ";";
+  for (const auto &pass : config_.custom_passes_) {
+    ss << pass << ",";
+  }
+  ss << config_.custom_pass_only_ << config_.pm_opt_level_ << ";";
+  for (const auto &pass : config_.deleted_passes_) {
+    ss << pass << ",";
+  }
+  ss << ";" << FLAGS_pir_apply_inplace_pass
+     << FLAGS_new_executor_sequential_run
+     << FLAGS_add_dependency_for_communication_op
+     << paddle::prim::PrimCommonUtils::IsFwdPrimEnabled();
+  return std::to_string(std::hash<std::string>()(ss.str()));
+}
+
+bool AnalysisPredictor::RestoreExecutionPlan() {
+  const std::string plan_file =
+      config_.execution_plan_dir() + "/" + kExecutionPlanFile;
+  const std::string params_file =
+      config_.execution_plan_dir() + "/" + kExecutionPlanParamsFile;
+  auto program = std::make_shared<pir::Program>(pir::IrContext::Instance());
+  pir::ExecutionPlan plan;
+  try {
+    if (!pir::ReadExecutionPlan(
+            plan_file, ExecutionPlanFingerprint(), program.get(), &plan)) {
+      return false;
+    }
+  } catch (const std::exception &e) {
+    LOG(WARNING) << "Failed to read the execution plan " << plan_file << ": "
+                 << e.what();
+    return false;
+  }
+
+  // Match the feeds and fetches against the program before changing the
+  // predictor, so that it can still fall back to the model.
+  std::map<std::string, pir::Operation *> data_ops, output_ops;
+  for (auto &op : *program->block()) {
+    if (op.isa<::pir::ShadowOutputOp>()) {
+      output_ops[op.attribute<pir::StrAttribute>("output_name").AsString()] =
+          &op;
+    } else if (op.HasAttribute("op_name") && op.HasAttribute("name")) {
+      auto op_name = op.attribute<pir::StrAttribute>("op_name").AsString();
+      if (op_name == paddle::dialect::DataOp::name() ||
+          op_name == paddle::dialect::FeedOp::name()) {
+        data_ops[op.attribute<pir::StrAttribute>("name").AsString()] = &op;
+      }
+    }
+  }
+  std::vector<pir::Operation *> feeds, fetches;
+  for (const auto &[name, shape] : plan.feeds) {
+    if (data_ops.count(name) == 0) {
+      LOG(WARNING) << "The input " << name
+                   << " is not found in the execution plan.";
+      return false;
+    }
+    feeds.push_back(data_ops.at(name));
+  }
+  for (const auto &[name, shape] : plan.fetches) {
+    if (output_ops.count(name) == 0) {
+      LOG(WARNING) << "The output " << name
+                   << " is not found in the execution plan.";
+      return false;
+    }
+    fetches.push_back(output_ops.at(name));
+  }
+
+  auto tensors = ExecutionPlanTensors(*program);
+  if (!tensors.empty()) {
+    std::vector<std::string> names;
+    std::vector<phi::DenseTensor *> tensor_out;
+    for (const auto &[name, value] : tensors) {
+      names.push_back(name);
+      tensor_out.push_back(sub_scope_->Var(name)->GetMutable<phi::DenseTensor>());
+    }
+    try {
+      pir::LoadCombineFunction(
+          params_file, names, &tensor_out, false, phi::CPUPlace());
+    } catch (const std::exception &e) {
+      LOG(WARNING) << "Failed to load the parameters of the execution plan "
+                   << params_file << ": " << e.what();
+      return false;
+    }
+    // Put the tensors back to the places the kernels were selected for.
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      auto type = tensors[i]
+                      .second.type()
+                      .dyn_cast<paddle::dialect::AllocatedDenseTensorType>();
+      phi::Place place = type ? type.place() : place_;
+      if (place.GetType() == phi::AllocationType::UNDEFINED) {
+        place = place_;
+      }
+      if (!phi::is_cpu_place(place)) {
+        framework::TensorCopySync(*tensor_out[i], place, tensor_out[i]);
+      }
+    }
+  }
+
+  pir_program_ = program;
+  load_pir_model_ = true;
+  pir_feeds_ = feeds;
+  pir_fetches_ = fetches;
+  for (size_t i = 0; i < plan.feeds.size(); ++i) {
+    const auto &[name, shape] = plan.feeds[i];
+    idx2feeds_[i] = name;
+    feed_names_[name] = i;
+    feed_name2shapes_[name] = shape;
+  }
+  for (size_t i = 0; i < plan.fetches.size(); ++i) {
+    const auto &[name, shape] = plan.fetches[i];
+    idx2fetches_[i] = name;
+    fetch_name2shapes_[name] = shape;
+  }
+  restored_dependencies_ =
+      std::make_shared<const std::map<size_t, std::set<size_t>>>(
+          std::move(plan.dependencies));
+  LOG(INFO) << "Restore the execution plan from " << plan_file;
+  return true;
+}
+
+void AnalysisPredictor::SaveExecutionPlan() {
+  save_execution_plan_ = false;
+  const std::string plan_file =
+      config_.execution_plan_dir() + "/" + kExecutionPlanFile;
+  const std::string params_file =
+      config_.execution_plan_dir() + "/" + kExecutionPlanParamsFile;
+  try {
+    const auto *core = executor_->GetInterpreterCore();
+    const auto *interpreter =
+        core == nullptr
+            ? nullptr
+            : dynamic_cast<const framework::PirInterpreter *>(core->Impl());
+    if (interpreter == nullptr) {
+      return;
+    }
+
+    pir::ExecutionPlan plan;
+    plan.fingerprint = ExecutionPlanFingerprint();
+    plan.dependencies =
+        interpreter->GetPirDependencyBuilder().OpDownstreamMap();
+    auto input_shapes = GetInputTensorShape();
+    for (const auto &[idx, name] : idx2feeds_) {
+      plan.feeds.emplace_back(name, input_shapes[name]);
+    }
+    auto output_shapes = GetOutputTensorShape();
+    for (const auto &[idx, name] : idx2fetches_) {
+      plan.fetches.emplace_back(name, output_shapes[name]);
+    }
+
+    auto tensors = ExecutionPlanTensors(*pir_program_);
+    if (!tensors.empty()) {
+      std::vector<std::string> names;
+      std::vector<const phi::DenseTensor *> tensor_in;
+      for (const auto &[name, value] : tensors) {
+        auto *var = sub_scope_->FindVar(name);
+        if (var == nullptr || !var->IsType<phi::DenseTensor>() ||
+            !var->Get<phi::DenseTensor>().IsInitialized()) {
+          LOG(WARNING) << "Skip saving the execution plan since " << name
+                       << " is not an initialized DenseTensor in scope.";
+          return;
+        }
+        names.push_back(name);
+        tensor_in.push_back(&var->Get<phi::DenseTensor>());
+      }
+      // Write the parameters to a temporary file and rename it, so that a
+      // predictor restoring the plan concurrently never reads half of them.
+      std::string tmp_file =
+          params_file + ".tmp." + std::to_string(std::random_device()());
+      try {
+        pir::SaveCombineFunction(
+            tensor_in, names, tmp_file, true, false, false);
+      } catch (...) {
+        std::remove(tmp_file.c_str());
+        throw;
+      }
+      if (std::rename(tmp_file.c_str(), params_file.c_str()) != 0) {
+        std::remove(tmp_file.c_str());
+        LOG(WARNING) << "Failed to rename " << tmp_file << " to "
+                     << params_file;
+        return;
+      }
+    }
+    // Write the plan after its parameters, so that a plan is not visible
+    // before its parameters are complete.
+    pir::WriteExecutionPlan(*pir_program_, plan, plan_file);
+    LOG(INFO) << "Execution plan saved to " << plan_file;
+  } catch (const std::exception &e) {
+    LOG(WARNING) << "Failed to save the execution plan to " << plan_file
+                 << ": " << e.what();
+  }
+}
+
 bool AnalysisPredictor::PrepareProgram(
     const std::shared_ptr<framework::ProgramDesc> &program) {
   if (!program) {
@@ -1355,6 +1644,7 @@ bool AnalysisPredictor::PrepareExecutor() {
 
     execution_config.skip_gc_vars.insert(output_names.begin(),
                                          output_names.end());
+    execution_config.instruction_dependencies = restored_dependencies_;
 
     if (config_.new_ir_enabled()) {
       executor_->PrepareInterpreterCore(
@@ -1770,6 +2060,9 @@ bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
 
   if (config_.new_executor_enabled()) {  // NOLINT
     executor_->RunInterpreterCore();
+    if (save_execution_plan_) {
+      SaveExecutionPlan();
+    }
   } else {
     // Run the inference program
     // if share variables, we need not create variables
@@ -1884,6 +2177,9 @@ bool AnalysisPredictor::Run(const std::vector<paddle::Tensor> &inputs,
     fleet_exe_->Run(config_.dist_config().carrier_id());
   } else if (config_.new_executor_enabled()) {  // NOLINT
     executor_->RunInterpreterCore();
+    if (save_execution_plan_) {
+      SaveExecutionPlan();
+    }
   } else {
     // Run the inference program
     // if share variables, we need not create variables
@@ -1892,6 +2188,9 @@ bool AnalysisPredictor::Run(const std::vector<paddle::Tensor> &inputs,
 #else
   if (config_.new_executor_enabled()) {  // NOLINT
     executor_->RunInterpreterCore();
+    if (save_execution_plan_) {
+      SaveExecutionPlan();
+    }
   } else {
     // Run the inference program
     // if share variables, we need not create variables
@@ -2840,6 +3139,9 @@ bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
 
   if (config_.new_executor_enabled()) {  // NOLINT
     executor_->RunInterpreterCore({}, false, switch_stream);
+    if (save_execution_plan_) {
+      SaveExecutionPlan();
+    }
   } else {
     executor_->Run();
   }
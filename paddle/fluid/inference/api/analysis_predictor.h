@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -392,6 +393,29 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   bool SaveOrLoadPirParameters(bool for_save);
 
+  ///
+  /// \brief Whether the execution plan is enabled by the config and
+  /// supported by the program to run.
+  ///
+  bool ExecutionPlanEnabled() const;
+  ///
+  /// \brief The fingerprint of the model, the config and the environment the
+  /// execution plan depends on.
+  ///
+  std::string ExecutionPlanFingerprint() const;
+  ///
+  /// \brief Restore the lowered program, its parameters and the dependencies
+  /// of its instructions from the execution plan.
+  ///
+  /// \return Whether the execution plan is restored
+  ///
+  bool RestoreExecutionPlan();
+  ///
+  /// \brief Save the execution plan after the first run, which builds the
+  /// dependencies of instructions.
+  ///
+  void SaveExecutionPlan();
+
   ///
   /// \brief Prepare input data, only used in Run()
   ///
@@ -583,6 +607,11 @@ class AnalysisPredictor : public PaddlePredictor {
   std::vector<pir::Operation *> pir_fetches_;
   std::map<size_t, std::string> idx2fetches_;
   std::map<std::string, std::vector<int64_t>> fetch_name2shapes_;
+  // The dependencies of instructions restored from the execution plan.
+  std::shared_ptr<const std::map<size_t, std::set<size_t>>>
+      restored_dependencies_;
+  // Save the execution plan after the next run.
+  bool save_execution_plan_{false};
 
   phi::DataType model_precision_{phi::DataType::FLOAT32};
 
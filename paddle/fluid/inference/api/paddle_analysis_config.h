@@ -889,6 +889,24 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   void UseOptimizedModel(bool x = true) { use_optimized_model_ = x; }
 
+  ///
+  /// \brief Set the directory of the execution plan. After the first run, the
+  /// program lowered for the new executor, its parameters and the dependencies
+  /// of its instructions are saved into the directory, and a predictor created
+  /// later with the same model and config restores them instead of optimizing
+  /// and analyzing the program again. It only works with new IR and the new
+  /// executor, and the model set by its program file and params file.
+  ///
+  /// \param dir the directory of the execution plan, empty to disable it.
+  ///
+  void SetExecutionPlanDir(const std::string& dir) { execution_plan_dir_ = dir; }
+  ///
+  /// \brief Get the directory of the execution plan.
+  ///
+  /// \return const std::string& The directory of the execution plan.
+  ///
+  const std::string& execution_plan_dir() const { return execution_plan_dir_; }
+
   ///
   /// \brief Control whether to debug IR graph analysis phase.
   /// This will generate DOT files for visualizing the computation graph after
@@ -1292,6 +1310,7 @@ struct PD_INFER_DECL AnalysisConfig {
   bool ir_debug_{false};
 
   bool use_optimized_model_{false};
+  std::string execution_plan_dir_;
 
   bool use_new_executor_{false};
 
@@ -29,6 +29,8 @@ class AllocatedDenseTensorType
  public:
   using Base::Base;
 
+  static std::string name() { return "t_allocated_dense_tensor"; }
+
   static AllocatedDenseTensorType get(pir::IrContext *ctx,
                                       const phi::Place &place,
                                       dialect::DenseTensorType type) {
@@ -73,6 +75,8 @@ class AllocatedSelectedRowsType
  public:
   using Base::Base;
 
+  static std::string name() { return "t_allocated_selected_rows"; }
+
   static AllocatedSelectedRowsType get(pir::IrContext *ctx,
                                        const phi::Place &place,
                                        dialect::SelectedRowsType type) {
@@ -117,6 +121,8 @@ class AllocatedSparseCooTensorType
  public:
   using Base::Base;
 
+  static std::string name() { return "t_allocated_sparse_coo_tensor"; }
+
   static AllocatedSparseCooTensorType get(pir::IrContext *ctx,
                                           const phi::Place &place,
                                           dialect::SparseCooTensorType type) {
@@ -175,6 +181,8 @@ class AllocatedSparseCsrTensorType
  public:
   using Base::Base;
 
+  static std::string name() { return "t_allocated_sparse_csr_tensor"; }
+
   static AllocatedSparseCsrTensorType get(pir::IrContext *ctx,
                                           const phi::Place &place,
                                           dialect::SparseCsrTensorType type) {
@@ -229,6 +237,8 @@ class AllocatedDenseTensorArrayType
  public:
   using Base::Base;
 
+  static std::string name() { return "t_allocated_dense_tensor_array"; }
+
   static AllocatedDenseTensorArrayType get(pir::IrContext *ctx,
                                            const phi::Place &place,
                                            dialect::DenseTensorArrayType type) {
@@ -22,6 +22,8 @@
 #include "paddle/fluid/framework/data_layout.h"
 #include "paddle/fluid/pir/dialect/distributed/ir/dist_attribute.h"
 #include "paddle/fluid/pir/dialect/distributed/ir/dist_type.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_attribute.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_type.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_attribute.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/schema.h"
@@ -71,6 +73,14 @@ class AttrTypeReader {
   static pir::Type ReadControlFlowType(const std::string type_name,
                                        Json* type_json,
                                        pir::IrContext* ctx);
+
+  static pir::Type ReadPaddleKernelType(const std::string type_name,
+                                        Json* type_json,
+                                        pir::IrContext* ctx);
+
+  static pir::Attribute ReadPaddleKernelAttr(const std::string attr_name,
+                                             Json* attr_json,
+                                             pir::IrContext* ctx);
 };
 
 template <typename T>
@@ -211,19 +221,38 @@ deserializeAttrFromJson<paddle::dialect::DataTypeAttribute, std::string>(
   return paddle::dialect::DataTypeAttribute::get(ctx, data_type);
 }
 
+phi::Place deserializePlaceFromJson(Json* place_json) {
+  int8_t type_id = place_json->at(0).template get<int8_t>();
+  phi::AllocationType type = static_cast<phi::AllocationType>(type_id);
+  int8_t id = place_json->at(1).template get<int8_t>();  // int8_t
+  std::string dev_type =
+      place_json->at(2).template get<std::string>();  // string
+  return phi::Place(type, id, dev_type);
+}
+
 template <>
 paddle::dialect::PlaceAttribute
 deserializeAttrFromJson<paddle::dialect::PlaceAttribute, int8_t>(
     Json* attr_json, pir::IrContext* ctx) {
-  Json data_json = attr_json->at(DATA);
-  int8_t type_id = data_json.at(0).template get<int8_t>();
-  phi::AllocationType type = static_cast<phi::AllocationType>(type_id);
-  int8_t id = data_json.at(1).template get<int8_t>();                  // int8_t
-  std::string dev_type = data_json.at(2).template get<std::string>();  // string
-  phi::Place place = phi::Place(type, id, dev_type);
+  phi::Place place = deserializePlaceFromJson(&(attr_json->at(DATA)));
   return paddle::dialect::PlaceAttribute::get(ctx, place);
 }
 
+template <>
+paddle::dialect::KernelAttribute
+deserializeAttrFromJson<paddle::dialect::KernelAttribute, int32_t>(
+    Json* attr_json, pir::IrContext* ctx) {
+  Json data_json = attr_json->at(DATA);
+  phi::Backend backend =
+      static_cast<phi::Backend>(data_json.at(0).template get<int32_t>());
+  phi::DataLayout layout =
+      common::StringToDataLayout(data_json.at(1).template get<std::string>());
+  phi::DataType dtype =
+      phi::StringToDataType(data_json.at(2).template get<std::string>());
+  return paddle::dialect::KernelAttribute::get(
+      ctx, phi::KernelKey(backend, layout, dtype));
+}
+
 pir::Type parseType(Json* type_json) {
   auto type_name = type_json->at(ID).template get<std::string>();
 
@@ -245,6 +274,9 @@ pir::Type parseType(Json* type_json) {
   } else if (DECOMPRESS_DIALECT_ID(name.first) ==
              pir::ControlFlowDialect::name()) {
     return AttrTypeReader::ReadControlFlowType(name.second, type_json, ctx);
+  } else if (DECOMPRESS_DIALECT_ID(name.first) ==
+             paddle::dialect::KernelDialect::name()) {
+    return AttrTypeReader::ReadPaddleKernelType(name.second, type_json, ctx);
   } else {
     PADDLE_ENFORCE(
         false,
@@ -280,6 +312,9 @@ pir::Attribute parseAttr(Json* attr_json) {
   } else if (DECOMPRESS_DIALECT_ID(name.first) ==
              paddle::dialect::DistDialect::name()) {
     return AttrTypeReader::ReadPaddleDistAttr(name.second, attr_json, ctx);
+  } else if (DECOMPRESS_DIALECT_ID(name.first) ==
+             paddle::dialect::KernelDialect::name()) {
+    return AttrTypeReader::ReadPaddleKernelAttr(name.second, attr_json, ctx);
   } else {
     PADDLE_ENFORCE(
         false,
@@ -604,6 +639,18 @@ deserializeTypeFromJsonIncludeParseType<paddle::dialect::DistDenseTensorType>(
       ctx, dense_tensor_type, tensor_dist_attr, local_ddim);
 }
 
+template <typename T, typename PrimType>
+T deserializeAllocatedTypeFromJson(Json* type_json, pir::IrContext* ctx) {
+  Json data_json = type_json->at(DATA);
+  phi::Place place = deserializePlaceFromJson(&(data_json.at(0)));
+  pir::Type type = parseType(&(data_json.at(1)));
+  PADDLE_ENFORCE_EQ(type.isa<PrimType>(),
+                    true,
+                    common::errors::InvalidArgument(
+                        "Unexpected prim type of %s.", T::name()));
+  return T::get(ctx, place, type.dyn_cast<PrimType>());
+}
+
 pir::Type AttrTypeReader::ReadBuiltInType(const std::string type_name,
                                           Json* type_json,
                                           pir::IrContext* ctx) {
@@ -727,4 +774,60 @@ pir::Type AttrTypeReader::ReadControlFlowType(const std::string type_name,
   }
 }
 
+pir::Type AttrTypeReader::ReadPaddleKernelType(const std::string type_name,
+                                               Json* type_json,
+                                               pir::IrContext* ctx) {
+  if (type_name == paddle::dialect::AllocatedDenseTensorType::name()) {
+    VLOG(8) << "Parse paddle::dialect::AllocatedDenseTensorType ... ";
+    return pir::deserializeAllocatedTypeFromJson<
+        paddle::dialect::AllocatedDenseTensorType,
+        pir::DenseTensorType>(type_json, ctx);
+  } else if (type_name == paddle::dialect::AllocatedSelectedRowsType::name()) {
+    VLOG(8) << "Parse paddle::dialect::AllocatedSelectedRowsType ... ";
+    return pir::deserializeAllocatedTypeFromJson<
+        paddle::dialect::AllocatedSelectedRowsType,
+        paddle::dialect::SelectedRowsType>(type_json, ctx);
+  } else if (type_name ==
+             paddle::dialect::AllocatedSparseCooTensorType::name()) {
+    VLOG(8) << "Parse paddle::dialect::AllocatedSparseCooTensorType ... ";
+    return pir::deserializeAllocatedTypeFromJson<
+        paddle::dialect::AllocatedSparseCooTensorType,
+        paddle::dialect::SparseCooTensorType>(type_json, ctx);
+  } else if (type_name ==
+             paddle::dialect::AllocatedSparseCsrTensorType::name()) {
+    VLOG(8) << "Parse paddle::dialect::AllocatedSparseCsrTensorType ... ";
+    return pir::deserializeAllocatedTypeFromJson<
+        paddle::dialect::AllocatedSparseCsrTensorType,
+        paddle::dialect::SparseCsrTensorType>(type_json, ctx);
+  } else if (type_name ==
+             paddle::dialect::AllocatedDenseTensorArrayType::name()) {
+    VLOG(8) << "Parse paddle::dialect::AllocatedDenseTensorArrayType ... ";
+    return pir::deserializeAllocatedTypeFromJson<
+        paddle::dialect::AllocatedDenseTensorArrayType,
+        paddle::dialect::DenseTensorArrayType>(type_json, ctx);
+  } else {
+    PADDLE_ENFORCE(false,
+                   common::errors::InvalidArgument(
+                       "Unknown Type %s for parse paddle kernel dialect type",
+                       type_name));
+    return pir::Type();
+  }
+}
+
+pir::Attribute AttrTypeReader::ReadPaddleKernelAttr(const std::string attr_name,
+                                                    Json* attr_json,
+                                                    pir::IrContext* ctx) {
+  if (attr_name == paddle::dialect::KernelAttribute::name()) {
+    VLOG(8) << "Parse KernelAttribute .";
+    return pir::deserializeAttrFromJson<paddle::dialect::KernelAttribute,
+                                        int32_t>(attr_json, ctx);
+  } else {
+    PADDLE_ENFORCE(false,
+                   common::errors::InvalidArgument(
+                       "Unknown Attr %s for parse paddle kernel dialect attr",
+                       attr_name));
+  }
+  return pir::Attribute();
+}
+
 }  // namespace pir
@@ -13,7 +13,11 @@
 // limitations under the License.
 #pragma once
 
+#include <map>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/pir/include/core/dll_decl.h"
 #include "paddle/pir/include/core/program.h"
@@ -65,6 +69,58 @@ bool IR_API ReadModule(const std::string& file_path,
                        pir::Program* program,
                        int64_t pir_version = -1);
 
+/**
+ * @brief What an executor analyses from a lowered program before running it,
+ * saved along with the program by WriteExecutionPlan.
+ */
+struct ExecutionPlan {
+  // Identifies the model, config and build the plan is made from. A plan with
+  // another fingerprint is not loaded.
+  std::string fingerprint;
+  // The downstream map of the instructions built from the program.
+  std::map<size_t, std::set<size_t>> dependencies;
+  // The names and shapes of the inputs and outputs of the program, in the
+  // order of feed and fetch.
+  std::vector<std::pair<std::string, std::vector<int64_t>>> feeds;
+  std::vector<std::pair<std::string, std::vector<int64_t>>> fetches;
+};
+
+/**
+ * @brief Write a lowered PIR program (of kernel dialect) and its execution plan
+ * into a file at the specified file path, which replaces the existing file.
+ *
+ * @param[in] program      The lowered PIR program to be written.
+ * @param[in] plan         The execution plan of the program.
+ * @param[in] file_path    The path to the file to be written.
+ *
+ * @return void。
+ *
+ * @note The file is written to a temporary file and renamed, so a concurrent
+ * ReadExecutionPlan never reads a partial file.
+ */
+void IR_API WriteExecutionPlan(const pir::Program& program,
+                               const ExecutionPlan& plan,
+                               const std::string& file_path);
+
+/**
+ * @brief Read a lowered PIR program and its execution plan written by
+ * WriteExecutionPlan.
+ *
+ * @param[in] file_path    The path to the file to be read.
+ * @param[in] fingerprint  The expected fingerprint of the plan.
+ * @param[out] program     A pointer to the PIR program object where the
+ * deserialized program will be stored.
+ * @param[out] plan        The execution plan of the program.
+ *
+ * @return bool. false if the file does not exist, is broken, or is written in
+ * another format version, PIR version or with another fingerprint. 'program'
+ * and 'plan' are only filled when it returns true.
+ */
+bool IR_API ReadExecutionPlan(const std::string& file_path,
+                              const std::string& fingerprint,
+                              pir::Program* program,
+                              ExecutionPlan* plan);
+
 /**
  * @brief Save the given tensor into a single file at the specified file path
  * with its name.
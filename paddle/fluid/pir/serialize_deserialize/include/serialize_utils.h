@@ -21,6 +21,8 @@
 #include "paddle/common/layout.h"
 #include "paddle/fluid/pir/dialect/distributed/ir/dist_attribute.h"
 #include "paddle/fluid/pir/dialect/distributed/ir/dist_type.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_attribute.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_type.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_attribute.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/schema.h"
@@ -56,6 +58,10 @@ class AttrTypeWriter {
   static Json WritePaddleDistAttr(const pir::Attribute& attr);
 
   static Json WriteControlFlowType(const pir::Type& type);
+
+  static Json WritePaddleKernelType(const pir::Type& type);
+
+  static Json WritePaddleKernelAttr(const pir::Attribute& attr);
 };
 /** serializeTypeToJson is a template function to serialize
  * a pir type to a json object. a pir type may have value or no value
@@ -218,16 +224,34 @@ Json serializeAttrToJson<paddle::dialect::ScalarAttribute>(
   return json_obj;
 }
 
+Json serializePlaceToJson(const phi::Place& place) {
+  Json content = Json::array();
+  content.push_back(static_cast<int8_t>(place.GetType()));
+  content.push_back(place.GetDeviceId());    // int8_t
+  content.push_back(place.GetDeviceType());  // string
+  return content;
+}
+
 template <>
 Json serializeAttrToJson<paddle::dialect::PlaceAttribute>(
     const paddle::dialect::PlaceAttribute& attr) {
   Json json_obj;
   json_obj[ID] = COMPRESS_DIALECT_NAME(attr) + "." + attr.name();
+  json_obj[DATA] = serializePlaceToJson(attr.data());
+  return json_obj;
+}
+
+// KernelKey includes: Backend backend, DataLayout layout, DataType dtype;
+template <>
+Json serializeAttrToJson<paddle::dialect::KernelAttribute>(
+    const paddle::dialect::KernelAttribute& attr) {
+  Json json_obj;
+  json_obj[ID] = COMPRESS_DIALECT_NAME(attr) + "." + attr.name();
   Json content = Json::array();
-  auto place = attr.data();
-  content.push_back(static_cast<int8_t>(place.GetType()));
-  content.push_back(place.GetDeviceId());    // int8_t
-  content.push_back(place.GetDeviceType());  // string
+  auto kernel_key = attr.data();
+  content.push_back(static_cast<int32_t>(kernel_key.backend()));
+  content.push_back(common::DataLayoutToString(kernel_key.layout()));
+  content.push_back(phi::DataTypeToString(kernel_key.dtype()));
   json_obj[DATA] = content;
   return json_obj;
 }
@@ -251,6 +275,9 @@ Json writeType(const pir::Type& type) {
   } else if (type.dialect().name() == pir::ControlFlowDialect::name()) {
     VLOG(6) << "write ControlFlowDialect ... ";
     return AttrTypeWriter::WriteControlFlowType(type);
+  } else if (type.dialect().name() == paddle::dialect::KernelDialect::name()) {
+    VLOG(6) << "write PaddleKernelType ... ";
+    return AttrTypeWriter::WritePaddleKernelType(type);
   } else {
     PADDLE_ENFORCE(
         false,
@@ -279,6 +306,9 @@ Json writeAttr(const pir::Attribute& attr) {
   } else if (attr.dialect().name() == paddle::dialect::DistDialect::name()) {
     VLOG(8) << "write PaddleDistAttr ... ";
     return AttrTypeWriter::WritePaddleDistAttr(attr);
+  } else if (attr.dialect().name() == paddle::dialect::KernelDialect::name()) {
+    VLOG(8) << "write PaddleKernelAttr ... ";
+    return AttrTypeWriter::WritePaddleKernelAttr(attr);
   } else {
     PADDLE_ENFORCE(
         false,
@@ -561,6 +591,20 @@ Json serializeTypeToJsonIncludeWriteType<paddle::dialect::DistDenseTensorType>(
   return json_obj;
 }
 
+// The allocated types of kernel dialect include: phi::Place place, and the
+// type of operator dialect or builtin dialect it is allocated for;
+template <typename T>
+Json serializeAllocatedTypeToJson(const T& type) {
+  Json json_obj;
+  json_obj[ID] = COMPRESS_DIALECT_NAME(type) + "." + type.name();
+  Json content = Json::array();
+  content.push_back(serializePlaceToJson(type.place()));
+  T allocated_type = type;
+  content.push_back(writeType(allocated_type.prim_type()));
+  json_obj[DATA] = content;
+  return json_obj;
+}
+
 Json AttrTypeWriter::WriteBuiltInType(const pir::Type& type) {
   Json type_json = Json::object();
   if (type.isa<pir::BoolType>()) {
@@ -756,4 +800,51 @@ Json AttrTypeWriter::WriteControlFlowType(const pir::Type& type) {
   return type_json;
 }
 
+Json AttrTypeWriter::WritePaddleKernelType(const pir::Type& type) {
+  if (type.isa<paddle::dialect::AllocatedDenseTensorType>()) {
+    VLOG(8) << "Write AllocatedDenseTensorType ... ";
+    return pir::serializeAllocatedTypeToJson<
+        paddle::dialect::AllocatedDenseTensorType>(
+        type.dyn_cast<paddle::dialect::AllocatedDenseTensorType>());
+  } else if (type.isa<paddle::dialect::AllocatedSelectedRowsType>()) {
+    VLOG(8) << "Write AllocatedSelectedRowsType ... ";
+    return pir::serializeAllocatedTypeToJson<
+        paddle::dialect::AllocatedSelectedRowsType>(
+        type.dyn_cast<paddle::dialect::AllocatedSelectedRowsType>());
+  } else if (type.isa<paddle::dialect::AllocatedSparseCooTensorType>()) {
+    VLOG(8) << "Write AllocatedSparseCooTensorType ... ";
+    return pir::serializeAllocatedTypeToJson<
+        paddle::dialect::AllocatedSparseCooTensorType>(
+        type.dyn_cast<paddle::dialect::AllocatedSparseCooTensorType>());
+  } else if (type.isa<paddle::dialect::AllocatedSparseCsrTensorType>()) {
+    VLOG(8) << "Write AllocatedSparseCsrTensorType ... ";
+    return pir::serializeAllocatedTypeToJson<
+        paddle::dialect::AllocatedSparseCsrTensorType>(
+        type.dyn_cast<paddle::dialect::AllocatedSparseCsrTensorType>());
+  } else if (type.isa<paddle::dialect::AllocatedDenseTensorArrayType>()) {
+    VLOG(8) << "Write AllocatedDenseTensorArrayType ... ";
+    return pir::serializeAllocatedTypeToJson<
+        paddle::dialect::AllocatedDenseTensorArrayType>(
+        type.dyn_cast<paddle::dialect::AllocatedDenseTensorArrayType>());
+  } else {
+    PADDLE_ENFORCE(false,
+                   common::errors::InvalidArgument(
+                       "Unknown Type when write paddle.kernel_dialect type"));
+    return Json::object();
+  }
+}
+
+Json AttrTypeWriter::WritePaddleKernelAttr(const pir::Attribute& attr) {
+  if (attr.isa<paddle::dialect::KernelAttribute>()) {
+    VLOG(8) << "write KernelAttribute .";
+    return pir::serializeAttrToJson<paddle::dialect::KernelAttribute>(
+        attr.dyn_cast<paddle::dialect::KernelAttribute>());
+  } else {
+    PADDLE_ENFORCE(false,
+                   common::errors::InvalidArgument(
+                       "Unknown Attr when write paddle.kernel_dialect attr"));
+  }
+  return Json::object();
+}
+
 }  // namespace pir
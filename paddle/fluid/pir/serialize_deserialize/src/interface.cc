@@ -14,7 +14,10 @@
 
 #include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
 #include <stdio.h>
+#include <random>
 #include "paddle/common/enforce.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/ir_deserialize.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/ir_serialize.h"
 #include "paddle/phi/common/port.h"
@@ -26,6 +29,16 @@ namespace pir {
 #define PIRVERSION "version"
 #define TRAINABLE "trainable"
 #define PIR "pir"
+#define PLAN "pir_plan"
+#define PLANVERSION "plan_version"
+#define FINGERPRINT "fingerprint"
+#define DEPENDENCIES "dependencies"
+#define FEEDS "feeds"
+#define FETCHES "fetches"
+
+// Bump it when the layout of the execution plan changes.
+constexpr uint64_t kExecutionPlanVersion = 1;
+
 void WriteModule(const pir::Program& program,
                  const std::string& file_path,
                  uint64_t pir_version,
@@ -109,4 +122,84 @@ bool ReadModule(const std::string& file_path,
   }
 }
 
+void WriteExecutionPlan(const pir::Program& program,
+                        const ExecutionPlan& plan,
+                        const std::string& file_path) {
+  Json total;
+  total[BASE_CODE] = {{MAGIC, PLAN},
+                      {PIRVERSION, DEVELOP_VERSION},
+                      {PLANVERSION, kExecutionPlanVersion},
+                      {FINGERPRINT, plan.fingerprint}};
+
+  ProgramWriter writer(DEVELOP_VERSION, true);
+  total[PROGRAM] = writer.GetProgramJson(&program);
+  total[DEPENDENCIES] = plan.dependencies;
+  total[FEEDS] = plan.feeds;
+  total[FETCHES] = plan.fetches;
+  std::string total_str = total.dump();
+
+  MkDirRecursively(DirName(file_path).c_str());
+  std::string tmp_path =
+      file_path + ".tmp." + std::to_string(std::random_device()());
+  std::ofstream fout(tmp_path, std::ios::binary);
+  PADDLE_ENFORCE_EQ(static_cast<bool>(fout),
+                    true,
+                    common::errors::Unavailable(
+                        "Cannot open %s to save execution plan.", tmp_path));
+  fout << total_str;
+  fout.close();
+  if (!fout || std::rename(tmp_path.c_str(), file_path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    PADDLE_THROW(common::errors::Unavailable(
+        "Failed to save execution plan to %s.", file_path));
+  }
+}
+
+bool ReadExecutionPlan(const std::string& file_path,
+                       const std::string& fingerprint,
+                       pir::Program* program,
+                       ExecutionPlan* plan) {
+  if (!FileExists(file_path)) {
+    VLOG(3) << "Execution plan " << file_path << " does not exist.";
+    return false;
+  }
+  std::ifstream f(file_path);
+  Json data = Json::parse(f, nullptr, /*allow_exceptions=*/false);
+  if (data.is_discarded() || !data.contains(BASE_CODE) ||
+      !data.contains(PROGRAM)) {
+    VLOG(3) << "Execution plan " << file_path << " is broken.";
+    return false;
+  }
+  const Json& base_code = data.at(BASE_CODE);
+  if (base_code.value(MAGIC, "") != PLAN ||
+      base_code.value(PIRVERSION, uint64_t(0)) != DEVELOP_VERSION ||
+      base_code.value(PLANVERSION, uint64_t(0)) != kExecutionPlanVersion) {
+    VLOG(3) << "Execution plan " << file_path
+            << " is written in another version: " << base_code;
+    return false;
+  }
+  if (base_code.value(FINGERPRINT, "") != fingerprint) {
+    VLOG(3) << "Execution plan " << file_path
+            << " is made from another model or config.";
+    return false;
+  }
+
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<paddle::dialect::KernelDialect>();
+  // The program is lowered for the current version, so no patch is applied.
+  PatchBuilder builder(DEVELOP_VERSION);
+  ProgramReader reader(DEVELOP_VERSION);
+  reader.RecoverProgram(&(data[PROGRAM]), program, &builder);
+
+  plan->fingerprint = fingerprint;
+  plan->dependencies = data.at(DEPENDENCIES)
+                           .template get<std::map<size_t, std::set<size_t>>>();
+  plan->feeds = data.at(FEEDS).template get<
+      std::vector<std::pair<std::string, std::vector<int64_t>>>>();
+  plan->fetches = data.at(FETCHES).template get<
+      std::vector<std::pair<std::string, std::vector<int64_t>>>>();
+  return true;
+}
+
 }  // namespace pir
@@ -14,11 +14,15 @@ limitations under the License. */
 #include <numeric>
 
 #include "glog/logging.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
 #include "paddle/phi/common/port.h"
+#include "paddle/phi/core/framework/lod_tensor_serialize.h"
 #include "paddle/phi/kernels/funcs/data_type_transform.h"
 
+COMMON_DECLARE_bool(enable_mmap_load_params);
+
 namespace pir {
 
 const phi::DeviceContext* GetDeviceContext(
@@ -206,6 +210,17 @@ void LoadCombineFunction(const std::string& file_path,
                         "it to be greater than 0.",
                         out->size()));
   const phi::DeviceContext* dev_ctx = GetDeviceContext(*(out->at(0)), place);
+#ifndef _WIN32
+  if (FLAGS_enable_mmap_load_params && !load_as_fp16 &&
+      dev_ctx->GetPlace().GetType() == phi::AllocationType::CPU) {
+    fin.close();
+    phi::DeserializeFromMappedFile(
+        file_path,
+        std::vector<phi::DenseTensor*>(out->begin(),
+                                       out->begin() + names.size()));
+    return;
+  }
+#endif
   for (size_t i = 0; i < names.size(); i++) {
     auto tensor = out->at(i);
     paddle::framework::DeserializeFromStream(fin, tensor, *dev_ctx);
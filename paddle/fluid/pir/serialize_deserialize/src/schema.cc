@@ -55,6 +55,7 @@ DialectIdMap::DialectIdMap() {
   insert(pir::ControlFlowDialect::name(), "2");
   insert(paddle::dialect::CustomOpDialect::name(), "3");
   insert(paddle::dialect::DistDialect::name(), "4");
+  insert(paddle::dialect::KernelDialect::name(), "5");
   // TestDialect for test use
   insert(test::TestDialect::name(), "-1");
   insert(test1::Test1Dialect::name(), "-2");
@@ -278,6 +278,12 @@ void BindDataset(py::module *m) {
       .def("global_shuffle",
            &framework::Dataset::GlobalShuffle,
            py::call_guard<py::gil_scoped_release>())
+      .def("streaming_global_shuffle",
+           &framework::Dataset::StreamingGlobalShuffle,
+           py::call_guard<py::gil_scoped_release>())
+      .def("wait_streaming_global_shuffle_done",
+           &framework::Dataset::WaitStreamingGlobalShuffleDone,
+           py::call_guard<py::gil_scoped_release>())
       .def("get_memory_data_size",
            &framework::Dataset::GetMemoryDataSize,
            py::call_guard<py::gil_scoped_release>())
@@ -0,0 +1,187 @@
+/* Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/backends/cpu/numa_info.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "glog/logging.h"
+
+namespace phi {
+namespace backends {
+namespace cpu {
+
+namespace {
+
+#ifdef __linux__
+// Same as MPOL_PREFERRED in <numaif.h>, which is not available without
+// libnuma headers.
+constexpr int kMpolPreferred = 1;
+
+// Parse a cpulist like "0-15,32-47".
+std::vector<int> ParseCpuList(const std::string& cpulist) {
+  std::vector<int> cpus;
+  std::stringstream ss(cpulist);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty() || range == "\n") continue;
+    auto dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = dash == std::string::npos ? first
+                                         : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+bool ReadNodeCpus(int node, std::vector<int>* cpus) {
+  std::ifstream fin("/sys/devices/system/node/node" + std::to_string(node) +
+                    "/cpulist");
+  if (!fin.is_open()) {
+    return false;
+  }
+  std::string cpulist;
+  std::getline(fin, cpulist);
+  *cpus = ParseCpuList(cpulist);
+  return true;
+}
+#endif
+
+struct NumaTopology {
+  NumaTopology() {
+#ifdef __linux__
+    std::vector<int> cpus;
+    while (ReadNodeCpus(static_cast<int>(node_cpus.size()), &cpus)) {
+      node_cpus.push_back(cpus);
+    }
+    for (size_t node = 0; node < node_cpus.size(); ++node) {
+      for (int cpu : node_cpus[node]) {
+        if (cpu >= static_cast<int>(cpu_to_node.size())) {
+          cpu_to_node.resize(cpu + 1, 0);
+        }
+        cpu_to_node[cpu] = static_cast<int>(node);
+      }
+    }
+#endif
+    if (node_cpus.empty()) {
+      std::vector<int> all_cpus;
+      int n = static_cast<int>(std::thread::hardware_concurrency());
+      for (int cpu = 0; cpu < n; ++cpu) {
+        all_cpus.push_back(cpu);
+      }
+      node_cpus.push_back(all_cpus);
+    }
+    VLOG(4) << "NUMA node count: " << node_cpus.size();
+  }
+
+  std::vector<std::vector<int>> node_cpus;
+  std::vector<int> cpu_to_node;
+};
+
+const NumaTopology& GetNumaTopology() {
+  static NumaTopology topology;
+  return topology;
+}
+
+}  // namespace
+
+int NumaNodeCount() {
+  return static_cast<int>(GetNumaTopology().node_cpus.size());
+}
+
+int CurrentNumaNode() {
+#ifdef __linux__
+  const auto& topology = GetNumaTopology();
+  if (topology.node_cpus.size() > 1) {
+    int cpu = sched_getcpu();
+    if (cpu >= 0 && cpu < static_cast<int>(topology.cpu_to_node.size())) {
+      return topology.cpu_to_node[cpu];
+    }
+  }
+#endif
+  return 0;
+}
+
+std::vector<int> NumaNodeCpus(int node) {
+  const auto& topology = GetNumaTopology();
+  if (node < 0 || node >= static_cast<int>(topology.node_cpus.size())) {
+    return {};
+  }
+  return topology.node_cpus[node];
+}
+
+bool BindMemoryToNumaNode(void* ptr, size_t size, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  if (NumaNodeCount() <= 1) {
+    return false;
+  }
+  constexpr size_t kBitsPerMask = sizeof(unsigned long) * 8;  // NOLINT
+  std::vector<unsigned long> nodemask(  // NOLINT
+      node / kBitsPerMask + 1,
+      0);
+  nodemask[node / kBitsPerMask] |= 1UL << (node % kBitsPerMask);
+  long ret = syscall(SYS_mbind,  // NOLINT
+                     ptr,
+                     size,
+                     kMpolPreferred,
+                     nodemask.data(),
+                     nodemask.size() * kBitsPerMask,
+                     0);
+  if (ret != 0) {
+    VLOG(4) << "mbind to NUMA node " << node << " failed, errno: " << errno;
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool BindCurrentThreadToNumaNode(int node) {
+#ifdef __linux__
+  auto cpus = NumaNodeCpus(node);
+  if (cpus.empty()) {
+    return false;
+  }
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &mask);
+  }
+  if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+    VLOG(4) << "Bind thread to NUMA node " << node
+            << " failed, errno: " << errno;
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+}  // namespace cpu
+}  // namespace backends
+}  // namespace phi
@@ -0,0 +1,50 @@
+/* Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+namespace backends {
+namespace cpu {
+
+// NUMA topology is read from /sys/devices/system/node on Linux. On other
+// platforms, or when the topology is unavailable, the machine is treated as
+// a single node 0 that owns all processors.
+
+//! Get the number of NUMA nodes, at least 1.
+TEST_API int NumaNodeCount();
+
+//! Get the NUMA node of the processor the calling thread runs on.
+TEST_API int CurrentNumaNode();
+
+//! Get the processors that belong to the NUMA node.
+TEST_API std::vector<int> NumaNodeCpus(int node);
+
+//! Prefer the pages of [ptr, ptr + size) to be placed on the NUMA node.
+//! ptr must be page aligned. Return false if the binding is not supported.
+bool BindMemoryToNumaNode(void* ptr, size_t size, int node);
+
+//! Restrict the calling thread to the processors of the NUMA node.
+//! Return false if the binding is not supported.
+TEST_API bool BindCurrentThreadToNumaNode(int node);
+
+}  // namespace cpu
+}  // namespace backends
+}  // namespace phi
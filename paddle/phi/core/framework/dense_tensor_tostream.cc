@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "paddle/common/flags.h"
 #include "paddle/phi/backends/context_pool.h"
 #include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/core/compat/convert_utils.h"
@@ -30,10 +31,72 @@
 #include "paddle/phi/core/tensor_utils.h"
 #include "paddle/phi/kernels/contiguous_kernel.h"
 
+COMMON_DECLARE_bool(enable_aligned_save_params);
+
 namespace phi {
 
 namespace proto = paddle::framework::proto;
 
+namespace {
+
+// The field number of the padding in TensorDesc, which is not used by it.
+constexpr uint32_t kPaddingFieldNumber = 1000;
+
+size_t VarintSize(uint64_t value) {
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+}  // namespace
+
+void PadTensorDesc(std::ostream& os, uint64_t data_size, std::string* desc) {
+  if (!FLAGS_enable_aligned_save_params) {
+    return;
+  }
+  auto pos = os.tellp();
+  if (pos < 0) {
+    return;
+  }
+  const size_t alignment = data_size >= kTensorDataPageSize
+                               ? kTensorDataPageSize
+                               : kTensorDataAlignment;
+  // The data starts after the int32_t size of desc and desc itself.
+  size_t data_offset =
+      static_cast<size_t>(pos) + sizeof(int32_t) + desc->size();
+  size_t padding = (alignment - data_offset % alignment) % alignment;
+  if (padding == 0) {
+    return;
+  }
+  // A length-delimited field takes its tag, its length and its bytes, so find
+  // the smallest padding it can fill exactly.
+  const uint64_t tag = (kPaddingFieldNumber << 3) | 2;
+  const size_t tag_size = VarintSize(tag);
+  for (;; padding += alignment) {
+    for (size_t length_size = 1; tag_size + length_size <= padding;
+         ++length_size) {
+      size_t length = padding - tag_size - length_size;
+      if (VarintSize(length) == length_size) {
+        AppendVarint(tag, desc);
+        AppendVarint(length, desc);
+        desc->append(length, '\0');
+        return;
+      }
+    }
+  }
+}
+
 template <typename Context>
 phi::DenseTensor InnerTensorContiguous(const Context& dev_ctx,
                                        const phi::DenseTensor& tensor) {
@@ -118,9 +181,13 @@ void TensorToStream(std::ostream& os,
     auto* pb_dims = desc.mutable_dims();
     pb_dims->Resize(static_cast<int>(dims.size()), 0);
     std::copy(dims.begin(), dims.end(), pb_dims->begin());
-    int32_t size = desc.ByteSize();
-    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
     auto out = desc.SerializeAsString();
+    PadTensorDesc(
+        os,
+        contiguous_tensor.numel() * phi::SizeOf(contiguous_tensor.dtype()),
+        &out);
+    int32_t size = static_cast<int32_t>(out.size());
+    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
     os.write(out.data(), size);
   }
   {  // the 3rd field, tensor data
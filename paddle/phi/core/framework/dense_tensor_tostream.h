@@ -27,6 +27,20 @@
 
 namespace phi {
 
+// The alignment of the tensor data in a parameter file saved with
+// FLAGS_enable_aligned_save_params: tensors not smaller than a page start at a
+// page boundary, and the others at kTensorDataAlignment.
+constexpr size_t kTensorDataPageSize = 4096;
+constexpr size_t kTensorDataAlignment = 64;
+
+// Pad the serialized TensorDesc `desc` with a field unknown to TensorDesc, so
+// that the tensor data written right after it starts at an aligned offset of
+// `os`. Protobuf skips unknown fields when parsing, so the padded desc is read
+// as before. It does nothing unless FLAGS_enable_aligned_save_params is set.
+TEST_API void PadTensorDesc(std::ostream& os,
+                            uint64_t data_size,
+                            std::string* desc);
+
 TEST_API void TensorToStream(std::ostream& os,
                              const phi::DenseTensor& tensor,
                              const phi::DeviceContext& dev_ctx);
@@ -14,7 +14,11 @@
 
 #include "paddle/phi/core/framework/lod_tensor_serialize.h"
 #include <cstdint>
+#include <cstring>
 #include "paddle/phi/core/framework/convert_utils.h"
+#ifndef _WIN32
+#include "paddle/phi/core/memory/allocation/mmap_allocator.h"
+#endif
 
 namespace phi {
 
@@ -127,4 +131,110 @@ void DeserializeFromStream(std::istream &is,
   TensorFromStream(is, static_cast<phi::DenseTensor *>(tensor), dev_ctx);
 }
 
+#ifndef _WIN32
+void DeserializeFromMappedFile(const std::string &file_path,
+                               const std::vector<phi::DenseTensor *> &tensors) {
+  auto file =
+      paddle::memory::allocation::AllocateMemoryMapFileAllocation(file_path);
+  const char *base = static_cast<const char *>(file->ptr());
+  const size_t file_size = file->size();
+  size_t offset = 0;
+  auto check_size = [&](size_t size) {
+    PADDLE_ENFORCE_LE(
+        size,
+        file_size - offset,
+        common::errors::Unavailable(
+            "An error occurred while loading model parameters from %s. "
+            "Please check whether the model file is complete or damaged.",
+            file_path));
+  };
+  auto read = [&](void *dst, size_t size) {
+    check_size(size);
+    std::memcpy(dst, base + offset, size);
+    offset += size;
+  };
+
+  const phi::DeviceContext *dev_ctx =
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace());
+  size_t num_mapped = 0;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    auto *tensor = tensors[i];
+    PADDLE_ENFORCE_NOT_NULL(
+        tensor,
+        common::errors::InvalidArgument(
+            "The variable index %d to be loaded cannot be found.", i));
+    // The layout is the same as SerializeToStream.
+    uint32_t version = 0;
+    read(&version, sizeof(version));
+    PADDLE_ENFORCE_EQ(
+        version,
+        0U,
+        common::errors::InvalidArgument(
+            "Deserialize to tensor failed, maybe the loaded file is "
+            "not a paddle model(expected file format: 0, but %u found).",
+            version));
+    uint64_t lod_level = 0;
+    read(&lod_level, sizeof(lod_level));
+    auto &lod = *tensor->mutable_lod();
+    lod.resize(lod_level);
+    for (uint64_t level = 0; level < lod_level; ++level) {
+      uint64_t size = 0;
+      read(&size, sizeof(size));
+      check_size(size);
+      std::vector<size_t> tmp(size / sizeof(size_t));
+      read(tmp.data(), size);
+      lod[level] = tmp;
+    }
+
+    uint32_t tensor_version = 0;
+    read(&tensor_version, sizeof(tensor_version));
+    PADDLE_ENFORCE_EQ(
+        tensor_version,
+        0U,
+        common::errors::InvalidArgument(
+            "tensor version %u is not supported, Only version 0 is supported",
+            tensor_version));
+    int32_t desc_size = -1;
+    read(&desc_size, sizeof(desc_size));
+    PADDLE_ENFORCE_GE(desc_size,
+                      0,
+                      common::errors::InvalidArgument(
+                          "phi::DenseTensor desc size should >= 0"));
+    check_size(desc_size);
+    proto::VarType::TensorDesc desc;
+    PADDLE_ENFORCE_EQ(
+        desc.ParseFromArray(base + offset, desc_size),
+        true,
+        common::errors::InvalidArgument("Cannot parse tensor desc"));
+    offset += desc_size;
+
+    std::vector<int64_t> dims(desc.dims().begin(), desc.dims().end());
+    tensor->Resize(common::make_ddim(dims));
+    auto dtype = phi::TransToPhiDataType(desc.data_type());
+    size_t size = tensor->numel() * phi::SizeOf(dtype);
+    check_size(size);
+    if (size > 0 && offset % kTensorDataAlignment == 0) {
+      tensor->set_offset(0);
+      tensor->ResetHolderWithType(
+          std::make_shared<
+              paddle::memory::allocation::MemoryMapFileSliceAllocation>(
+              file, offset, size),
+          dtype);
+      ++num_mapped;
+    } else {
+      void *dst = dev_ctx->Alloc(tensor, dtype);
+      std::memcpy(dst, base + offset, size);
+    }
+    offset += size;
+  }
+  PADDLE_ENFORCE_EQ(offset,
+                    file_size,
+                    common::errors::Unavailable(
+                        "Not allowed to load partial data via "
+                        "load_combine_op, please use load_op instead."));
+  VLOG(3) << num_mapped << " of " << tensors.size() << " tensors in "
+          << file_path << " are mapped without copying.";
+}
+#endif
+
 }  // namespace phi
@@ -50,4 +50,15 @@ void SerializeToStream(std::ostream& os, const phi::DenseTensor& tensor);
 
 void DeserializeFromStream(std::istream& os, phi::DenseTensor* tensor);
 
+#ifndef _WIN32
+/*
+ * Deserialize all the tensors of a combined file, which is mapped into memory
+ * by mmap. A tensor whose data is aligned in the file points into the mapping
+ * instead of being copied, see FLAGS_enable_mmap_load_params. The tensors are
+ * on CPU.
+ */
+void DeserializeFromMappedFile(const std::string& file_path,
+                               const std::vector<phi::DenseTensor*>& tensors);
+#endif
+
 }  // namespace phi
@@ -25,8 +25,12 @@
 #include "paddle/phi/core/memory/allocation/auto_growth_best_fit_allocator_v2.h"
 #include "paddle/phi/core/memory/allocation/cpu_allocator.h"
 #include "paddle/phi/core/memory/allocation/naive_best_fit_allocator.h"
+#ifndef _WIN32
+#include "paddle/phi/core/memory/allocation/numa_cpu_allocator.h"
+#endif
 #include "paddle/phi/core/memory/allocation/retry_allocator.h"
 #include "paddle/phi/core/memory/allocation/stat_allocator.h"
+#include "paddle/phi/core/memory/allocation/thread_cached_allocator.h"
 #include "paddle/phi/core/platform/device_context.h"
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -111,6 +115,28 @@ PHI_DEFINE_EXPORTED_bool(
     "Whether to use AutoGrowthBestFitAllocatorV2 for auto_growth "
     "strategy");
 
+PHI_DEFINE_EXPORTED_bool(
+    use_thread_cached_cpu_allocator,
+    false,
+    "Whether to put a ThreadCachedAllocator in front of an "
+    "AutoGrowthBestFitAllocator for CPU memory, only available for "
+    "auto_growth strategy. It removes lock contention of small CPU "
+    "allocations in multi-threaded inference.");
+
+PHI_DEFINE_EXPORTED_uint64(
+    thread_cached_cpu_allocator_max_bytes_per_thread,
+    4UL << 20,
+    "The high-water mark of bytes cached by each thread in "
+    "ThreadCachedAllocator. When a thread caches more than this, "
+    "half of its free lists are returned to the shared pool.");
+
+PHI_DEFINE_EXPORTED_bool(
+    use_numa_cpu_allocator,
+    false,
+    "Whether to allocate CPU memory from per-NUMA-node arenas, each request "
+    "is served by the arena of the node the calling thread runs on. Only "
+    "available for auto_growth strategy on Linux.");
+
 COMMON_DECLARE_string(allocator_strategy);
 COMMON_DECLARE_uint64(auto_growth_chunk_size_in_mb);
 COMMON_DECLARE_bool(use_auto_growth_pinned_allocator);
@@ -243,7 +269,13 @@ class AllocatorFacadePrivate {
       }
 
       case AllocatorStrategy::kAutoGrowth: {
-        InitNaiveBestFitCPUAllocator();
+        if (FLAGS_use_numa_cpu_allocator) {
+          InitNumaCPUAllocator(allow_free_idle_chunk);
+        } else if (FLAGS_use_thread_cached_cpu_allocator) {
+          InitThreadCachedCPUAllocator(allow_free_idle_chunk);
+        } else {
+          InitNaiveBestFitCPUAllocator();
+        }
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
         allow_free_idle_chunk_ = allow_free_idle_chunk;
         for (int dev_id = 0; dev_id < platform::GetGPUDeviceCount(); ++dev_id) {
@@ -831,6 +863,45 @@ class AllocatorFacadePrivate {
 #endif
   }
 
+  // NOTE: CPU chunks are requested from the system directly, a small
+  // chunk size would make the best-fit pool grow one request at a time.
+  static size_t AutoGrowthCPUChunkSize() {
+    constexpr size_t kDefaultCPUChunkSize = 1UL << 20;
+    size_t chunk_size = FLAGS_auto_growth_chunk_size_in_mb << 20;
+    return chunk_size == 0 ? kDefaultCPUChunkSize : chunk_size;
+  }
+
+  // Blocks of CPU best-fit pools are aligned to the cache line rather than
+  // the page, otherwise every small allocation would occupy a whole page.
+  static constexpr size_t kCPUBlockAlignment = 64;
+
+  void InitThreadCachedCPUAllocator(bool allow_free_idle_chunk) {
+    auto best_fit_allocator = std::make_shared<AutoGrowthBestFitAllocator>(
+        std::make_shared<CPUAllocator>(),
+        kCPUBlockAlignment,
+        AutoGrowthCPUChunkSize(),
+        allow_free_idle_chunk);
+    allocators_[phi::CPUPlace()] = std::make_shared<ThreadCachedAllocator>(
+        best_fit_allocator,
+        FLAGS_thread_cached_cpu_allocator_max_bytes_per_thread);
+  }
+
+  void InitNumaCPUAllocator(bool allow_free_idle_chunk) {
+#ifndef _WIN32
+    PADDLE_ENFORCE_EQ(FLAGS_use_thread_cached_cpu_allocator,
+                      false,
+                      common::errors::InvalidArgument(
+                          "FLAGS_use_numa_cpu_allocator and "
+                          "FLAGS_use_thread_cached_cpu_allocator cannot be "
+                          "enabled at the same time."));
+    allocators_[phi::CPUPlace()] = std::make_shared<NumaCPUAllocator>(
+        kCPUBlockAlignment, AutoGrowthCPUChunkSize(), allow_free_idle_chunk);
+#else
+    PADDLE_THROW(common::errors::Unimplemented(
+        "NumaCPUAllocator is not supported on Windows."));
+#endif
+  }
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   void InitNaiveBestFitCUDAPinnedAllocator() {
     if (FLAGS_use_auto_growth_pinned_allocator) {
@@ -17,6 +17,7 @@
 #include <cstdlib>
 
 #include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/memory/allocation/huge_page.h"
 #include "paddle/phi/core/memory/stats.h"
 
 namespace paddle::memory::allocation {
@@ -26,6 +27,13 @@ bool CPUAllocator::IsAllocThreadSafe() const { return true; }
 void CPUAllocator::FreeImpl(phi::Allocation *allocation) {
   auto size = allocation->size();
   void *p = allocation->ptr();
+  if (auto *huge_page_allocation =
+          dynamic_cast<HugePageAllocation *>(allocation)) {
+    FreeHugePageMemory(p, huge_page_allocation->mapped_size());
+    HOST_MEMORY_STAT_UPDATE(Reserved, 0, -size);
+    delete allocation;
+    return;
+  }
 #ifdef _WIN32
   _aligned_free(p);
 #else
@@ -37,6 +45,14 @@ void CPUAllocator::FreeImpl(phi::Allocation *allocation) {
 
 phi::Allocation *CPUAllocator::AllocateImpl(size_t size) {
   void *p = nullptr;
+  if (UseHugePage(size)) {
+    size_t mapped_size = 0;
+    p = AllocHugePageMemory(size, &mapped_size);
+    if (p != nullptr) {
+      HOST_MEMORY_STAT_UPDATE(Reserved, 0, size);
+      return new HugePageAllocation(p, size, mapped_size);
+    }
+  }
 #ifdef _WIN32
   p = _aligned_malloc(size, kAlignment);
 #else
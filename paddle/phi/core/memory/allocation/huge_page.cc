@@ -0,0 +1,125 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/huge_page.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+#include <atomic>
+#include <cerrno>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+
+PHI_DEFINE_EXPORTED_bool(
+    use_cpu_huge_page,
+    false,
+    "Whether to back large CPU allocations with huge pages. Explicit huge "
+    "pages (MAP_HUGETLB) are tried first, then transparent huge pages "
+    "(madvise(MADV_HUGEPAGE)). It falls back to regular pages silently.");
+
+PHI_DEFINE_EXPORTED_uint64(
+    cpu_huge_page_threshold_in_mb,
+    2,
+    "CPU allocations not smaller than this size (in MB) try huge pages when "
+    "FLAGS_use_cpu_huge_page is set.");
+
+namespace paddle::memory::allocation {
+
+namespace {
+
+constexpr size_t kHugePageSize = 2UL << 20;
+
+std::atomic<uint64_t> huge_page_hit_count{0};
+std::atomic<uint64_t> huge_page_miss_count{0};
+
+}  // namespace
+
+bool UseHugePage(size_t size) {
+  return FLAGS_use_cpu_huge_page &&
+         size >= (FLAGS_cpu_huge_page_threshold_in_mb << 20);
+}
+
+size_t HugePageMappedSize(size_t size) {
+  return AlignedSize(size, kHugePageSize);
+}
+
+void* AllocHugePageMemory(size_t size, size_t* mapped_size) {
+#if defined(__linux__)
+  size = HugePageMappedSize(size);
+  *mapped_size = size;
+#ifdef MAP_HUGETLB
+  void* ptr = mmap(nullptr,
+                   size,
+                   PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                   -1,
+                   0);
+  if (ptr != MAP_FAILED) {
+    ++huge_page_hit_count;
+    VLOG(10) << "Map " << size << " bytes with MAP_HUGETLB";
+    return ptr;
+  }
+  VLOG(10) << "MAP_HUGETLB of " << size << " bytes failed, errno: " << errno;
+#endif
+  void* fallback_ptr = mmap(nullptr,
+                            size,
+                            PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS,
+                            -1,
+                            0);
+  if (fallback_ptr == MAP_FAILED) {
+    ++huge_page_miss_count;
+    return nullptr;
+  }
+  AdviseHugePage(fallback_ptr, size);
+  return fallback_ptr;
+#else
+  ++huge_page_miss_count;
+  return nullptr;
+#endif
+}
+
+void FreeHugePageMemory(void* ptr, size_t mapped_size) {
+#ifndef _WIN32
+  PADDLE_ENFORCE_EQ(munmap(ptr, mapped_size),
+                    0,
+                    common::errors::Unavailable(
+                        "Fail to munmap huge page memory of %ld size, errno "
+                        "is %d.",
+                        mapped_size,
+                        errno));
+#endif
+}
+
+bool AdviseHugePage(void* ptr, size_t size) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (madvise(ptr, size, MADV_HUGEPAGE) == 0) {
+    ++huge_page_hit_count;
+    return true;
+  }
+  VLOG(10) << "madvise(MADV_HUGEPAGE) of " << size
+           << " bytes failed, errno: " << errno;
+#endif
+  ++huge_page_miss_count;
+  return false;
+}
+
+uint64_t HugePageHitCount() { return huge_page_hit_count.load(); }
+
+uint64_t HugePageMissCount() { return huge_page_miss_count.load(); }
+
+}  // namespace paddle::memory::allocation
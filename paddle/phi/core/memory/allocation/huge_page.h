@@ -0,0 +1,73 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "paddle/phi/core/memory/allocation/allocator.h"
+#include "paddle/utils/test_macros.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+/**
+ * Huge-page backed CPU memory.
+ *
+ * When FLAGS_use_cpu_huge_page is set, CPU requests not smaller than
+ * FLAGS_cpu_huge_page_threshold_in_mb are mapped by mmap instead of
+ * posix_memalign. The mapping first tries explicit huge pages
+ * (MAP_HUGETLB), then falls back to regular pages with
+ * madvise(MADV_HUGEPAGE) so that transparent huge pages can back it. If
+ * both fail, callers fall back to their regular allocation path.
+ *
+ * A request that is backed by huge pages counts as a hit, otherwise a miss.
+ */
+
+// Whether a CPU request of `size` bytes should try huge pages.
+bool UseHugePage(size_t size);
+
+// Map at least `size` bytes, preferring huge pages. The mapped size is
+// returned by `mapped_size`. Return nullptr if the memory can not be mapped.
+void* AllocHugePageMemory(size_t size, size_t* mapped_size);
+
+// The size AllocHugePageMemory maps for a request of `size` bytes.
+size_t HugePageMappedSize(size_t size);
+
+void FreeHugePageMemory(void* ptr, size_t mapped_size);
+
+// Advise an existing mapping, e.g. a shared memory segment, to be backed by
+// transparent huge pages. Return whether the advice is accepted.
+bool AdviseHugePage(void* ptr, size_t size);
+
+TEST_API uint64_t HugePageHitCount();
+TEST_API uint64_t HugePageMissCount();
+
+// Allocation mapped by AllocHugePageMemory.
+class HugePageAllocation : public Allocation {
+ public:
+  HugePageAllocation(void* ptr, size_t size, size_t mapped_size)
+      : Allocation(ptr, size, phi::CPUPlace()), mapped_size_(mapped_size) {}
+
+  size_t mapped_size() const { return mapped_size_; }
+
+ private:
+  size_t mapped_size_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
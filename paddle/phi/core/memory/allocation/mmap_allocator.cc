@@ -18,6 +18,7 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <cstdlib>
 
 #include <atomic>
@@ -27,6 +28,7 @@
 #include "glog/logging.h"
 #include "paddle/common/flags.h"
 #include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/memory/allocation/huge_page.h"
 
 COMMON_DECLARE_bool(use_shm_cache);
 
@@ -108,6 +110,9 @@ void AllocateMemoryMap(std::string filename,
                     MAP_FAILED,
                     common::errors::Unavailable(
                         "Memory map failed when create shared memory."));
+  if ((flags & MAPPED_SHAREDMEM) && UseHugePage(size)) {
+    AdviseHugePage(*map_ptr_, size);
+  }
   if (flags & MAPPED_KEEPFD) {
     *shared_fd = fd;
     VLOG(6) << "keep fd: " << *shared_fd;
@@ -303,10 +308,49 @@ std::shared_ptr<MemoryMapWriterAllocation> AllocateMemoryMapWriterAllocation(
                     common::errors::Unavailable(
                         "Memory map failed when create shared memory."));
   close(fd);
+  if (UseHugePage(size)) {
+    AdviseHugePage(ptr, size);
+  }
 
   return std::make_shared<MemoryMapWriterAllocation>(ptr, size, ipc_name);
 }
 
+void MemoryMapFileAllocation::close() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  if (munmap(map_ptr_, map_size_) == -1) {
+    LOG(WARNING) << "Failed to unmap the file " << ipc_name_;
+    return;
+  }
+  VLOG(6) << "munmap file: " << ipc_name_;
+}
+
+std::shared_ptr<MemoryMapFileAllocation> AllocateMemoryMapFileAllocation(
+    const std::string &filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  PADDLE_ENFORCE_NE(
+      fd,
+      -1,
+      common::errors::Unavailable("Failed to open the file %s.", filename));
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1 || file_stat.st_size == 0) {
+    ::close(fd);
+    PADDLE_THROW(common::errors::Unavailable(
+        "Failed to get the size of the file %s, or it is empty.", filename));
+  }
+  size_t size = static_cast<size_t>(file_stat.st_size);
+  // PROT_WRITE with MAP_PRIVATE only writes to the private copies of pages.
+  void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  PADDLE_ENFORCE_NE(
+      ptr,
+      MAP_FAILED,
+      common::errors::Unavailable("Failed to map the file %s.", filename));
+  return std::make_shared<MemoryMapFileAllocation>(ptr, size, filename);
+}
+
 std::shared_ptr<MemoryMapReaderAllocation> RebuildMemoryMapReaderAllocation(
     const std::string &ipc_name, size_t size) {
   int flags = O_RDWR | O_CREAT;
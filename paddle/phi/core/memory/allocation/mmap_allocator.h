@@ -154,6 +154,39 @@ std::shared_ptr<MemoryMapWriterAllocation> AllocateMemoryMapWriterAllocation(
 std::shared_ptr<MemoryMapReaderAllocation> RebuildMemoryMapReaderAllocation(
     const std::string &ipc_name, size_t size);
 
+// MemoryMapFileAllocation maps a whole regular file privately. Writes to the
+// mapping are copy-on-write and never reach the file, and the pages not
+// written are shared with the page cache, so with other processes mapping the
+// same file.
+class MemoryMapFileAllocation : public MemoryMapAllocation {
+ public:
+  MemoryMapFileAllocation(void *ptr, size_t size, std::string filename)
+      : MemoryMapAllocation(ptr, size, std::move(filename), -1) {}
+
+  void close() override;
+
+  ~MemoryMapFileAllocation() override { close(); }
+};
+
+// The file should not be truncated while it is mapped.
+std::shared_ptr<MemoryMapFileAllocation> AllocateMemoryMapFileAllocation(
+    const std::string &filename);
+
+// A part of a MemoryMapFileAllocation, which keeps the whole mapping alive.
+class MemoryMapFileSliceAllocation : public Allocation {
+ public:
+  MemoryMapFileSliceAllocation(std::shared_ptr<MemoryMapFileAllocation> file,
+                               size_t offset,
+                               size_t size)
+      : Allocation(static_cast<char *>(file->ptr()) + offset,
+                   size,
+                   phi::CPUPlace()),
+        file_(std::move(file)) {}
+
+ private:
+  std::shared_ptr<MemoryMapFileAllocation> file_;
+};
+
 class MemoryMapFdSet {
  public:
   static MemoryMapFdSet &Instance();  // NOLINT
@@ -0,0 +1,132 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/numa_cpu_allocator.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <utility>
+
+#include "paddle/phi/backends/cpu/numa_info.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/memory/allocation/auto_growth_best_fit_allocator.h"
+#include "paddle/phi/core/memory/allocation/huge_page.h"
+#include "paddle/phi/core/memory/stats.h"
+
+namespace paddle::memory::allocation {
+
+namespace {
+
+// NUMA stats are only declared for node 0 ~ 7, nodes beyond that share the
+// arena of node (node % kMaxNumaNodes).
+constexpr int kMaxNumaNodes = 8;
+
+class NumaAllocation : public Allocation {
+ public:
+  NumaAllocation(DecoratedAllocationPtr underlying_allocation, int node)
+      : Allocation(underlying_allocation->ptr(),
+                   underlying_allocation->base_ptr(),
+                   underlying_allocation->size(),
+                   underlying_allocation->place()),
+        underlying_allocation_(std::move(underlying_allocation)),
+        node_(node) {}
+
+  int node() const { return node_; }
+
+ private:
+  DecoratedAllocationPtr underlying_allocation_;
+  int node_;
+};
+
+}  // namespace
+
+phi::Allocation* NumaNodeChunkAllocator::AllocateImpl(size_t size) {
+  static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size = AlignedSize(size, page_size);
+  void* ptr = mmap(
+      nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) {
+    PADDLE_THROW_BAD_ALLOC(common::errors::ResourceExhausted(
+        "Fail to alloc memory of %ld size on NUMA node %d, errno is %d.",
+        size,
+        node_,
+        errno));
+  }
+  // Pages are not touched yet, so the binding takes effect on first touch.
+  phi::backends::cpu::BindMemoryToNumaNode(ptr, size, node_);
+  if (UseHugePage(size)) {
+    AdviseHugePage(ptr, size);
+  }
+  HOST_MEMORY_STAT_UPDATE(Reserved, 0, size);
+  HOST_NUMA_MEMORY_STAT_UPDATE(Reserved, node_, size);
+  return new Allocation(ptr, size, phi::CPUPlace());
+}
+
+void NumaNodeChunkAllocator::FreeImpl(phi::Allocation* allocation) {
+  auto size = allocation->size();
+  PADDLE_ENFORCE_EQ(
+      munmap(allocation->ptr(), size),
+      0,
+      common::errors::Unavailable("Fail to munmap memory on NUMA node %d, "
+                                  "errno is %d.",
+                                  node_,
+                                  errno));
+  HOST_MEMORY_STAT_UPDATE(Reserved, 0, -size);
+  HOST_NUMA_MEMORY_STAT_UPDATE(Reserved, node_, -size);
+  delete allocation;
+}
+
+NumaCPUAllocator::NumaCPUAllocator(size_t alignment,
+                                   size_t chunk_size,
+                                   bool allow_free_idle_chunk) {
+  int num_nodes =
+      std::min(phi::backends::cpu::NumaNodeCount(), kMaxNumaNodes);
+  for (int node = 0; node < num_nodes; ++node) {
+    arenas_.emplace_back(std::make_shared<AutoGrowthBestFitAllocator>(
+        std::make_shared<NumaNodeChunkAllocator>(node),
+        alignment,
+        chunk_size,
+        allow_free_idle_chunk));
+  }
+  VLOG(4) << "NumaCPUAllocator with " << num_nodes << " NUMA node arenas";
+}
+
+phi::Allocation* NumaCPUAllocator::AllocateImpl(size_t size) {
+  int node = phi::backends::cpu::CurrentNumaNode() % NumNodes();
+  auto underlying_allocation =
+      static_unique_ptr_cast<Allocation>(arenas_[node]->Allocate(size));
+  HOST_NUMA_MEMORY_STAT_UPDATE(
+      Allocated, node, underlying_allocation->size());
+  return new NumaAllocation(std::move(underlying_allocation), node);
+}
+
+void NumaCPUAllocator::FreeImpl(phi::Allocation* allocation) {
+  auto* numa_allocation = static_cast<NumaAllocation*>(allocation);
+  HOST_NUMA_MEMORY_STAT_UPDATE(
+      Allocated, numa_allocation->node(), -numa_allocation->size());
+  delete numa_allocation;
+}
+
+uint64_t NumaCPUAllocator::ReleaseImpl(const phi::Place& place) {
+  uint64_t bytes = 0;
+  for (auto& arena : arenas_) {
+    bytes += arena->Release(place);
+  }
+  return bytes;
+}
+
+}  // namespace paddle::memory::allocation
@@ -0,0 +1,71 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "paddle/phi/core/memory/allocation/allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// Allocate page aligned chunks by mmap, and prefer their pages to be placed
+// on the given NUMA node.
+class NumaNodeChunkAllocator : public Allocator {
+ public:
+  explicit NumaNodeChunkAllocator(int node) : node_(node) {}
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+ protected:
+  phi::Allocation* AllocateImpl(size_t size) override;
+  void FreeImpl(phi::Allocation* allocation) override;
+
+ private:
+  int node_;
+};
+
+// NumaCPUAllocator keeps one AutoGrowthBestFitAllocator arena per NUMA node,
+// and serves each request from the arena of the node the calling thread runs
+// on. Together with worker threads pinned to a node (see
+// WorkQueueOptions::numa_node), the tensors produced by the executor stay in
+// local memory.
+//
+// Allocated and reserved bytes of each node are reported by
+// HOST_NUMA_MEMORY_STAT_* in stats.h.
+class NumaCPUAllocator : public Allocator {
+ public:
+  NumaCPUAllocator(size_t alignment,
+                   size_t chunk_size,
+                   bool allow_free_idle_chunk = true);
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  size_t NumNodes() const { return arenas_.size(); }
+
+ protected:
+  phi::Allocation* AllocateImpl(size_t size) override;
+  void FreeImpl(phi::Allocation* allocation) override;
+  uint64_t ReleaseImpl(const phi::Place& place) override;
+
+ private:
+  std::vector<std::shared_ptr<Allocator>> arenas_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
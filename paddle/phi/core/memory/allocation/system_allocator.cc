@@ -31,6 +31,7 @@ limitations under the License. */
 #include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/core/memory/allocation/allocator.h"
+#include "paddle/phi/core/memory/allocation/huge_page.h"
 #include "paddle/phi/core/platform/device/gpu/gpu_info.h"
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -79,11 +80,23 @@ void* CPUAllocator::Alloc(size_t* index, size_t size) {
 
   *index = 0;  // unlock memory
 
-  void* p = AlignedMalloc(size);
+  void* p = nullptr;
+  if (allocation::UseHugePage(size)) {
+    size_t mapped_size = 0;
+    p = allocation::AllocHugePageMemory(size, &mapped_size);
+    if (p != nullptr) {
+      // The mapped size is the size aligned to huge pages, which can be
+      // recomputed on Free, so only the huge page bit is kept in index.
+      *index |= kHugePageIndexBit;
+    }
+  }
+  if (p == nullptr) {
+    p = AlignedMalloc(size);
+  }
 
   if (p != nullptr) {
     if (FLAGS_use_pinned_memory) {
-      *index = 1;
+      *index |= kLockedIndexBit;
 #ifdef _WIN32
       VirtualLock(p, size);
 #else
@@ -99,7 +112,7 @@ void* CPUAllocator::Alloc(size_t* index, size_t size) {
 }
 
 void CPUAllocator::Free(void* p, size_t size, size_t index) {
-  if (p != nullptr && index == 1) {
+  if (p != nullptr && (index & kLockedIndexBit)) {
 #ifdef _WIN32
     VirtualUnlock(p, size);
 #else
@@ -109,6 +122,10 @@ void CPUAllocator::Free(void* p, size_t size, size_t index) {
   HOST_MEMORY_STAT_UPDATE(Reserved, 0, -size);
   platform::RecordMemEvent(
       p, CPUPlace(), size, phi::TracerMemEventType::ReservedFree);
+  if (index & kHugePageIndexBit) {
+    allocation::FreeHugePageMemory(p, allocation::HugePageMappedSize(size));
+    return;
+  }
 #ifdef _WIN32
   _aligned_free(p);
 #else
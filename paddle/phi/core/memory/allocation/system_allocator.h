@@ -38,6 +38,10 @@ class SystemAllocator {
 
 class CPUAllocator : public SystemAllocator {
  public:
+  // Bits of the index returned by Alloc.
+  static constexpr size_t kLockedIndexBit = 1;
+  static constexpr size_t kHugePageIndexBit = 2;
+
   virtual void* Alloc(size_t* index, size_t size);
   virtual void Free(void* p, size_t size, size_t index);
   virtual bool UseGpu() const;
@@ -0,0 +1,294 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/thread_cached_allocator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle::memory::allocation {
+
+namespace {
+
+// The central free list keeps at most this many batches per size class, the
+// rest is returned to the underlying allocator.
+constexpr size_t kMaxCentralBatches = 8;
+
+// Bytes moved between a thread cache and the central free list at once.
+constexpr size_t kBytesToMove = 64UL << 10;
+
+// log2(ThreadCachedAllocator::kSmallSizeMax)
+constexpr size_t kSmallSizeMaxLog2 = 10;
+
+// log2(ThreadCachedAllocator::kClassesPerPowerOfTwo)
+constexpr size_t kClassesPerPowerOfTwoLog2 = 2;
+
+inline size_t Log2Floor(size_t n) {
+  size_t lg = 0;
+  while (n >>= 1) {
+    ++lg;
+  }
+  return lg;
+}
+
+}  // namespace
+
+std::atomic<uint64_t> ThreadCachedAllocator::next_id_{0};
+
+// The allocation handed out to users. It owns an allocation of the
+// underlying allocator and is recycled as a whole, so a cache hit allocates
+// nothing.
+class ThreadCachedAllocator::ThreadCachedAllocation : public Allocation {
+ public:
+  ThreadCachedAllocation(DecoratedAllocationPtr underlying_allocation,
+                         size_t size_class)
+      : Allocation(underlying_allocation->ptr(),
+                   underlying_allocation->base_ptr(),
+                   ClassToSize(size_class),
+                   underlying_allocation->place()),
+        underlying_allocation_(std::move(underlying_allocation)),
+        size_class_(size_class) {}
+
+  size_t size_class() const { return size_class_; }
+
+ private:
+  DecoratedAllocationPtr underlying_allocation_;
+  size_t size_class_;
+};
+
+class ThreadCachedAllocator::ThreadCache {
+ public:
+  ThreadCache(std::shared_ptr<CentralCache> central_cache,
+              size_t max_cached_bytes)
+      : central_cache_(std::move(central_cache)),
+        max_cached_bytes_(max_cached_bytes) {}
+
+  ~ThreadCache() { ReleaseAll(); }
+
+  ThreadCachedAllocation* Pop(size_t size_class) {
+    auto& list = lists_[size_class];
+    if (UNLIKELY(list.empty())) {
+      central_cache_->Fetch(size_class, NumToMove(size_class), &list);
+      cached_bytes_ += list.size() * ClassToSize(size_class);
+    }
+    auto* allocation = list.back();
+    list.pop_back();
+    cached_bytes_ -= ClassToSize(size_class);
+    return allocation;
+  }
+
+  void Push(ThreadCachedAllocation* allocation) {
+    size_t size_class = allocation->size_class();
+    auto& list = lists_[size_class];
+    list.push_back(allocation);
+    cached_bytes_ += ClassToSize(size_class);
+
+    size_t num_to_move = NumToMove(size_class);
+    if (UNLIKELY(list.size() > 2 * num_to_move)) {
+      ReturnToCentral(size_class, num_to_move);
+    }
+    if (UNLIKELY(cached_bytes_ > max_cached_bytes_)) {
+      Scavenge();
+    }
+  }
+
+  void ReleaseAll() {
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      ReturnToCentral(i, lists_[i].size());
+    }
+  }
+
+ private:
+  void ReturnToCentral(size_t size_class, size_t num) {
+    num = std::min(num, lists_[size_class].size());
+    if (num == 0) return;
+    central_cache_->Return(size_class, num, &lists_[size_class]);
+    cached_bytes_ -= num * ClassToSize(size_class);
+  }
+
+  // Return half of every free list, so that the size classes this thread
+  // uses most keep warm while the total drops below the high-water mark.
+  void Scavenge() {
+    VLOG(10) << "Thread cache exceeds " << max_cached_bytes_
+             << " bytes, scavenge " << cached_bytes_ << " bytes";
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      ReturnToCentral(i, (lists_[i].size() + 1) / 2);
+    }
+  }
+
+  std::shared_ptr<CentralCache> central_cache_;
+  std::vector<ThreadCachedAllocation*> lists_[kNumSizeClasses];
+  size_t cached_bytes_{0};
+  size_t max_cached_bytes_;
+};
+
+ThreadCachedAllocator::CentralCache::CentralCache(
+    std::shared_ptr<Allocator> underlying_allocator)
+    : underlying_allocator(std::move(underlying_allocator)) {}
+
+ThreadCachedAllocator::CentralCache::~CentralCache() { ReleaseAll(); }
+
+void ThreadCachedAllocator::CentralCache::Fetch(
+    size_t size_class, size_t num, std::vector<ThreadCachedAllocation*>* out) {
+  auto& list = lists[size_class];
+  {
+    std::lock_guard<SpinLock> guard(list.lock);
+    size_t n = std::min(num, list.items.size());
+    out->insert(out->end(), list.items.end() - n, list.items.end());
+    list.items.resize(list.items.size() - n);
+  }
+  // Only one allocation is taken from the underlying allocator on a miss, to
+  // avoid holding memory that the thread may never use.
+  if (out->empty()) {
+    auto underlying_allocation = static_unique_ptr_cast<Allocation>(
+        underlying_allocator->Allocate(ClassToSize(size_class)));
+    out->push_back(new ThreadCachedAllocation(std::move(underlying_allocation),
+                                              size_class));
+  }
+}
+
+void ThreadCachedAllocator::CentralCache::Return(
+    size_t size_class, size_t num, std::vector<ThreadCachedAllocation*>* in) {
+  auto& list = lists[size_class];
+  std::vector<ThreadCachedAllocation*> overflow;
+  {
+    std::lock_guard<SpinLock> guard(list.lock);
+    list.items.insert(list.items.end(), in->end() - num, in->end());
+    size_t max_size = kMaxCentralBatches * NumToMove(size_class);
+    if (list.items.size() > max_size) {
+      overflow.assign(list.items.begin() + max_size, list.items.end());
+      list.items.resize(max_size);
+    }
+  }
+  in->resize(in->size() - num);
+  // Free outside the lock, the underlying allocator takes its own lock.
+  for (auto* allocation : overflow) {
+    delete allocation;
+  }
+}
+
+uint64_t ThreadCachedAllocator::CentralCache::ReleaseAll() {
+  uint64_t bytes = 0;
+  for (size_t i = 0; i < kNumSizeClasses; ++i) {
+    std::vector<ThreadCachedAllocation*> items;
+    {
+      std::lock_guard<SpinLock> guard(lists[i].lock);
+      items.swap(lists[i].items);
+    }
+    bytes += items.size() * ClassToSize(i);
+    for (auto* allocation : items) {
+      delete allocation;
+    }
+  }
+  return bytes;
+}
+
+ThreadCachedAllocator::ThreadCachedAllocator(
+    std::shared_ptr<Allocator> underlying_allocator,
+    size_t max_thread_cache_bytes)
+    : underlying_allocator_(std::move(underlying_allocator)),
+      central_cache_(std::make_shared<CentralCache>(underlying_allocator_)),
+      max_thread_cache_bytes_(max_thread_cache_bytes),
+      id_(next_id_.fetch_add(1)) {
+  PADDLE_ENFORCE_NOT_NULL(
+      underlying_allocator_,
+      common::errors::InvalidArgument(
+          "Underlying allocator of ThreadCachedAllocator is NULL"));
+  PADDLE_ENFORCE_EQ(
+      underlying_allocator_->IsAllocThreadSafe(),
+      true,
+      common::errors::InvalidArgument(
+          "Underlying allocator of ThreadCachedAllocator must be thread safe"));
+  VLOG(4) << "ThreadCachedAllocator " << id_
+          << " max_thread_cache_bytes: " << max_thread_cache_bytes_;
+}
+
+ThreadCachedAllocator::~ThreadCachedAllocator() = default;
+
+size_t ThreadCachedAllocator::SizeToClass(size_t size) {
+  if (size <= kSmallSizeMax) {
+    return size == 0 ? 0 : (size - 1) / kSmallAlignment;
+  }
+  // size - 1 lies in [2^lg, 2^(lg+1)), which is split into
+  // kClassesPerPowerOfTwo classes.
+  size_t lg = Log2Floor(size - 1);
+  return kNumSmallClasses + (lg - kSmallSizeMaxLog2) * kClassesPerPowerOfTwo +
+         ((size - 1) >> (lg - kClassesPerPowerOfTwoLog2)) -
+         kClassesPerPowerOfTwo;
+}
+
+size_t ThreadCachedAllocator::ClassToSize(size_t size_class) {
+  if (size_class < kNumSmallClasses) {
+    return (size_class + 1) * kSmallAlignment;
+  }
+  size_t idx = size_class - kNumSmallClasses;
+  size_t lg = kSmallSizeMaxLog2 + idx / kClassesPerPowerOfTwo;
+  return (1UL << lg) + (idx % kClassesPerPowerOfTwo + 1) *
+                           (1UL << (lg - kClassesPerPowerOfTwoLog2));
+}
+
+size_t ThreadCachedAllocator::NumToMove(size_t size_class) {
+  return std::min<size_t>(
+      std::max<size_t>(kBytesToMove / ClassToSize(size_class), 2), 32);
+}
+
+ThreadCachedAllocator::ThreadCache* ThreadCachedAllocator::GetThreadCache() {
+  thread_local std::unordered_map<uint64_t, std::unique_ptr<ThreadCache>>
+      thread_caches;
+  thread_local uint64_t last_id = UINT64_MAX;
+  thread_local ThreadCache* last_cache = nullptr;
+  if (LIKELY(last_id == id_)) {
+    return last_cache;
+  }
+  auto& cache = thread_caches[id_];
+  if (cache == nullptr) {
+    cache = std::make_unique<ThreadCache>(central_cache_,
+                                          max_thread_cache_bytes_);
+  }
+  last_id = id_;
+  last_cache = cache.get();
+  return last_cache;
+}
+
+phi::Allocation* ThreadCachedAllocator::AllocateImpl(size_t size) {
+  if (size > kMaxCachedSize) {
+    return underlying_allocator_->Allocate(size).release();
+  }
+  return GetThreadCache()->Pop(SizeToClass(size));
+}
+
+void ThreadCachedAllocator::FreeImpl(phi::Allocation* allocation) {
+  // Cached allocations are never larger than kMaxCachedSize, while the
+  // underlying allocator never returns less than the requested size.
+  if (allocation->size() > kMaxCachedSize) {
+    underlying_allocator_->Free(allocation);
+    return;
+  }
+  GetThreadCache()->Push(static_cast<ThreadCachedAllocation*>(allocation));
+}
+
+uint64_t ThreadCachedAllocator::ReleaseImpl(const phi::Place& place) {
+  // Caches of other threads can not be touched safely, only the calling
+  // thread and the central free list are drained.
+  GetThreadCache()->ReleaseAll();
+  uint64_t bytes = central_cache_->ReleaseAll();
+  return bytes + underlying_allocator_->Release(place);
+}
+
+}  // namespace paddle::memory::allocation
@@ -0,0 +1,124 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "paddle/phi/core/memory/allocation/allocator.h"
+#include "paddle/phi/core/memory/allocation/spin_lock.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+/**
+ * ThreadCachedAllocator is a tcmalloc-style front-end of a thread-safe pool
+ * allocator (usually AutoGrowthBestFitAllocator on CPU).
+ *
+ * Requests not larger than kMaxCachedSize are rounded up to a size class.
+ * Each thread keeps a free list per size class, so that the hot path of
+ * Allocate/Free does not touch any lock. When a free list becomes too long,
+ * or the bytes cached by a thread exceed the high-water mark, a batch of
+ * allocations is moved to a central free list shared by all threads. The
+ * central free list returns batches to the underlying pool when it
+ * overflows, or when Release() is called.
+ *
+ * Requests larger than kMaxCachedSize go to the underlying allocator
+ * directly.
+ */
+class ThreadCachedAllocator : public Allocator {
+ public:
+  static constexpr size_t kMaxCachedSize = 256UL << 10;
+  static constexpr size_t kSmallAlignment = 16;
+  static constexpr size_t kSmallSizeMax = 1024;
+  static constexpr size_t kNumSmallClasses = kSmallSizeMax / kSmallAlignment;
+  static constexpr size_t kClassesPerPowerOfTwo = 4;
+  // 64 classes of 16 bytes up to 1KB, then 4 classes for each power of two
+  // in (1KB, 256KB].
+  static constexpr size_t kNumSizeClasses =
+      kNumSmallClasses + 8 * kClassesPerPowerOfTwo;
+
+  ThreadCachedAllocator(std::shared_ptr<Allocator> underlying_allocator,
+                        size_t max_thread_cache_bytes);
+
+  ~ThreadCachedAllocator() override;
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  // Map a request size in (0, kMaxCachedSize] to its size class index.
+  static size_t SizeToClass(size_t size);
+
+  // The allocation size of the given size class.
+  static size_t ClassToSize(size_t size_class);
+
+  // Number of allocations moved between a thread cache and the central free
+  // list at once.
+  static size_t NumToMove(size_t size_class);
+
+ protected:
+  phi::Allocation* AllocateImpl(size_t size) override;
+  void FreeImpl(phi::Allocation* allocation) override;
+  uint64_t ReleaseImpl(const phi::Place& place) override;
+
+ private:
+  class ThreadCachedAllocation;
+  class ThreadCache;
+
+  struct CentralFreeList {
+    SpinLock lock;
+    std::vector<ThreadCachedAllocation*> items;
+  };
+
+  // State shared by the allocator and all thread caches. Thread caches hold
+  // it by shared_ptr, so that a thread exiting after the allocator has been
+  // destroyed can still return its cached allocations safely.
+  struct CentralCache {
+    explicit CentralCache(std::shared_ptr<Allocator> underlying_allocator);
+    ~CentralCache();
+
+    // Move up to `num` allocations of `size_class` into `out`, allocating
+    // from the underlying allocator when the central list is empty.
+    void Fetch(size_t size_class,
+               size_t num,
+               std::vector<ThreadCachedAllocation*>* out);
+
+    // Take `num` allocations from the back of `in` into the central list.
+    void Return(size_t size_class,
+                size_t num,
+                std::vector<ThreadCachedAllocation*>* in);
+
+    uint64_t ReleaseAll();
+
+    std::shared_ptr<Allocator> underlying_allocator;
+    CentralFreeList lists[kNumSizeClasses];
+  };
+
+  ThreadCache* GetThreadCache();
+
+  std::shared_ptr<Allocator> underlying_allocator_;
+  std::shared_ptr<CentralCache> central_cache_;
+  size_t max_thread_cache_bytes_;
+  // Identifies this allocator in the thread-local cache registry. Unlike the
+  // address of the allocator, it is never reused.
+  uint64_t id_;
+
+  static std::atomic<uint64_t> next_id_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
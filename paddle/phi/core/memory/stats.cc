@@ -108,6 +108,17 @@ void HostMemoryStatUpdate(const std::string& stat_type,
   StatRegistry::GetInstance()->Update("Host" + stat_type, dev_id, increment);
 }
 
+int64_t HostNumaMemoryStatCurrentValue(const std::string& stat_type,
+                                       int node) {
+  return StatRegistry::GetInstance()->GetCurrentValue("HostNuma" + stat_type,
+                                                      node);
+}
+
+int64_t HostNumaMemoryStatPeakValue(const std::string& stat_type, int node) {
+  return StatRegistry::GetInstance()->GetPeakValue("HostNuma" + stat_type,
+                                                   node);
+}
+
 void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name) {
   if (FLAGS_log_memory_stats && phi::is_gpu_place(place)) {
     VLOG(0) << "After launching op_name: " << op_name << ", "
@@ -160,12 +171,29 @@ void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name) {
   StatRegistry::GetInstance()->Register( \
       "Host" #item, 0, Stat<HostMemoryStat##item##0>::GetInstance());
 
+#define HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, id) \
+  StatRegistry::GetInstance()->Register(                 \
+      "HostNuma" #item, id, Stat<HostNumaMemoryStat##item##id>::GetInstance());
+
+#define HOST_NUMA_MEMORY_STAT_REGISTER(item)       \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 0); \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 1); \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 2); \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 3); \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 4); \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 5); \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 6); \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 7)
+
 int RegisterAllStats() {
   DEVICE_MEMORY_STAT_REGISTER(Allocated);
   DEVICE_MEMORY_STAT_REGISTER(Reserved);
 
   HOST_MEMORY_STAT_REGISTER(Allocated);
   HOST_MEMORY_STAT_REGISTER(Reserved);
+
+  HOST_NUMA_MEMORY_STAT_REGISTER(Allocated);
+  HOST_NUMA_MEMORY_STAT_REGISTER(Reserved);
   return 0;
 }
 
@@ -135,6 +135,10 @@ void HostMemoryStatUpdate(const std::string& stat_type,
                           int dev_id,
                           int64_t increment);
 
+// Host memory stats of each NUMA node, see NumaCPUAllocator.
+int64_t HostNumaMemoryStatCurrentValue(const std::string& stat_type, int node);
+int64_t HostNumaMemoryStatPeakValue(const std::string& stat_type, int node);
+
 void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name);
 
 #define DEVICE_MEMORY_STAT_FUNC_SWITCH_CASE(item, id)               \
@@ -200,6 +204,41 @@ void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name);
 #define HOST_MEMORY_STAT_UPDATE(item, id, increment) \
   HOST_MEMORY_STAT_FUNC(item, id, Update, increment)
 
+#define HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, id)              \
+  case id:                                                            \
+    stat = paddle::memory::Stat<                                      \
+        paddle::memory::HostNumaMemoryStat##item##id>::GetInstance(); \
+    break
+
+#define HOST_NUMA_MEMORY_STAT_FUNC(item, node, func, ...)                 \
+  [&] {                                                                   \
+    paddle::memory::StatBase* stat = nullptr;                             \
+    switch (node) {                                                       \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 0);                    \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 1);                    \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 2);                    \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 3);                    \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 4);                    \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 5);                    \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 6);                    \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 7);                    \
+      default:                                                            \
+        PADDLE_THROW(common::errors::OutOfRange(                          \
+            "Only support NUMA node between [0, 7] for host memory stats," \
+            "not support NUMA node: %d",                                  \
+            node));                                                       \
+        break;                                                            \
+    }                                                                     \
+    return stat->func(__VA_ARGS__);                                       \
+  }()
+
+#define HOST_NUMA_MEMORY_STAT_CURRENT_VALUE(item, node) \
+  HOST_NUMA_MEMORY_STAT_FUNC(item, node, GetCurrentValue)
+#define HOST_NUMA_MEMORY_STAT_PEAK_VALUE(item, node) \
+  HOST_NUMA_MEMORY_STAT_FUNC(item, node, GetPeakValue)
+#define HOST_NUMA_MEMORY_STAT_UPDATE(item, node, increment) \
+  HOST_NUMA_MEMORY_STAT_FUNC(item, node, Update, increment)
+
 #define DEVICE_MEMORY_STAT_DECLARE_WITH_ID(item, id) \
   struct DeviceMemoryStat##item##id : public ThreadLocalStatBase {}
 
@@ -225,6 +264,20 @@ void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name);
 #define HOST_MEMORY_STAT_DECLARE(item) \
   struct HostMemoryStat##item##0 : public ThreadLocalStatBase{};
 
+#define HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, id) \
+  struct HostNumaMemoryStat##item##id : public ThreadLocalStatBase {}
+
+// Only support NUMA node 0 ~ 7 for host NUMA memory stat
+#define HOST_NUMA_MEMORY_STAT_DECLARE(item)       \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 0); \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 1); \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 2); \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 3); \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 4); \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 5); \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 6); \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 7)
+
 // To add a new STAT type, declare here and register in stats.cc
 DEVICE_MEMORY_STAT_DECLARE(Allocated);
 DEVICE_MEMORY_STAT_DECLARE(Reserved);
@@ -232,5 +285,8 @@ DEVICE_MEMORY_STAT_DECLARE(Reserved);
 HOST_MEMORY_STAT_DECLARE(Allocated);
 HOST_MEMORY_STAT_DECLARE(Reserved);
 
+HOST_NUMA_MEMORY_STAT_DECLARE(Allocated);
+HOST_NUMA_MEMORY_STAT_DECLARE(Reserved);
+
 }  // namespace memory
 }  // namespace paddle
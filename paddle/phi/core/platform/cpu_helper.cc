@@ -18,6 +18,8 @@ limitations under the License. */
 #include <omp.h>
 
 #include "paddle/phi/backends/dynload/mklml.h"
+#elif defined(_OPENMP)
+#include <omp.h>
 #endif
 
 #ifdef PADDLE_USE_OPENBLAS
@@ -57,5 +59,22 @@ void SetNumThreads(int num_threads) {
 #endif
 }
 
+int SetThreadLocalNumThreads(int num_threads) {
+  int real_num_threads = num_threads > 1 ? num_threads : 1;
+#if defined(PADDLE_WITH_MKLML)
+  int prev_num_threads = omp_get_max_threads();
+  omp_set_num_threads(real_num_threads);
+  phi::dynload::MKL_Set_Num_Threads_Local(real_num_threads);
+  return prev_num_threads;
+#elif defined(_OPENMP)
+  // OpenBLAS only has a process wide setting, so only OpenMP is set here.
+  int prev_num_threads = omp_get_max_threads();
+  omp_set_num_threads(real_num_threads);
+  return prev_num_threads;
+#else
+  return 1;
+#endif
+}
+
 }  // namespace platform
 }  // namespace paddle
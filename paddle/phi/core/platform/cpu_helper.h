@@ -22,5 +22,9 @@ namespace platform {
 //! Set the number of threads in use.
 void SetNumThreads(int num_threads);
 
+//! Set the number of threads used by OpenMP and MKL in the calling thread
+//! only, and return the previous number.
+int SetThreadLocalNumThreads(int num_threads);
+
 }  // namespace platform
 }  // namespace paddle
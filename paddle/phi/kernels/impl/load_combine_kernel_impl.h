@@ -18,6 +18,7 @@
 #include <string>
 #include <vector>
 
+#include "paddle/common/flags.h"
 #include "paddle/phi/core/extended_tensor.h"
 #include "paddle/phi/core/framework/convert_utils.h"
 #include "paddle/phi/core/framework/data_type_transform.h"
@@ -29,6 +30,8 @@
 #include "paddle/phi/core/tensor_utils.h"
 #include "paddle/phi/core/vocab/string_array.h"
 
+COMMON_DECLARE_bool(enable_mmap_load_params);
+
 namespace phi {
 
 template <typename T, typename Context>
@@ -219,6 +222,13 @@ void LoadCombineKernel(const Context& dev_ctx,
                         "The number of variables to be loaded is %d, expect "
                         "it to be greater than 0.",
                         out_var_names.size()));
+#ifndef _WIN32
+  if (FLAGS_enable_mmap_load_params && !model_from_memory && !load_as_fp16 &&
+      place.GetType() == phi::AllocationType::CPU) {
+    DeserializeFromMappedFile(filename, out);
+    return;
+  }
+#endif
   if (!model_from_memory) {
     std::ifstream fin(filename, std::ios::binary);
     PADDLE_ENFORCE_EQ(
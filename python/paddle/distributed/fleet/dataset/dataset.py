@@ -466,6 +466,7 @@ class InMemoryDataset(DatasetBase):
         self.enable_pv_merge = False
         self.merge_by_lineid = False
         self.fleet_send_sleep_seconds = None
+        self.streaming_shuffle = False
 
     def _init_distributed_settings(
         self, **kwargs: Unpack[_InMemoryDatasetDistributedSettings]
@@ -744,6 +745,10 @@ class InMemoryDataset(DatasetBase):
         self.dataset.dynamic_adjust_readers_num(thread_num)
 
     def _dynamic_adjust_after_train(self):
+        if self.streaming_shuffle:
+            # all the shuffled data has been trained
+            self.dataset.wait_streaming_global_shuffle_done()
+            self.streaming_shuffle = False
         if not self.is_user_set_queue_num:
             if self.use_ps_gpu:
                 self.dataset.dynamic_adjust_channel_num(self.thread_num, True)
@@ -1165,6 +1170,81 @@ class InMemoryDataset(DatasetBase):
         if fleet is not None:
             fleet._role_maker.barrier_worker()
 
+    def streaming_global_shuffle(
+        self, fleet: Fleet | None = None, thread_num: int = 12
+    ) -> None:
+        """
+        :api_attr: Static Graph
+
+        Load data into memory and global shuffle it in a stream.
+        The data of each file is sent to the other trainers as soon as it is
+        parsed, and train_from_dataset can be called right after this
+        function to train the shuffled data while the rest is still being
+        sent. It replaces load_into_memory and global_shuffle, and the data
+        stays in memory for the later epochs after the first one is trained.
+        The first epoch has to be trained with the thread num of the dataset,
+        which reads each output queue by a thread.
+
+        Examples:
+            .. code-block:: python
+
+                >>> # doctest: +SKIP('No files to read')
+                >>> import paddle
+                >>> paddle.enable_static()
+
+                >>> dataset = paddle.distributed.InMemoryDataset()
+                >>> slots = ["slot1", "slot2", "slot3", "slot4"]
+                >>> slots_vars = []
+                >>> for slot in slots:
+                ...     var = paddle.static.data(
+                ...         name=slot, shape=[None, 1], dtype="int64", lod_level=1)
+                ...     slots_vars.append(var)
+                >>> dataset.init(
+                ...     batch_size=1,
+                ...     thread_num=2,
+                ...     input_type=1,
+                ...     pipe_command="cat",
+                ...     use_var=slots_vars)
+                >>> filelist = ["a.txt", "b.txt"]
+                >>> dataset.set_filelist(filelist)
+                >>> dataset.streaming_global_shuffle()
+                >>> exe = paddle.static.Executor(paddle.CPUPlace())
+                >>> startup_program = paddle.static.Program()
+                >>> main_program = paddle.static.Program()
+                >>> exe.run(startup_program)
+                >>> exe.train_from_dataset(main_program, dataset)
+
+        Args:
+            fleet(Fleet): fleet singleton. Default None.
+            thread_num(int): shuffle thread num. Default is 12.
+
+        """
+        if self.merge_by_lineid:
+            raise ValueError(
+                "merge_by_lineid is not supported by streaming_global_shuffle"
+            )
+        if self.use_ps_gpu:
+            raise ValueError(
+                "streaming_global_shuffle is not supported with use_ps_gpu"
+            )
+        self._prepare_to_run()
+        trainer_num = 1
+        if fleet is not None:
+            fleet._role_maker.barrier_worker()
+            trainer_num = fleet.worker_num()
+        if self.fleet_send_batch_size is None:
+            self.fleet_send_batch_size = 1024
+        if self.fleet_send_sleep_seconds is None:
+            self.fleet_send_sleep_seconds = 0
+        self.dataset.register_client2client_msg_handler()
+        self.dataset.set_trainer_num(trainer_num)
+        self.dataset.set_fleet_send_batch_size(self.fleet_send_batch_size)
+        self.dataset.set_fleet_send_sleep_seconds(self.fleet_send_sleep_seconds)
+        if fleet is not None:
+            fleet._role_maker.barrier_worker()
+        self.dataset.streaming_global_shuffle(thread_num)
+        self.streaming_shuffle = True
+
     def release_memory(self) -> None:
         """
         :api_attr: Static Graph
@@ -1203,6 +1283,9 @@ class InMemoryDataset(DatasetBase):
                 >>> dataset.release_memory()
 
         """
+        if self.streaming_shuffle:
+            self.dataset.wait_streaming_global_shuffle_done()
+            self.streaming_shuffle = False
         self.dataset.release_memory()
 
     def get_memory_data_size(self, fleet: Fleet | None = None) -> int:
@@ -15,6 +15,7 @@
 #include "paddle/fluid/framework/data_feed.h"
 
 #include <fcntl.h>
+#include <sys/stat.h>
 
 #include <chrono>  // NOLINT
 #include <fstream>
@@ -22,6 +23,8 @@
 #include <map>
 #include <mutex>  // NOLINT
 #include <set>
+#include <sstream>
+#include <string>
 #include <thread>  // NOLINT
 #include <utility>
 #include <vector>
@@ -29,10 +32,14 @@
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 #include "google/protobuf/text_format.h"
 #include "gtest/gtest.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/data_feed_factory.h"
+#include "paddle/fluid/framework/io/fs.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/scope.h"
 
+COMMON_DECLARE_string(dataset_record_cache_dir);
+
 paddle::framework::DataFeedDesc load_datafeed_param_from_file(
     const char* filename) {
   paddle::framework::DataFeedDesc data_feed_desc;
@@ -209,18 +216,18 @@ void GetElemSetFromReader(std::vector<MultiTypeSet>* reader_elem_set,
           } else {  // sparse branch
             if (slot.type() == "uint64") {
               const int64_t* data = tens->data<int64_t>();
-              for (size_t i = 0; i < tens->NumElements(); ++i) {
-                std::pair<size_t, size_t> element = tens->lod_element(0, i);
-                for (size_t j = element.first; j < element.second; ++j) {
+              const auto& lod = tens->lod()[0];
+              for (size_t i = 0; i + 1 < lod.size(); ++i) {
+                for (size_t j = lod[i]; j < lod[i + 1]; ++j) {
                   std::lock_guard<std::mutex> lock(mu);
                   (*reader_elem_set)[index].AddValue((uint64_t)data[j]);
                 }
               }
             } else if (slot.type() == "float") {
               const float* data = tens->data<float>();
-              for (size_t i = 0; i < tens->NumElements(); ++i) {
-                std::pair<size_t, size_t> element = tens->lod_element(0, i);
-                for (size_t j = element.first; j < element.second; ++j) {
+              const auto& lod = tens->lod()[0];
+              for (size_t i = 0; i + 1 < lod.size(); ++i) {
+                for (size_t j = lod[i]; j < lod[i + 1]; ++j) {
                   std::lock_guard<std::mutex> lock(mu);
                   (*reader_elem_set)[index].AddValue(data[j]);
                 }
@@ -344,3 +351,332 @@ TEST(DataFeed, MultiSlotUnitTest) {
   // GetElemSetFromFile(&file_elem_set, data_feed_desc, filelist);
   // CheckIsUnorderedSame(reader_elem_set, file_elem_set);
 }
+
+const char* kRecordCacheDir = "./TestRecordFileCache";
+
+paddle::framework::DataFeedDesc GetRecordCacheDataFeedDesc(
+    const std::string& name) {
+  paddle::framework::DataFeedDesc data_feed_desc;
+  google::protobuf::TextFormat::ParseFromString(
+      "batch_size: 2\n"
+      "pipe_command: \"cat\"\n"
+      "multi_slot_desc {\n"
+      "    slots {\n"
+      "        name: \"uint64_sparse_slot\"\n"
+      "        type: \"uint64\"\n"
+      "        is_dense: false\n"
+      "        is_used: true\n"
+      "    }\n"
+      "    slots {\n"
+      "        name: \"float_sparse_slot\"\n"
+      "        type: \"float\"\n"
+      "        is_dense: false\n"
+      "        is_used: true\n"
+      "    }\n"
+      "    slots {\n"
+      "        name: \"not_used_slot\"\n"
+      "        type: \"uint64\"\n"
+      "        is_dense: false\n"
+      "        is_used: false\n"
+      "    }\n"
+      "}",
+      &data_feed_desc);
+  data_feed_desc.set_name(name);
+  return data_feed_desc;
+}
+
+// The files written with the bases of the same number of digits have the
+// same size.
+void GenerateRecordCacheFile(const std::string& filename, int base) {
+  std::ofstream w_datafile(filename.c_str());
+  for (int i = 0; i < 3; ++i) {
+    w_datafile << "2 " << base + i << " " << base + 10 + i << " 1 " << i
+               << ".5 1 " << base + 20 + i << "\n";
+  }
+  w_datafile.close();
+}
+
+struct timespec GetFileMtime(const std::string& filename) {
+  struct stat st;
+  PADDLE_ENFORCE_EQ(
+      stat(filename.c_str(), &st),
+      0,
+      common::errors::Unavailable("Cannot stat file %s.", filename));
+  return st.st_mtim;
+}
+
+void SetFileMtime(const std::string& filename, const struct timespec& mtime) {
+  struct timespec times[2] = {mtime, mtime};
+  PADDLE_ENFORCE_EQ(
+      utimensat(AT_FDCWD, filename.c_str(), times, 0),
+      0,
+      common::errors::Unavailable("Cannot set the mtime of file %s.",
+                                  filename));
+}
+
+std::string RecordToString(const paddle::framework::Record& record) {
+  std::ostringstream os;
+  os << record.ins_id_ << ";";
+  for (auto& item : record.uint64_feasigns_) {
+    os << " " << item.slot() << ":" << item.sign().uint64_feasign_;
+  }
+  os << ";";
+  for (auto& item : record.float_feasigns_) {
+    os << " " << item.slot() << ":" << item.sign().float_feasign_;
+  }
+  return os.str();
+}
+
+std::string RecordToString(const paddle::framework::SlotRecord& record) {
+  std::ostringstream os;
+  os << record->ins_id_ << ";";
+  for (auto value : record->slot_uint64_feasigns_.slot_values) {
+    os << " " << value;
+  }
+  for (auto offset : record->slot_uint64_feasigns_.slot_offsets) {
+    os << " @" << offset;
+  }
+  os << ";";
+  for (auto value : record->slot_float_feasigns_.slot_values) {
+    os << " " << value;
+  }
+  for (auto offset : record->slot_float_feasigns_.slot_offsets) {
+    os << " @" << offset;
+  }
+  return os.str();
+}
+
+void ReleaseRecords(std::vector<paddle::framework::Record>* records UNUSED) {}
+
+void ReleaseRecords(std::vector<paddle::framework::SlotRecord>* records) {
+  paddle::framework::SlotRecordPool().put(records);
+}
+
+// Load the records of the files into memory with the record cache in
+// cache_dir, or without the record cache if cache_dir is empty.
+template <typename T>
+std::vector<std::string> LoadRecordStrings(
+    const paddle::framework::DataFeedDesc& data_feed_desc,
+    const std::vector<std::string>& filelist,
+    const std::string& cache_dir) {
+  FLAGS_dataset_record_cache_dir = cache_dir;
+  std::shared_ptr<paddle::framework::DataFeed> reader =
+      paddle::framework::DataFeedFactory::CreateDataFeed(data_feed_desc.name());
+  reader->Init(data_feed_desc);
+  std::mutex file_mutex;
+  size_t file_idx = 0;
+  std::mutex fea_num_mutex;
+  uint64_t fea_num = 0;
+  auto channel = paddle::framework::MakeChannel<T>();
+  reader->SetFileListMutex(&file_mutex);
+  reader->SetFileListIndex(&file_idx);
+  reader->SetFeaNumMutex(&fea_num_mutex);
+  reader->SetFeaNum(&fea_num);
+  reader->SetThreadId(0);
+  reader->SetInputChannel(channel.get());
+  reader->SetFileList(filelist);
+  reader->LoadIntoMemory();
+  channel->Close();
+  std::vector<T> records;
+  channel->ReadAll(records);
+  std::vector<std::string> record_strs;
+  for (auto& record : records) {
+    record_strs.push_back(RecordToString(record));
+  }
+  ReleaseRecords(&records);
+  return record_strs;
+}
+
+template <typename T>
+void TestRecordFileCacheRoundTrip(const std::string& name) {
+  paddle::framework::localfs_remove(kRecordCacheDir);
+  paddle::framework::DataFeedDesc data_feed_desc =
+      GetRecordCacheDataFeedDesc(name);
+  const std::string filename = "TestRecordFileCache.data." + name;
+  const std::vector<std::string> filelist = {filename};
+
+  // the records parsed without the record cache
+  std::map<int, std::vector<std::string>> parsed;
+  for (int base : {100, 200, 300, 1000, 2000}) {
+    GenerateRecordCacheFile(filename, base);
+    parsed[base] = LoadRecordStrings<T>(data_feed_desc, filelist, "");
+    ASSERT_EQ(parsed[base].size(), 3UL);
+  }
+  ASSERT_NE(parsed[100], parsed[200]);
+  ASSERT_NE(parsed[1000], parsed[2000]);
+
+  // the first load parses the file and commits the cache
+  GenerateRecordCacheFile(filename, 100);
+  struct timespec mtime = GetFileMtime(filename);
+  EXPECT_EQ(LoadRecordStrings<T>(data_feed_desc, filelist, kRecordCacheDir),
+            parsed[100]);
+  std::vector<std::string> cache_files =
+      paddle::framework::localfs_list(kRecordCacheDir);
+  ASSERT_EQ(cache_files.size(), 1UL);
+  EXPECT_EQ(cache_files[0].find(".tmp."), std::string::npos);
+
+  // the content is changed with the same size and mtime, so the records
+  // loaded from the cache are still the ones parsed from the old content
+  GenerateRecordCacheFile(filename, 200);
+  SetFileMtime(filename, mtime);
+  EXPECT_EQ(LoadRecordStrings<T>(data_feed_desc, filelist, kRecordCacheDir),
+            parsed[100]);
+  // the batch size is not a part of the signature
+  paddle::framework::DataFeedDesc batch_size_desc = data_feed_desc;
+  batch_size_desc.set_batch_size(4);
+  EXPECT_EQ(LoadRecordStrings<T>(batch_size_desc, filelist, kRecordCacheDir),
+            parsed[100]);
+
+  // the mtime is changed, the file is parsed again and the cache is rewritten
+  mtime.tv_sec += 1;
+  SetFileMtime(filename, mtime);
+  EXPECT_EQ(LoadRecordStrings<T>(data_feed_desc, filelist, kRecordCacheDir),
+            parsed[200]);
+  GenerateRecordCacheFile(filename, 300);
+  SetFileMtime(filename, mtime);
+  EXPECT_EQ(LoadRecordStrings<T>(data_feed_desc, filelist, kRecordCacheDir),
+            parsed[200]);
+
+  // the size is changed
+  GenerateRecordCacheFile(filename, 1000);
+  SetFileMtime(filename, mtime);
+  EXPECT_EQ(LoadRecordStrings<T>(data_feed_desc, filelist, kRecordCacheDir),
+            parsed[1000]);
+
+  // the signature is changed by the pipe command, the cache of the old
+  // signature is not used
+  GenerateRecordCacheFile(filename, 2000);
+  SetFileMtime(filename, mtime);
+  paddle::framework::DataFeedDesc pipe_command_desc = data_feed_desc;
+  pipe_command_desc.set_pipe_command("cat | cat");
+  EXPECT_EQ(
+      LoadRecordStrings<T>(pipe_command_desc, filelist, kRecordCacheDir),
+      parsed[2000]);
+  EXPECT_EQ(LoadRecordStrings<T>(data_feed_desc, filelist, kRecordCacheDir),
+            parsed[1000]);
+  cache_files = paddle::framework::localfs_list(kRecordCacheDir);
+  EXPECT_EQ(cache_files.size(), 2UL);
+  FLAGS_dataset_record_cache_dir = "";
+}
+
+template <typename T>
+void TestRecordFileCacheParseFailure(const std::string& name) {
+  paddle::framework::localfs_remove(kRecordCacheDir);
+  paddle::framework::DataFeedDesc data_feed_desc =
+      GetRecordCacheDataFeedDesc(name);
+  const std::string filename = "TestRecordFileCache.broken." + name;
+  std::ofstream w_datafile(filename.c_str());
+  w_datafile << "1 100 1 0.5 1 120\n"
+                "0 1 1.5 1 121\n"
+                "1 102 1 2.5 1 122\n";
+  w_datafile.close();
+  EXPECT_ANY_THROW(LoadRecordStrings<T>(data_feed_desc, {filename},
+                                        kRecordCacheDir));
+  EXPECT_TRUE(paddle::framework::localfs_list(kRecordCacheDir).empty());
+  FLAGS_dataset_record_cache_dir = "";
+}
+
+TEST(RecordFileCache, RecordRoundTrip) {
+  TestRecordFileCacheRoundTrip<paddle::framework::Record>(
+      "MultiSlotInMemoryDataFeed");
+}
+
+TEST(RecordFileCache, SlotRecordRoundTrip) {
+  TestRecordFileCacheRoundTrip<paddle::framework::SlotRecord>(
+      "SlotRecordInMemoryDataFeed");
+}
+
+TEST(RecordFileCache, RecordParseFailure) {
+  TestRecordFileCacheParseFailure<paddle::framework::Record>(
+      "MultiSlotInMemoryDataFeed");
+}
+
+TEST(RecordFileCache, SlotRecordParseFailure) {
+  TestRecordFileCacheParseFailure<paddle::framework::SlotRecord>(
+      "SlotRecordInMemoryDataFeed");
+
+  // the lines not parsed into a SlotRecord drop the cache as well, a record
+  // without the uint64 feasigns is not valid
+  paddle::framework::localfs_remove(kRecordCacheDir);
+  paddle::framework::DataFeedDesc data_feed_desc;
+  google::protobuf::TextFormat::ParseFromString(
+      "name: \"SlotRecordInMemoryDataFeed\"\n"
+      "batch_size: 2\n"
+      "pipe_command: \"cat\"\n"
+      "multi_slot_desc {\n"
+      "    slots {\n"
+      "        name: \"float_sparse_slot\"\n"
+      "        type: \"float\"\n"
+      "        is_dense: false\n"
+      "        is_used: true\n"
+      "    }\n"
+      "}",
+      &data_feed_desc);
+  const std::string filename = "TestRecordFileCache.float.data";
+  std::ofstream w_datafile(filename.c_str());
+  w_datafile << "1 0.5\n1 1.5\n";
+  w_datafile.close();
+  EXPECT_TRUE(LoadRecordStrings<paddle::framework::SlotRecord>(
+                  data_feed_desc, {filename}, kRecordCacheDir)
+                  .empty());
+  EXPECT_TRUE(paddle::framework::localfs_list(kRecordCacheDir).empty());
+  FLAGS_dataset_record_cache_dir = "";
+}
+
+// The unused slot with several feasigns in the middle of the lines is
+// skipped, and the slots after it are parsed.
+template <typename T>
+std::vector<std::string> LoadUnusedSlotRecordStrings(const std::string& name) {
+  paddle::framework::DataFeedDesc data_feed_desc;
+  google::protobuf::TextFormat::ParseFromString(
+      "batch_size: 2\n"
+      "pipe_command: \"cat\"\n"
+      "multi_slot_desc {\n"
+      "    slots {\n"
+      "        name: \"uint64_sparse_slot\"\n"
+      "        type: \"uint64\"\n"
+      "        is_dense: false\n"
+      "        is_used: true\n"
+      "    }\n"
+      "    slots {\n"
+      "        name: \"not_used_slot\"\n"
+      "        type: \"uint64\"\n"
+      "        is_dense: false\n"
+      "        is_used: false\n"
+      "    }\n"
+      "    slots {\n"
+      "        name: \"float_sparse_slot\"\n"
+      "        type: \"float\"\n"
+      "        is_dense: false\n"
+      "        is_used: true\n"
+      "    }\n"
+      "    slots {\n"
+      "        name: \"uint64_sparse_slot2\"\n"
+      "        type: \"uint64\"\n"
+      "        is_dense: false\n"
+      "        is_used: true\n"
+      "    }\n"
+      "}",
+      &data_feed_desc);
+  data_feed_desc.set_name(name);
+  const std::string filename = "TestUnusedSlot.data." + name;
+  std::ofstream w_datafile(filename.c_str());
+  w_datafile << "2 11 12 3 901 902 903 2 1.5 2.25 1 21\n"
+                "1 13 2 904 905 1 3.5 2 22 23\n";
+  w_datafile.close();
+  return LoadRecordStrings<T>(data_feed_desc, {filename}, "");
+}
+
+TEST(DataFeed, MultiSlotSkipUnusedSlot) {
+  EXPECT_EQ(LoadUnusedSlotRecordStrings<paddle::framework::Record>(
+                "MultiSlotInMemoryDataFeed"),
+            (std::vector<std::string>{"; 0:11 0:12 2:21; 1:1.5 1:2.25",
+                                      "; 0:13 2:22 2:23; 1:3.5"}));
+}
+
+TEST(DataFeed, SlotRecordSkipUnusedSlot) {
+  EXPECT_EQ(LoadUnusedSlotRecordStrings<paddle::framework::SlotRecord>(
+                "SlotRecordInMemoryDataFeed"),
+            (std::vector<std::string>{"; 11 12 21 @0 @2 @3; 1.5 2.25 @0 @2",
+                                      "; 13 22 23 @0 @1 @3; 3.5 @0 @1"}));
+}
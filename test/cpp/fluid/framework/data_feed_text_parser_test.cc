@@ -0,0 +1,282 @@
+/* Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/data_feed_text_parser.h"
+
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace framework {
+
+static void CheckUint64(const std::string& text) {
+  const char* str = text.c_str();
+  char* expected_end = nullptr;
+  uint64_t expected = strtoull(str, &expected_end, 10);
+  uint64_t value = 0;
+  const char* end = ParseDataFeedUint64(str, str + text.size(), &value);
+  ASSERT_EQ(value, expected) << text;
+  ASSERT_EQ(end, expected_end) << text;
+}
+
+static void CheckInt(const std::string& text) {
+  const char* str = text.c_str();
+  char* expected_end = nullptr;
+  int expected = static_cast<int>(strtol(str, &expected_end, 10));
+  int value = 0;
+  const char* end = ParseDataFeedInt(str, str + text.size(), &value);
+  ASSERT_EQ(value, expected) << text;
+  ASSERT_EQ(end, expected_end) << text;
+}
+
+static void CheckFloat(const std::string& text) {
+  const char* str = text.c_str();
+  char* expected_end = nullptr;
+  float expected = strtof(str, &expected_end);
+  float value = 0;
+  const char* end = ParseDataFeedFloat(str, str + text.size(), &value);
+  if (std::isnan(expected)) {
+    ASSERT_TRUE(std::isnan(value)) << text;
+  } else {
+    // the same bits, including the sign of zeros
+    ASSERT_EQ(memcmp(&value, &expected, sizeof(float)), 0)
+        << text << " " << value << " " << expected;
+  }
+  ASSERT_EQ(end, expected_end) << text;
+}
+
+TEST(DataFeedTextParser, Uint64) {
+  for (auto text : {"0",
+                    "1",
+                    " 42 ",
+                    "12345678",
+                    "123456789",
+                    "1234567890123456",
+                    "12345678901234567",
+                    "18446744073709551615",
+                    "18446744073709551616",
+                    "99999999999999999999999",
+                    "0000000000000000000000001",
+                    "-1",
+                    "+7",
+                    "",
+                    " ",
+                    "abc",
+                    "12ab",
+                    "1234567a9"}) {
+    CheckUint64(text);
+  }
+  std::mt19937_64 rng(0);
+  for (int i = 0; i < 100000; ++i) {
+    uint64_t value = rng() >> (rng() % 64);
+    CheckUint64(std::to_string(value) + " 1");
+  }
+}
+
+TEST(DataFeedTextParser, Int) {
+  for (auto text : {"0",
+                    "3",
+                    " 15 1",
+                    "123456789",
+                    "1234567890",
+                    "99999999999",
+                    "-1",
+                    "+2",
+                    "",
+                    "x"}) {
+    CheckInt(text);
+  }
+}
+
+TEST(DataFeedTextParser, Float) {
+  for (auto text : {"0",
+                    "-0",
+                    "0.0",
+                    "-0.000",
+                    "1",
+                    "1.",
+                    ".5",
+                    "-.25",
+                    "+3.5",
+                    "0.1",
+                    "0.123456",
+                    "1234567",
+                    "12345678",
+                    "0.00000000001",
+                    "0.000000000012345",
+                    "3.4028235e38",
+                    "1e-3",
+                    "1E5",
+                    "0x1p3",
+                    "inf",
+                    "-nan",
+                    "",
+                    ".",
+                    "-",
+                    "abc",
+                    "1.5f",
+                    "1.2.3",
+                    " 2.5 3"}) {
+    CheckFloat(text);
+  }
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<double> dist(-1000, 1000);
+  char buf[64];
+  for (int i = 0; i < 100000; ++i) {
+    double value = dist(rng) * std::pow(10.0, static_cast<int>(rng() % 8) - 6);
+    snprintf(buf, sizeof(buf), "%.*f", static_cast<int>(rng() % 12), value);
+    CheckFloat(buf);
+    snprintf(buf, sizeof(buf), "%g", value);
+    CheckFloat(buf);
+  }
+}
+
+TEST(DataFeedTextParser, SkipTokens) {
+  std::mt19937 rng(0);
+  for (int i = 0; i < 10000; ++i) {
+    std::string text;
+    std::vector<size_t> token_ends;
+    int token_num = rng() % 40;
+    for (int j = 0; j < token_num; ++j) {
+      text.append(1 + rng() % 2, ' ');
+      text.append(1 + rng() % 20, 'a' + j % 26);
+      token_ends.push_back(text.size());
+    }
+    text.append(rng() % 3, ' ');
+    const char* str = text.c_str();
+    for (int num = 1; num <= token_num; ++num) {
+      ASSERT_EQ(SkipDataFeedTokens(str, str + text.size(), num) - str,
+                token_ends[num - 1])
+          << text << " " << num;
+    }
+    ASSERT_EQ(SkipDataFeedTokens(str, str + text.size(), 0), str);
+  }
+}
+
+// Generate the lines of CTR samples: the label, and the uint64 feasigns of
+// the sparse slots and the float values of the dense slots.
+static std::vector<std::string> GenerateCtrLines(int line_num) {
+  std::mt19937_64 rng(0);
+  std::vector<std::string> lines;
+  for (int i = 0; i < line_num; ++i) {
+    std::string line = "1 " + std::to_string(rng() % 2);
+    for (int slot = 0; slot < 400; ++slot) {
+      int num = 1 + rng() % 4;
+      line += " " + std::to_string(num);
+      for (int j = 0; j < num; ++j) {
+        line += " " + std::to_string(rng() >> (rng() % 20));
+      }
+    }
+    char buf[32];
+    for (int slot = 0; slot < 20; ++slot) {
+      line += " 1";
+      snprintf(buf, sizeof(buf), " %.6f", (rng() % 1000000) / 1e6);
+      line += buf;
+    }
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+template <typename ParseInt, typename ParseUint64, typename ParseFloat>
+static double ParseCtrLines(const std::vector<std::string>& lines,
+                            ParseInt parse_int,
+                            ParseUint64 parse_uint64,
+                            ParseFloat parse_float,
+                            uint64_t* checksum) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<uint64_t> uint64_feasigns;
+  std::vector<float> float_feasigns;
+  for (auto& line : lines) {
+    const char* str = line.c_str();
+    const char* end = str + line.size();
+    uint64_feasigns.clear();
+    float_feasigns.clear();
+    int num = 0;
+    for (int slot = 0; slot < 421; ++slot) {
+      str = parse_int(str, end, &num);
+      for (int j = 0; j < num; ++j) {
+        if (slot < 401) {
+          uint64_t feasign = 0;
+          str = parse_uint64(str, end, &feasign);
+          uint64_feasigns.push_back(feasign);
+        } else {
+          float feasign = 0;
+          str = parse_float(str, end, &feasign);
+          float_feasigns.push_back(feasign);
+        }
+      }
+    }
+    for (auto feasign : uint64_feasigns) {
+      *checksum += feasign;
+    }
+    for (auto feasign : float_feasigns) {
+      *checksum += static_cast<uint64_t>(feasign * 1e6);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+// The benchmark is disabled by default, run it with
+// --gtest_also_run_disabled_tests.
+TEST(DataFeedTextParser, DISABLED_ParseThroughputBenchmark) {
+  auto lines = GenerateCtrLines(2000);
+  size_t bytes = 0;
+  for (auto& line : lines) {
+    bytes += line.size();
+  }
+
+  uint64_t strto_checksum = 0;
+  double strto_sec = ParseCtrLines(
+      lines,
+      [](const char* str, const char*, int* value) -> const char* {
+        char* endptr = nullptr;
+        *value = static_cast<int>(strtol(str, &endptr, 10));
+        return endptr;
+      },
+      [](const char* str, const char*, uint64_t* value) -> const char* {
+        char* endptr = nullptr;
+        *value = strtoull(str, &endptr, 10);
+        return endptr;
+      },
+      [](const char* str, const char*, float* value) -> const char* {
+        char* endptr = nullptr;
+        *value = strtof(str, &endptr);
+        return endptr;
+      },
+      &strto_checksum);
+
+  uint64_t fast_checksum = 0;
+  double fast_sec = ParseCtrLines(lines,
+                                  ParseDataFeedInt,
+                                  ParseDataFeedUint64,
+                                  ParseDataFeedFloat,
+                                  &fast_checksum);
+  ASSERT_EQ(fast_checksum, strto_checksum);
+
+  std::cout << "lines: " << lines.size() << ", bytes: " << bytes
+            << ", strto*: " << bytes / strto_sec / (1 << 20)
+            << " MB/s, DataFeedTextParser: " << bytes / fast_sec / (1 << 20)
+            << " MB/s" << std::endl;
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,159 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/data_set.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/framework/dataset_factory.h"
+#include "paddle/fluid/framework/lod_tensor.h"
+#include "paddle/fluid/framework/scope.h"
+
+COMMON_DECLARE_bool(enable_dataset_column_store);
+
+namespace paddle {
+namespace framework {
+
+static const char* kDataFeedDesc =
+    "name: \"MultiSlotInMemoryDataFeed\"\n"
+    "batch_size: 4\n"
+    "multi_slot_desc {\n"
+    "  slots {\n"
+    "    name: \"uint64_slot\"\n"
+    "    type: \"uint64\"\n"
+    "    is_dense: false\n"
+    "    is_used: true\n"
+    "  }\n"
+    "  slots {\n"
+    "    name: \"float_slot\"\n"
+    "    type: \"float\"\n"
+    "    is_dense: false\n"
+    "    is_used: true\n"
+    "  }\n"
+    "  slots {\n"
+    "    name: \"not_used_slot\"\n"
+    "    type: \"uint64\"\n"
+    "    is_dense: false\n"
+    "    is_used: false\n"
+    "  }\n"
+    "}";
+
+static const int kFileNum = 2;
+static const int kInsNumPerFile = 21;
+
+// The i-th instance has the uint64 feasigns 1000 + i and 2000 + i, and the
+// float feasign i / 2.
+static std::vector<std::string> GenerateFiles() {
+  std::vector<std::string> filelist;
+  for (int f = 0; f < kFileNum; ++f) {
+    std::string filename = "TestMultiSlotDataset.data." + std::to_string(f);
+    std::ofstream fout(filename);
+    for (int j = 0; j < kInsNumPerFile; ++j) {
+      int i = f * kInsNumPerFile + j;
+      fout << "2 " << 1000 + i << " " << 2000 + i << " 1 " << i / 2.0
+           << " 1 " << 3000 + i << "\n";
+    }
+    filelist.push_back(filename);
+  }
+  return filelist;
+}
+
+// Read all batches of the readers of the dataset, return the uint64
+// feasigns and the float feasigns of all instances.
+static void ReadAll(Dataset* dataset,
+                    std::vector<uint64_t>* uint64_feasigns,
+                    std::vector<float>* float_feasigns) {
+  uint64_feasigns->clear();
+  float_feasigns->clear();
+  dataset->CreateReaders();
+  for (auto* reader : dataset->GetReaders()) {
+    Scope scope;
+    reader->AddFeedVar(scope.Var("uint64_slot"), "uint64_slot");
+    reader->AddFeedVar(scope.Var("float_slot"), "float_slot");
+    reader->Start();
+    int batch_size = 0;
+    while ((batch_size = reader->Next()) != 0) {
+      ASSERT_LE(batch_size, 4);
+      const auto& uint64_tensor =
+          scope.FindVar("uint64_slot")->Get<phi::DenseTensor>();
+      const auto& float_tensor =
+          scope.FindVar("float_slot")->Get<phi::DenseTensor>();
+      ASSERT_EQ(uint64_tensor.lod()[0].size(),
+                static_cast<size_t>(batch_size + 1));
+      ASSERT_EQ(float_tensor.lod()[0].size(),
+                static_cast<size_t>(batch_size + 1));
+      const int64_t* uint64_data = uint64_tensor.data<int64_t>();
+      for (size_t k = 0; k < uint64_tensor.lod()[0].back(); ++k) {
+        uint64_feasigns->push_back(static_cast<uint64_t>(uint64_data[k]));
+      }
+      const float* float_data = float_tensor.data<float>();
+      for (size_t k = 0; k < float_tensor.lod()[0].back(); ++k) {
+        float_feasigns->push_back(float_data[k]);
+      }
+    }
+  }
+  dataset->DestroyReaders();
+  std::sort(uint64_feasigns->begin(), uint64_feasigns->end());
+  std::sort(float_feasigns->begin(), float_feasigns->end());
+}
+
+TEST(MultiSlotDataset, LocalShuffleToColumnStore) {
+  FLAGS_enable_dataset_column_store = true;
+  auto dataset = DatasetFactory::CreateDataset("MultiSlotDataset");
+  dataset->SetFileList(GenerateFiles());
+  dataset->SetThreadNum(2);
+  dataset->SetDataFeedDesc(kDataFeedDesc);
+  dataset->CreateChannel();
+  dataset->CreateReaders();
+  dataset->LoadIntoMemory();
+  dataset->LocalShuffle();
+  const int ins_num = kFileNum * kInsNumPerFile;
+  ASSERT_EQ(dataset->GetMemoryDataSize(), ins_num);
+
+  std::vector<uint64_t> expected_uint64;
+  std::vector<float> expected_float;
+  for (int i = 0; i < ins_num; ++i) {
+    expected_uint64.push_back(1000 + i);
+    expected_uint64.push_back(2000 + i);
+    expected_float.push_back(i / 2.0f);
+  }
+  std::sort(expected_uint64.begin(), expected_uint64.end());
+  std::sort(expected_float.begin(), expected_float.end());
+
+  // the readers of each pass read all instances from the column store once
+  std::vector<uint64_t> uint64_feasigns;
+  std::vector<float> float_feasigns;
+  for (int pass = 0; pass < 2; ++pass) {
+    ReadAll(dataset.get(), &uint64_feasigns, &float_feasigns);
+    ASSERT_EQ(uint64_feasigns, expected_uint64);
+    ASSERT_EQ(float_feasigns, expected_float);
+  }
+
+  // the instances are read from the channels after the flag is off
+  FLAGS_enable_dataset_column_store = false;
+  dataset->LocalShuffle();
+  ASSERT_EQ(dataset->GetMemoryDataSize(), ins_num);
+  ReadAll(dataset.get(), &uint64_feasigns, &float_feasigns);
+  ASSERT_EQ(uint64_feasigns, expected_uint64);
+  ASSERT_EQ(float_feasigns, expected_float);
+}
+
+}  // namespace framework
+}  // namespace paddle
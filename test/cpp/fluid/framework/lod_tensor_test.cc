@@ -17,8 +17,15 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/framework/lod_tensor_serialize.h"
 #include "paddle/phi/core/lod_utils.h"
 
+COMMON_DECLARE_bool(enable_aligned_save_params);
+
 namespace paddle {
 namespace framework {
 
@@ -133,5 +140,53 @@ TEST(LoD, ConvertToOffsetBasedLoD) {
   EXPECT_EQ(offset_lod, expected);
 }
 
+#ifndef _WIN32
+TEST(LoD, DeserializeFromMappedFile) {
+  phi::CPUContext ctx;
+  phi::DenseTensor small, large;
+  small.Resize({3});
+  small.mutable_data<int64_t>(phi::CPUPlace());
+  for (int i = 0; i < 3; ++i) {
+    small.data<int64_t>()[i] = i;
+  }
+  small.set_lod({{0, 1, 3}});
+  large.Resize({64, 32});
+  large.mutable_data<float>(phi::CPUPlace());
+  for (int i = 0; i < large.numel(); ++i) {
+    large.data<float>()[i] = static_cast<float>(i) * 0.5f;
+  }
+
+  const std::string path = "lod_tensor_test_mapped.pdiparams";
+  FLAGS_enable_aligned_save_params = true;
+  {
+    std::ofstream fout(path, std::ios::binary);
+    SerializeToStream(fout, small, ctx);
+    SerializeToStream(fout, large, ctx);
+  }
+  FLAGS_enable_aligned_save_params = false;
+
+  phi::DenseTensor loaded_small, loaded_large;
+  phi::DeserializeFromMappedFile(path, {&loaded_small, &loaded_large});
+  std::remove(path.c_str());
+
+  EXPECT_EQ(loaded_small.dims(), small.dims());
+  EXPECT_EQ(loaded_small.lod(), small.lod());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(loaded_small.data<int64_t>()[i], i);
+  }
+  EXPECT_EQ(loaded_large.dims(), large.dims());
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(loaded_large.data<float>()) %
+                phi::kTensorDataPageSize,
+            0UL);
+  for (int i = 0; i < large.numel(); ++i) {
+    EXPECT_EQ(loaded_large.data<float>()[i], static_cast<float>(i) * 0.5f);
+  }
+  // The tensors keep the mapping alive after the file is removed, and can be
+  // written without touching the file.
+  loaded_large.data<float>()[0] = -1.0f;
+  EXPECT_EQ(loaded_large.data<float>()[0], -1.0f);
+}
+#endif
+
 }  // namespace framework
 }  // namespace paddle
@@ -0,0 +1,306 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/new_executor/workqueue/lock_free_run_queue.h"
+#include "paddle/fluid/framework/new_executor/workqueue/run_queue.h"
+#include "paddle/fluid/framework/new_executor/workqueue/workqueue.h"
+#include "paddle/fluid/framework/new_executor/workqueue/workqueue_utils.h"
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+// 0 is the empty Work.
+template <typename Queue>
+void TestBasic() {
+  Queue q;
+  EXPECT_TRUE(q.Empty());
+  EXPECT_EQ(q.PopFront(), 0);
+  EXPECT_EQ(q.PopBack(), 0);
+
+  EXPECT_EQ(q.PushFront(1), 0);
+  EXPECT_EQ(q.PushFront(2), 0);
+  EXPECT_EQ(q.PushBack(3), 0);
+  EXPECT_EQ(q.Size(), 3u);
+  EXPECT_EQ(q.PopFront(), 2);
+  EXPECT_EQ(q.PopBack(), 3);
+  EXPECT_EQ(q.PopBack(), 1);
+  EXPECT_TRUE(q.Empty());
+
+  // Full
+  for (int i = 1; i <= 8; ++i) {
+    EXPECT_EQ(q.PushFront(i), 0);
+  }
+  EXPECT_EQ(q.PushFront(9), 9);
+  std::vector<int> half;
+  EXPECT_EQ(q.PopBackHalf(&half), 4u);
+  EXPECT_EQ(q.Size(), 4u);
+  q.Flush();
+  EXPECT_TRUE(q.Empty());
+}
+
+// The owner pushes to and pops from the front, while the other threads push
+// to and steal from the back. Every item must be taken exactly once.
+template <typename Queue>
+void TestConcurrent() {
+  constexpr int kRemoteThreads = 8;
+  constexpr int kItemsPerThread = 20000;
+  Queue q;
+  std::atomic<int64_t> sum{0};
+  std::atomic<int> taken{0};
+  std::atomic<bool> done{false};
+  const int total = kItemsPerThread * (kRemoteThreads + 1);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kRemoteThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      int pushed = 0;
+      while (!done) {
+        if (pushed < kItemsPerThread) {
+          int item = (t + 1) * kItemsPerThread + pushed + 1;
+          if (q.PushBack(item) == 0) {
+            ++pushed;
+          }
+        }
+        int item = q.PopBack();
+        if (item != 0) {
+          sum += item;
+          ++taken;
+        }
+      }
+    });
+  }
+
+  int pushed = 0;
+  while (taken < total) {
+    if (pushed < kItemsPerThread && q.PushFront(pushed + 1) == 0) {
+      ++pushed;
+    }
+    int item = q.PopFront();
+    if (item != 0) {
+      sum += item;
+      ++taken;
+    }
+  }
+  done = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  int64_t expected = 0;
+  for (int t = 0; t <= kRemoteThreads; ++t) {
+    for (int i = 0; i < kItemsPerThread; ++i) {
+      expected += t * kItemsPerThread + i + 1;
+    }
+  }
+  EXPECT_EQ(taken.load(), total);
+  EXPECT_EQ(sum.load(), expected);
+  EXPECT_TRUE(q.Empty());
+}
+
+struct StealStats {
+  double seconds{0};
+  double mean_latency_us{0};
+  double max_latency_us{0};
+  double steal_rate{0};
+};
+
+// Each thread owns a queue. It pushes most items to its own front and some to
+// the back of a random queue, then pops its own front and steals from random
+// queues when it runs out of work. Items carry their push time to measure
+// the latency in the queue.
+template <typename Queue>
+StealStats BenchmarkSteal(int num_threads, int items_per_thread) {
+  using Clock = std::chrono::steady_clock;
+  std::vector<std::unique_ptr<Queue>> queues;
+  for (int i = 0; i < num_threads; ++i) {
+    queues.emplace_back(std::make_unique<Queue>());
+  }
+  const int64_t total = static_cast<int64_t>(num_threads) * items_per_thread;
+  const auto start = Clock::now();
+  auto now_ns = [&]() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                                start)
+               .count() +
+           1;
+  };
+  std::atomic<int64_t> taken{0};
+  std::atomic<int64_t> steal_tries{0};
+  std::atomic<int64_t> steal_hits{0};
+  std::atomic<int64_t> latency_sum{0};
+  std::atomic<int64_t> latency_max{0};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      std::mt19937 rng(t);
+      Queue& own = *queues[t];
+      int pushed = 0;
+      int64_t tries = 0, hits = 0, lat_sum = 0, lat_max = 0, local_taken = 0;
+      auto consume = [&](int64_t item) {
+        int64_t lat = now_ns() - item;
+        lat_sum += lat;
+        lat_max = std::max(lat_max, lat);
+        ++local_taken;
+      };
+      while (taken.load(std::memory_order_relaxed) + local_taken < total) {
+        if (pushed < items_per_thread) {
+          int64_t item = now_ns();
+          bool remote = rng() % 4 == 0;
+          int64_t rest = remote ? queues[rng() % num_threads]->PushBack(item)
+                                : own.PushFront(item);
+          if (rest == 0) {
+            ++pushed;
+          }
+        }
+        int64_t item = own.PopFront();
+        if (item != 0) {
+          consume(item);
+          continue;
+        }
+        ++tries;
+        item = queues[rng() % num_threads]->PopBack();
+        if (item != 0) {
+          ++hits;
+          consume(item);
+        } else if (local_taken > 0) {
+          taken += local_taken;
+          local_taken = 0;
+        }
+      }
+      taken += local_taken;
+      steal_tries += tries;
+      steal_hits += hits;
+      latency_sum += lat_sum;
+      int64_t cur = latency_max.load();
+      while (lat_max > cur &&
+             !latency_max.compare_exchange_weak(cur, lat_max)) {
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  StealStats stats;
+  stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  stats.mean_latency_us = latency_sum.load() / 1e3 / taken.load();
+  stats.max_latency_us = latency_max.load() / 1e3;
+  stats.steal_rate = steal_tries.load() == 0
+                         ? 0
+                         : static_cast<double>(steal_hits.load()) /
+                               static_cast<double>(steal_tries.load());
+  EXPECT_EQ(taken.load(), total);
+  return stats;
+}
+
+double BenchmarkWorkQueue(bool lock_free_queue, int num_threads, int tasks) {
+  EventsWaiter events_waiter;
+  WorkQueueOptions options(/*name*/ "RunQueueBenchmark",
+                           /*num_threads*/ num_threads,
+                           /*allow_spinning*/ true,
+                           /*always_spinning*/ false,
+                           /*track_task*/ true,
+                           /*detached*/ true,
+                           &events_waiter);
+  options.lock_free_queue = lock_free_queue;
+  auto work_queue = CreateMultiThreadedWorkQueue(options);
+  std::atomic<int> counter{0};
+  auto start = std::chrono::steady_clock::now();
+  // Half of the tasks are added from outside, the other half by the workers.
+  for (int i = 0; i < tasks / 2; ++i) {
+    work_queue->AddTask([&]() {
+      ++counter;
+      work_queue->AddTask([&]() { ++counter; });
+    });
+  }
+  events_waiter.WaitEvent();
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  EXPECT_EQ(counter.load(), tasks / 2 * 2);
+  return seconds;
+}
+
+}  // namespace
+
+TEST(RunQueue, basic) { TestBasic<RunQueue<int, 8>>(); }
+
+TEST(LockFreeRunQueue, basic) { TestBasic<LockFreeRunQueue<int, 8>>(); }
+
+TEST(RunQueue, concurrent) { TestConcurrent<RunQueue<int, 1024>>(); }
+
+TEST(LockFreeRunQueue, concurrent) {
+  TestConcurrent<LockFreeRunQueue<int, 1024>>();
+}
+
+TEST(LockFreeRunQueue, work_queue) {
+  EventsWaiter events_waiter;
+  WorkQueueOptions options(/*name*/ "LockFreeWorkQueue",
+                           /*num_threads*/ 4,
+                           /*allow_spinning*/ true,
+                           /*always_spinning*/ false,
+                           /*track_task*/ true,
+                           /*detached*/ true,
+                           &events_waiter);
+  options.lock_free_queue = true;
+  auto work_queue = CreateMultiThreadedWorkQueue(options);
+  EXPECT_EQ(work_queue->NumThreads(), 4u);
+  auto handle = work_queue->AddAwaitableTask([]() { return 1234; });
+  EXPECT_EQ(handle.get(), 1234);
+  events_waiter.WaitEvent();
+}
+
+// Compare RunQueue and LockFreeRunQueue with 64 threads, the results are
+// printed for reference instead of being checked. The benchmark is disabled
+// by default, run it with --gtest_also_run_disabled_tests.
+TEST(LockFreeRunQueue, DISABLED_benchmark) {
+  constexpr int kThreads = 64;
+  constexpr int kItemsPerThread = 20000;
+  auto locked = BenchmarkSteal<RunQueue<int64_t, 1024>>(kThreads,
+                                                        kItemsPerThread);
+  auto lock_free = BenchmarkSteal<LockFreeRunQueue<int64_t, 1024>>(
+      kThreads, kItemsPerThread);
+  for (const auto& [name, stats] :
+       {std::make_pair("RunQueue", locked),
+        std::make_pair("LockFreeRunQueue", lock_free)}) {
+    LOG(INFO) << name << " with " << kThreads << " threads: " << stats.seconds
+              << " s, steal success rate " << stats.steal_rate
+              << ", mean latency " << stats.mean_latency_us
+              << " us, max latency " << stats.max_latency_us << " us";
+  }
+
+  constexpr int kTasks = 200000;
+  LOG(INFO) << "WorkQueue with RunQueue and " << kThreads << " threads runs "
+            << kTasks
+            << " tasks in: " << BenchmarkWorkQueue(false, kThreads, kTasks)
+            << " s";
+  LOG(INFO) << "WorkQueue with LockFreeRunQueue and " << kThreads
+            << " threads runs " << kTasks
+            << " tasks in: " << BenchmarkWorkQueue(true, kThreads, kTasks)
+            << " s";
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -20,6 +20,7 @@
 #include "glog/logging.h"
 #include "gtest/gtest.h"
 #include "paddle/fluid/framework/new_executor/workqueue/workqueue_utils.h"
+#include "paddle/phi/backends/cpu/numa_info.h"
 
 TEST(WorkQueueUtils, TestEventsWaiter) {
   using paddle::framework::EventsWaiter;
@@ -203,3 +204,17 @@ TEST(WorkQueue, TestWorkQueueGroup) {
   queue_group.reset();
   waiter_thread.join();
 }
+
+TEST(WorkQueue, TestNumaPinnedWorkQueue) {
+  using paddle::framework::CreateMultiThreadedWorkQueue;
+  using paddle::framework::WorkQueueOptions;
+  WorkQueueOptions options(/*name*/ "NumaPinnedWorkQueueForTesting",
+                           /*num_threads*/ 2,
+                           /*allow_spinning*/ false,
+                           /*track_task*/ false);
+  options.numa_node = 0;
+  auto work_queue = CreateMultiThreadedWorkQueue(options);
+  auto handle = work_queue->AddAwaitableTask(
+      []() { return phi::backends::cpu::CurrentNumaNode(); });
+  EXPECT_EQ(handle.get(), 0);
+}
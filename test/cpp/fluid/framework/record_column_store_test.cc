@@ -0,0 +1,202 @@
+/* Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/record_column_store.h"
+
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace framework {
+
+static const std::vector<std::string> kSlotTypes = {
+    "uint64", "float", "uint64", "uint64", "float"};
+
+// Generate the records of CTR samples, the ins id of each is its index.
+static std::vector<Record> GenerateRecords(size_t num, bool with_log_key) {
+  std::mt19937_64 rng(num);
+  std::vector<Record> records(num);
+  for (size_t i = 0; i < num; ++i) {
+    Record& record = records[i];
+    for (size_t slot = 0; slot < kSlotTypes.size(); ++slot) {
+      // some slots have no feasign
+      int feasign_num = rng() % 4;
+      for (int j = 0; j < feasign_num; ++j) {
+        FeatureFeasign sign;
+        if (kSlotTypes[slot] == "float") {
+          sign.float_feasign_ = static_cast<float>(rng() % 1000) / 7;
+          record.float_feasigns_.emplace_back(sign, slot);
+        } else {
+          sign.uint64_feasign_ = rng();
+          record.uint64_feasigns_.emplace_back(sign, slot);
+        }
+      }
+    }
+    record.ins_id_ = std::to_string(i);
+    if (i % 3 == 0) {
+      record.content_ = "content of a long record " + std::to_string(i);
+    }
+    record.search_id = with_log_key ? rng() : 0;
+    record.rank = with_log_key ? i % 7 : 0;
+    record.cmatch = with_log_key ? i % 5 : 0;
+  }
+  return records;
+}
+
+static void ExpectSameFeasigns(const std::vector<FeatureItem>& a,
+                               const std::vector<FeatureItem>& b,
+                               bool is_float) {
+  ASSERT_EQ(a.size(), b.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    ASSERT_EQ(a[i].slot(), b[i].slot());
+    if (is_float) {
+      ASSERT_EQ(a[i].sign().float_feasign_, b[i].sign().float_feasign_);
+    } else {
+      ASSERT_EQ(a[i].sign().uint64_feasign_, b[i].sign().uint64_feasign_);
+    }
+  }
+}
+
+static void ExpectSameRecord(const Record& a, const Record& b) {
+  ExpectSameFeasigns(a.uint64_feasigns_, b.uint64_feasigns_, false);
+  ExpectSameFeasigns(a.float_feasigns_, b.float_feasigns_, true);
+  ASSERT_EQ(a.ins_id_, b.ins_id_);
+  ASSERT_EQ(a.content_, b.content_);
+  ASSERT_EQ(a.uid_, b.uid_);
+  ASSERT_EQ(a.search_id, b.search_id);
+  ASSERT_EQ(a.rank, b.rank);
+  ASSERT_EQ(a.cmatch, b.cmatch);
+}
+
+TEST(RecordColumnStore, AppendAndGet) {
+  RecordColumnStore store;
+  store.Init(kSlotTypes);
+  // more than a chunk, with and without the log keys
+  auto records = GenerateRecords(RecordColumnStore::kChunkSize + 100, false);
+  auto log_key_records = GenerateRecords(1000, true);
+  std::vector<Record> expected = records;
+  expected.insert(
+      expected.end(), log_key_records.begin(), log_key_records.end());
+  store.Append(&records);
+  store.Append(&log_key_records);
+  ASSERT_TRUE(records.empty());
+  ASSERT_EQ(store.Size(), expected.size());
+
+  Record record;
+  for (size_t i = 0; i < expected.size(); ++i) {
+    store.Get(i, &record);
+    ExpectSameRecord(record, expected[i]);
+    ASSERT_EQ(store.InsId(i), expected[i].ins_id_);
+    ASSERT_EQ(store.Content(i), expected[i].content_);
+  }
+
+  // the feasigns of a slot are in one array
+  std::vector<float> slot_floats;
+  for (auto& item : expected[0].float_feasigns_) {
+    if (item.slot() == 1) {
+      slot_floats.push_back(item.sign().float_feasign_);
+    }
+  }
+  size_t num = 0;
+  const float* floats = store.FloatFeasigns(0, 1, &num);
+  ASSERT_EQ(std::vector<float>(floats, floats + num), slot_floats);
+  ASSERT_EQ(store.Uint64Feasigns(0, 1, &num), nullptr);
+
+  // a feasign in a slot of the other type
+  std::vector<Record> bad(1);
+  FeatureFeasign sign;
+  sign.uint64_feasign_ = 1;
+  bad[0].uint64_feasigns_.emplace_back(sign, 1);
+  ASSERT_ANY_THROW(store.Append(&bad));
+}
+
+TEST(RecordColumnStore, ShuffleAndBatch) {
+  RecordColumnStore store;
+  store.Init(kSlotTypes);
+  auto records = GenerateRecords(10000, false);
+  std::vector<Record> expected = records;
+  store.Append(&records);
+  std::default_random_engine engine(0);
+  store.Shuffle(&engine);
+
+  // the batches taken by the threads cover each record once
+  std::vector<std::vector<size_t>> taken(4);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < taken.size(); ++t) {
+    threads.emplace_back([&store, &taken, t] {
+      size_t begin = 0;
+      size_t num = 0;
+      while ((num = store.NextBatch(32, &begin)) != 0) {
+        for (size_t i = begin; i < begin + num; ++i) {
+          taken[t].push_back(std::stoul(store.InsId(i)));
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  std::vector<int> count(expected.size());
+  bool shuffled = false;
+  for (auto& ids : taken) {
+    for (size_t i = 0; i < ids.size(); ++i) {
+      ++count[ids[i]];
+      shuffled = shuffled || (i > 0 && ids[i] != ids[i - 1] + 1);
+    }
+  }
+  ASSERT_TRUE(shuffled);
+  for (auto c : count) {
+    ASSERT_EQ(c, 1);
+  }
+
+  // the shuffled records are the same
+  Record record;
+  for (size_t i = 0; i < store.Size(); ++i) {
+    store.Get(i, &record);
+    ExpectSameRecord(record, expected[std::stoul(record.ins_id_)]);
+  }
+
+  size_t begin = 0;
+  ASSERT_EQ(store.NextBatch(32, &begin), 0UL);
+  store.ResetBatch();
+  ASSERT_EQ(store.NextBatch(32, &begin), 32UL);
+  ASSERT_EQ(begin, 0UL);
+}
+
+TEST(RecordColumnStore, MemorySize) {
+  auto records = GenerateRecords(100000, false);
+  // the heap bytes of the records, without the overhead of the allocator
+  size_t record_bytes = records.capacity() * sizeof(Record);
+  for (auto& record : records) {
+    record_bytes += (record.uint64_feasigns_.capacity() +
+                     record.float_feasigns_.capacity()) *
+                    sizeof(FeatureItem);
+    for (auto* str : {&record.ins_id_, &record.content_, &record.uid_}) {
+      if (str->capacity() > 15) {
+        record_bytes += str->capacity() + 1;
+      }
+    }
+  }
+  RecordColumnStore store;
+  store.Init(kSlotTypes);
+  store.Append(&records);
+  ASSERT_LT(store.MemorySize() * 2, record_bytes);
+}
+
+}  // namespace framework
+}  // namespace paddle
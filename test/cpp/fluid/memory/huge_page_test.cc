@@ -0,0 +1,87 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/huge_page.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/memory/allocation/auto_growth_best_fit_allocator.h"
+#include "paddle/phi/core/memory/allocation/cpu_allocator.h"
+#include "paddle/phi/core/memory/allocation/system_allocator.h"
+
+COMMON_DECLARE_bool(use_cpu_huge_page);
+COMMON_DECLARE_uint64(cpu_huge_page_threshold_in_mb);
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+TEST(HugePage, cpu_allocator) {
+  FLAGS_use_cpu_huge_page = true;
+  FLAGS_cpu_huge_page_threshold_in_mb = 2;
+  CPUAllocator allocator;
+
+  // Small requests never try huge pages.
+  uint64_t tried = HugePageHitCount() + HugePageMissCount();
+  {
+    auto allocation = allocator.Allocate(4096);
+    ASSERT_EQ(HugePageHitCount() + HugePageMissCount(), tried);
+  }
+
+  // Large requests either hit huge pages or fall back, the memory is usable
+  // in both cases.
+  size_t size = 5UL << 20;
+  {
+    auto allocation = allocator.Allocate(size);
+    ASSERT_NE(allocation->ptr(), nullptr);
+    ASSERT_EQ(allocation->size(), size);
+    std::memset(allocation->ptr(), 1, size);
+    ASSERT_GT(HugePageHitCount() + HugePageMissCount(), tried);
+  }
+  FLAGS_use_cpu_huge_page = false;
+}
+
+TEST(HugePage, auto_growth_chunk) {
+  FLAGS_use_cpu_huge_page = true;
+  FLAGS_cpu_huge_page_threshold_in_mb = 2;
+  uint64_t tried = HugePageHitCount() + HugePageMissCount();
+  AutoGrowthBestFitAllocator allocator(
+      std::make_shared<CPUAllocator>(), /*alignment*/ 64, 4UL << 20);
+  {
+    // The first request grows a 4MB chunk, which is backed by huge pages.
+    auto allocation = allocator.Allocate(1024);
+    std::memset(allocation->ptr(), 1, 1024);
+    ASSERT_EQ(HugePageHitCount() + HugePageMissCount(), tried + 1);
+  }
+  FLAGS_use_cpu_huge_page = false;
+}
+
+TEST(HugePage, system_allocator) {
+  FLAGS_use_cpu_huge_page = true;
+  FLAGS_cpu_huge_page_threshold_in_mb = 2;
+  detail::CPUAllocator allocator;
+  size_t index = 0;
+  size_t size = 3UL << 20;
+  void* p = allocator.Alloc(&index, size);
+  ASSERT_NE(p, nullptr);
+  std::memset(p, 1, size);
+  allocator.Free(p, size, index);
+  FLAGS_use_cpu_huge_page = false;
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,59 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/numa_cpu_allocator.h"
+
+#include <cstring>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/cpu/numa_info.h"
+#include "paddle/phi/core/memory/stats.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+TEST(NumaCPUAllocator, alloc_on_each_node) {
+  NumaCPUAllocator allocator(/*alignment*/ 64, /*chunk_size*/ 1 << 20);
+  ASSERT_GE(allocator.NumNodes(), 1UL);
+
+  for (int node = 0; node < static_cast<int>(allocator.NumNodes()); ++node) {
+    std::thread worker([&allocator, node] {
+      phi::backends::cpu::BindCurrentThreadToNumaNode(node);
+      int64_t allocated = HostNumaMemoryStatCurrentValue("Allocated", node);
+      {
+        auto allocation = allocator.Allocate(4096);
+        ASSERT_NE(allocation->ptr(), nullptr);
+        std::memset(allocation->ptr(), 0, allocation->size());
+        ASSERT_EQ(HostNumaMemoryStatCurrentValue("Allocated", node),
+                  allocated + static_cast<int64_t>(allocation->size()));
+        ASSERT_GE(HostNumaMemoryStatCurrentValue("Reserved", node),
+                  static_cast<int64_t>(allocation->size()));
+      }
+      ASSERT_EQ(HostNumaMemoryStatCurrentValue("Allocated", node), allocated);
+    });
+    worker.join();
+  }
+
+  allocator.Release(phi::CPUPlace());
+  for (int node = 0; node < static_cast<int>(allocator.NumNodes()); ++node) {
+    ASSERT_EQ(HostNumaMemoryStatCurrentValue("Reserved", node), 0);
+  }
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,186 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/thread_cached_allocator.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/core/memory/allocation/auto_growth_best_fit_allocator.h"
+#include "paddle/phi/core/memory/allocation/cpu_allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+class CountedAllocator : public Allocator {
+ public:
+  bool IsAllocThreadSafe() const override { return true; }
+
+  int64_t AllocatedCount() const { return allocated_count_; }
+
+ protected:
+  phi::Allocation *AllocateImpl(size_t size) override {
+    ++allocated_count_;
+    return new Allocation(malloc(size), size, phi::CPUPlace());  // NOLINT
+  }
+
+  void FreeImpl(phi::Allocation *allocation) override {
+    --allocated_count_;
+    free(allocation->ptr());  // NOLINT
+    delete allocation;
+  }
+
+ private:
+  std::atomic<int64_t> allocated_count_{0};
+};
+
+TEST(ThreadCachedAllocator, size_class) {
+  size_t last_size = 0;
+  for (size_t cls = 0; cls < ThreadCachedAllocator::kNumSizeClasses; ++cls) {
+    size_t size = ThreadCachedAllocator::ClassToSize(cls);
+    ASSERT_GT(size, last_size);
+    ASSERT_EQ(ThreadCachedAllocator::SizeToClass(size), cls);
+    ASSERT_EQ(ThreadCachedAllocator::SizeToClass(last_size + 1), cls);
+    last_size = size;
+  }
+  ASSERT_EQ(last_size, ThreadCachedAllocator::kMaxCachedSize);
+}
+
+TEST(ThreadCachedAllocator, reuse_and_release) {
+  auto underlying = std::make_shared<CountedAllocator>();
+  auto allocator = std::make_shared<ThreadCachedAllocator>(underlying, 1 << 20);
+
+  void *ptr = nullptr;
+  {
+    auto allocation = allocator->Allocate(100);
+    ASSERT_GE(allocation->size(), 100UL);
+    ptr = allocation->ptr();
+  }
+  ASSERT_EQ(underlying->AllocatedCount(), 1);
+  {
+    // Same size class is served from the thread cache.
+    auto allocation = allocator->Allocate(112);
+    ASSERT_EQ(allocation->ptr(), ptr);
+    ASSERT_EQ(underlying->AllocatedCount(), 1);
+  }
+  {
+    // Large requests bypass the cache.
+    auto allocation =
+        allocator->Allocate(ThreadCachedAllocator::kMaxCachedSize + 1);
+    ASSERT_EQ(underlying->AllocatedCount(), 2);
+  }
+  ASSERT_EQ(underlying->AllocatedCount(), 1);
+
+  allocator->Release(phi::CPUPlace());
+  ASSERT_EQ(underlying->AllocatedCount(), 0);
+}
+
+TEST(ThreadCachedAllocator, high_water_mark) {
+  auto underlying = std::make_shared<CountedAllocator>();
+  size_t max_thread_cache_bytes = 64 << 10;
+  auto allocator = std::make_shared<ThreadCachedAllocator>(
+      underlying, max_thread_cache_bytes);
+
+  // 1024 allocations of 1KB, 16 times the high-water mark.
+  std::vector<phi::Allocator::AllocationPtr> allocations;
+  for (int i = 0; i < 1024; ++i) {
+    allocations.emplace_back(allocator->Allocate(1024));
+  }
+  allocations.clear();
+  // Whatever is not cached by the thread or the central free list has been
+  // returned to the underlying allocator.
+  size_t max_central_bytes = 8 * ThreadCachedAllocator::NumToMove(
+                                     ThreadCachedAllocator::SizeToClass(1024)) *
+                             1024;
+  ASSERT_LE(static_cast<size_t>(underlying->AllocatedCount()) * 1024,
+            max_thread_cache_bytes + max_central_bytes);
+}
+
+TEST(ThreadCachedAllocator, cross_thread_free) {
+  auto underlying = std::make_shared<CountedAllocator>();
+  auto allocator = std::make_shared<ThreadCachedAllocator>(underlying, 1 << 20);
+
+  std::vector<phi::Allocator::AllocationPtr> allocations;
+  std::thread producer([&] {
+    for (int i = 0; i < 256; ++i) {
+      allocations.emplace_back(allocator->Allocate(64 * (i % 16 + 1)));
+    }
+  });
+  producer.join();
+  std::thread consumer([&] { allocations.clear(); });
+  consumer.join();
+
+  // Both threads have exited, so all allocations are in the central list.
+  allocator->Release(phi::CPUPlace());
+  ASSERT_EQ(underlying->AllocatedCount(), 0);
+}
+
+// Contention benchmark: many threads allocate and free small CPU buffers,
+// compare AutoGrowthBestFitAllocator with and without the thread cache.
+static double RunContentionBenchmark(std::shared_ptr<Allocator> allocator,
+                                     int thread_num,
+                                     int iter_num) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&allocator, iter_num, t] {
+      std::mt19937 rng(t);
+      std::uniform_int_distribution<size_t> dist(16, 64 << 10);
+      std::vector<phi::Allocator::AllocationPtr> live(16);
+      for (int i = 0; i < iter_num; ++i) {
+        live[i % live.size()] = allocator->Allocate(dist(rng));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// The benchmark is disabled by default, run it with
+// --gtest_also_run_disabled_tests.
+TEST(ThreadCachedAllocator, DISABLED_contention_benchmark) {
+  constexpr int kThreadNum = 32;
+  constexpr int kIterNum = 20000;
+  constexpr size_t kAlignment = 64;
+  constexpr size_t kChunkSize = 1 << 20;
+
+  auto best_fit = std::make_shared<AutoGrowthBestFitAllocator>(
+      std::make_shared<CPUAllocator>(), kAlignment, kChunkSize);
+  double best_fit_ms = RunContentionBenchmark(best_fit, kThreadNum, kIterNum);
+
+  auto thread_cached = std::make_shared<ThreadCachedAllocator>(
+      std::make_shared<AutoGrowthBestFitAllocator>(
+          std::make_shared<CPUAllocator>(), kAlignment, kChunkSize),
+      4 << 20);
+  double thread_cached_ms =
+      RunContentionBenchmark(thread_cached, kThreadNum, kIterNum);
+
+  std::cout << "threads: " << kThreadNum << ", iterations: " << kIterNum
+            << ", AutoGrowthBestFitAllocator: " << best_fit_ms
+            << " ms, ThreadCachedAllocator: " << thread_cached_ms << " ms"
+            << std::endl;
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -16,12 +16,20 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "paddle/phi/core/kernel_registry.h"
 
+#include "paddle/fluid/framework/new_executor/interpreter/cpu_core_budget.h"
+#include "paddle/fluid/framework/new_executor/interpreter/critical_path_scheduler.h"
+#include "paddle/fluid/framework/new_executor/interpreter/static_memory_planner.h"
 #include "paddle/fluid/framework/new_executor/pir_interpreter.h"
 #include "paddle/fluid/pir/dialect/operator/ir/control_flow_op.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
@@ -39,6 +47,11 @@
 
 DECLARE_FILE_SYMBOLS(kernel_dialect);
 
+COMMON_DECLARE_bool(new_executor_static_memory_plan);
+COMMON_DECLARE_bool(enable_pir_in_executor_trace_run);
+COMMON_DECLARE_string(new_executor_scheduling_policy);
+COMMON_DECLARE_int32(new_executor_cpu_core_budget);
+
 PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(full_int_array, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(uniform, CPU, ALL_LAYOUT);
@@ -260,6 +273,353 @@ TEST(StandaloneExecutor, run_inplace_sqrt) {
   EXPECT_EQ(res3, true);
 }
 
+TEST(StaticMemoryPlanner, assign_offsets) {
+  std::vector<interpreter::MemoryBlock> blocks = {
+      {256, 0, 1}, {128, 1, 2}, {256, 2, 3}, {64, 3, 4}, {64, 0, 4}};
+  size_t arena_size = interpreter::AssignMemoryOffsets(&blocks);
+
+  size_t total_size = 0;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    total_size += blocks[i].size;
+    EXPECT_LE(blocks[i].offset + blocks[i].size, arena_size);
+    for (size_t j = i + 1; j < blocks.size(); ++j) {
+      bool alive_together = blocks[i].first_use <= blocks[j].last_use &&
+                            blocks[j].first_use <= blocks[i].last_use;
+      bool overlap = blocks[i].offset < blocks[j].offset + blocks[j].size &&
+                     blocks[j].offset < blocks[i].offset + blocks[i].size;
+      EXPECT_FALSE(alive_together && overlap) << i << " vs " << j;
+    }
+  }
+  // The two 256 bytes blocks share memory.
+  EXPECT_EQ(blocks[0].offset, blocks[2].offset);
+  EXPECT_EQ(arena_size, 448u);
+  EXPECT_LT(arena_size, total_size);
+}
+
+TEST(StandaloneExecutor, run_with_static_memory_plan) {
+  FLAGS_new_executor_static_memory_plan = true;
+  FLAGS_enable_pir_in_executor_trace_run = true;
+
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Program program((ctx));
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  pir::Builder builder = pir::Builder(ctx, program.block());
+
+  paddle::dialect::FullOp a = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{2, 2}, 1.0, phi::DataType::FLOAT32, phi::CPUPlace());
+  paddle::dialect::FullOp b = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{2, 2}, 1.0, phi::DataType::FLOAT32, phi::CPUPlace());
+  auto c = builder.Build<paddle::dialect::AddOp>(a->result(0), b->result(0));
+  auto d = builder.Build<paddle::dialect::AddOp>(c->result(0), a->result(0));
+  auto e = builder.Build<paddle::dialect::AddOp>(d->result(0), d->result(0));
+
+  std::string out_name = "add_out";
+  builder.Build<pir::ShadowOutputOp>(e->result(0), out_name);
+
+  auto kernel_program = paddle::dialect::PdOpLowerToKernelPass(&program);
+
+  auto place = phi::CPUPlace();
+  Scope scope;
+  InterpreterCore test_core(place, {}, kernel_program->block(), &scope);
+  test_core.SetSkipGcVars({out_name});
+
+  const auto* interpreter =
+      dynamic_cast<const PirInterpreter*>(test_core.Impl());
+  ASSERT_NE(interpreter, nullptr);
+
+  // The first run builds the plan, the following runs use it.
+  for (int i = 0; i < 3; ++i) {
+    test_core.Run({});
+
+    // a, b, c and d are planned, e is the output. b is dead when d is
+    // produced, so they share memory.
+    const auto* planner = interpreter->GetStaticMemoryPlanner();
+    ASSERT_NE(planner, nullptr);
+    EXPECT_EQ(planner->NumPlannedValues(), 4u);
+    EXPECT_LT(planner->PlannedPeak(), planner->TotalSize());
+    EXPECT_EQ(planner->IsBound(), i > 0);
+
+    auto out_tensor =
+        test_core.local_scope() == nullptr
+            ? scope.FindVar(out_name)->Get<phi::DenseTensor>()
+            : test_core.local_scope()
+                  ->FindVar(out_name)
+                  ->Get<phi::DenseTensor>();
+    for (int j = 0; j < 4; ++j) {
+      EXPECT_TRUE(simple_cmp(out_tensor.data<float>()[j], 6.0));
+    }
+  }
+
+  FLAGS_new_executor_static_memory_plan = false;
+  FLAGS_enable_pir_in_executor_trace_run = false;
+}
+
+TEST(CriticalPathScheduler, path_length) {
+  // 0 -> 1 -> 3
+  //  \-> 2 -/
+  std::map<size_t, std::set<size_t>> downstream_map = {
+      {0, {1, 2}}, {1, {3}}, {2, {3}}};
+  auto path_length =
+      interpreter::ComputePathLength({1, 5, 2, 1}, downstream_map);
+  EXPECT_EQ(path_length, (std::vector<double>{7, 6, 3, 1}));
+}
+
+TEST(StandaloneExecutor, run_with_critical_path_scheduling) {
+  FLAGS_new_executor_scheduling_policy = "critical_path";
+
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Program program((ctx));
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  pir::Builder builder = pir::Builder(ctx, program.block());
+
+  paddle::dialect::FullOp a = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{2, 2}, 4.0, phi::DataType::FLOAT32, phi::CPUPlace());
+  // A long branch and a short branch.
+  auto b1 = builder.Build<paddle::dialect::SqrtOp>(a->result(0));
+  auto b2 = builder.Build<paddle::dialect::AddOp>(b1->result(0), b1->result(0));
+  auto b3 = builder.Build<paddle::dialect::SqrtOp>(b2->result(0));
+  auto c1 = builder.Build<paddle::dialect::AddOp>(a->result(0), a->result(0));
+  auto out =
+      builder.Build<paddle::dialect::AddOp>(b3->result(0), c1->result(0));
+
+  std::string out_name = "add_out";
+  builder.Build<pir::ShadowOutputOp>(out->result(0), out_name);
+
+  auto kernel_program = paddle::dialect::PdOpLowerToKernelPass(&program);
+
+  auto place = phi::CPUPlace();
+  Scope scope;
+  InterpreterCore test_core(place, {}, kernel_program->block(), &scope);
+  test_core.SetSkipGcVars({out_name});
+
+  // Run enough times to replace the estimated costs by the profiled ones.
+  size_t num_runs = interpreter::CriticalPathScheduler::kWarmupRuns +
+                    interpreter::CriticalPathScheduler::kProfileRuns + 2;
+  for (size_t i = 0; i < num_runs; ++i) {
+    test_core.Run({});
+
+    auto out_tensor =
+        test_core.local_scope() == nullptr
+            ? scope.FindVar(out_name)->Get<phi::DenseTensor>()
+            : test_core.local_scope()
+                  ->FindVar(out_name)
+                  ->Get<phi::DenseTensor>();
+    for (int j = 0; j < 4; ++j) {
+      EXPECT_TRUE(simple_cmp(out_tensor.data<float>()[j], 10.0));
+    }
+  }
+
+  FLAGS_new_executor_scheduling_policy = "default";
+}
+
+// Run a program of branches with 2, 4, ..., 16 chained sqrt ops on 1024x1024
+// tensors with the scheduling policy, return the average milliseconds of a
+// run after the costs are profiled.
+double RunMultiBranchProgram(const std::string& policy, int num_runs) {
+  FLAGS_new_executor_scheduling_policy = policy;
+
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Program program((ctx));
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  pir::Builder builder = pir::Builder(ctx, program.block());
+
+  paddle::dialect::FullOp a = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{1024, 1024},
+      4.0,
+      phi::DataType::FLOAT32,
+      phi::CPUPlace());
+  pir::Value sum;
+  for (int branch = 1; branch <= 8; ++branch) {
+    pir::Value value = a->result(0);
+    for (int i = 0; i < 2 * branch; ++i) {
+      value = builder.Build<paddle::dialect::SqrtOp>(value)->result(0);
+    }
+    sum = sum ? builder.Build<paddle::dialect::AddOp>(sum, value)->result(0)
+              : value;
+  }
+
+  std::string out_name = "add_out";
+  builder.Build<pir::ShadowOutputOp>(sum, out_name);
+
+  auto kernel_program = paddle::dialect::PdOpLowerToKernelPass(&program);
+
+  auto place = phi::CPUPlace();
+  Scope scope;
+  InterpreterCore test_core(place, {}, kernel_program->block(), &scope);
+  test_core.SetSkipGcVars({out_name});
+
+  size_t warmup_runs = interpreter::CriticalPathScheduler::kWarmupRuns +
+                       interpreter::CriticalPathScheduler::kProfileRuns;
+  for (size_t i = 0; i < warmup_runs; ++i) {
+    test_core.Run({});
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_runs; ++i) {
+    test_core.Run({});
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  FLAGS_new_executor_scheduling_policy = "default";
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         num_runs;
+}
+
+// Compare the default and the critical path scheduling on a multi-branch
+// program. The benchmark is disabled by default, run it with
+// --gtest_also_run_disabled_tests.
+TEST(StandaloneExecutor, DISABLED_critical_path_scheduling_benchmark) {
+  const int num_runs = 50;
+  double default_ms = RunMultiBranchProgram("default", num_runs);
+  double critical_path_ms = RunMultiBranchProgram("critical_path", num_runs);
+  std::cout << "default: " << default_ms
+            << " ms, critical_path: " << critical_path_ms << " ms"
+            << std::endl;
+}
+
+TEST(CpuCoreBudget, acquire) {
+  interpreter::CpuCoreBudget budget(4);
+  budget.SetDesiredThreads(0, 3);
+  budget.SetDesiredThreads(1, 8);
+  budget.SetDesiredThreads(2, 1);
+
+  // Instruction 0 takes 3 cores, instruction 1 takes the last one, and
+  // instruction 2 runs beyond the budget with a single thread.
+  EXPECT_EQ(budget.Acquire(0), 3);
+  EXPECT_EQ(budget.Acquire(1), 1);
+  EXPECT_EQ(budget.Acquire(2), 1);
+  budget.Release(3);
+  budget.Release(1);
+  budget.Release(1);
+
+  // All cores are idle again, the desired threads are capped by the budget.
+  EXPECT_EQ(budget.Acquire(1), 4);
+  budget.Release(4);
+}
+
+TEST(StandaloneExecutor, run_with_cpu_core_budget) {
+  FLAGS_new_executor_cpu_core_budget = 2;
+
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Program program((ctx));
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  pir::Builder builder = pir::Builder(ctx, program.block());
+
+  paddle::dialect::FullOp a = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{256, 256},
+      4.0,
+      phi::DataType::FLOAT32,
+      phi::CPUPlace());
+  auto b = builder.Build<paddle::dialect::SqrtOp>(a->result(0));
+  auto c = builder.Build<paddle::dialect::AddOp>(a->result(0), a->result(0));
+  auto d = builder.Build<paddle::dialect::AddOp>(b->result(0), c->result(0));
+
+  std::string out_name = "add_out";
+  builder.Build<pir::ShadowOutputOp>(d->result(0), out_name);
+
+  auto kernel_program = paddle::dialect::PdOpLowerToKernelPass(&program);
+
+  auto place = phi::CPUPlace();
+  Scope scope;
+  InterpreterCore test_core(place, {}, kernel_program->block(), &scope);
+  test_core.SetSkipGcVars({out_name});
+
+  for (int i = 0; i < 2; ++i) {
+    test_core.Run({});
+
+    auto out_tensor =
+        test_core.local_scope() == nullptr
+            ? scope.FindVar(out_name)->Get<phi::DenseTensor>()
+            : test_core.local_scope()
+                  ->FindVar(out_name)
+                  ->Get<phi::DenseTensor>();
+    for (int j = 0; j < 256 * 256; j += 1024) {
+      EXPECT_TRUE(simple_cmp(out_tensor.data<float>()[j], 10.0));
+    }
+  }
+
+  FLAGS_new_executor_cpu_core_budget = 0;
+}
+
+TEST(StandaloneExecutor, run_with_restored_dependencies) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Program program((ctx));
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  pir::Builder builder = pir::Builder(ctx, program.block());
+
+  paddle::dialect::FullOp a = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{2, 2}, 4.0, phi::DataType::FLOAT32, phi::CPUPlace());
+  auto b = builder.Build<paddle::dialect::SqrtOp>(a->result(0));
+  auto c = builder.Build<paddle::dialect::AddOp>(a->result(0), a->result(0));
+  auto d = builder.Build<paddle::dialect::AddOp>(b->result(0), c->result(0));
+
+  std::string out_name = "add_out";
+  builder.Build<pir::ShadowOutputOp>(d->result(0), out_name);
+
+  auto kernel_program = paddle::dialect::PdOpLowerToKernelPass(&program);
+  auto place = phi::CPUPlace();
+
+  auto run = [&](const interpreter::ExecutionConfig& config,
+                 std::map<size_t, std::set<size_t>>* downstream_map,
+                 std::vector<std::vector<bool>>* happens_before) {
+    Scope scope;
+    InterpreterCore test_core(
+        place, {}, kernel_program->block(), &scope, config);
+    test_core.SetSkipGcVars({out_name});
+    test_core.Run({});
+
+    auto out_tensor =
+        test_core.local_scope() == nullptr
+            ? scope.FindVar(out_name)->Get<phi::DenseTensor>()
+            : test_core.local_scope()
+                  ->FindVar(out_name)
+                  ->Get<phi::DenseTensor>();
+    for (int j = 0; j < 4; ++j) {
+      EXPECT_TRUE(simple_cmp(out_tensor.data<float>()[j], 10.0));
+    }
+
+    const auto* interpreter =
+        dynamic_cast<const PirInterpreter*>(test_core.Impl());
+    ASSERT_NE(interpreter, nullptr);
+    const auto& dependency_builder = interpreter->GetPirDependencyBuilder();
+    *downstream_map = dependency_builder.OpDownstreamMap();
+    size_t op_num = 0;
+    for (const auto& [op_idx, next_ops] : *downstream_map) {
+      op_num = std::max(op_num, op_idx + 1);
+      if (!next_ops.empty()) {
+        op_num = std::max(op_num, *next_ops.rbegin() + 1);
+      }
+    }
+    happens_before->assign(op_num, std::vector<bool>(op_num, false));
+    for (size_t i = 0; i < op_num; ++i) {
+      for (size_t j = 0; j < op_num; ++j) {
+        (*happens_before)[i][j] = dependency_builder.OpHappensBefore(i, j);
+      }
+    }
+  };
+
+  std::map<size_t, std::set<size_t>> built_map, restored_map;
+  std::vector<std::vector<bool>> built_happens_before, restored_happens_before;
+  run(interpreter::ExecutionConfig(), &built_map, &built_happens_before);
+  ASSERT_FALSE(built_map.empty());
+
+  // The dependencies restored from the saved downstream map are the same as
+  // the built ones.
+  interpreter::ExecutionConfig restore_config;
+  restore_config.instruction_dependencies =
+      std::make_shared<const std::map<size_t, std::set<size_t>>>(built_map);
+  run(restore_config, &restored_map, &restored_happens_before);
+  EXPECT_EQ(restored_map, built_map);
+  EXPECT_EQ(restored_happens_before, built_happens_before);
+
+  // A map which does not fit the program falls back to build them.
+  restore_config.instruction_dependencies =
+      std::make_shared<const std::map<size_t, std::set<size_t>>>(
+          std::map<size_t, std::set<size_t>>{{1, {0}}, {0, {100}}});
+  run(restore_config, &restored_map, &restored_happens_before);
+  EXPECT_EQ(restored_map, built_map);
+  EXPECT_EQ(restored_happens_before, built_happens_before);
+}
+
 TEST(StandaloneExecutor, if_op) {
   pir::IrContext* ctx = pir::IrContext::Instance();
   ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
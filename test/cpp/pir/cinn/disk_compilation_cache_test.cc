@@ -0,0 +1,156 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "paddle/cinn/common/target.h"
+#include "paddle/cinn/hlir/framework/pir/disk_compilation_cache.h"
+#include "paddle/cinn/hlir/framework/pir/fusion_info.h"
+#include "paddle/cinn/hlir/framework/pir/op_lowering_group.h"
+#include "paddle/cinn/hlir/framework/pir/utils.h"
+#include "paddle/cinn/hlir/framework/pir_compiler.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/pir/include/core/ir_context.h"
+#include "paddle/pir/include/core/program.h"
+
+PD_DECLARE_string(cinn_compilation_cache_dir);
+PD_DECLARE_bool(enable_cinn_compile_cache);
+
+using cinn::hlir::framework::pir::CompatibleInfo;
+using cinn::hlir::framework::pir::DiskCompilationCache;
+using cinn::hlir::framework::pir::FusionInfo;
+using cinn::hlir::framework::pir::OpLoweringGroup;
+using cinn::hlir::framework::pir::OpLoweringGroupPtr;
+
+namespace {
+
+using ProgramInfo =
+    std::tuple<std::shared_ptr<::pir::Program>, OpLoweringGroupPtr>;
+
+ProgramInfo BuildProgram(const std::vector<int64_t>& input_shape,
+                         float value) {
+  ::pir::IrContext* ctx = ::pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  auto program = std::make_shared<::pir::Program>(ctx);
+  ::pir::Builder builder = ::pir::Builder(ctx, program->block());
+
+  auto full_op = builder.Build<paddle::dialect::FullOp>(
+      input_shape, value, phi::DataType::FLOAT32, phi::CPUPlace());
+  const std::string fn_name = CompatibleInfo::GroupOpsName(
+      std::initializer_list<::pir::Operation*>({full_op.operation()}));
+  auto group = std::make_shared<OpLoweringGroup>(
+      std::initializer_list<::pir::Operation*>({full_op.operation()}),
+      fn_name);
+  group->mut_output_ops().insert(full_op.operation());
+  return {program, group};
+}
+
+}  // namespace
+
+TEST(FusionInfo, Fingerprint) {
+  auto [program_a, group_a] = BuildProgram({64, 128}, 1.0);
+  auto [program_b, group_b] = BuildProgram({64, 128}, 1.0);
+  auto [program_c, group_c] = BuildProgram({64, 256}, 1.0);
+  auto [program_d, group_d] = BuildProgram({64, 128}, 2.0);
+
+  const std::string fingerprint_a = FusionInfo(*group_a).Fingerprint();
+  LOG(INFO) << fingerprint_a;
+  EXPECT_NE(fingerprint_a.find("pd_op.full"), std::string::npos);
+  EXPECT_EQ(fingerprint_a, FusionInfo(*group_b).Fingerprint());
+  EXPECT_NE(fingerprint_a, FusionInfo(*group_c).Fingerprint());
+  EXPECT_NE(fingerprint_a, FusionInfo(*group_d).Fingerprint());
+}
+
+TEST(DiskCompilationCache, Miss) {
+  const auto dir = std::filesystem::temp_directory_path() /
+                   "disk_compilation_cache_test";
+  std::filesystem::remove_all(dir);
+  const auto target = cinn::common::DefaultHostTarget();
+
+  EXPECT_FALSE(DiskCompilationCache::IsEnabled(target));
+  FLAGS_cinn_compilation_cache_dir = dir.string();
+  EXPECT_TRUE(DiskCompilationCache::IsEnabled(target));
+  EXPECT_FALSE(
+      DiskCompilationCache::IsEnabled(cinn::common::DefaultNVGPUTarget()));
+
+  auto [program, group] = BuildProgram({64, 128}, 1.0);
+  EXPECT_EQ(DiskCompilationCache::Instance().Load(FusionInfo(*group), target),
+            nullptr);
+  // The directory is created on the first access.
+  EXPECT_TRUE(std::filesystem::is_directory(dir));
+  EXPECT_NE(DiskCompilationCache::Version().find("llvm-"), std::string::npos);
+
+  FLAGS_cinn_compilation_cache_dir = "";
+  std::filesystem::remove_all(dir);
+}
+
+TEST(DiskCompilationCache, SaveAndLoad) {
+  const auto dir = std::filesystem::temp_directory_path() /
+                   "disk_compilation_cache_save_test";
+  std::filesystem::remove_all(dir);
+  FLAGS_cinn_compilation_cache_dir = dir.string();
+  FLAGS_enable_cinn_compile_cache = true;
+  const auto target = cinn::common::DefaultHostTarget();
+
+  // The compiled kernel is saved into the directory.
+  auto [program, group] = BuildProgram({64, 128}, 1.0);
+  cinn::hlir::framework::PirCompiler compiler(target);
+  const auto kernel_infos = compiler.Build({group});
+  ASSERT_EQ(kernel_infos.size(), 1UL);
+  std::vector<std::filesystem::path> entries;
+  for (const auto& it : std::filesystem::directory_iterator(dir)) {
+    entries.push_back(it.path());
+  }
+  ASSERT_EQ(entries.size(), 1UL);
+  EXPECT_EQ(entries[0].extension(), ".cinn");
+
+  // A group of another program with the same fingerprint loads the kernel
+  // without compiling it.
+  auto [program_b, group_b] = BuildProgram({64, 128}, 1.0);
+  auto result =
+      DiskCompilationCache::Instance().Load(FusionInfo(*group_b), target);
+  ASSERT_NE(result, nullptr);
+  const auto kernel_info = result->GetKernelInfo();
+  EXPECT_EQ(kernel_info.fn_name, kernel_infos[0].fn_name);
+  EXPECT_NE(kernel_info.fn_ptr, nullptr);
+  EXPECT_NE(kernel_info.infer_shape_fn_ptr, nullptr);
+  EXPECT_NE(kernel_info.CX86_fn_ptr, nullptr);
+  EXPECT_EQ(kernel_info.symbol_args_map, kernel_infos[0].symbol_args_map);
+  EXPECT_EQ(kernel_info.temp_space_sizes, kernel_infos[0].temp_space_sizes);
+
+  // Another group misses.
+  auto [program_c, group_c] = BuildProgram({64, 256}, 1.0);
+  EXPECT_EQ(
+      DiskCompilationCache::Instance().Load(FusionInfo(*group_c), target),
+      nullptr);
+
+  // A truncated entry is ignored.
+  const auto entry_size = std::filesystem::file_size(entries[0]);
+  std::filesystem::resize_file(entries[0], entry_size / 2);
+  EXPECT_EQ(
+      DiskCompilationCache::Instance().Load(FusionInfo(*group_b), target),
+      nullptr);
+
+  FLAGS_cinn_compilation_cache_dir = "";
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2026 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_attribute.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_dialect.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_type.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
+#include "paddle/fluid/pir/transforms/pd_op_to_kernel_pass.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/pir/include/core/builtin_dialect.h"
+#include "paddle/pir/include/core/program.h"
+
+PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
+
+std::unique_ptr<pir::Program> BuildKernelProgram() {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<paddle::dialect::KernelDialect>();
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+  auto full_op1 = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{2, 3}, 1.0, phi::DataType::FLOAT32, phi::CPUPlace());
+  auto full_op2 = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{2, 3}, 2.0, phi::DataType::FLOAT32, phi::CPUPlace());
+  builder.Build<paddle::dialect::AddOp>(full_op1.out(), full_op2.out());
+  return paddle::dialect::PdOpLowerToKernelPass(&program, phi::CPUPlace());
+}
+
+TEST(ExecutionPlanTest, save_and_restore) {
+  auto program = BuildKernelProgram();
+
+  pir::ExecutionPlan plan;
+  plan.fingerprint = "test_fingerprint";
+  plan.dependencies = {{0, {2}}, {1, {2}}};
+  plan.fetches = {{"out", {2, 3}}};
+  pir::WriteExecutionPlan(*program, plan, "./test_execution_plan.json");
+
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Program new_program(ctx);
+  pir::ExecutionPlan new_plan;
+  ASSERT_TRUE(pir::ReadExecutionPlan("./test_execution_plan.json",
+                                     "test_fingerprint",
+                                     &new_program,
+                                     &new_plan));
+  EXPECT_EQ(new_plan.dependencies, plan.dependencies);
+  EXPECT_EQ(new_plan.feeds, plan.feeds);
+  EXPECT_EQ(new_plan.fetches, plan.fetches);
+
+  ASSERT_EQ(new_program.block()->size(), program->block()->size());
+  auto old_iter = program->block()->begin();
+  auto new_iter = new_program.block()->begin();
+  for (; old_iter != program->block()->end(); ++old_iter, ++new_iter) {
+    EXPECT_EQ(old_iter->name(), new_iter->name());
+    EXPECT_EQ(old_iter->attribute("kernel_key"),
+              new_iter->attribute("kernel_key"));
+    ASSERT_EQ(old_iter->num_results(), new_iter->num_results());
+    for (size_t i = 0; i < old_iter->num_results(); ++i) {
+      auto type = new_iter->result(i)
+                      .type()
+                      .dyn_cast<paddle::dialect::AllocatedDenseTensorType>();
+      ASSERT_TRUE(type);
+      EXPECT_EQ(type, old_iter->result(i).type());
+      EXPECT_EQ(type.place(), phi::CPUPlace());
+    }
+  }
+}
+
+TEST(ExecutionPlanTest, mismatched_fingerprint) {
+  auto program = BuildKernelProgram();
+
+  pir::ExecutionPlan plan;
+  plan.fingerprint = "old_fingerprint";
+  pir::WriteExecutionPlan(*program, plan, "./test_stale_plan.json");
+
+  pir::Program new_program(pir::IrContext::Instance());
+  pir::ExecutionPlan new_plan;
+  EXPECT_FALSE(pir::ReadExecutionPlan(
+      "./test_stale_plan.json", "new_fingerprint", &new_program, &new_plan));
+  EXPECT_FALSE(pir::ReadExecutionPlan(
+      "./not_exist_plan.json", "old_fingerprint", &new_program, &new_plan));
+  EXPECT_EQ(new_program.block()->size(), 0UL);
+}
@@ -82,13 +82,24 @@ class CtrReader:
         return reader
 
 
+def is_sampled_line(line):
+    # the same lines are sampled in each run, so that the streaming shuffle
+    # test can count them
+    return random.Random(line.strip()).random() < 0.05
+
+
 class DatasetCtrReader(fleet.MultiSlotDataGenerator):
     def generate_sample(self, line):
         def get_rand(low=0.0, high=1.0):
             return random.random()
 
+        def is_sampled():
+            if os.getenv("STREAMING_SHUFFLE") == "1":
+                return is_sampled_line(line)
+            return get_rand() < 0.05
+
         def iter():
-            if get_rand() < 0.05:
+            if is_sampled():
                 fs = line.strip().split('\t')
                 dnn_input = load_dnn_input_record(fs[0])
                 lr_input = load_lr_input_record(fs[1])
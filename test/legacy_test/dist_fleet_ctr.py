@@ -321,22 +321,37 @@ class TestDistCTR2x2(FleetDistRunnerBase):
         filelist = train_file_list
 
         # config dataset
-        dataset = base.DatasetFactory().create_dataset("InMemoryDataset")
-        dataset.set_use_var(self.feeds)
-        dataset.set_batch_size(128)
-        dataset.set_thread(2)
-        dataset.set_filelist(filelist)
-        dataset.set_pipe_command('python ctr_dataset_reader.py')
-        dataset.load_into_memory()
-
-        dataset.global_shuffle(fleet, 12)  # TODO: thread configure
-        shuffle_data_size = dataset.get_shuffle_data_size(fleet)
-        local_data_size = dataset.get_shuffle_data_size()
-        data_size_list = fleet.util.all_gather(local_data_size)
-        print('after global_shuffle data_size_list: ', data_size_list)
-        print('after global_shuffle data_size: ', shuffle_data_size)
-
-        for epoch_id in range(1):
+        streaming_shuffle = os.getenv("STREAMING_SHUFFLE") == "1"
+        if streaming_shuffle:
+            dataset = paddle.distributed.InMemoryDataset()
+            dataset.init(
+                batch_size=batch_size,
+                thread_num=thread_num,
+                pipe_command='python ctr_dataset_reader.py',
+                use_var=self.feeds,
+            )
+            dataset.set_filelist(filelist)
+            # the first epoch trains the data while it is being shuffled
+            dataset.streaming_global_shuffle(fleet, 12)
+            epoch_num = 2
+        else:
+            dataset = base.DatasetFactory().create_dataset("InMemoryDataset")
+            dataset.set_use_var(self.feeds)
+            dataset.set_batch_size(128)
+            dataset.set_thread(2)
+            dataset.set_filelist(filelist)
+            dataset.set_pipe_command('python ctr_dataset_reader.py')
+            dataset.load_into_memory()
+
+            dataset.global_shuffle(fleet, 12)  # TODO: thread configure
+            shuffle_data_size = dataset.get_shuffle_data_size(fleet)
+            local_data_size = dataset.get_shuffle_data_size()
+            data_size_list = fleet.util.all_gather(local_data_size)
+            print('after global_shuffle data_size_list: ', data_size_list)
+            print('after global_shuffle data_size: ', shuffle_data_size)
+            epoch_num = 1
+
+        for epoch_id in range(epoch_num):
             pass_start = time.time()
             exe.train_from_dataset(
                 program=base.default_main_program(),
@@ -347,6 +362,25 @@ class TestDistCTR2x2(FleetDistRunnerBase):
                 debug=int(os.getenv("Debug", "0")),
             )
             pass_time = time.time() - pass_start
+        if streaming_shuffle:
+            shuffle_data_size = dataset.get_shuffle_data_size(fleet)
+            print(
+                'after streaming global_shuffle data_size: ', shuffle_data_size
+            )
+            # each loaded instance is shuffled to exactly one trainer
+            local_ins_num = 0
+            for file in filelist:
+                with open(file) as f:
+                    local_ins_num += sum(
+                        ctr_dataset_reader.is_sampled_line(line) for line in f
+                    )
+            global_ins_num = fleet.util.all_reduce(
+                [local_ins_num], mode="sum"
+            )[0]
+            assert shuffle_data_size == global_ins_num, (
+                f"shuffled {shuffle_data_size} instances, but loaded "
+                f"{global_ins_num}"
+            )
         dataset.release_memory()
 
         if os.getenv("SAVE_MODEL") == "1":
@@ -57,6 +57,18 @@ class TestDistMnistAsyncInMemoryDataset2x2(TestFleetBase):
         )
 
 
+class TestDistMnistAsyncInMemoryDatasetStreamingShuffle2x2(
+    TestDistMnistAsyncInMemoryDataset2x2
+):
+    def test_dist_train(self):
+        self.check_with_place(
+            "dist_fleet_ctr.py",
+            delta=1e-5,
+            check_error_log=False,
+            need_envs={"STREAMING_SHUFFLE": "1"},
+        )
+
+
 class TestDistMnistAsync2x2(TestFleetBase):
     def _setup_config(self):
         self._mode = "async"